@@ -20,13 +20,13 @@ clean-local:
 	@rm -f libtool.bak
 
 # Force header generation before any compilation
-$(shared_objects_valkey_glide): include/glide_bindings.h cluster_scan_cursor_arginfo.h valkey_glide_arginfo.h valkey_glide_cluster_arginfo.h logger_arginfo.h src/client_constructor_mock_arginfo.h valkey-glide/ffi/target/release/libglide_ffi.a
+$(shared_objects_valkey_glide): include/glide_bindings.h cluster_scan_cursor_arginfo.h valkey_glide_bitmap_arginfo.h valkey_glide_bloom_arginfo.h valkey_glide_rate_limiter_arginfo.h valkey_glide_arginfo.h valkey_glide_cluster_arginfo.h logger_arginfo.h src/client_constructor_mock_arginfo.h valkey-glide/ffi/target/release/libglide_ffi.a
 
 # Ensure protobuf files exist before compiling object files that need them
 src/command_request.lo src/connection_request.lo src/response.lo: include/glide_bindings.h
 
 # Backward compatibility alias
-build-modules-pre: include/glide_bindings.h cluster_scan_cursor_arginfo.h valkey_glide_arginfo.h valkey_glide_cluster_arginfo.h logger_arginfo.h src/client_constructor_mock_arginfo.h valkey-glide/ffi/target/release/libglide_ffi.a
+build-modules-pre: include/glide_bindings.h cluster_scan_cursor_arginfo.h valkey_glide_bitmap_arginfo.h valkey_glide_bloom_arginfo.h valkey_glide_rate_limiter_arginfo.h valkey_glide_arginfo.h valkey_glide_cluster_arginfo.h logger_arginfo.h src/client_constructor_mock_arginfo.h valkey-glide/ffi/target/release/libglide_ffi.a
 
 # Debug what files exist
 debug-files:
@@ -56,6 +56,15 @@ endif
 cluster_scan_cursor_arginfo.h: cluster_scan_cursor.stub.php
 	@php -f $(top_srcdir)/build/gen_stub.php cluster_scan_cursor.stub.php || echo "cluster_scan_cursor arginfo generation failed"
 
+valkey_glide_bitmap_arginfo.h: valkey_glide_bitmap.stub.php
+	@php -f $(top_srcdir)/build/gen_stub.php valkey_glide_bitmap.stub.php || echo "valkey_glide_bitmap arginfo generation failed"
+
+valkey_glide_bloom_arginfo.h: valkey_glide_bloom.stub.php
+	@php -f $(top_srcdir)/build/gen_stub.php valkey_glide_bloom.stub.php || echo "valkey_glide_bloom arginfo generation failed"
+
+valkey_glide_rate_limiter_arginfo.h: valkey_glide_rate_limiter.stub.php
+	@php -f $(top_srcdir)/build/gen_stub.php valkey_glide_rate_limiter.stub.php || echo "valkey_glide_rate_limiter arginfo generation failed"
+
 valkey_glide_arginfo.h: valkey_glide.stub.php
 	@php -f $(top_srcdir)/build/gen_stub.php valkey_glide.stub.php || echo "valkey_glide arginfo generation failed"
 
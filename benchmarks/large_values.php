@@ -0,0 +1,96 @@
+<?php
+
+/**
+ * Copyright Valkey GLIDE Project Contributors - SPDX Identifier: Apache-2.0
+ */
+
+declare(strict_types=1);
+
+namespace ValkeyGlide\Benchmarks;
+
+// phpcs:disable PSR1.Files.SideEffects
+require_once __DIR__ . '/utils.php';
+
+use ValkeyGlide;
+use ValkeyGlideCluster;
+
+// Value sizes exercised by default: small, medium and multi-megabyte payloads
+const LARGE_VALUE_SIZES = [1_024, 204_800, 1_048_576, 5_242_880];
+const LARGE_VALUE_ITERATIONS = 1_000;
+const LARGE_VALUE_KEY = 'bench:large_value';
+
+/**
+ * GET latency and throughput for large values.
+ *
+ * Reply strings are copied from the FFI response exactly once, so the time spent per GET and
+ * the peak memory should grow linearly with the value size without a second copy of the payload.
+ */
+function runLargeValueBenchmark(object $client, int $size, int $iterations): array
+{
+    $client->set(LARGE_VALUE_KEY, generateValue($size));
+    /* PHP 8.1 can't reset the peak, which then only reports growth past earlier runs */
+    if (function_exists('memory_reset_peak_usage')) {
+        memory_reset_peak_usage();
+    }
+    $baseline = memory_get_usage();
+
+    $latencies = [];
+    $start = hrtime(true);
+    for ($i = 0; $i < $iterations; $i++) {
+        $opStart = hrtime(true);
+        $value = $client->get(LARGE_VALUE_KEY);
+        $latencies[] = (hrtime(true) - $opStart) / 1_000_000;
+        unset($value);
+    }
+    $elapsed = (hrtime(true) - $start) / 1_000_000_000;
+
+    $client->del(LARGE_VALUE_KEY);
+
+    return array_merge(
+        [
+            'data_size' => $size,
+            'iterations' => $iterations,
+            'tps' => (int)($iterations / $elapsed),
+            'mb_per_sec' => round(($size * $iterations) / $elapsed / 1_048_576, 1),
+            'peak_overhead_bytes' => memory_get_peak_usage() - $baseline,
+        ],
+        latencyResults('get', $latencies)
+    );
+}
+
+$options = getopt('', ['host::', 'port::', 'sizes::', 'iterations::', 'clusterModeEnabled', 'resultsFile::']);
+$host = $options['host'] ?? DEFAULT_HOST;
+$port = (int)($options['port'] ?? DEFAULT_PORT);
+$sizes = isset($options['sizes'])
+    ? array_map('intval', explode(',', $options['sizes']))
+    : LARGE_VALUE_SIZES;
+$iterations = (int)($options['iterations'] ?? LARGE_VALUE_ITERATIONS);
+
+if (isset($options['clusterModeEnabled'])) {
+    $client = new ValkeyGlideCluster(addresses: [['host' => $host, 'port' => $port]]);
+} else {
+    $client = new ValkeyGlide();
+    $client->connect(addresses: [['host' => $host, 'port' => $port]]);
+}
+
+$results = [];
+foreach ($sizes as $size) {
+    $result = runLargeValueBenchmark($client, $size, $iterations);
+    $results[] = $result;
+    printf(
+        "%10d bytes | %7d ops/s | %8.1f MB/s | p50 %.3f ms | p99 %.3f ms | peak +%d bytes\n",
+        $size,
+        $result['tps'],
+        $result['mb_per_sec'],
+        $result['get_p50_latency'],
+        $result['get_p99_latency'],
+        $result['peak_overhead_bytes']
+    );
+}
+
+$client->close();
+
+if (isset($options['resultsFile'])) {
+    file_put_contents($options['resultsFile'], json_encode($results, JSON_PRETTY_PRINT));
+    echo "Results written to {$options['resultsFile']}\n";
+}
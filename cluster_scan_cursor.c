@@ -18,6 +18,7 @@
 #include <ext/standard/info.h>
 
 #include "cluster_scan_cursor_arginfo.h"
+#include "valkey_glide_memory.h"
 
 /* Global variables */
 zend_class_entry*    cluster_scan_cursor_ce;
@@ -35,6 +36,7 @@ zend_object* create_cluster_scan_cursor_object(zend_class_entry* ce) {
     object_properties_init(&cursor_obj->std, ce);
 
     cursor_obj->cursor_id = NULL;
+    valkey_glide_mem_alloc(VALKEY_GLIDE_MEM_SCAN, sizeof(cluster_scan_cursor_object));
 
     memcpy(&cluster_scan_cursor_object_handlers,
            zend_get_std_object_handlers(),
@@ -52,18 +54,22 @@ void free_cluster_scan_cursor_object(zend_object* object) {
 
     /* Call FFI function to clean up Rust-side cursor */
     remove_cluster_scan_cursor(cursor_obj->cursor_id);
+    valkey_glide_mem_scan_cursor_released(cursor_obj->cursor_id);
 
     /* Free cursor string */
     if (cursor_obj->cursor_id) {
+        valkey_glide_mem_free(VALKEY_GLIDE_MEM_SCAN, strlen(cursor_obj->cursor_id) + 1);
         efree(cursor_obj->cursor_id);
         cursor_obj->cursor_id = NULL;
     }
 
     /* Free cursor string */
     if (cursor_obj->next_cursor_id) {
+        valkey_glide_mem_free(VALKEY_GLIDE_MEM_SCAN, strlen(cursor_obj->next_cursor_id) + 1);
         efree(cursor_obj->next_cursor_id);
         cursor_obj->next_cursor_id = NULL;
     }
+    valkey_glide_mem_free(VALKEY_GLIDE_MEM_SCAN, sizeof(cluster_scan_cursor_object));
 
     /* Clean up the standard object */
     zend_object_std_dtor(&cursor_obj->std);
@@ -93,6 +99,7 @@ PHP_METHOD(ClusterScanCursor, __construct) {
     } else {
         cursor_obj->cursor_id = estrdup("0");
     }
+    valkey_glide_mem_alloc(VALKEY_GLIDE_MEM_SCAN, strlen(cursor_obj->cursor_id) + 1);
     cursor_obj->next_cursor_id = NULL; /* Initialize next_cursor_id to NULL */
 }
 
@@ -20,8 +20,16 @@
 #include "include/glide/response.pb-c.h"
 #include "include/glide_bindings.h"
 #include "logger.h"
+#include "valkey_glide_bloom.h"
+#include "valkey_glide_breaker.h"
 #include "valkey_glide_commands_common.h"
+#include "valkey_glide_deadline.h"
+#include "valkey_glide_fiber.h"
+#include "valkey_glide_hedge.h"
+#include "valkey_glide_node_stats.h"
 #include "valkey_glide_otel.h"
+#include "valkey_glide_slot.h"
+#include "valkey_glide_slowlog.h"
 
 #define DEBUG_COMMAND_RESPONSE_TO_ZVAL 0
 
@@ -30,7 +38,8 @@ typedef struct {
     enum {
         ROUTE_TYPE_KEY,       /* Route by key */
         ROUTE_TYPE_HOST_PORT, /* Route by host:port */
-        ROUTE_TYPE_SIMPLE     /* Simple route: "randomNode", "allPrimaries", "allNodes" */
+        ROUTE_TYPE_SIMPLE,    /* Simple route: "randomNode", "allPrimaries", "allNodes" */
+        ROUTE_TYPE_SLOT_ID    /* Route by hash slot, to its primary or to a replica */
     } type;
 
     union {
@@ -46,6 +55,11 @@ typedef struct {
         } host_port_route;
 
         int simple_route_type; /* Using SimpleRoutes_C enum values */
+
+        struct {
+            int  slot;
+            bool replica;
+        } slot_id_route;
     } data;
 } cluster_route_t;
 
@@ -158,6 +172,7 @@ uint8_t* create_route_bytes_from_route(cluster_route_t* route, size_t* route_byt
     /* Declare protobuf structures outside switch to keep them in scope */
     CommandRequest__SlotKeyRoute   slot_key_route   = COMMAND_REQUEST__SLOT_KEY_ROUTE__INIT;
     CommandRequest__ByAddressRoute by_address_route = COMMAND_REQUEST__BY_ADDRESS_ROUTE__INIT;
+    CommandRequest__SlotIdRoute    slot_id_route    = COMMAND_REQUEST__SLOT_ID_ROUTE__INIT;
     CommandRequest__SimpleRoutes   simple_route;
 
     switch (route->type) {
@@ -197,6 +212,16 @@ uint8_t* create_route_bytes_from_route(cluster_route_t* route, size_t* route_byt
             routes.simple_routes = simple_route;
             break;
 
+        case ROUTE_TYPE_SLOT_ID:
+            slot_id_route.slot_type = route->data.slot_id_route.replica
+                                          ? COMMAND_REQUEST__SLOT_TYPES__Replica
+                                          : COMMAND_REQUEST__SLOT_TYPES__Primary;
+            slot_id_route.slot_id   = route->data.slot_id_route.slot;
+
+            routes.value_case    = COMMAND_REQUEST__ROUTES__VALUE_SLOT_ID_ROUTE;
+            routes.slot_id_route = &slot_id_route;
+            break;
+
         default: {
             /* Unknown route type */
             VALKEY_LOG_ERROR_FMT("route_processing", "Unknown route type: %d", route->type);
@@ -236,6 +261,120 @@ uint8_t* create_route_bytes_from_route(cluster_route_t* route, size_t* route_byt
     return route_bytes;
 }
 
+/* Human-readable route, for the slow log */
+static void describe_route(const cluster_route_t* route, char* buf, size_t size) {
+    switch (route->type) {
+        case ROUTE_TYPE_KEY:
+            snprintf(buf,
+                     size,
+                     "key:%.*s",
+                     (int) MIN(route->data.key_route.key_len, size),
+                     route->data.key_route.key);
+            break;
+        case ROUTE_TYPE_HOST_PORT:
+            snprintf(buf,
+                     size,
+                     "%s:%d",
+                     route->data.host_port_route.host,
+                     route->data.host_port_route.port);
+            break;
+        case ROUTE_TYPE_SIMPLE:
+            if (route->data.simple_route_type == COMMAND_REQUEST__SIMPLE_ROUTES__AllPrimaries) {
+                snprintf(buf, size, "allPrimaries");
+            } else if (route->data.simple_route_type == COMMAND_REQUEST__SIMPLE_ROUTES__AllNodes) {
+                snprintf(buf, size, "allNodes");
+            } else {
+                snprintf(buf, size, "randomNode");
+            }
+            break;
+        case ROUTE_TYPE_SLOT_ID:
+            snprintf(buf,
+                     size,
+                     "slot:%d:%s",
+                     route->data.slot_id_route.slot,
+                     route->data.slot_id_route.replica ? "replica" : "primary");
+            break;
+    }
+}
+
+/* Slot a route sends to, VALKEY_GLIDE_NODE_STATS_UNKEYED for node and multi-node routes */
+static int route_slot(const cluster_route_t* route) {
+    switch (route->type) {
+        case ROUTE_TYPE_KEY:
+            return valkey_glide_key_slot(route->data.key_route.key, route->data.key_route.key_len);
+        case ROUTE_TYPE_SLOT_ID:
+            return route->data.slot_id_route.slot;
+        default:
+            return VALKEY_GLIDE_NODE_STATS_UNKEYED;
+    }
+}
+
+/* Whether a route sends to a replica */
+static bool route_replica(const cluster_route_t* route) {
+    return route->type == ROUTE_TYPE_SLOT_ID && route->data.slot_id_route.replica;
+}
+
+/* Send a command, suspending the current Fiber on fiber-aware clients */
+static CommandResult* send_command(const void*          glide_client,
+                                   enum RequestType     command_type,
+                                   unsigned long        arg_count,
+                                   const uintptr_t*     args,
+                                   const unsigned long* args_len,
+                                   const uint8_t*       route_bytes,
+                                   size_t               route_bytes_len,
+                                   uint64_t             span_ptr) {
+    if (valkey_glide_fiber_should_offload(glide_client)) {
+        return valkey_glide_fiber_command(glide_client,
+                                          command_type,
+                                          arg_count,
+                                          args,
+                                          args_len,
+                                          route_bytes,
+                                          route_bytes_len,
+                                          span_ptr);
+    }
+    return command(glide_client,
+                   0,               /* channel */
+                   command_type,    /* command type */
+                   arg_count,       /* number of arguments */
+                   args,            /* arguments */
+                   args_len,        /* argument lengths */
+                   route_bytes,     /* route bytes */
+                   route_bytes_len, /* route bytes length */
+                   span_ptr         /* span pointer */
+    );
+}
+
+/*
+ * Record the outcome of a call with the circuit breakers, and send a repeatable read that
+ * failed once more when the retry budget allows it.
+ */
+static CommandResult* breaker_outcome(valkey_glide_breaker*      breaker,
+                                      valkey_glide_breaker_node* node,
+                                      CommandResult*             result,
+                                      bool                       retry,
+                                      const void*                glide_client,
+                                      enum RequestType           command_type,
+                                      unsigned long              arg_count,
+                                      const uintptr_t*           args,
+                                      const unsigned long*       args_len,
+                                      const uint8_t*             route_bytes,
+                                      size_t                     route_bytes_len) {
+    valkey_glide_breaker_add(breaker, node, result, false);
+    if (!retry || !valkey_glide_is_idempotent_read(command_type) ||
+        !valkey_glide_breaker_retry(breaker, node, result)) {
+        return result;
+    }
+
+    if (result) {
+        free_command_result(result);
+    }
+    result = send_command(
+        glide_client, command_type, arg_count, args, args_len, route_bytes, route_bytes_len, 0);
+    valkey_glide_breaker_add(breaker, node, result, true);
+    return result;
+}
+
 /* Execute a command and handle common error checking */
 CommandResult* execute_command_with_route(const void*          glide_client,
                                           enum RequestType     command_type,
@@ -249,6 +388,17 @@ CommandResult* execute_command_with_route(const void*          glide_client,
         return NULL;
     }
 
+    /* Routed calls go through command(), a withDeadline() budget is only checked beforehand */
+    int64_t deadline_ms;
+    bool    deadline = valkey_glide_deadline_take(glide_client, &deadline_ms);
+    if (deadline && deadline_ms == 0) {
+        valkey_glide_deadline_exceeded(false);
+        return NULL;
+    }
+
+    /* The explicit route wins over a withReadFrom() made for this call */
+    valkey_glide_drop_next_call_options(glide_client);
+
     /* Parse the route from the first parameter */
     cluster_route_t route;
     memset(&route, 0, sizeof(cluster_route_t));
@@ -298,24 +448,69 @@ CommandResult* execute_command_with_route(const void*          glide_client,
         }
     }
 
+    /*
+     * Circuit breaker of the node the route sends to, if it sends to a single slot. Asked last,
+     * as a call it lets through must record an outcome or a half-open breaker stays so.
+     */
+    valkey_glide_breaker*      breaker      = valkey_glide_breaker_find(glide_client);
+    valkey_glide_breaker_node* breaker_node = NULL;
+    if (breaker && !valkey_glide_breaker_allow(breaker, route_slot(&route), &breaker_node)) {
+        efree(route_bytes);
+        if (route.type == ROUTE_TYPE_KEY && route.data.key_route.key_allocated) {
+            efree(route.data.key_route.key);
+        }
+        return NULL;
+    }
+
+    /* Keys the command may create, for a Bloom filter attached to the client */
+    valkey_glide_bloom_record(glide_client, command_type, args, args_len, arg_count);
+
     /* Create OTEL span for tracing */
     uint64_t span_ptr = valkey_glide_create_span(command_type);
 
-    /* Execute the command */
-    CommandResult* result = command(glide_client,
-                                    0,               /* channel */
-                                    command_type,    /* command type */
-                                    arg_count,       /* number of arguments */
-                                    args,            /* arguments */
-                                    args_len,        /* argument lengths */
-                                    route_bytes,     /* route bytes */
-                                    route_bytes_len, /* route bytes length */
-                                    span_ptr         /* span pointer */
-    );
+    valkey_glide_slowlog*    slowlog    = valkey_glide_slowlog_find(glide_client);
+    valkey_glide_node_stats* node_stats = valkey_glide_node_stats_find(glide_client);
+    uint64_t start_ns = slowlog || node_stats ? valkey_glide_slowlog_now() : 0;
+
+    CommandResult* result = send_command(glide_client,
+                                         command_type,
+                                         arg_count,
+                                         args,
+                                         args_len,
+                                         route_bytes,
+                                         route_bytes_len,
+                                         span_ptr);
 
     /* Cleanup span */
     valkey_glide_drop_span(span_ptr);
 
+    if (breaker) {
+        result = breaker_outcome(breaker,
+                                 breaker_node,
+                                 result,
+                                 !deadline,
+                                 glide_client,
+                                 command_type,
+                                 arg_count,
+                                 args,
+                                 args_len,
+                                 route_bytes,
+                                 route_bytes_len);
+    }
+
+    if (node_stats) {
+        valkey_glide_node_stats_add(
+            node_stats, route_slot(&route), route_replica(&route), start_ns, result);
+    }
+
+    uint64_t duration_us;
+    if (slowlog && valkey_glide_slowlog_is_slow(slowlog, start_ns, &duration_us)) {
+        char route_name[VALKEY_GLIDE_SLOWLOG_ROUTE_MAX];
+        describe_route(&route, route_name, sizeof(route_name));
+        valkey_glide_slowlog_add_command(
+            slowlog, duration_us, command_type, arg_count, args, args_len, route_name, result);
+    }
+
     /* Free route bytes */
     if (route_bytes) {
         efree(route_bytes);
@@ -326,6 +521,10 @@ CommandResult* execute_command_with_route(const void*          glide_client,
         efree(route.data.key_route.key);
     }
 
+    if (deadline) {
+        result = valkey_glide_deadline_check(result);
+    }
+
     /* Validate result before returning */
     if (!result) {
         VALKEY_LOG_ERROR("command_response", "Command execution returned NULL result");
@@ -341,39 +540,404 @@ CommandResult* execute_command_with_route(const void*          glide_client,
 }
 
 /* Execute a command and handle common error checking */
-CommandResult* execute_command(const void*          glide_client,
-                               enum RequestType     command_type,
-                               unsigned long        arg_count,
-                               const uintptr_t*     args,
-                               const unsigned long* args_len) {
+/* Keys of read-only commands that may be served by a replica */
+#define READ_KEYS_NONE 0
+#define READ_KEYS_FIRST 1 /* The first argument is the only key */
+#define READ_KEYS_ALL 2   /* Every argument is a key */
+
+static int read_command_keys(enum RequestType command_type) {
+    switch (command_type) {
+        case Get:
+        case GetRange:
+        case Strlen:
+        case GetBit:
+        case BitCount:
+        case BitPos:
+        case HGet:
+        case HGetAll:
+        case HMGet:
+        case HKeys:
+        case HVals:
+        case HLen:
+        case HExists:
+        case HStrlen:
+        case HRandField:
+        case LRange:
+        case LIndex:
+        case LLen:
+        case LPos:
+        case SMembers:
+        case SIsMember:
+        case SMIsMember:
+        case SCard:
+        case SRandMember:
+        case ZRange:
+        case ZScore:
+        case ZMScore:
+        case ZCard:
+        case ZCount:
+        case ZRank:
+        case ZRevRank:
+        case ZLexCount:
+        case ZRandMember:
+        case GeoPos:
+        case GeoDist:
+        case GeoHash:
+        case GeoSearch:
+        case XRange:
+        case XRevRange:
+        case XLen:
+        case Type:
+        case TTL:
+        case PTTL:
+        case ExpireTime:
+        case PExpireTime:
+        case Dump:
+            return READ_KEYS_FIRST;
+        case MGet:
+        case Exists:
+        case SInter:
+        case SUnion:
+        case SDiff:
+        case PfCount:
+            return READ_KEYS_ALL;
+        default:
+            return READ_KEYS_NONE;
+    }
+}
+
+bool valkey_glide_is_idempotent_read(enum RequestType command_type) {
+    switch (command_type) {
+        case SRandMember:
+        case HRandField:
+        case ZRandMember:
+            /* Read-only, but two calls may return different replies */
+            return false;
+        default:
+            return read_command_keys(command_type) != READ_KEYS_NONE;
+    }
+}
+
+/* Slot of a read-only command, false for writes, commands without keys and cross-slot reads */
+static bool read_command_slot(enum RequestType     command_type,
+                              unsigned long        arg_count,
+                              const uintptr_t*     args,
+                              const unsigned long* args_len,
+                              uint16_t*            slot) {
+    int keys = read_command_keys(command_type);
+    if (keys == READ_KEYS_NONE || arg_count == 0) {
+        return false;
+    }
+
+    *slot = valkey_glide_key_slot((const char*) args[0], args_len[0]);
+    for (unsigned long i = 1; keys == READ_KEYS_ALL && i < arg_count; i++) {
+        if (valkey_glide_key_slot((const char*) args[i], args_len[i]) != *slot) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/*
+ * Route for a read under a withReadFrom() override of glide_client, NULL to use the default
+ * routing: writes, commands without keys and reads spanning several slots aren't redirected.
+ */
+static uint8_t* read_from_route_bytes(const void*          glide_client,
+                                      enum RequestType     command_type,
+                                      unsigned long        arg_count,
+                                      const uintptr_t*     args,
+                                      const unsigned long* args_len,
+                                      cluster_route_t*     route,
+                                      size_t*              route_bytes_len) {
+    if (VALKEY_GLIDE_G(read_from_client) != glide_client) {
+        return NULL;
+    }
+
+    int read_from = (int) VALKEY_GLIDE_G(read_from);
+    if (VALKEY_GLIDE_G(read_from_once)) {
+        VALKEY_GLIDE_G(read_from_client) = NULL;
+        VALKEY_GLIDE_G(read_from_once)   = false;
+    }
+
+    uint16_t slot;
+    if (!read_command_slot(command_type, arg_count, args, args_len, &slot)) {
+        return NULL;
+    }
+
+    memset(route, 0, sizeof(cluster_route_t));
+    route->type                       = ROUTE_TYPE_SLOT_ID;
+    route->data.slot_id_route.slot    = slot;
+    route->data.slot_id_route.replica = read_from == VALKEY_GLIDE_READ_FROM_PREFER_REPLICA;
+
+    return create_route_bytes_from_route(route, route_bytes_len);
+}
+
+void valkey_glide_drop_next_call_options_slow(const void* glide_client) {
+    /* A withReadFrom() callback scope lasts until the callback returns */
+    if (VALKEY_GLIDE_G(read_from_client) == glide_client && VALKEY_GLIDE_G(read_from_once)) {
+        VALKEY_GLIDE_G(read_from_client) = NULL;
+        VALKEY_GLIDE_G(read_from_once)   = false;
+    }
+    if (VALKEY_GLIDE_G(deadline_next_client) == glide_client) {
+        VALKEY_GLIDE_G(deadline_next_client) = NULL;
+    }
+}
+
+uint8_t* valkey_glide_slot_route_bytes(uint16_t slot, bool replica, size_t* route_bytes_len) {
+    cluster_route_t route;
+
+    memset(&route, 0, sizeof(cluster_route_t));
+    route.type                       = ROUTE_TYPE_SLOT_ID;
+    route.data.slot_id_route.slot    = slot;
+    route.data.slot_id_route.replica = replica;
+
+    return create_route_bytes_from_route(&route, route_bytes_len);
+}
+
+/*
+ * execute_command(), sending a call with a time budget through batch() when reply is given. The
+ * batch replies with a one element array, *reply is set to that element, or to the response.
+ */
+static CommandResult* execute_command_ex(const void*          glide_client,
+                                         enum RequestType     command_type,
+                                         unsigned long        arg_count,
+                                         const uintptr_t*     args,
+                                         const unsigned long* args_len,
+                                         CommandResponse**    reply) {
     /* Check if client is valid */
     if (!glide_client) {
         return NULL;
     }
 
+    /* Time budget set with withDeadline(), nothing is sent once it is spent */
+    int64_t deadline_ms;
+    bool    deadline = valkey_glide_deadline_take(glide_client, &deadline_ms);
+    if (deadline && deadline_ms == 0) {
+        valkey_glide_deadline_exceeded(false);
+        return NULL;
+    }
+
+    /* Per-call read preference set with withReadFrom() */
+    cluster_route_t route;
+    size_t          route_bytes_len = 0;
+    uint8_t*        route_bytes     = read_from_route_bytes(
+        glide_client, command_type, arg_count, args, args_len, &route, &route_bytes_len);
+
+    /* OPT_HEDGED_READS, for repeatable reads of one slot under the default routing */
+    valkey_glide_hedge* hedge      = NULL;
+    uint16_t            hedge_slot = 0;
+    if (!deadline && !route_bytes) {
+        hedge = valkey_glide_hedge_find(glide_client);
+        if (hedge && (!valkey_glide_is_idempotent_read(command_type) ||
+                      !read_command_slot(command_type, arg_count, args, args_len, &hedge_slot) ||
+                      valkey_glide_fiber_should_offload(glide_client))) {
+            hedge = NULL;
+        }
+    }
+
+    /* Circuit breaker of the node the key noted by the executor, or the route, goes to */
+    valkey_glide_breaker*      breaker      = valkey_glide_breaker_find(glide_client);
+    valkey_glide_breaker_node* breaker_node = NULL;
+    if (breaker &&
+        !valkey_glide_breaker_allow(breaker,
+                                    route_bytes ? route_slot(&route)
+                                                : VALKEY_GLIDE_BREAKER_UNKEYED,
+                                    &breaker_node)) {
+        if (route_bytes) {
+            efree(route_bytes);
+        }
+        return NULL;
+    }
+
+    /* Keys the command may create, for a Bloom filter attached to the client */
+    valkey_glide_bloom_record(glide_client, command_type, args, args_len, arg_count);
+
     /* Create OTEL span for tracing */
     uint64_t span_ptr = valkey_glide_create_span(command_type);
 
-    /* Execute the command with span support */
-    CommandResult* result = command(glide_client,
-                                    0,            /* channel */
-                                    command_type, /* command type */
-                                    arg_count,    /* number of arguments */
-                                    args,         /* arguments */
-                                    args_len,     /* argument lengths */
-                                    NULL,         /* route bytes */
-                                    0,            /* route bytes length */
-                                    span_ptr      /* span pointer */
-    );
+    valkey_glide_slowlog*    slowlog    = valkey_glide_slowlog_find(glide_client);
+    valkey_glide_node_stats* node_stats = valkey_glide_node_stats_find(glide_client);
+    uint64_t start_ns = slowlog || node_stats ? valkey_glide_slowlog_now() : 0;
+
+    /* Execute the command with span support, bounded by the budget when the reply is unwrapped */
+    CommandResult* result;
+    bool           hedge_replica = false;
+    bool           batched       = deadline && !route_bytes && reply;
+    if (batched) {
+        result = valkey_glide_deadline_command(
+            glide_client, command_type, arg_count, args, args_len, deadline_ms, span_ptr);
+    } else if (hedge) {
+        /* The span goes with the read to the primary, which may outlive this call */
+        result = valkey_glide_hedge_command(
+            hedge, command_type, arg_count, args, args_len, hedge_slot, span_ptr, &hedge_replica);
+        span_ptr = 0;
+    } else {
+        result = send_command(glide_client,
+                              command_type,
+                              arg_count,
+                              args,
+                              args_len,
+                              route_bytes,
+                              route_bytes_len,
+                              span_ptr);
+    }
 
     /* Cleanup span */
     valkey_glide_drop_span(span_ptr);
 
+    if (breaker) {
+        /* Calls under a deadline are sent without retries */
+        result = breaker_outcome(breaker,
+                                 breaker_node,
+                                 result,
+                                 !deadline,
+                                 glide_client,
+                                 command_type,
+                                 arg_count,
+                                 args,
+                                 args_len,
+                                 route_bytes,
+                                 route_bytes_len);
+    }
+
+    if (node_stats) {
+        /* Under default routing the key noted by the executor decides the slot */
+        int slot = route_bytes ? route_slot(&route)
+                   : hedge     ? hedge_slot
+                               : VALKEY_GLIDE_NODE_STATS_UNKEYED;
+        valkey_glide_node_stats_add(node_stats,
+                                    slot,
+                                    route_bytes ? route_replica(&route) : hedge_replica,
+                                    start_ns,
+                                    result);
+    }
+
+    uint64_t duration_us;
+    if (slowlog && valkey_glide_slowlog_is_slow(slowlog, start_ns, &duration_us)) {
+        char route_name[VALKEY_GLIDE_SLOWLOG_ROUTE_MAX] = "default";
+        if (route_bytes) {
+            describe_route(&route, route_name, sizeof(route_name));
+        }
+        valkey_glide_slowlog_add_command(
+            slowlog, duration_us, command_type, arg_count, args, args_len, route_name, result);
+    }
+
+    if (route_bytes) {
+        efree(route_bytes);
+    }
+
+    if (deadline) {
+        result = valkey_glide_deadline_check(result);
+    }
+
+    if (reply) {
+        *reply = result ? result->response : NULL;
+        if (batched && *reply) {
+            if ((*reply)->response_type == Array && (*reply)->array_value_len == 1 &&
+                (*reply)->array_value) {
+                *reply = &(*reply)->array_value[0];
+            } else {
+                VALKEY_LOG_ERROR("deadline", "Unexpected reply to a single command batch");
+                free_command_result(result);
+                result = NULL;
+                *reply = NULL;
+            }
+        }
+    }
+
     return result;
 }
 
+CommandResult* execute_command(const void*          glide_client,
+                               enum RequestType     command_type,
+                               unsigned long        arg_count,
+                               const uintptr_t*     args,
+                               const unsigned long* args_len) {
+    return execute_command_ex(glide_client, command_type, arg_count, args, args_len, NULL);
+}
+
+CommandResult* execute_command_for_reply(const void*          glide_client,
+                                         enum RequestType     command_type,
+                                         unsigned long        arg_count,
+                                         const uintptr_t*     args,
+                                         const unsigned long* args_len,
+                                         CommandResponse**    reply) {
+    return execute_command_ex(glide_client, command_type, arg_count, args, args_len, reply);
+}
+
+zend_string* valkey_glide_string_from_response(const CommandResponse* response) {
+    size_t len = (size_t) response->string_value_len;
+
+    if (len == 0) {
+        return ZSTR_EMPTY_ALLOC();
+    }
+    if (len == 1) {
+        return ZSTR_CHAR((zend_uchar) response->string_value[0]);
+    }
+
+    zend_string* str = zend_string_alloc(len, 0);
+    memcpy(ZSTR_VAL(str), response->string_value, len);
+    ZSTR_VAL(str)[len] = '\0';
+    return str;
+}
+
+void valkey_glide_column_add(zval* column, const CommandResponse* value) {
+    zval element;
+
+    switch (value ? value->response_type : Null) {
+        case String:
+            ZVAL_STR(&element, valkey_glide_string_from_response(value));
+            break;
+        case Int:
+            ZVAL_LONG(&element, value->int_value);
+            break;
+        case Float:
+            ZVAL_DOUBLE(&element, value->float_value);
+            break;
+        case Bool:
+            ZVAL_BOOL(&element, value->bool_value);
+            break;
+        case Null:
+            ZVAL_NULL(&element);
+            break;
+        default:
+            command_response_to_zval((CommandResponse*) value,
+                                     &element,
+                                     COMMAND_RESPONSE_NOT_ASSOSIATIVE,
+                                     false);
+            break;
+    }
+    zend_hash_next_index_insert_new(Z_ARRVAL_P(column), &element);
+}
+
+void valkey_glide_column_add_double(zval* column, const CommandResponse* value) {
+    zval   element;
+    char   number[64];
+    size_t len;
+
+    switch (value ? value->response_type : Null) {
+        case Float:
+            ZVAL_DOUBLE(&element, value->float_value);
+            break;
+        case Int:
+            ZVAL_DOUBLE(&element, (double) value->int_value);
+            break;
+        case String:
+            /* The reply is not NUL terminated */
+            len = MIN((size_t) value->string_value_len, sizeof(number) - 1);
+            memcpy(number, value->string_value, len);
+            number[len] = '\0';
+            ZVAL_DOUBLE(&element, zend_strtod(number, NULL));
+            break;
+        default:
+            ZVAL_NULL(&element);
+            break;
+    }
+    zend_hash_next_index_insert_new(Z_ARRVAL_P(column), &element);
+}
+
 /* Handle a string response */
-int handle_string_response(CommandResult* result, char** output, size_t* output_len) {
+int handle_string_response(CommandResult* result, zend_string** output) {
     /* Check if the command was successful */
     if (!result) {
         return -1;
@@ -395,38 +959,15 @@ int handle_string_response(CommandResult* result, char** output, size_t* output_
         switch (result->response->response_type) {
             case String:
 
-                /* Command returns a string/binary data */
-                if (result->response->string_value_len == 0) {
-                    *output = emalloc(1);  // Allocate at least one byte using PHP's memory manager
-                    if (*output) {
-                        (*output)[0] = '\0';  // Empty string is still null-terminated
-                    }
-                    *output_len = 0;
-                } else {
-                    // Allocate exact size needed for binary data using PHP's memory manager
-                    *output = emalloc(result->response->string_value_len + 1);
-                    (*output)[result->response->string_value_len] = '\0';
-                    if (*output) {
-                        // Copy binary data without assuming null-termination
-                        memcpy(*output,
-                               result->response->string_value,
-                               result->response->string_value_len);
-                    }
-                    *output_len = result->response->string_value_len;
-                }
-                // Check if allocation failed
-                if (!*output) {
-                    ret_val = -1;  // Memory allocation failed
-                } else {
-                    ret_val = 1;  // Success
-                }
+                /* Command returns a string/binary data, copied once into the PHP string */
+                *output = valkey_glide_string_from_response(result->response);
+                ret_val = 1;
                 break;
             case Null:
 
                 /* Key didn't exist, return NULL */
-                *output     = NULL;
-                *output_len = 0;
-                ret_val     = 0;
+                *output = NULL;
+                ret_val = 0;
                 break;
             default:
 
@@ -442,6 +983,106 @@ int handle_string_response(CommandResult* result, char** output, size_t* output_
 }
 
 
+/*
+ * Convert a plain list, set or map, and everything nested in it, straight into arrays presized
+ * to the element counts. Map keys become array keys without being copied again.
+ */
+static int response_to_zval_presized(const CommandResponse* response,
+                                     zval*                  output,
+                                     bool                   assoc_maps,
+                                     bool                   false_if_null) {
+    int64_t i;
+
+    switch (response->response_type) {
+        case Null:
+            if (false_if_null) {
+                ZVAL_FALSE(output);
+            } else {
+                ZVAL_NULL(output);
+            }
+            return 0;
+        case Int:
+            ZVAL_LONG(output, response->int_value);
+            return 1;
+        case Float:
+            ZVAL_DOUBLE(output, response->float_value);
+            return 1;
+        case Bool:
+            ZVAL_BOOL(output, response->bool_value);
+            return 1;
+        case String:
+            ZVAL_STR(output, valkey_glide_string_from_response(response));
+            return 1;
+        case Ok:
+            ZVAL_TRUE(output);
+            return 1;
+        case Error:
+            ZVAL_FALSE(output);
+            return 1;
+        case Array:
+            array_init_size(output, (uint32_t) MIN(response->array_value_len, HT_MAX_SIZE));
+            for (i = 0; i < response->array_value_len; i++) {
+                zval value;
+                response_to_zval_presized(
+                    &response->array_value[i], &value, assoc_maps, false_if_null);
+                zend_hash_next_index_insert_new(Z_ARRVAL_P(output), &value);
+            }
+            return 1;
+        case Map:
+            /* Flattened to key, value, key, value, ... unless associative */
+            array_init_size(
+                output,
+                (uint32_t) MIN(response->array_value_len * (assoc_maps ? 1 : 2), HT_MAX_SIZE));
+            for (i = 0; i < response->array_value_len; i++) {
+                const CommandResponse* element = &response->array_value[i];
+                zval                   key, value;
+
+                if (element->map_key) {
+                    response_to_zval_presized(element->map_key, &key, assoc_maps, false_if_null);
+                } else {
+                    ZVAL_NULL(&key);
+                }
+                if (element->map_value) {
+                    response_to_zval_presized(
+                        element->map_value, &value, assoc_maps, false_if_null);
+                } else {
+                    ZVAL_NULL(&value);
+                }
+
+                if (assoc_maps && Z_TYPE(key) == IS_STRING) {
+                    /* The key string is hashed in place rather than copied into the table */
+                    zend_symtable_update(Z_ARRVAL_P(output), Z_STR(key), &value);
+                    zend_string_release(Z_STR(key));
+                } else {
+                    /* Keys PHP can't index by are kept as a key, value sequence */
+                    zend_hash_next_index_insert(Z_ARRVAL_P(output), &key);
+                    zend_hash_next_index_insert(Z_ARRVAL_P(output), &value);
+                }
+            }
+            return 1;
+        case Sets:
+            /* Only string members are returned */
+            array_init_size(output, (uint32_t) MIN(response->sets_value_len, HT_MAX_SIZE));
+            for (i = 0; i < response->sets_value_len; i++) {
+                const CommandResponse* set_item = &response->sets_value[i];
+
+                if (set_item->response_type == String) {
+                    zval value;
+                    ZVAL_STR(&value, valkey_glide_string_from_response(set_item));
+                    zend_hash_next_index_insert_new(Z_ARRVAL_P(output), &value);
+                }
+            }
+            return 1;
+        default:
+            if (false_if_null) {
+                ZVAL_FALSE(output);
+            } else {
+                ZVAL_NULL(output);
+            }
+            return -1;
+    }
+}
+
 /* Helper function to convert a CommandResponse to a PHP value
  * use_associative_array:
  * - 0: regular array processing
@@ -456,6 +1097,18 @@ int command_response_to_zval(CommandResponse* response,
         return 0;
     }
 
+    /* Plain lists, sets and maps are built in a single pass, straight into presized arrays */
+    if ((response->response_type == Array || response->response_type == Map ||
+         response->response_type == Sets) &&
+        (use_associative_array == COMMAND_RESPONSE_NOT_ASSOSIATIVE ||
+         use_associative_array == COMMAND_RESPONSE_ASSOSIATIVE_ARRAY_MAP)) {
+        return response_to_zval_presized(response,
+                                         output,
+                                         use_associative_array ==
+                                             COMMAND_RESPONSE_ASSOSIATIVE_ARRAY_MAP,
+                                         use_false_if_null);
+    }
+
     switch (response->response_type) {
         case Null:
 #if DEBUG_COMMAND_RESPONSE_TO_ZVAL
@@ -501,7 +1154,7 @@ int command_response_to_zval(CommandResponse* response,
                                  "CommandResponse is String with length: %ld",
                                  response->string_value_len);
 #endif
-            ZVAL_STRINGL(output, response->string_value, response->string_value_len);
+            ZVAL_STR(output, valkey_glide_string_from_response(response));
             return 1;
         case Array:
 #if DEBUG_COMMAND_RESPONSE_TO_ZVAL
@@ -44,6 +44,19 @@ CommandResult* execute_command(const void*          glide_client,
                                const uintptr_t*     args,
                                const unsigned long* args_len);
 
+/*
+ * execute_command() for callers that process the reply rather than the result. A withDeadline()
+ * budget then bounds the call while it runs, and reply is the command's reply within the result,
+ * which is still freed with free_command_result(). execute_command() only checks the budget
+ * before sending.
+ */
+CommandResult* execute_command_for_reply(const void*          glide_client,
+                                         enum RequestType     command_type,
+                                         unsigned long        arg_count,
+                                         const uintptr_t*     args,
+                                         const unsigned long* args_len,
+                                         CommandResponse**    reply);
+
 CommandResult* execute_command_with_route(const void*          glide_client,
                                           enum RequestType     command_type,
                                           unsigned long        arg_count,
@@ -51,14 +64,56 @@ CommandResult* execute_command_with_route(const void*          glide_client,
                                           const unsigned long* args_len,
                                           zval*                arg_route);
 
+/* Slow path of valkey_glide_drop_next_call_options() */
+void valkey_glide_drop_next_call_options_slow(const void* glide_client);
+
+/*
+ * Drop the withReadFrom() and withDeadline() settings made for the next call of glide_client.
+ * For calls that don't apply them, which would otherwise leave them to whichever call is next.
+ */
+static inline void valkey_glide_drop_next_call_options(const void* glide_client) {
+    if (EXPECTED(VALKEY_GLIDE_G(read_from_client) != glide_client &&
+                 VALKEY_GLIDE_G(deadline_next_client) != glide_client)) {
+        return;
+    }
+    valkey_glide_drop_next_call_options_slow(glide_client);
+}
+
 /*
  * Handle a string response
  * Returns 1 on success, 0 if the key doesn't exist, -1 on error
- * The output and output_len parameters are set to the string value and length
- * The caller is responsible for freeing the output string using efree()
+ * The output parameter is set to the string value
+ * The caller owns the output string and releases it with zend_string_release()
  * This function frees the CommandResult
  */
-int handle_string_response(CommandResult* result, char** output, size_t* output_len);
+int handle_string_response(CommandResult* result, zend_string** output);
+
+/*
+ * Copy the payload of a String CommandResponse into a new zend_string
+ * The bytes are copied exactly once, directly into the string PHP will own.
+ * Empty and single byte payloads use the interned strings and don't allocate.
+ */
+zend_string* valkey_glide_string_from_response(const CommandResponse* response);
+
+/*
+ * Columnar results
+ *
+ * With OPT_COLUMNAR, replies made of rows are returned as one packed array per field instead
+ * of one array per row. These append a reply element to such a column, a NULL or missing
+ * element appending null so the columns stay aligned. The double variant also parses numbers
+ * sent as strings, such as GEOSEARCH distances.
+ */
+void valkey_glide_column_add(zval* column, const CommandResponse* value);
+void valkey_glide_column_add_double(zval* column, const CommandResponse* value);
+
+/*
+ * Whether a command only reads keys and returns the same reply when repeated without a write
+ * in between, so identical copies of it can share a single reply.
+ */
+bool valkey_glide_is_idempotent_read(enum RequestType command_type);
+
+/* Serialized route to the primary of slot, or to one of its replicas */
+uint8_t* valkey_glide_slot_route_bytes(uint16_t slot, bool replica, size_t* route_bytes_len);
 
 /*
  * Handle a map response
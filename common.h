@@ -127,6 +127,7 @@ typedef struct {
 #define VALKEY_GLIDE_COMPRESSION_BACKEND "backend"
 #define VALKEY_GLIDE_COMPRESSION_LEVEL "compression_level"
 #define VALKEY_GLIDE_COMPRESSION_MIN_SIZE "min_compression_size"
+#define VALKEY_GLIDE_COMPRESSION_DICTIONARY_KEY "dictionary_key"
 
 typedef enum {
     VALKEY_GLIDE_COMPRESSION_BACKEND_ZSTD = 0,
@@ -138,6 +139,7 @@ typedef struct {
     int32_t                            compression_level; /* -1 means not set (use default) */
     valkey_glide_compression_backend_t backend;
     bool                               enabled;
+    char*                              dictionary_key; /* Trained dictionaries, NULL if none */
 } valkey_glide_compression_config_t;
 
 typedef struct {
@@ -153,9 +155,22 @@ typedef struct {
     bool     use_insecure_tls; /* Whether to use insecure TLS (skips certificate verification) */
 } valkey_glide_tls_advanced_configuration_t;
 
+typedef struct {
+    int    failures;        /* Failures in a row opening a node's breaker, 0 for no breakers */
+    int    open_ms;         /* Time an open breaker rejects calls before a probe is let through */
+    int    retry_window_ms; /* Retry budget window, 0 for no retries */
+    double retry_ratio;     /* Retries allowed per request of the window */
+    int    min_retries;     /* Retries allowed in any window */
+} valkey_glide_breaker_config_t;
+
 typedef struct {
     valkey_glide_tls_advanced_configuration_t* tls_config;         /* NULL if not set */
     int                                        connection_timeout; /* In milliseconds. */
+    bool                                       async_completions;  /* Callback-mode client. */
+    int                                        fiber_threads;      /* 0 unless fiber_aware. */
+    zval*                                      fiber_suspend;      /* Borrowed, NULL if not set. */
+    bool                                       shared_client;      /* Process-wide client. */
+    valkey_glide_breaker_config_t              breaker;            /* Zeroed if not set. */
 } valkey_glide_advanced_base_client_configuration_t;
 
 typedef struct {
@@ -249,7 +264,13 @@ struct batch_command {
 
 /* Client runtime options - matching PHPRedis behavior */
 typedef enum {
-    VALKEY_GLIDE_OPT_REPLY_LITERAL = 1 /* Return "OK" string instead of true for Ok responses */
+    VALKEY_GLIDE_OPT_REPLY_LITERAL     = 1, /* Return "OK" string instead of true for Ok replies */
+    VALKEY_GLIDE_OPT_PIPELINE_DEDUPE   = 2, /* Send identical reads of a pipeline only once */
+    VALKEY_GLIDE_OPT_HOT_KEY_SAMPLING  = 3, /* Fraction of commands fed to the hot-key detector */
+    VALKEY_GLIDE_OPT_SLOWLOG_THRESHOLD = 4, /* Microseconds from which calls are slow-logged */
+    VALKEY_GLIDE_OPT_COLUMNAR          = 5, /* Return wide replies as parallel column arrays */
+    VALKEY_GLIDE_OPT_NODE_STATS        = 6, /* Time and count requests per node */
+    VALKEY_GLIDE_OPT_HEDGED_READS      = 7  /* Repeat slow reads on a replica, first reply wins */
 } valkey_glide_option_t;
 
 typedef struct {
@@ -261,7 +282,39 @@ typedef struct {
     bool                  is_in_batch_mode;
 
     /* Runtime options (like PHPRedis OPT_* settings) */
-    bool opt_reply_literal; /* OPT_REPLY_LITERAL: return "OK" string instead of true */
+    bool opt_reply_literal;   /* OPT_REPLY_LITERAL: return "OK" string instead of true */
+    bool opt_pipeline_dedupe; /* OPT_PIPELINE_DEDUPE: send identical pipelined reads once */
+    bool opt_columnar;        /* OPT_COLUMNAR: one array per field instead of per row */
+
+    /* OPT_HOT_KEY_SAMPLING detector, NULL while sampling is off */
+    struct valkey_glide_hot_keys* hot_keys;
+
+    /* OPT_SLOWLOG_THRESHOLD entries, also registered in the slow_logs global by glide_client */
+    struct valkey_glide_slowlog* slowlog;
+
+    /* OPT_NODE_STATS counters, also registered in the node_stats global by glide_client */
+    struct valkey_glide_node_stats* node_stats;
+
+    /* OPT_HEDGED_READS workers and counters, also registered in the hedges global */
+    struct valkey_glide_hedge* hedge;
+
+    /* read_from the cluster client was configured with, PRIMARY for standalone clients */
+    valkey_glide_read_from_t read_from;
+
+    /* advanced_config circuit breakers and retry budget, also registered in the breakers global */
+    struct valkey_glide_breaker* breaker;
+
+    /* Trained compression dictionaries of the compression dictionary_key, NULL if not set */
+    struct valkey_glide_dictionary* dictionary;
+
+    /* ValkeyGlideBloom attached by setBloomFilter(), holding a reference, NULL if none */
+    zend_object* bloom;
+
+    /* Counters of the last metricsSnapshot() by node, NULL until the first snapshot */
+    HashTable* metrics_samples;
+
+    struct valkey_glide_async_context* async_ctx; /* NULL unless async completions are enabled */
+    bool shared_client; /* glide_client is process-wide, owned by the shared client registry */
 
     zend_object std; /* MUST be last - PHP allocates extra memory after this */
 } valkey_glide_object;
@@ -278,6 +331,37 @@ ZEND_END_MODULE_GLOBALS(redis)
 ZEND_EXTERN_MODULE_GLOBALS(redis)
 #define REDIS_G(v) ZEND_MODULE_GLOBALS_ACCESSOR(redis, v)
 
+/* Per-thread state. Anything shared with glide-core threads lives in locked process-wide
+ * registries instead (pubsub callbacks, shared clients, logger and OTEL configuration). */
+ZEND_BEGIN_MODULE_GLOBALS(valkey_glide)
+HashTable   fiber_clients;  /* Fiber offload pools by glide client pointer */
+HashTable   slow_logs;      /* getSlowLog() entries by glide client pointer */
+HashTable   node_stats;     /* getNodeStats() counters by glide client pointer */
+HashTable   hedges;         /* OPT_HEDGED_READS workers by glide client pointer */
+HashTable   breakers;       /* Circuit breakers and retry budgets by glide client pointer */
+HashTable   breaker_nodes;  /* Circuit breaker state by node address, kept across requests */
+HashTable   blooms;         /* setBloomFilter() filters by glide client pointer */
+uint64_t    otel_rng_state; /* Span sampler state */
+HashTable   otel_spans;       /* startOtelSpan() spans by handle */
+zend_long   otel_next_span;   /* Last handle given out by startOtelSpan() */
+zend_long   otel_parent_span; /* setOtelParentSpan() handle, 0 if none */
+HashTable*  stream_aliases; /* registerStreamAlias() clients, created on first use */
+const void* read_from_client; /* Client under a withReadFrom() override, NULL if none */
+zend_long   read_from;        /* The overriding VALKEY_GLIDE_READ_FROM_* strategy */
+bool        read_from_once;   /* Cleared by the next command rather than at the end of a scope */
+const void* deadline_client;      /* Client under a withDeadline() callback, NULL if none */
+uint64_t    deadline_ns;          /* Its deadline, on the valkey_glide_slowlog_now() clock */
+const void* deadline_next_client; /* Client whose next call has a withDeadline() budget */
+uint64_t    deadline_next_ns;
+ZEND_END_MODULE_GLOBALS(valkey_glide)
+
+ZEND_EXTERN_MODULE_GLOBALS(valkey_glide)
+#define VALKEY_GLIDE_G(v) ZEND_MODULE_GLOBALS_ACCESSOR(valkey_glide, v)
+
+#if defined(ZTS) && defined(COMPILE_DL_VALKEY_GLIDE)
+ZEND_TSRMLS_CACHE_EXTERN()
+#endif
+
 #ifdef ZTS
 #include "TSRM.h"
 #endif
@@ -288,7 +372,15 @@ PHP_MINFO_FUNCTION(redis);
 
 zend_class_entry* get_valkey_glide_ce(void);
 zend_class_entry* get_valkey_glide_exception_ce(void);
+zend_class_entry* get_valkey_glide_timeout_exception_ce(void);
+zend_class_entry* get_valkey_glide_circuit_open_exception_ce(void);
 
 zend_class_entry* get_valkey_glide_cluster_ce(void);
 
+/*
+ * Throw and return true for a feature whose state is kept by glide client or changes the
+ * connection, which every user of a shared client would see.
+ */
+bool valkey_glide_refuse_shared(const valkey_glide_object* valkey_glide, const char* feature);
+
 #endif  // VALKEY_GLIDE
@@ -95,9 +95,21 @@ if test "$PHP_VALKEY_GLIDE" != "no"; then
       ])
       ;;
   esac
+
+  dnl Optional libzstd for compression with trained dictionaries (compression dictionary_key)
+  AC_CHECK_HEADER([zdict.h], [
+    AC_CHECK_LIB([zstd], [ZDICT_trainFromBuffer], [
+      PHP_ADD_LIBRARY(zstd, 1, VALKEY_GLIDE_SHARED_LIBADD)
+      AC_DEFINE([HAVE_VALKEY_GLIDE_ZSTD], [1], [Define if libzstd is available for dictionary compression])
+    ], [
+      AC_MSG_RESULT([libzstd not found - dictionary compression disabled])
+    ])
+  ], [
+    AC_MSG_RESULT([zdict.h not found - dictionary compression disabled])
+  ])
   
   PHP_NEW_EXTENSION(valkey_glide,
-    valkey_glide.c valkey_glide_cluster.c valkey_glide_pubsub_common.c valkey_glide_pubsub_introspection.c cluster_scan_cursor.c command_response.c logger.c valkey_glide_otel.c valkey_glide_commands.c valkey_glide_commands_2.c valkey_glide_commands_3.c valkey_glide_core_commands.c valkey_glide_core_common.c valkey_glide_expire_commands.c valkey_glide_geo_commands.c valkey_glide_geo_common.c valkey_glide_hash_common.c valkey_glide_list_common.c valkey_glide_s_common.c valkey_glide_str_commands.c valkey_glide_x_commands.c valkey_glide_x_common.c valkey_glide_z.c valkey_glide_z_common.c valkey_z_php_methods.c valkey_glide_script_commands.c valkey_glide_function_commands.c src/command_request.pb-c.c src/connection_request.pb-c.c src/response.pb-c.c src/client_constructor_mock.c,
+    valkey_glide.c valkey_glide_cluster.c valkey_glide_pubsub_common.c valkey_glide_pubsub_introspection.c cluster_scan_cursor.c command_response.c logger.c valkey_glide_otel.c valkey_glide_commands.c valkey_glide_commands_2.c valkey_glide_commands_3.c valkey_glide_core_commands.c valkey_glide_core_common.c valkey_glide_expire_commands.c valkey_glide_geo_commands.c valkey_glide_geo_common.c valkey_glide_hash_common.c valkey_glide_list_common.c valkey_glide_s_common.c valkey_glide_str_commands.c valkey_glide_x_commands.c valkey_glide_x_common.c valkey_glide_z.c valkey_glide_z_common.c valkey_z_php_methods.c valkey_glide_script_commands.c valkey_glide_function_commands.c valkey_glide_ingest.c valkey_glide_async.c valkey_glide_fiber.c valkey_glide_stream.c valkey_glide_slot.c valkey_glide_hot_keys.c valkey_glide_slowlog.c valkey_glide_bitmap.c valkey_glide_bulk.c valkey_glide_memory.c valkey_glide_rate_limiter.c valkey_glide_bloom.c valkey_glide_metrics.c valkey_glide_node_stats.c valkey_glide_deadline.c valkey_glide_hedge.c valkey_glide_breaker.c valkey_glide_dictionary.c src/command_request.pb-c.c src/connection_request.pb-c.c src/response.pb-c.c src/client_constructor_mock.c,
     $ext_shared,, $VALKEY_GLIDE_SHARED_LIBADD)
 
   dnl Add FFI library only for macOS (keep Mac working as before)
@@ -469,7 +481,7 @@ if test "$PHP_VALKEY_GLIDE" != "no"; then
       cp -r "$PECL_SOURCE_DIR/valkey-glide" "$BUILD_DIR/" 2>/dev/null || true
       
       dnl Copy arginfo.h files explicitly
-      for arginfo_file in cluster_scan_cursor_arginfo.h valkey_glide_arginfo.h valkey_glide_cluster_arginfo.h logger_arginfo.h; do
+      for arginfo_file in cluster_scan_cursor_arginfo.h valkey_glide_bitmap_arginfo.h valkey_glide_bloom_arginfo.h valkey_glide_rate_limiter_arginfo.h valkey_glide_arginfo.h valkey_glide_cluster_arginfo.h logger_arginfo.h; do
         if test -f "$PECL_SOURCE_DIR/$arginfo_file"; then
           AC_MSG_RESULT([Debug: copying $arginfo_file])
           cp "$PECL_SOURCE_DIR/$arginfo_file" "$BUILD_DIR/"
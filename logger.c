@@ -10,6 +10,12 @@
 
 #include "include/glide_bindings.h"
 
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <pthread.h>
+#endif
+
 /* ============================================================================
  * Internal State Management - Singleton Pattern like Node.js Logger
  * ============================================================================ */
@@ -19,9 +25,17 @@ static int  current_log_level  = VALKEY_LOG_LEVEL_DEFAULT;
 
 static enum Level current_ffi_log_level = WARN; /* FFI level tracking */
 
-
-/* Simple mutex simulation using static variable for initialization protection */
-static volatile bool initialization_in_progress = false;
+/* The glide-core logger is process-wide, so (re)initialization is serialized across threads.
+ * Statically initialized, as the logger is used before MINIT completes. */
+#ifdef _WIN32
+static SRWLOCK logger_lock = SRWLOCK_INIT;
+#define LOGGER_LOCK() AcquireSRWLockExclusive(&logger_lock)
+#define LOGGER_UNLOCK() ReleaseSRWLockExclusive(&logger_lock)
+#else
+static pthread_mutex_t logger_lock = PTHREAD_MUTEX_INITIALIZER;
+#define LOGGER_LOCK() pthread_mutex_lock(&logger_lock)
+#define LOGGER_UNLOCK() pthread_mutex_unlock(&logger_lock)
+#endif
 
 /* ============================================================================
  * Level Conversion Functions
@@ -126,16 +140,9 @@ int valkey_glide_logger_get_level(void) {
 
 /**
  * Internal function to actually initialize the logger via FFI.
- * This centralizes the FFI call and state management.
+ * This centralizes the FFI call and state management. Must be called with logger_lock held.
  */
 static int internal_init_logger(const char* level, const char* filename) {
-    /* Prevent concurrent initialization attempts */
-    if (initialization_in_progress) {
-        return -1;
-    }
-
-    initialization_in_progress = true;
-
     int        level_int = valkey_glide_logger_level_from_string(level);
     enum Level ffi_level = int_to_ffi_level(level_int);
 
@@ -143,7 +150,6 @@ static int internal_init_logger(const char* level, const char* filename) {
     struct LogResult* log_result = init(&ffi_level, filename);
 
     if (log_result == NULL) {
-        initialization_in_progress = false;
         fprintf(stderr, "Failed to initialize logger: NULL result\n");
         return -1; /* Failed to get result */
     }
@@ -153,7 +159,6 @@ static int internal_init_logger(const char* level, const char* filename) {
         /* Initialization failed */
         fprintf(stderr, "Failed to initialize logger: ERROR result, %s\n", log_result->log_error);
         free_log_result(log_result);
-        initialization_in_progress = false;
         return -1;
     }
 
@@ -165,8 +170,6 @@ static int internal_init_logger(const char* level, const char* filename) {
     /* Clean up the LogResult */
     free_log_result(log_result);
 
-    initialization_in_progress = false;
-
     return 0; /* Success */
 }
 
@@ -176,10 +179,16 @@ static int internal_init_logger(const char* level, const char* filename) {
  * initializes a new logger with default configuration if none exists.
  */
 static void ensure_logger_initialized(void) {
-    if (!logger_initialized && !initialization_in_progress) {
+    if (logger_initialized) {
+        return;
+    }
+
+    LOGGER_LOCK();
+    if (!logger_initialized) {
         /* Auto-initialize with default configuration like Node.js Logger */
         internal_init_logger(NULL, NULL);
     }
+    LOGGER_UNLOCK();
 }
 
 /* ============================================================================
@@ -192,11 +201,15 @@ int valkey_glide_logger_init(const char* level, const char* filename) {
      * Initialize only if it wasn't initialized before
      */
 
-    if (logger_initialized) {
-        return 0; /* Already initialized, return success */
+    int result = 0; /* Already initialized, return success */
+
+    LOGGER_LOCK();
+    if (!logger_initialized) {
+        result = internal_init_logger(level, filename);
     }
+    LOGGER_UNLOCK();
 
-    return internal_init_logger(level, filename);
+    return result;
 }
 
 int valkey_glide_logger_set_config(const char* level, const char* filename) {
@@ -205,10 +218,11 @@ int valkey_glide_logger_set_config(const char* level, const char* filename) {
      * Replace the existing configuration - always reinitialize
      */
 
-    /* Reset state to allow reinitialization */
-    logger_initialized = false;
+    LOGGER_LOCK();
+    int result = internal_init_logger(level, filename);
+    LOGGER_UNLOCK();
 
-    return internal_init_logger(level, filename);
+    return result;
 }
 
 void valkey_glide_logger_log(const char* level, const char* identifier, const char* message) {
@@ -18,6 +18,22 @@ const OPERATIONS_PER_CYCLE = 1000;
 const REPORT_INTERVAL_SECONDS = 120;  // Report every 2 minutes
 const MEMORY_CHECK_INTERVAL = 100;
 
+// Leak detection: memory is sampled into a sliding window and a series is flagged when its
+// least-squares slope stays above its limit with a good linear fit
+const MEMORY_SAMPLE_SECONDS = 10;
+const MEMORY_WINDOW_SAMPLES = 360;      // One hour of samples
+const LEAK_MIN_SAMPLES = 30;            // Five minutes before judging
+const LEAK_MIN_R2 = 0.8;                // How linear the growth must be
+const LEAK_SLOPE_LIMITS = [             // Growth per hour considered a leak
+    'php_heap' => 4 * 1024 * 1024,
+    'batch_bytes' => 64 * 1024,
+    'pubsub_bytes' => 64 * 1024,
+    'scan_bytes' => 64 * 1024,
+    'response_bytes' => 64 * 1024,
+    'pubsub_queue_depth' => 100,
+    'rust_scan_cursors' => 10,
+];
+
 // Command weights (probability distribution)
 const COMMAND_WEIGHTS = [
     'string_ops' => 40,    // 40% - SET, GET, INCR
@@ -39,6 +55,9 @@ class SoakTest
         'command_counts' => [],
         'error_types' => [],
     ];
+    private int $lastMemorySample = 0;
+    private array $memorySeries = [];   // Series name => [[elapsed seconds, value], ...]
+    private array $leakWarnings = [];   // Series name => slope per hour when flagged
 
     public function __construct(bool $isCluster = false, string $host = 'localhost', int $port = 6379)
     {
@@ -315,6 +334,96 @@ class SoakTest
         if ($memoryMB > 500) {
             error_log("WARNING: High memory usage: {$memoryMB} MB");
         }
+
+        $now = time();
+        if ($now - $this->lastMemorySample < MEMORY_SAMPLE_SECONDS) {
+            return;
+        }
+        $this->lastMemorySample = $now;
+        $this->sampleMemory($now - $this->startTime);
+    }
+
+    /**
+     * Record one sample of the PHP heap and of the extension's own accounting per subsystem,
+     * then check every series for sustained growth.
+     */
+    private function sampleMemory(int $elapsed): void
+    {
+        $values = ['php_heap' => memory_get_usage()];
+
+        if (method_exists($this->client, 'getMemoryStats')) {
+            $stats = $this->client->getMemoryStats();
+            foreach (['batch', 'pubsub', 'scan', 'response'] as $subsystem) {
+                $values["{$subsystem}_bytes"] = $stats[$subsystem]['live_bytes'];
+            }
+            $values['pubsub_queue_depth'] = $stats['pubsub']['queue_depth'];
+            $values['rust_scan_cursors'] = $stats['scan']['rust_cursors'];
+        }
+
+        foreach ($values as $name => $value) {
+            $this->memorySeries[$name][] = [$elapsed, $value];
+            if (count($this->memorySeries[$name]) > MEMORY_WINDOW_SAMPLES) {
+                array_shift($this->memorySeries[$name]);
+            }
+
+            [$slope, $r2] = self::linearTrend($this->memorySeries[$name]);
+            $perHour = $slope * 3600;
+            $leaking = count($this->memorySeries[$name]) >= LEAK_MIN_SAMPLES
+                && $perHour > LEAK_SLOPE_LIMITS[$name]
+                && $r2 >= LEAK_MIN_R2;
+
+            if ($leaking && !isset($this->leakWarnings[$name])) {
+                error_log(sprintf(
+                    "WARNING: Possible leak in %s: +%s per hour (r2 %.2f), now %s",
+                    $name,
+                    number_format($perHour),
+                    $r2,
+                    number_format($value)
+                ));
+            }
+            if ($leaking) {
+                $this->leakWarnings[$name] = $perHour;
+            } else {
+                unset($this->leakWarnings[$name]);
+            }
+        }
+    }
+
+    /**
+     * Least-squares fit of a series of [x, y] points.
+     *
+     * @return array [slope in units per second, coefficient of determination]
+     */
+    private static function linearTrend(array $points): array
+    {
+        $n = count($points);
+        if ($n < 2) {
+            return [0.0, 0.0];
+        }
+
+        $sumX = $sumY = 0.0;
+        foreach ($points as [$x, $y]) {
+            $sumX += $x;
+            $sumY += $y;
+        }
+        $meanX = $sumX / $n;
+        $meanY = $sumY / $n;
+
+        $sxx = $sxy = $syy = 0.0;
+        foreach ($points as [$x, $y]) {
+            $sxx += ($x - $meanX) ** 2;
+            $sxy += ($x - $meanX) * ($y - $meanY);
+            $syy += ($y - $meanY) ** 2;
+        }
+        if ($sxx == 0.0) {
+            return [0.0, 0.0];
+        }
+
+        $slope = $sxy / $sxx;
+        // A flat series fits perfectly but is no trend
+        $r2 = $syy == 0.0 ? 0.0 : ($sxy * $sxy) / ($sxx * $syy);
+
+        return [$slope, $r2];
     }
 
     /**
@@ -365,6 +474,16 @@ class SoakTest
         echo "Memory: " . number_format($memoryMB, 2) . " MB\n";
         echo "CPU: " . number_format($cpuPercent, 2) . "% (User: " . number_format($cpu['user'], 2) . "s, System: " . number_format($cpu['system'], 2) . "s)\n";
 
+        $window = MEMORY_WINDOW_SAMPLES * MEMORY_SAMPLE_SECONDS / 60;
+        echo "\nMemory Trends (per hour, last {$window} minutes):\n";
+        foreach ($this->memorySeries as $name => $points) {
+            [$slope, $r2] = self::linearTrend($points);
+            $latest = end($points)[1];
+            $flag = isset($this->leakWarnings[$name]) ? '  <-- POSSIBLE LEAK' : '';
+            echo "  {$name}: " . number_format($latest) . " (" . sprintf('%+.0f', $slope * 3600)
+                . "/h, r2 " . number_format($r2, 2) . "){$flag}\n";
+        }
+
         echo "\nCommand Distribution:\n";
         arsort($this->stats['command_counts']);
         foreach ($this->stats['command_counts'] as $cmd => $count) {
@@ -387,6 +506,13 @@ class SoakTest
             echo "  {$cmd}: " . number_format($count) . " (" . number_format($pct, 2) . "%)\n";
         }
 
+        if (!empty($this->leakWarnings)) {
+            echo "\nPossible Leaks:\n";
+            foreach ($this->leakWarnings as $name => $perHour) {
+                echo "  {$name}: +" . number_format($perHour) . " per hour\n";
+            }
+        }
+
         if (!empty($this->stats['error_types'])) {
             echo "\nError Types:\n";
             foreach ($this->stats['error_types'] as $type => $count) {
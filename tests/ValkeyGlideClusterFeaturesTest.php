@@ -1455,4 +1455,353 @@ class ValkeyGlideClusterFeaturesTest extends ValkeyGlideClusterBaseTest
             $this->valkey_glide->del($key);
         }
     }
+
+    public function testWithReadFrom()
+    {
+        $key = '{read_from}' . uniqid();
+        $other = '{read_from}' . uniqid();
+        $elsewhere = 'read_from_elsewhere_' . uniqid();
+
+        try {
+            $this->assertTrue($this->valkey_glide->set($key, 'value'));
+            $this->valkey_glide->set($other, 'other');
+            $this->valkey_glide->set($elsewhere, 'elsewhere');
+
+            /* The primary always has the write */
+            $this->assertEquals('value', $this->valkey_glide->withReadFrom(ValkeyGlide::READ_FROM_PRIMARY)->get($key));
+
+            /* Replicas catch up asynchronously */
+            $value = false;
+            for ($i = 0; $i < 50 && $value !== 'value'; $i++) {
+                $value = $this->valkey_glide->withReadFrom(ValkeyGlide::READ_FROM_PREFER_REPLICA)->get($key);
+                usleep(20000);
+            }
+            $this->assertEquals('value', $value);
+
+            $result = $this->valkey_glide->withReadFrom(
+                ValkeyGlide::READ_FROM_PREFER_REPLICA,
+                function ($client) use ($key, $other, $elsewhere) {
+                    /* Same slot reads are redirected, cross slot ones keep the default routing */
+                    $client->mget([$key, $other]);
+                    $this->assertTrue($client->set($key, 'written'));
+                    return $client->mget([$key, $elsewhere]);
+                }
+            );
+            $this->assertEquals(['written', 'elsewhere'], $result);
+        } finally {
+            $this->valkey_glide->del($key, $other, $elsewhere);
+        }
+
+        $this->assertThrowsMatch(null, function () {
+            $this->valkey_glide->withReadFrom(42);
+        }, '/Invalid read_from/');
+        foreach ([ValkeyGlide::READ_FROM_AZ_AFFINITY, ValkeyGlide::READ_FROM_AZ_AFFINITY_REPLICAS_AND_PRIMARY] as $az) {
+            $this->assertThrowsMatch($az, function ($read_from) {
+                $this->valkey_glide->withReadFrom($read_from);
+            }, '/READ_FROM_PREFER_REPLICA only/');
+        }
+    }
+
+    public function testMetricsSnapshotRoutes()
+    {
+        $nodes = $this->valkey_glide->metricsSnapshot(['used_memory']);
+        $this->assertGT(0, count($nodes));
+        foreach ($nodes as $node) {
+            $this->assertTrue(is_int($node['used_memory']));
+            $this->assertArrayKey($node, 'rates');
+        }
+
+        /* A single node is keyed by the address it was routed to */
+        list($host, $port) = explode(':', array_key_first($nodes));
+        $route = ['type' => 'routeByAddress', 'host' => $host, 'port' => (int) $port];
+        $this->valkey_glide->metricsSnapshot(['used_memory'], $route);
+        usleep(10000);
+        $rates = $this->valkey_glide->metricsSnapshot(['used_memory'], $route)['rates'];
+        $this->assertGT(0, $rates['interval']);
+
+        foreach (['randomNode', 'some_key', ['type' => 'primarySlotKey', 'key' => 'some_key']] as $route) {
+            $this->assertThrowsMatch($route, function ($route) {
+                $this->valkey_glide->metricsSnapshot([], $route);
+            }, '/routeByAddress/');
+        }
+    }
+
+    public function testHotKeysPerSlot()
+    {
+        $key = '{hot_slot}' . uniqid();
+
+        try {
+            $this->assertTrue($this->valkey_glide->setOption(ValkeyGlideCluster::OPT_HOT_KEY_SAMPLING, 1));
+            for ($i = 0; $i < 10; $i++) {
+                $this->valkey_glide->incr($key);
+            }
+
+            $report = $this->valkey_glide->getHotKeys(1);
+            $this->assertEquals($key, $report['keys'][0]['key']);
+            $this->assertEquals(10, $report['keys'][0]['count']);
+
+            /* The slot of "{hot_slot}..." is the slot of "hot_slot" */
+            $this->assertEquals([3011], array_keys($report['slots']));
+            $this->assertEquals(10, $report['slots'][3011]['count']);
+        } finally {
+            $this->valkey_glide->setOption(ValkeyGlideCluster::OPT_HOT_KEY_SAMPLING, 0);
+            $this->valkey_glide->del($key);
+        }
+    }
+
+    public function testKeySlotAndGroupKeysBySlot()
+    {
+        $this->assertEquals(12182, $this->valkey_glide->keySlot('foo'));
+        $this->assertEquals(10778, $this->valkey_glide->keySlot('{user:1}:cart'));
+        $this->assertEquals(12182, $this->valkey_glide->keySlot('foo{}'));
+
+        $keys = ['foo', '{user:1}:cart', 'bar', '{user:1}:orders'];
+        $this->assertEquals(
+            [12182 => ['foo'], 10778 => ['{user:1}:cart', '{user:1}:orders'], 5061 => ['bar']],
+            $this->valkey_glide->groupKeysBySlot($keys)
+        );
+
+        $byNode = $this->valkey_glide->groupKeysBySlot($keys, true);
+        $placed = [];
+        foreach ($byNode as $node => $slots) {
+            $this->assertTrue(strpos($node, ':') !== false);
+            foreach ($slots as $slot => $group) {
+                foreach ($group as $key) {
+                    $this->assertEquals($slot, $this->valkey_glide->keySlot($key));
+                    $placed[] = $key;
+                }
+            }
+        }
+        sort($placed);
+        sort($keys);
+        $this->assertEquals($keys, $placed);
+
+        $this->assertThrowsMatch(null, function () {
+            $this->valkey_glide->groupKeysBySlot(['foo', 42]);
+        }, '/only strings/');
+    }
+
+    public function testNodeStatsPerPrimary()
+    {
+        try {
+            $this->assertTrue(
+                $this->valkey_glide->setOption(ValkeyGlideCluster::OPT_NODE_STATS, true)
+            );
+
+            for ($i = 0; $i < 30; $i++) {
+                $this->valkey_glide->set("node_stats:$i", $i);
+            }
+            $this->valkey_glide->ping('allPrimaries');
+            /* Reads sent to replicas are counted apart from the primaries' own */
+            for ($i = 0; $i < 5; $i++) {
+                $this->valkey_glide->withReadFrom(ValkeyGlide::READ_FROM_PREFER_REPLICA)
+                    ->get("node_stats:$i");
+            }
+
+            $stats = $this->valkey_glide->getNodeStats();
+            $requests = 0;
+            $replica_reads = 0;
+            $slots = 0;
+            foreach ($stats as $node => $entry) {
+                if ($node === '') {
+                    $this->assertGT(0, $entry['requests']);
+                    continue;
+                }
+                $this->assertEquals('primary', $entry['role']);
+                $requests += $entry['requests'];
+                $replica_reads += $entry['replicas']['requests'];
+                $slots += $entry['slots'];
+            }
+            $this->assertEquals(30, $requests);
+            $this->assertEquals(5, $replica_reads);
+            $this->assertEquals(16384, $slots);
+        } finally {
+            $this->valkey_glide->setOption(ValkeyGlideCluster::OPT_NODE_STATS, false);
+            for ($i = 0; $i < 30; $i++) {
+                $this->valkey_glide->del("node_stats:$i");
+            }
+        }
+    }
+
+    public function testWithDeadline()
+    {
+        $this->assertTrue($this->valkey_glide->withDeadline(1000)->set('deadline:key', 'v'));
+        $this->assertEquals('v', $this->valkey_glide->withDeadline(1000)->get('deadline:key'));
+
+        $values = $this->valkey_glide->withDeadline(1000, function ($client) {
+            return [$client->get('deadline:key'), $client->get('deadline:missing')];
+        });
+        $this->assertEquals(['v', false], $values);
+
+        $this->assertThrowsMatch(null, function () {
+            $this->valkey_glide->withDeadline(1, function ($client) {
+                usleep(5000);
+                return $client->get('deadline:key');
+            });
+        }, '/Deadline exceeded/');
+
+        $this->valkey_glide->del('deadline:key');
+    }
+
+    public function testHedgedReads()
+    {
+        // The test client reads from primaries only
+        $this->assertFalse(
+            $this->valkey_glide->setOption(ValkeyGlideCluster::OPT_HEDGED_READS, true)
+        );
+
+        $client = new ValkeyGlideCluster(
+            addresses: [['host' => '127.0.0.1', 'port' => 7001]],
+            use_tls: false,
+            credentials: $this->getAuth(),
+            read_from: ValkeyGlide::READ_FROM_PREFER_REPLICA
+        );
+        $this->assertFalse($client->getHedgeStats());
+        $this->assertFalse(
+            $client->setOption(ValkeyGlideCluster::OPT_HEDGED_READS, -1)
+        );
+
+        try {
+            $this->assertTrue($client->setOption(
+                ValkeyGlideCluster::OPT_HEDGED_READS,
+                ['delay' => 1, 'max_rate' => 1.0]
+            ));
+            $this->assertEquals(
+                ['delay' => 1, 'max_rate' => 1.0],
+                $client->getOption(ValkeyGlideCluster::OPT_HEDGED_READS)
+            );
+
+            $client->set('hedge:key', 'value');
+            for ($i = 0; $i < 50; $i++) {
+                $this->assertEquals('value', $client->get('hedge:key'));
+            }
+
+            $stats = $client->getHedgeStats();
+            $this->assertGT(49, $stats['reads']);
+            $this->assertTrue($stats['hedged'] <= $stats['reads']);
+            $this->assertTrue($stats['wins'] <= $stats['hedged']);
+            $this->assertEquals(1.0, $stats['delay_ms']);
+
+            // Learned from the primary latencies
+            $this->assertTrue(
+                $client->setOption(ValkeyGlideCluster::OPT_HEDGED_READS, true)
+            );
+            $option = $client->getOption(ValkeyGlideCluster::OPT_HEDGED_READS);
+            $this->assertEquals(0, $option['delay']);
+
+            // Until the delay is learned, reads are sent from the calling thread unhedged
+            $client->setOption(ValkeyGlideCluster::OPT_HEDGED_READS, false);
+            $client->setOption(ValkeyGlideCluster::OPT_HEDGED_READS, true);
+            for ($i = 0; $i < 10; $i++) {
+                $this->assertEquals('value', $client->get('hedge:key'));
+            }
+            $stats = $client->getHedgeStats();
+            $this->assertEquals(10, $stats['reads']);
+            $this->assertEquals(0, $stats['hedged']);
+            $this->assertEquals(null, $stats['delay_ms']);
+        } finally {
+            $client->setOption(ValkeyGlideCluster::OPT_HEDGED_READS, false);
+            $client->del('hedge:key');
+        }
+
+        $this->assertFalse($client->getOption(ValkeyGlideCluster::OPT_HEDGED_READS));
+        $this->assertFalse($client->getHedgeStats());
+        $client->close();
+    }
+
+    public function testCircuitBreaker()
+    {
+        $this->assertFalse($this->valkey_glide->getBreakerStats());
+
+        $this->assertThrowsMatch(null, function () {
+            new ValkeyGlideCluster(
+                addresses: [['host' => '127.0.0.1', 'port' => 7001]],
+                credentials: $this->getAuth(),
+                advanced_config: ['retry_budget' => ['ratio' => 2]]
+            );
+        }, '/retry_budget must be/');
+
+        $client = new ValkeyGlideCluster(
+            addresses: [['host' => '127.0.0.1', 'port' => 7001]],
+            credentials: $this->getAuth(),
+            request_timeout: 50,
+            advanced_config: ['circuit_breaker' => ['failures' => 1, 'open_ms' => 300]]
+        );
+
+        try {
+            // The slot lookup made before the first keyed call is neither counted nor logged
+            $this->assertTrue($client->setOption(ValkeyGlideCluster::OPT_NODE_STATS, true));
+            $this->assertTrue($client->setOption(ValkeyGlideCluster::OPT_SLOWLOG_THRESHOLD, 0));
+            $this->assertTrue($client->set('{breaker}key', 'v'));
+            $stats = $client->getNodeStats();
+            $this->assertEquals(1, array_sum(array_column($stats, 'requests')));
+            $this->assertFalse(isset($stats['']));
+            $this->assertEquals(1, count($client->getSlowLog()));
+            $client->setOption(ValkeyGlideCluster::OPT_NODE_STATS, false);
+            $client->setOption(ValkeyGlideCluster::OPT_SLOWLOG_THRESHOLD, -1);
+
+            // Only the primary serving the slot that timed out is cut off
+            $route = ['type' => 'primarySlotKey', 'key' => '{breaker}key'];
+            $this->assertFalse($client->rawcommand($route, 'DEBUG', 'SLEEP', '0.2'));
+            $this->assertThrowsMatch(null, function () use ($client) {
+                $client->get('{breaker}key');
+            }, '/Circuit breaker open for/');
+
+            $open = array_filter($client->getBreakerStats()['nodes'], function ($node) {
+                return $node['state'] === 'open';
+            });
+            $this->assertEquals(1, count($open));
+            $this->assertEquals(1, reset($open)['rejected']);
+
+            usleep(400000);
+            $this->assertEquals('v', $client->get('{breaker}key'));
+            foreach ($client->getBreakerStats()['nodes'] as $node) {
+                $this->assertEquals('closed', $node['state']);
+            }
+
+            $client->del('{breaker}key');
+        } finally {
+            $client->close();
+        }
+    }
+
+    public function testCompressionDictionary()
+    {
+        $this->assertThrowsMatch($this->valkey_glide, function ($r) {
+            $r->trainCompressionDictionary(['sample']);
+        }, '/Dictionary compression is off/');
+
+        try {
+            $client = new ValkeyGlideCluster(
+                addresses: [['host' => '127.0.0.1', 'port' => 7001]],
+                credentials: $this->getAuth(),
+                compression: ['enabled' => true, 'dictionary_key' => '{dictionary}dicts']
+            );
+        } catch (ValkeyGlideException $e) {
+            if (strpos($e->getMessage(), 'libzstd') === false) {
+                throw $e;
+            }
+            $this->markTestSkipped('Built without libzstd');
+        }
+
+        $document = function ($i) {
+            return json_encode(['id' => $i, 'name' => "user-$i", 'tags' => ['cluster', 'dictionary']]);
+        };
+
+        try {
+            $client->trainCompressionDictionary(array_map($document, range(1, 1000)), 2048);
+
+            // Values on every shard are compressed with the same dictionary
+            $pairs = ['{a}doc' => $document(5000), '{b}doc' => $document(5001), '{c}doc' => $document(5002)];
+            $this->assertTrue($client->mset($pairs));
+            foreach ($pairs as $key => $value) {
+                $this->assertLT(strlen($value), $client->strlen($key));
+            }
+            $this->assertEquals(array_values($pairs), $client->mget(array_keys($pairs)));
+
+            $client->del('{dictionary}dicts', ...array_keys($pairs));
+        } finally {
+            $client->close();
+        }
+    }
 }
@@ -1291,6 +1291,55 @@ class ValkeyGlideFeaturesTest extends ValkeyGlideBaseTest
         }
     }
 
+    public function testOtelParentSpanAndBatchSpan()
+    {
+        $tracesFile = sys_get_temp_dir() . '/valkey_glide_traces_test.json';
+        $otelConfig = OpenTelemetryConfig::builder()
+            ->traces(
+                TracesConfig::builder()
+                    ->endpoint('file://' . $tracesFile)
+                    ->samplePercentage(100)
+                    ->build()
+            )
+            ->flushIntervalMs(100)
+            ->build();
+
+        $client = new ValkeyGlide();
+        $client->connect(
+            addresses: [
+                ['host' => 'localhost', 'port' => 6379]
+            ],
+            use_tls: false,
+            advanced_config: [
+                'otel' => $otelConfig
+            ]
+        );
+        ValkeyGlide::setOtelSamplePercentage(100);
+
+        $checkout = ValkeyGlide::startOtelSpan('checkout');
+        $cart = ValkeyGlide::startOtelSpan('load-cart');
+        $this->assertIsInt($checkout);
+        $this->assertIsInt($cart);
+        $this->assertFalse($checkout === $cart);
+
+        $this->assertTrue(ValkeyGlide::setOtelParentSpan($cart));
+        $client->set('otel:parent', 'value');
+        $this->assertTrue(ValkeyGlide::endOtelSpan($cart));
+
+        // Ending the parent span leaves command spans without parent
+        $this->assertTrue(ValkeyGlide::setOtelParentSpan($checkout));
+        $result = $client->multi(ValkeyGlide::PIPELINE)->get('otel:parent')->del('otel:parent')->exec();
+        $this->assertEquals(['value', 1], $result);
+        $this->assertTrue(ValkeyGlide::setOtelParentSpan(null));
+        $this->assertTrue(ValkeyGlide::endOtelSpan($checkout));
+
+        // Only open spans can be ended or used as parents
+        $this->assertFalse(ValkeyGlide::endOtelSpan($checkout));
+        $this->assertFalse(ValkeyGlide::setOtelParentSpan($cart));
+
+        $client->close();
+    }
+
     public function testCompressionBasicZSTD()
     {
         // Test basic compression with ZSTD backend
@@ -2050,4 +2099,1456 @@ class ValkeyGlideFeaturesTest extends ValkeyGlideBaseTest
             $this->valkey_glide->del($key);
         }
     }
+
+    // ===================================================================
+    // BULK INGEST TESTS
+    // ===================================================================
+
+    public function testIngestFileResp()
+    {
+        $prefix = 'ingest_resp_' . uniqid() . '_';
+        $file = tempnam(sys_get_temp_dir(), 'valkey_glide_ingest');
+        $data = '';
+        for ($i = 0; $i < 25; $i++) {
+            $key = $prefix . $i;
+            $value = "value\r\n$i";
+            $data .= "*3\r\n\$3\r\nSET\r\n\$" . strlen($key) . "\r\n$key\r\n\$" . strlen($value) . "\r\n$value\r\n";
+        }
+        file_put_contents($file, $data);
+
+        try {
+            $stats = $this->valkey_glide->ingestFile($file, 'resp', 10);
+            $this->assertIsArray($stats);
+            $this->assertEquals(25, $stats['commands']);
+            $this->assertEquals(0, $stats['errors']);
+            $this->assertEquals(3, $stats['batches']);
+            $this->assertEquals(strlen($data), $stats['offset']);
+            $this->assertTrue($stats['complete']);
+            $this->assertNull($stats['error']);
+            $this->assertEquals("value\r\n7", $this->valkey_glide->get($prefix . '7'));
+        } finally {
+            unlink($file);
+            for ($i = 0; $i < 25; $i++) {
+                $this->valkey_glide->del($prefix . $i);
+            }
+        }
+    }
+
+    public function testIngestFileCsvWithTtl()
+    {
+        $prefix = 'ingest_csv_' . uniqid() . '_';
+        $file = tempnam(sys_get_temp_dir(), 'valkey_glide_ingest');
+        file_put_contents($file, "# key,value,ttl\n{$prefix}a,1\r\n{$prefix}b,2,100\n\n{$prefix}c,3\n");
+
+        try {
+            $stats = $this->valkey_glide->ingestFile($file, 'csv');
+            $this->assertEquals(3, $stats['commands']);
+            $this->assertTrue($stats['complete']);
+            $this->assertEquals('1', $this->valkey_glide->get($prefix . 'a'));
+            $this->assertEquals('3', $this->valkey_glide->get($prefix . 'c'));
+            $this->assertEquals(-1, $this->valkey_glide->ttl($prefix . 'a'));
+            $this->assertBetween($this->valkey_glide->ttl($prefix . 'b'), 1, 100);
+        } finally {
+            unlink($file);
+            $this->valkey_glide->del($prefix . 'a', $prefix . 'b', $prefix . 'c');
+        }
+    }
+
+    public function testIngestFileResumesAfterTruncatedInput()
+    {
+        $key1 = 'ingest_resume_1_' . uniqid();
+        $key2 = 'ingest_resume_2_' . uniqid();
+        $file = tempnam(sys_get_temp_dir(), 'valkey_glide_ingest');
+        $first = "*3\r\n\$3\r\nSET\r\n\$" . strlen($key1) . "\r\n$key1\r\n\$1\r\na\r\n";
+        $second = "*3\r\n\$3\r\nSET\r\n\$" . strlen($key2) . "\r\n$key2\r\n\$1\r\nb\r\n";
+        file_put_contents($file, $first . substr($second, 0, 10));
+
+        try {
+            $stats = $this->valkey_glide->ingestFile($file, 'resp');
+            $this->assertEquals(1, $stats['commands']);
+            $this->assertFalse($stats['complete']);
+            $this->assertEquals(strlen($first), $stats['offset']);
+
+            file_put_contents($file, $first . $second);
+            $stats = $this->valkey_glide->ingestFile($file, 'resp', 1000, $stats['offset']);
+            $this->assertEquals(1, $stats['commands']);
+            $this->assertTrue($stats['complete']);
+            $this->assertEquals('b', $this->valkey_glide->get($key2));
+        } finally {
+            unlink($file);
+            $this->valkey_glide->del($key1, $key2);
+        }
+    }
+
+    public function testIngestFileCsvReportsTruncatedFinalRecord()
+    {
+        $prefix = 'ingest_csv_trunc_' . uniqid() . '_';
+        $file = tempnam(sys_get_temp_dir(), 'valkey_glide_ingest');
+        $first = "{$prefix}a,1\n";
+        file_put_contents($file, $first . "{$prefix}b,2");
+
+        try {
+            $stats = $this->valkey_glide->ingestFile($file, 'csv');
+            $this->assertEquals(1, $stats['commands']);
+            $this->assertFalse($stats['complete']);
+            $this->assertEquals(strlen($first), $stats['offset']);
+            $this->assertStringContains('Truncated', $stats['error']);
+            $this->assertEquals(0, $this->valkey_glide->exists($prefix . 'b'));
+        } finally {
+            unlink($file);
+            $this->valkey_glide->del($prefix . 'a', $prefix . 'b');
+        }
+    }
+
+    public function testIngestFileInvalidArguments()
+    {
+        $file = tempnam(sys_get_temp_dir(), 'valkey_glide_ingest');
+
+        try {
+            $this->assertThrowsMatch($file, function ($f) {
+                $this->valkey_glide->ingestFile($f, 'xml');
+            }, '/format/');
+            $this->assertThrowsMatch($file, function ($f) {
+                $this->valkey_glide->ingestFile($f, 'resp', 0);
+            }, '/window/');
+            $this->assertThrowsMatch($file, function ($f) {
+                $this->valkey_glide->ingestFile($f, 'resp', 1000, 1);
+            }, '/offset/');
+        } finally {
+            unlink($file);
+        }
+    }
+
+    // ===================================================================
+    // ASYNCHRONOUS COMPLETION TESTS
+    // ===================================================================
+
+    private function createAsyncClient()
+    {
+        $client = new ValkeyGlide();
+        $advanced_config = ['async_completions' => true];
+        if ($this->getTLS()) {
+            $advanced_config['tls_config'] = ['use_insecure_tls' => true];
+        }
+        $client->connect(
+            addresses: [['host' => $this->getHost(), 'port' => $this->getPort()]],
+            use_tls: $this->getTLS(),
+            advanced_config: $advanced_config
+        );
+
+        return $client;
+    }
+
+    private function waitForReplies($client, int $count): array
+    {
+        $fd = $client->getCompletionFd();
+        $replies = [];
+        $deadline = microtime(true) + 5;
+
+        while (count($replies) < $count && microtime(true) < $deadline) {
+            $read = [$fd];
+            $write = $except = null;
+            if (stream_select($read, $write, $except, 0, 100000) > 0) {
+                $replies += $client->poll();
+            }
+        }
+        fclose($fd);
+
+        return $replies;
+    }
+
+    public function testSubmitAndPoll()
+    {
+        $client = $this->createAsyncClient();
+        $key = 'async_submit_' . uniqid();
+
+        try {
+            $set_id = $client->submit('SET', $key, 'value');
+            $get_id = $client->submit('GET', $key);
+            $this->assertGT($set_id, $get_id);
+
+            $replies = $this->waitForReplies($client, 2);
+            $this->assertEquals(2, count($replies));
+            $this->assertTrue($replies[$set_id]);
+            $this->assertEquals('value', $replies[$get_id]);
+            $this->assertEquals([], $client->poll());
+        } finally {
+            $client->del($key);
+            $client->close();
+        }
+    }
+
+    public function testSubmitErrorReply()
+    {
+        $client = $this->createAsyncClient();
+        $key = 'async_error_' . uniqid();
+
+        try {
+            $client->set($key, 'not_a_list');
+            $id = $client->submit('LPUSH', $key, 'x');
+
+            $replies = $this->waitForReplies($client, 1);
+            $this->assertIsObject($replies[$id], ValkeyGlideException::class);
+        } finally {
+            $client->del($key);
+            $client->close();
+        }
+    }
+
+    public function testSubmitRequiresAsyncCompletions()
+    {
+        $this->assertThrowsMatch($this->valkey_glide, function ($client) {
+            $client->submit('PING');
+        }, '/async_completions/');
+        $this->assertThrowsMatch($this->valkey_glide, function ($client) {
+            $client->poll();
+        }, '/async_completions/');
+    }
+
+    // ===================================================================
+    // FIBER-AWARE EXECUTION TESTS
+    // ===================================================================
+
+    public function testFiberAwareCommands()
+    {
+        $client = new ValkeyGlide();
+        $advanced_config = ['fiber_aware' => 2];
+        if ($this->getTLS()) {
+            $advanced_config['tls_config'] = ['use_insecure_tls' => true];
+        }
+        $client->connect(
+            addresses: [['host' => $this->getHost(), 'port' => $this->getPort()]],
+            use_tls: $this->getTLS(),
+            advanced_config: $advanced_config
+        );
+        $prefix = 'fiber_' . uniqid();
+
+        try {
+            $fibers = [];
+            foreach (['a', 'b'] as $name) {
+                $fibers[$name] = new Fiber(function () use ($client, $prefix, $name) {
+                    $client->set("$prefix:$name", $name);
+                    return $client->get("$prefix:$name");
+                });
+                /* The first command suspends the Fiber instead of blocking */
+                $this->assertNull($fibers[$name]->start());
+                $this->assertTrue($fibers[$name]->isSuspended());
+            }
+
+            $fd = $client->getCompletionFd();
+            $deadline = microtime(true) + 5;
+            while ((!$fibers['a']->isTerminated() || !$fibers['b']->isTerminated()) &&
+                   microtime(true) < $deadline) {
+                $read = [$fd];
+                $write = $except = null;
+                if (stream_select($read, $write, $except, 0, 100000) > 0) {
+                    $this->assertEquals([], $client->poll());
+                }
+            }
+            fclose($fd);
+
+            $this->assertEquals('a', $fibers['a']->getReturn());
+            $this->assertEquals('b', $fibers['b']->getReturn());
+
+            /* Outside of a Fiber commands still run synchronously */
+            $this->assertEquals('a', $client->get("$prefix:a"));
+        } finally {
+            $client->del("$prefix:a", "$prefix:b");
+            $client->close();
+        }
+    }
+
+    public function testPollKeepsRepliesWhenFiberThrows()
+    {
+        $client = new ValkeyGlide();
+        $advanced_config = ['fiber_aware' => 2, 'async_completions' => true];
+        if ($this->getTLS()) {
+            $advanced_config['tls_config'] = ['use_insecure_tls' => true];
+        }
+        $client->connect(
+            addresses: [['host' => $this->getHost(), 'port' => $this->getPort()]],
+            use_tls: $this->getTLS(),
+            advanced_config: $advanced_config
+        );
+        $key = 'fiber_throw_' . uniqid();
+
+        try {
+            $fiber = new Fiber(function () use ($client, $key) {
+                $client->set($key, 'value');
+                throw new RuntimeException('fiber failed');
+            });
+            $fiber->start();
+            $id = $client->submit('GET', $key);
+
+            /* Whichever poll() the Fiber throws from, the GET reply must not be lost */
+            $fd = $client->getCompletionFd();
+            $thrown = 0;
+            $replies = [];
+            $deadline = microtime(true) + 5;
+            while ((!$fiber->isTerminated() || !isset($replies[$id])) && microtime(true) < $deadline) {
+                $read = [$fd];
+                $write = $except = null;
+                if (stream_select($read, $write, $except, 0, 100000) > 0) {
+                    try {
+                        $replies += $client->poll();
+                    } catch (RuntimeException $e) {
+                        $this->assertEquals('fiber failed', $e->getMessage());
+                        $thrown++;
+                    }
+                }
+            }
+            fclose($fd);
+
+            $this->assertEquals(1, $thrown);
+            $this->assertTrue(array_key_exists($id, $replies));
+        } finally {
+            $client->del($key);
+            $client->close();
+        }
+    }
+
+    public function testFiberSuspendCallable()
+    {
+        $connect = function (array $advanced_config) {
+            $client = new ValkeyGlide();
+            if ($this->getTLS()) {
+                $advanced_config['tls_config'] = ['use_insecure_tls' => true];
+            }
+            $client->connect(
+                addresses: [['host' => $this->getHost(), 'port' => $this->getPort()]],
+                use_tls: $this->getTLS(),
+                advanced_config: $advanced_config
+            );
+            return $client;
+        };
+
+        $this->assertThrowsMatch(null, function () use ($connect) {
+            $connect(['fiber_aware' => true, 'fiber_suspend' => 'not a function']);
+        }, '/fiber_suspend/');
+
+        $waits = 0;
+        $client = $connect(['fiber_aware' => 2, 'fiber_suspend' => function ($stream) use (&$waits) {
+            /* Stands in for an event loop waiting on the stream */
+            $waits++;
+            $read = [$stream];
+            $write = $except = null;
+            stream_select($read, $write, $except, 5);
+        }]);
+        $key = 'fiber_suspend_' . uniqid();
+
+        try {
+            $fiber = new Fiber(function () use ($client, $key) {
+                $client->set($key, 'value');
+                return $client->get($key);
+            });
+            $fiber->start();
+
+            $this->assertTrue($fiber->isTerminated());
+            $this->assertEquals('value', $fiber->getReturn());
+            /* Replies can beat the first check, the callable isn't always needed */
+            $this->assertLTE(2, $waits);
+        } finally {
+            $client->del($key);
+            $client->close();
+        }
+    }
+
+    // ===================================================================
+    // SHARED CLIENT TESTS
+    // ===================================================================
+
+    private function createSharedClient(array $advanced_config = [])
+    {
+        $client = new ValkeyGlide();
+        $advanced_config['shared_client'] = true;
+        if ($this->getTLS()) {
+            $advanced_config['tls_config'] = ['use_insecure_tls' => true];
+        }
+        $client->connect(
+            addresses: [['host' => $this->getHost(), 'port' => $this->getPort()]],
+            use_tls: $this->getTLS(),
+            advanced_config: $advanced_config
+        );
+
+        return $client;
+    }
+
+    public function testSharedClient()
+    {
+        $first = $this->createSharedClient();
+        $second = $this->createSharedClient();
+        $key = 'shared_client_' . uniqid();
+
+        try {
+            $this->assertTrue($first->set($key, 'value'));
+            $this->assertEquals('value', $second->get($key));
+
+            /* Closing one user keeps the shared connection usable for the others */
+            $first->close();
+            unset($first);
+            $this->assertEquals('value', $second->get($key));
+        } finally {
+            $second->del($key);
+            $second->close();
+        }
+    }
+
+    public function testSharedClientRestrictions()
+    {
+        $this->assertThrowsMatch(null, function () {
+            $this->createSharedClient(['fiber_aware' => true]);
+        }, '/fiber_aware cannot be combined with shared_client/');
+        $this->assertThrowsMatch(null, function () {
+            $this->createSharedClient(['circuit_breaker' => true]);
+        }, '/circuit_breaker cannot be combined with shared_client/');
+
+        $client = $this->createSharedClient();
+        $this->assertThrowsMatch($client, function ($client) {
+            $client->subscribe(['shared_client_channel'], function () {});
+        }, '/not supported on shared clients/');
+        /* State kept by client handle or connection would leak to the other users */
+        $this->assertThrowsMatch($client, function ($client) {
+            $client->select(1);
+        }, '/select\(\) is not supported on shared clients/');
+        $this->assertThrowsMatch($client, function ($client) {
+            $client->withDeadline(100);
+        }, '/not supported on shared clients/');
+        $this->assertThrowsMatch($client, function ($client) {
+            $client->setOption(ValkeyGlide::OPT_SLOWLOG_THRESHOLD, 0);
+        }, '/not supported on shared clients/');
+        $this->assertThrowsMatch($client, function ($client) {
+            $client->setOption(ValkeyGlide::OPT_NODE_STATS, true);
+        }, '/not supported on shared clients/');
+        $this->assertThrowsMatch($client, function ($client) {
+            $client->setBloomFilter(new ValkeyGlideBloom(100));
+        }, '/setBloomFilter\(\) is not supported on shared clients/');
+        $client->close();
+    }
+
+    // ===================================================================
+    // STRING REPLY TESTS
+    // ===================================================================
+
+    public function testStringReplySizes()
+    {
+        $key = 'string_reply_' . uniqid();
+        $list = 'string_reply_list_' . uniqid();
+
+        try {
+            /* Empty and single byte replies are returned as interned strings */
+            foreach (['', 'x', "\0", 'ab', str_repeat("\xff\0", 100000), str_repeat('v', 5242880)] as $value) {
+                $this->assertTrue($this->valkey_glide->set($key, $value));
+                $this->assertEquals($value, $this->valkey_glide->get($key));
+                $this->assertEquals($value, $this->valkey_glide->getset($key, $value));
+            }
+
+            $this->valkey_glide->rpush($list, '', 'a', "binary\0value");
+            $this->assertEquals('', $this->valkey_glide->lindex($list, 0));
+            $this->assertEquals('a', $this->valkey_glide->lindex($list, 1));
+            $this->assertEquals("binary\0value", $this->valkey_glide->lindex($list, 2));
+
+            $results = $this->valkey_glide->multi()->get($key)->lindex($list, 1)->exec();
+            $this->assertEquals([str_repeat('v', 5242880), 'a'], $results);
+        } finally {
+            $this->valkey_glide->del($key, $list);
+        }
+    }
+
+    public function testLargeAggregateReplies()
+    {
+        $list = 'aggregate_list_' . uniqid();
+        $hash = 'aggregate_hash_' . uniqid();
+        $set = 'aggregate_set_' . uniqid();
+
+        try {
+            $values = array_map('strval', range(0, 99999));
+            foreach (array_chunk($values, 10000) as $chunk) {
+                $this->valkey_glide->rpush($list, ...$chunk);
+                $this->valkey_glide->sadd($set, ...$chunk);
+            }
+            $this->assertEquals($values, $this->valkey_glide->lrange($list, 0, -1));
+
+            $members = $this->valkey_glide->smembers($set);
+            sort($members, SORT_NUMERIC);
+            $this->assertEquals($values, $members);
+
+            /* Numeric and binary field names keep PHP's array key semantics */
+            $fields = ['field' => 'a', '42' => 'b', "bin\0ary" => 'c', '' => 'd'];
+            $this->valkey_glide->hmset($hash, $fields);
+            $all = $this->valkey_glide->hgetall($hash);
+            ksort($all);
+            ksort($fields);
+            $this->assertEquals($fields, $all);
+            $this->assertEquals('b', $all[42]);
+        } finally {
+            $this->valkey_glide->del($list, $hash, $set);
+        }
+    }
+
+    // ===================================================================
+    // STREAM WRAPPER TESTS
+    // ===================================================================
+
+    public function testStreamWrapper()
+    {
+        $key = 'stream wrapper/' . uniqid();
+        $url = 'valkey://features/' . rawurlencode($key);
+        $value = random_bytes(300000);
+        $context = stream_context_create(['valkey' => ['chunk_size' => 4096, 'read_ahead' => 3]]);
+
+        $this->assertTrue($this->valkey_glide->registerStreamAlias('features'));
+
+        try {
+            /* Written in chunks, read back in windows */
+            $this->assertEquals(strlen($value), file_put_contents($url, $value, 0, $context));
+            $this->assertEquals($value, $this->valkey_glide->get($key));
+            $this->assertEquals($value, file_get_contents($url, false, $context));
+            $this->assertEquals(strlen($value), filesize($url));
+
+            $out = fopen('php://memory', 'w+');
+            $in = fopen($url, 'r', false, stream_context_create(['valkey' => ['read_ahead' => 0]]));
+            $this->assertEquals(strlen($value), stream_copy_to_stream($in, $out));
+            $this->assertTrue(feof($in));
+            fclose($in);
+            rewind($out);
+            $this->assertEquals($value, stream_get_contents($out));
+            fclose($out);
+
+            /* Seeking within a read stream */
+            $in = fopen($url, 'r', false, $context);
+            $this->assertEquals(0, fseek($in, 123456));
+            $this->assertEquals(substr($value, 123456, 10), fread($in, 10));
+            fclose($in);
+
+            /* Append and in-place update */
+            file_put_contents($url, 'tail', FILE_APPEND);
+            $this->assertEquals($value . 'tail', $this->valkey_glide->get($key));
+            $fp = fopen($url, 'c');
+            fseek($fp, 2);
+            fwrite($fp, 'XY');
+            fclose($fp);
+            $this->assertEquals(substr($value, 0, 2) . 'XY', $this->valkey_glide->getrange($key, 0, 3));
+
+            /* 'w' truncates even when nothing is written */
+            fclose(fopen($url, 'w'));
+            $this->assertEquals('', $this->valkey_glide->get($key));
+
+            $this->assertTrue(unlink($url));
+            $this->assertFalse(file_exists($url));
+            $this->assertFalse(@fopen($url, 'r'));
+            $this->assertFalse(@fopen('valkey://unknown_alias/key', 'r'));
+        } finally {
+            $this->valkey_glide->del($key);
+        }
+
+        $this->assertThrowsMatch(null, function () {
+            $this->valkey_glide->registerStreamAlias('a/b');
+        }, '/must not contain/');
+    }
+
+    // ===================================================================
+    // PIPELINE DEDUPLICATION
+    // ===================================================================
+
+    public function testPipelineDedupe()
+    {
+        $this->assertEquals(2, ValkeyGlide::OPT_PIPELINE_DEDUPE);
+        $this->assertFalse($this->valkey_glide->getOption(ValkeyGlide::OPT_PIPELINE_DEDUPE));
+
+        $key = 'pipeline_dedupe_' . uniqid();
+        $hash = $key . ':hash';
+
+        $this->valkey_glide->set($key, 'v1');
+        $this->valkey_glide->hMSet($hash, ['a' => '1', 'b' => '2']);
+
+        try {
+            $this->assertTrue($this->valkey_glide->setOption(ValkeyGlide::OPT_PIPELINE_DEDUPE, true));
+            $this->assertTrue($this->valkey_glide->getOption(ValkeyGlide::OPT_PIPELINE_DEDUPE));
+
+            /* Every duplicate gets its own copy of the reply, reads after a write see the write */
+            $result = $this->valkey_glide->pipeline()
+                ->get($key)
+                ->hGetAll($hash)
+                ->get($key)
+                ->exists($key)
+                ->hGetAll($hash)
+                ->set($key, 'v2')
+                ->get($key)
+                ->get($key)
+                ->exec();
+            $this->assertEquals(
+                ['v1', ['a' => '1', 'b' => '2'], 'v1', 1, ['a' => '1', 'b' => '2'], true, 'v2', 'v2'],
+                $result
+            );
+
+            /* Transactions are never deduplicated */
+            $result = $this->valkey_glide->multi()->get($key)->incr($key . ':n')->get($key)->exec();
+            $this->assertEquals(['v2', 1, 'v2'], $result);
+        } finally {
+            $this->valkey_glide->setOption(ValkeyGlide::OPT_PIPELINE_DEDUPE, false);
+            $this->valkey_glide->del($key, $hash, $key . ':n');
+        }
+    }
+
+    // ===================================================================
+    // HOT KEYS
+    // ===================================================================
+
+    public function testHotKeys()
+    {
+        $this->assertEquals(3, ValkeyGlide::OPT_HOT_KEY_SAMPLING);
+        $this->assertFalse($this->valkey_glide->getHotKeys());
+
+        $hot = 'hot_keys_hot_' . uniqid();
+        $warm = 'hot_keys_warm_' . uniqid();
+
+        try {
+            $this->assertFalse($this->valkey_glide->setOption(ValkeyGlide::OPT_HOT_KEY_SAMPLING, 1.5));
+            $this->assertTrue($this->valkey_glide->setOption(ValkeyGlide::OPT_HOT_KEY_SAMPLING, 1));
+            $this->assertEquals(1.0, $this->valkey_glide->getOption(ValkeyGlide::OPT_HOT_KEY_SAMPLING));
+
+            $this->valkey_glide->set($hot, str_repeat('x', 100));
+            for ($i = 0; $i < 50; $i++) {
+                $this->valkey_glide->get($hot);
+            }
+            for ($i = 0; $i < 5; $i++) {
+                $this->valkey_glide->hSet($warm, 'f' . $i, 'v');
+            }
+            /* Pipelined commands are counted too */
+            $this->valkey_glide->pipeline()->get($hot)->get($hot)->exec();
+
+            $report = $this->valkey_glide->getHotKeys(2);
+            $this->assertEquals(1.0, $report['sample_rate']);
+            $this->assertEquals(58, $report['samples']);
+            $this->assertEquals(2, count($report['keys']));
+            $this->assertEquals($hot, $report['keys'][0]['key']);
+            $this->assertEquals(53, $report['keys'][0]['count']);
+            $this->assertGT(100, $report['keys'][0]['bytes']);
+            $this->assertEquals($warm, $report['keys'][1]['key']);
+            $this->assertEquals(5, $report['keys'][1]['count']);
+            $this->assertFalse(isset($report['slots']));
+
+            /* Setting a rate starts over */
+            $this->valkey_glide->setOption(ValkeyGlide::OPT_HOT_KEY_SAMPLING, 0.5);
+            $this->assertEquals([], $this->valkey_glide->getHotKeys()['keys']);
+
+            $this->assertThrowsMatch(null, function () {
+                $this->valkey_glide->getHotKeys(0);
+            }, '/greater than 0/');
+        } finally {
+            $this->valkey_glide->setOption(ValkeyGlide::OPT_HOT_KEY_SAMPLING, 0);
+            $this->valkey_glide->del($hot, $warm);
+        }
+
+        $this->assertFalse($this->valkey_glide->getHotKeys());
+    }
+
+    // ===================================================================
+    // CLIENT SLOW LOG
+    // ===================================================================
+
+    public function testSlowLog()
+    {
+        $this->assertEquals(4, ValkeyGlide::OPT_SLOWLOG_THRESHOLD);
+        $this->assertEquals(-1, $this->valkey_glide->getOption(ValkeyGlide::OPT_SLOWLOG_THRESHOLD));
+        $this->assertFalse($this->valkey_glide->getSlowLog());
+        $this->assertFalse($this->valkey_glide->resetSlowLog());
+
+        $key = 'slowlog_' . uniqid();
+
+        try {
+            /* A threshold of 0 records every call */
+            $this->assertTrue($this->valkey_glide->setOption(ValkeyGlide::OPT_SLOWLOG_THRESHOLD, 0));
+            $this->assertEquals(0, $this->valkey_glide->getOption(ValkeyGlide::OPT_SLOWLOG_THRESHOLD));
+
+            $this->valkey_glide->set($key, str_repeat('a', 100));
+            $this->valkey_glide->get($key);
+            $this->valkey_glide->get($key);
+
+            $log = $this->valkey_glide->getSlowLog();
+            $this->assertEquals(3, count($log));
+            for ($i = 1; $i < count($log); $i++) {
+                $this->assertLTE($log[$i - 1]['duration_us'], $log[$i]['duration_us']);
+            }
+            usort($log, fn($a, $b) => $b['id'] <=> $a['id']);
+            [$get, $previous_get, $set] = $log;
+
+            $this->assertGT($previous_get['id'], $get['id']);
+            $this->assertEquals($key, $get['key']);
+            $this->assertEquals([], $get['args']);
+            $this->assertEquals(100, $get['reply_bytes']);
+            $this->assertEquals('default', $get['route']);
+            $this->assertFalse($get['failed']);
+            $this->assertEquals($previous_get['fingerprint'], $get['fingerprint']);
+            $this->assertTrue($get['fingerprint'] !== $set['fingerprint']);
+
+            $this->assertEquals([str_repeat('a', 32) . '... (68 more bytes)'], $set['args']);
+            $this->assertEquals(strlen($key) + 100, $set['arg_bytes']);
+            $this->assertEquals('SET', $set['command']);
+            $this->assertEquals('GET', $get['command']);
+            $this->assertTrue(is_float($set['timestamp']));
+            $this->assertTrue($set['duration_us'] >= 0);
+
+            $this->valkey_glide->rawcommand('GET', $key);
+            $this->valkey_glide->pipeline()->get($key)->get($key)->exec();
+            $log = $this->valkey_glide->getSlowLog();
+            $batch = array_values(array_filter($log, fn($entry) => $entry['command'] === 'PIPELINE'))[0];
+            $raw = array_values(array_filter($log, fn($entry) => $entry['command'] === 'GET' &&
+                                                                  $entry['id'] > $get['id']))[0];
+            $this->assertEquals($key, $raw['key']);
+            $this->assertEquals(1, $raw['arg_count']);
+            $this->assertEquals('PIPELINE', $batch['command']);
+            $this->assertEquals(2, $batch['commands']);
+            $this->assertEquals(200, $batch['reply_bytes']);
+
+            $this->assertTrue($this->valkey_glide->resetSlowLog());
+            $this->assertEquals([], $this->valkey_glide->getSlowLog());
+
+            /* Fast calls stay out of the log */
+            $this->valkey_glide->setOption(ValkeyGlide::OPT_SLOWLOG_THRESHOLD, 10_000_000);
+            $this->valkey_glide->get($key);
+            $this->assertEquals([], $this->valkey_glide->getSlowLog());
+        } finally {
+            $this->valkey_glide->setOption(ValkeyGlide::OPT_SLOWLOG_THRESHOLD, -1);
+            $this->valkey_glide->del($key);
+        }
+
+        $this->assertFalse($this->valkey_glide->getSlowLog());
+    }
+
+    // ===================================================================
+    // BITMAPS
+    // ===================================================================
+
+    public function testBitmap()
+    {
+        $key = 'bitmap_' . uniqid();
+        $other = $key . '_other';
+
+        try {
+            /* A missing key is an empty bitmap */
+            $bitmap = $this->valkey_glide->getBitmap($key);
+            $this->assertTrue($bitmap instanceof ValkeyGlideBitmap);
+            $this->assertEquals(0, $bitmap->length());
+            $this->assertEquals(0, $bitmap->bitCount());
+
+            foreach ([0, 7, 8, 100, 1337] as $offset) {
+                $this->valkey_glide->setBit($key, $offset, 1);
+            }
+
+            $bitmap = $this->valkey_glide->getBitmap($key);
+            $this->assertEquals(1344, $bitmap->length());
+            $this->assertEquals($this->valkey_glide->bitcount($key), $bitmap->bitCount());
+            $this->assertEquals([0, 7, 8, 100, 1337], $bitmap->toArray());
+            $this->assertEquals([0, 7, 8, 100, 1337], iterator_to_array($bitmap));
+            $this->assertTrue($bitmap->getBit(100));
+            $this->assertFalse($bitmap->getBit(101));
+            $this->assertFalse($bitmap->getBit(1 << 20));
+            $this->assertEquals(3, $bitmap->rank(8));
+            $this->assertEquals(3, $bitmap->rank(99));
+            $this->assertEquals(5, $bitmap->rank(1 << 20));
+            $this->assertEquals(100, $bitmap->select(3));
+            $this->assertFalse($bitmap->select(5));
+
+            $this->valkey_glide->setBit($other, 8, 1);
+            $this->valkey_glide->setBit($other, 9, 1);
+            $mask = $this->valkey_glide->getBitmap($other);
+
+            $this->assertEquals([8], $bitmap->and($mask)->toArray());
+            $this->assertEquals(1344, $bitmap->and($mask)->length());
+            $this->assertEquals([0, 7, 8, 9, 100, 1337], $bitmap->or($mask)->toArray());
+            $this->assertEquals([0, 7, 9, 100, 1337], $bitmap->xor($mask)->toArray());
+            $this->assertEquals([0, 7, 100, 1337], $bitmap->andNot($mask)->toArray());
+            $this->assertEquals([9], $mask->andNot($bitmap)->toArray());
+
+            /* The local operations agree with BITOP */
+            $this->valkey_glide->bitop('XOR', $key . '_xor', $key, $other);
+            $this->assertTrue($bitmap->xor($mask) == $this->valkey_glide->getBitmap($key . '_xor'));
+
+            /* Local changes leave the source alone and are written back with set() */
+            $copy = clone $bitmap;
+            $copy->setBit(100, false);
+            $copy->setBit(2000);
+            $this->assertTrue($bitmap->getBit(100));
+            $this->assertTrue($this->valkey_glide->set($key, $copy));
+            $this->assertEquals(0, $this->valkey_glide->getBit($key, 100));
+            $this->assertEquals(1, $this->valkey_glide->getBit($key, 2000));
+            $this->assertEquals((string)$copy, $this->valkey_glide->get($key));
+
+            $this->assertEquals([0], (new ValkeyGlideBitmap("\x80"))->toArray());
+            $this->assertThrowsMatch(null, function () use ($bitmap) {
+                $bitmap->setBit(-1);
+            }, '/Bit offset/');
+        } finally {
+            $this->valkey_glide->del($key, $other, $key . '_xor');
+        }
+    }
+
+    // ===================================================================
+    // COLUMNAR RESULTS
+    // ===================================================================
+
+    public function testColumnarResults()
+    {
+        $this->assertEquals(5, ValkeyGlide::OPT_COLUMNAR);
+        $this->assertFalse($this->valkey_glide->getOption(ValkeyGlide::OPT_COLUMNAR));
+
+        $prefix = 'columnar_' . uniqid();
+        $geo = "$prefix:geo";
+        $zset = "$prefix:zset";
+        $stream = "$prefix:stream";
+
+        $this->valkey_glide->geoadd($geo, -121.837478, 39.728494, 'Chico', -122.032182, 37.322998, 'Cupertino');
+        $this->valkey_glide->zAdd($zset, 1.5, 'a', 2.5, 'b', 3.5, 'c');
+        $first = $this->valkey_glide->xAdd($stream, '*', ['temp' => '20', 'unit' => 'C']);
+        $second = $this->valkey_glide->xAdd($stream, '*', ['temp' => '21']);
+        $third = $this->valkey_glide->xAdd($stream, '*', ['humidity' => '40']);
+        $this->valkey_glide->xGroup('CREATE', $stream, 'group', '0');
+        $this->valkey_glide->xReadGroup('group', 'consumer', [$stream => '>']);
+
+        try {
+            $this->assertTrue($this->valkey_glide->setOption(ValkeyGlide::OPT_COLUMNAR, true));
+            $this->assertTrue($this->valkey_glide->getOption(ValkeyGlide::OPT_COLUMNAR));
+
+            $res = $this->valkey_glide->geosearch($geo, 'Chico', 500, 'km', ['withcoord', 'withdist', 'ASC']);
+            $this->assertEquals(['member', 'dist', 'lon', 'lat'], array_keys($res));
+            $this->assertEquals(['Chico', 'Cupertino'], $res['member']);
+            $this->assertTrue(is_float($res['dist'][0]) && is_float($res['dist'][1]));
+            $this->assertGT($res['dist'][0], $res['dist'][1]);
+            $this->assertEquals(-121.8375, round($res['lon'][0], 4));
+            $this->assertEquals(37.323, round($res['lat'][1], 3));
+
+            /* Without WITH* options there is only one column to begin with */
+            $this->assertEquals(['Chico'], $this->valkey_glide->geosearch($geo, 'Chico', 1, 'm'));
+
+            $this->assertEquals(
+                ['member' => ['a', 'b', 'c'], 'score' => [1.5, 2.5, 3.5]],
+                $this->valkey_glide->zRange($zset, 0, -1, ['withscores' => true])
+            );
+            $this->assertEquals(
+                ['member' => ['c', 'b'], 'score' => [3.5, 2.5]],
+                $this->valkey_glide->zRevRangeByScore($zset, '+inf', '2', ['withscores' => true])
+            );
+            $this->assertEquals(['a', 'b', 'c'], $this->valkey_glide->zRange($zset, 0, -1));
+
+            $this->assertEquals(
+                [
+                    'id' => [$first, $second, $third],
+                    'fields' => [
+                        'temp' => ['20', '21', null],
+                        'unit' => ['C', null, null],
+                        'humidity' => [null, null, '40'],
+                    ],
+                ],
+                $this->valkey_glide->xRange($stream, '-', '+')
+            );
+            $this->assertEquals([$third, $second, $first], $this->valkey_glide->xRevRange($stream, '+', '-')['id']);
+
+            $pending = $this->valkey_glide->xPending($stream, 'group', '-', '+', 10);
+            $this->assertEquals(['id', 'consumer', 'idle', 'deliveries'], array_keys($pending));
+            $this->assertEquals([$first, $second, $third], $pending['id']);
+            $this->assertEquals(['consumer', 'consumer', 'consumer'], $pending['consumer']);
+            $this->assertEquals([1, 1, 1], $pending['deliveries']);
+
+            /* The summary form is not made of rows */
+            $this->assertEquals(3, $this->valkey_glide->xPending($stream, 'group')[0]);
+
+            /* Batched commands keep the mode they were queued with */
+            $res = $this->valkey_glide->pipeline()->zRange($zset, 0, 0, ['withscores' => true])->exec();
+            $this->assertEquals([['member' => ['a'], 'score' => [1.5]]], $res);
+        } finally {
+            $this->valkey_glide->setOption(ValkeyGlide::OPT_COLUMNAR, false);
+            $this->valkey_glide->del($geo, $zset, $stream);
+        }
+    }
+
+    // ====================================================================
+    // BULK WRITERS
+    // ====================================================================
+
+    public function testBulkWriters()
+    {
+        $prefix = 'bulk_' . uniqid() . ':';
+        $a = $prefix . 'a';
+        $b = $prefix . 'b';
+        $c = $prefix . 'c';
+
+        try {
+            $stored = $this->valkey_glide->msetex([$a => 'x', $b => 42, $c => 1.5], 100);
+            $this->assertTrue($stored instanceof ValkeyGlideBitmap);
+            $this->assertEquals([0, 1, 2], $stored->toArray());
+            $this->assertEquals(['x', '42', '1.5'], $this->valkey_glide->mget([$a, $b, $c]));
+            $ttl = $this->valkey_glide->ttl($b);
+            $this->assertTrue($ttl > 0 && $ttl <= 100);
+
+            /* Floats are stored as PHP prints them, like set() does */
+            $this->valkey_glide->msetex([$c => 0.1], 100);
+            $this->assertEquals('0.1', $this->valkey_glide->get($c));
+
+            /* TTLs by key */
+            $stored = $this->valkey_glide->msetex([$a => 'y', $b => 'z'], [$a => 10, $b => 1000]);
+            $this->assertEquals(2, $stored->bitCount());
+            $this->assertTrue($this->valkey_glide->ttl($a) <= 10);
+            $this->assertGT(10, $this->valkey_glide->ttl($b));
+
+            $this->assertThrowsMatch(null, function () use ($a, $b) {
+                $this->valkey_glide->msetex([$a => 'x', $b => 'y'], [$a => 10]);
+            }, '/TTL/');
+            $this->assertThrowsMatch(null, function () use ($a) {
+                $this->valkey_glide->msetex([$a => 'x'], 0);
+            }, '/TTL/');
+            $this->assertEquals(0, $this->valkey_glide->msetex([], 10)->length());
+
+            /* A failing command only clears its own bit */
+            $this->valkey_glide->del($a, $b, $c);
+            $this->valkey_glide->set($b, 'not a hash');
+            $written = $this->valkey_glide->hmsetMulti([
+                $a => ['name' => 'Ann', 'age' => 30],
+                $b => ['name' => 'Bob'],
+                $c => ['name' => 'Eve', 7 => 'seven'],
+            ]);
+            $this->assertEquals([0, 2], $written->toArray());
+            $this->assertEquals(['name' => 'Ann', 'age' => '30'], $this->valkey_glide->hGetAll($a));
+            $this->assertEquals('seven', $this->valkey_glide->hGet($c, '7'));
+            $this->valkey_glide->hmsetMulti([$c => ['ratio' => 0.1]]);
+            $this->assertEquals('0.1', $this->valkey_glide->hGet($c, 'ratio'));
+
+            $this->assertThrowsMatch(null, function () use ($a) {
+                $this->valkey_glide->hmsetMulti([$a => []]);
+            }, '/non-empty array/');
+
+            $this->valkey_glide->del($a, $c);
+            $written = $this->valkey_glide->zaddMulti([
+                $a => ['ann' => 10, 'bob' => 7.25],
+                $b => ['eve' => 1],
+                $c => ['zed' => 0.1],
+            ]);
+            $this->assertEquals([0, 2], $written->toArray());
+            $this->assertEquals(['bob' => 7.25, 'ann' => 10.0], $this->valkey_glide->zRange($a, 0, -1, ['withscores' => true]));
+            $this->assertEquals(0.1, $this->valkey_glide->zScore($c, 'zed'));
+
+            $this->assertThrowsMatch(null, function () use ($a) {
+                $this->valkey_glide->zaddMulti([$a => ['ann' => [1]]]);
+            }, '/scores/');
+            $this->assertThrowsMatch(null, function () use ($a) {
+                $this->valkey_glide->zaddMulti([$a => ['ann' => 'ten']]);
+            }, '/scores/');
+            $this->valkey_glide->zaddMulti([$a => ['inf' => '+inf', 'two' => '2.5']]);
+            $this->assertEquals(2.5, $this->valkey_glide->zScore($a, 'two'));
+        } finally {
+            $this->valkey_glide->del($a, $b, $c);
+        }
+    }
+
+    // ====================================================================
+    // MEMORY ACCOUNTING
+    // ====================================================================
+
+    public function testMemoryStats()
+    {
+        $key = 'memstats_' . uniqid();
+
+        $stats = $this->valkey_glide->getMemoryStats();
+        foreach (['batch', 'pubsub', 'scan', 'response'] as $subsystem) {
+            $this->assertEquals(
+                ['live_bytes', 'peak_bytes', 'allocations', 'live_allocations'],
+                array_slice(array_keys($stats[$subsystem]), 0, 4)
+            );
+            $this->assertTrue($stats[$subsystem]['peak_bytes'] >= $stats[$subsystem]['live_bytes']);
+        }
+        $this->assertTrue(isset($stats['pubsub']['queue_depth']));
+        $this->assertTrue(isset($stats['scan']['rust_cursors']));
+        $this->assertGT(0, $stats['php_usage']);
+
+        /* Buffered commands are accounted until exec() */
+        $before = $stats['batch']['live_bytes'];
+        $this->valkey_glide->pipeline();
+        $this->valkey_glide->set($key, str_repeat('x', 4096));
+        $this->valkey_glide->get($key);
+        $during = $this->valkey_glide->getMemoryStats()['batch'];
+        $this->assertGT($before + 4096, $during['live_bytes']);
+        $this->valkey_glide->exec();
+
+        $after = $this->valkey_glide->getMemoryStats();
+        $this->assertEquals($before, $after['batch']['live_bytes']);
+        $this->assertTrue($after['batch']['peak_bytes'] >= $during['live_bytes']);
+        $this->assertGT($stats['batch']['allocations'], $after['batch']['allocations']);
+
+        /* Reply conversion only holds scratch space while it runs */
+        $this->valkey_glide->rpush($key . ':list', 'a', 'b', 'c');
+        $this->valkey_glide->lrange($key . ':list', 0, -1);
+        $this->assertEquals(0, $this->valkey_glide->getMemoryStats()['response']['live_bytes']);
+
+        $this->valkey_glide->del($key, $key . ':list');
+    }
+
+    // ====================================================================
+    // RATE LIMITER
+    // ====================================================================
+
+    public function testRateLimiter()
+    {
+        $prefix = '{ratelimit_' . uniqid() . '}';
+        $algorithms = [
+            ValkeyGlideRateLimiter::TOKEN_BUCKET,
+            ValkeyGlideRateLimiter::GCRA,
+            ValkeyGlideRateLimiter::SLIDING_WINDOW,
+        ];
+
+        foreach ($algorithms as $algorithm) {
+            $key = "$prefix:$algorithm";
+            $limiter = new ValkeyGlideRateLimiter($this->valkey_glide, $algorithm);
+            $this->assertEquals($algorithm, $limiter->getAlgorithm());
+
+            for ($i = 0; $i < 3; $i++) {
+                $result = $limiter->allow($key, 3, 60);
+                $this->assertTrue($result->allowed);
+                $this->assertEquals(2 - $i, $result->remaining);
+                $this->assertEquals(0.0, $result->retryAfter);
+            }
+
+            $result = $limiter->allow($key, 3, 60);
+            $this->assertFalse($result->allowed);
+            $this->assertEquals(0, $result->remaining);
+            $this->assertGT(0, $result->retryAfter);
+            $this->assertTrue($result->retryAfter <= 60);
+            $this->assertGT(0, $result->resetAfter);
+
+            /* A cost of 0 only looks */
+            $this->assertEquals(0, $limiter->allow("$key:peek", 3, 60, 0)->limit);
+            $this->assertEquals(3, $limiter->allow("$key:peek", 3, 60, 0)->remaining);
+
+            /* All or nothing: the refused call counts against neither limit */
+            $result = $limiter->check([
+                ['key' => "$key:wide", 'limit' => 10, 'period' => 60],
+                [$key, 3, 60],
+            ]);
+            $this->assertFalse($result->allowed);
+            $this->assertEquals(1, $result->limit);
+            $this->assertEquals(10, $limiter->allow("$key:wide", 10, 60, 0)->remaining);
+
+            $this->valkey_glide->del($key, "$key:wide");
+        }
+
+        $limiter = new ValkeyGlideRateLimiter($this->valkey_glide);
+        $this->assertEquals(ValkeyGlideRateLimiter::GCRA, $limiter->getAlgorithm());
+        $this->assertThrowsMatch(null, function () use ($limiter) {
+            $limiter->check([]);
+        }, '/At least one/');
+        $this->assertThrowsMatch(null, function () use ($limiter, $prefix) {
+            $limiter->allow("$prefix:bad", 3, 60, 4);
+        }, '/cost/');
+        $this->assertThrowsMatch(null, function () use ($limiter, $prefix) {
+            $limiter->allow("$prefix:bad", 0, 60);
+        }, '/positive/');
+    }
+
+    // ====================================================================
+    // BLOOM FILTER
+    // ====================================================================
+
+    public function testBloomFilter()
+    {
+        $prefix = 'bloom_' . uniqid();
+
+        $bloom = new ValkeyGlideBloom(1000, 0.01);
+        $this->assertEquals(2, $bloom->add("$prefix:a", "$prefix:b"));
+        $this->assertEquals(2, $bloom->add(["$prefix:c", "$prefix:d"]));
+        foreach (['a', 'b', 'c', 'd'] as $suffix) {
+            $this->assertTrue($bloom->mightContain("$prefix:$suffix"));
+        }
+
+        $stats = $bloom->getStats();
+        $this->assertEquals(1000, $stats['capacity']);
+        $this->assertEquals(4, $stats['items']);
+        $this->assertEquals(0, $stats['bytes'] % 64);
+        $this->assertTrue($stats['fill_ratio'] > 0 && $stats['fill_ratio'] < 0.1);
+
+        /* Saved and loaded as a plain string value */
+        $this->valkey_glide->set("$prefix:filter", (string) $bloom);
+        $loaded = ValkeyGlideBloom::fromBitmap(
+            $this->valkey_glide->getBitmap("$prefix:filter"),
+            $stats['hashes']
+        );
+        $this->assertEquals((string) $bloom, (string) $loaded);
+        $this->assertTrue($loaded->mightContain("$prefix:c"));
+
+        $bloom->clear();
+        $this->assertFalse($bloom->mightContain("$prefix:a"));
+
+        /* Attached, misses are answered locally and writes are learned */
+        $this->valkey_glide->set("$prefix:known", 'value');
+        $this->valkey_glide->hSet("$prefix:hash", 'field', 'value');
+        $bloom = ValkeyGlideBloom::fromScan($this->valkey_glide, "$prefix:*");
+        $this->assertTrue($bloom->mightContain("$prefix:known"));
+        $this->assertTrue($this->valkey_glide->setBloomFilter($bloom));
+        $this->assertTrue($this->valkey_glide->getBloomFilter() === $bloom);
+
+        $this->assertEquals('value', $this->valkey_glide->get("$prefix:known"));
+        $this->assertEquals('value', $this->valkey_glide->hGet("$prefix:hash", 'field'));
+        $this->assertFalse($this->valkey_glide->get("$prefix:missing"));
+        $this->assertFalse($this->valkey_glide->hGet("$prefix:missing", 'field'));
+        $this->assertEquals(0, $this->valkey_glide->exists("$prefix:missing", "$prefix:gone"));
+        $this->assertEquals(1, $this->valkey_glide->exists(["$prefix:known", "$prefix:missing"]));
+        $this->assertGT(0, $bloom->getStats()['short_circuits']);
+
+        $this->valkey_glide->set("$prefix:new", 'fresh');
+        $this->valkey_glide->mset(["$prefix:m1" => 1, "$prefix:m2" => 2]);
+        $this->valkey_glide->rename("$prefix:m2", "$prefix:renamed");
+        $this->assertEquals('fresh', $this->valkey_glide->get("$prefix:new"));
+        $this->assertEquals('1', $this->valkey_glide->get("$prefix:m1"));
+        $this->assertEquals('2', $this->valkey_glide->get("$prefix:renamed"));
+
+        /* Every send path teaches it, not only the command executors */
+        $this->valkey_glide->rawcommand('SET', "$prefix:raw", 'raw');
+        $this->valkey_glide->geoadd("$prefix:geo", 13.361389, 38.115556, 'Palermo');
+        $this->valkey_glide->eval("return redis.call('SET', KEYS[1], 'lua')", ["$prefix:lua"], 1);
+        $this->valkey_glide->pipeline()->set("$prefix:piped", 'piped')->exec();
+        $this->assertEquals('raw', $this->valkey_glide->get("$prefix:raw"));
+        $this->assertEquals(1, $this->valkey_glide->exists("$prefix:geo"));
+        $this->assertEquals('lua', $this->valkey_glide->get("$prefix:lua"));
+        $this->assertEquals('piped', $this->valkey_glide->get("$prefix:piped"));
+
+        /* Another database isn't described by the filter */
+        $this->assertTrue($this->valkey_glide->select(1));
+        $this->assertEquals(null, $this->valkey_glide->getBloomFilter());
+        $this->valkey_glide->set("$prefix:db1", 'other');
+        $this->assertTrue($this->valkey_glide->select(0));
+        $this->assertTrue($this->valkey_glide->setBloomFilter($bloom));
+        $this->valkey_glide->rawcommand('SELECT', '1');
+        $this->assertEquals('other', $this->valkey_glide->get("$prefix:db1"));
+        $this->valkey_glide->del("$prefix:db1");
+        $this->valkey_glide->rawcommand('SELECT', '0');
+
+        $this->assertTrue($this->valkey_glide->setBloomFilter(null));
+        $this->assertEquals(null, $this->valkey_glide->getBloomFilter());
+
+        $this->assertThrowsMatch(null, function () {
+            new ValkeyGlideBloom(0);
+        }, '/greater than 0/');
+        $this->assertThrowsMatch(null, function () {
+            ValkeyGlideBloom::fromBitmap('short', 3);
+        }, '/multiple of 64/');
+
+        $this->valkey_glide->del(
+            "$prefix:filter",
+            "$prefix:known",
+            "$prefix:hash",
+            "$prefix:new",
+            "$prefix:m1",
+            "$prefix:renamed",
+            "$prefix:raw",
+            "$prefix:geo",
+            "$prefix:lua",
+            "$prefix:piped"
+        );
+    }
+
+    // ====================================================================
+    // METRICS SNAPSHOT
+    // ====================================================================
+
+    public function testMetricsSnapshot()
+    {
+        $first = $this->valkey_glide->metricsSnapshot();
+        $this->assertTrue(is_int($first['used_memory']));
+        $this->assertTrue(is_int($first['connected_clients']));
+        $this->assertTrue(is_int($first['total_commands_processed']));
+        $this->assertEquals(
+            ['ops_per_sec', 'hit_ratio', 'net_input_bytes_per_sec', 'net_output_bytes_per_sec',
+             'interval'],
+            array_keys($first['rates'])
+        );
+
+        $fields = ['mem_fragmentation_ratio', 'role', 'no_such_field'];
+        $snapshot = $this->valkey_glide->metricsSnapshot($fields);
+        $this->assertEquals(array_merge($fields, ['rates']), array_keys($snapshot));
+        $this->assertTrue(is_float($snapshot['mem_fragmentation_ratio']));
+        $this->assertEquals('master', $snapshot['role']);
+        $this->assertEquals(null, $snapshot['no_such_field']);
+
+        for ($i = 0; $i < 10; $i++) {
+            $this->valkey_glide->get('metrics:missing');
+        }
+        usleep(10000);
+        $rates = $this->valkey_glide->metricsSnapshot(['keyspace_misses'])['rates'];
+        $this->assertGT(0, $rates['interval']);
+        $this->assertGT(0, $rates['ops_per_sec']);
+        $this->assertTrue($rates['hit_ratio'] === null || $rates['hit_ratio'] < 1);
+
+        $this->assertThrowsMatch(null, function () {
+            $this->valkey_glide->metricsSnapshot(['']);
+        }, '/non-empty strings/');
+    }
+
+    // ====================================================================
+    // NODE STATISTICS
+    // ====================================================================
+
+    public function testNodeStats()
+    {
+        $this->assertFalse($this->valkey_glide->getNodeStats());
+
+        try {
+            $this->assertTrue($this->valkey_glide->setOption(ValkeyGlide::OPT_NODE_STATS, true));
+            $this->assertTrue($this->valkey_glide->getOption(ValkeyGlide::OPT_NODE_STATS));
+
+            for ($i = 0; $i < 20; $i++) {
+                $this->valkey_glide->set('node_stats:key', $i);
+            }
+
+            $stats = $this->valkey_glide->getNodeStats();
+            $this->assertEquals(['default'], array_keys($stats));
+            $this->assertEquals(20, $stats['default']['requests']);
+            $this->assertEquals(0, $stats['default']['errors']);
+            $this->assertGT(0, $stats['default']['rtt_avg_us']);
+            $this->assertGT(0, $stats['default']['rtt_p99_us']);
+        } finally {
+            $this->valkey_glide->setOption(ValkeyGlide::OPT_NODE_STATS, false);
+            $this->valkey_glide->del('node_stats:key');
+        }
+
+        $this->assertFalse($this->valkey_glide->getOption(ValkeyGlide::OPT_NODE_STATS));
+        $this->assertFalse($this->valkey_glide->getNodeStats());
+    }
+
+    // ====================================================================
+    // DEADLINES
+    // ====================================================================
+
+    public function testWithDeadline()
+    {
+        $this->assertTrue($this->valkey_glide->withDeadline(1000)->set('deadline:key', 'v'));
+        $this->assertEquals('v', $this->valkey_glide->withDeadline(1000)->get('deadline:key'));
+
+        $value = $this->valkey_glide->withDeadline(1000, function ($client) {
+            $client->incr('deadline:counter');
+            return $client->incr('deadline:counter');
+        });
+        $this->assertEquals(2, $value);
+
+        $this->valkey_glide->pipeline()->get('deadline:key')->get('deadline:counter');
+        $this->assertEquals(['v', '2'], $this->valkey_glide->withDeadline(1000)->exec());
+
+        // Spent before the call, nothing is sent
+        try {
+            $this->valkey_glide->withDeadline(1, function ($client) {
+                usleep(5000);
+                return $client->get('deadline:key');
+            });
+            $this->fail('Should throw once the budget is spent');
+        } catch (ValkeyGlideTimeoutException $e) {
+            $this->assertStringContains('before the call was sent', $e->getMessage());
+        }
+
+        // Spent while the call is in flight
+        try {
+            $this->valkey_glide->withDeadline(50)->blPop(['deadline:missing'], 1);
+            $this->fail('Should throw when the call outlasts its budget');
+        } catch (ValkeyGlideTimeoutException $e) {
+            $this->assertTrue($e instanceof ValkeyGlideException);
+        }
+
+        // The budget was for one call only
+        $this->assertEquals('v', $this->valkey_glide->get('deadline:key'));
+
+        // Calls that don't apply a budget drop it rather than leaving it to the next one
+        $this->valkey_glide->withDeadline(1);
+        usleep(5000);
+        $this->assertFalse($this->valkey_glide->zmpop(['deadline:missing'], 'MIN'));
+        $this->assertEquals('v', $this->valkey_glide->get('deadline:key'));
+
+        $this->valkey_glide->del('deadline:key', 'deadline:counter');
+    }
+
+    public function testCircuitBreaker()
+    {
+        $this->assertFalse($this->valkey_glide->getBreakerStats());
+
+        $this->assertThrowsMatch(null, function () {
+            $client = new ValkeyGlide();
+            $client->connect(
+                addresses: [['host' => $this->getHost(), 'port' => $this->getPort()]],
+                use_tls: $this->getTLS(),
+                advanced_config: ['circuit_breaker' => ['failures' => 0]]
+            );
+        }, '/circuit_breaker must be/');
+
+        $advanced_config = [
+            'circuit_breaker' => ['failures' => 1, 'open_ms' => 300],
+            'retry_budget' => ['ratio' => 0.5, 'window_ms' => 1000, 'min_retries' => 0],
+        ];
+        if ($this->getTLS()) {
+            $advanced_config['tls_config'] = ['use_insecure_tls' => true];
+        }
+        $connect = function () use ($advanced_config) {
+            $client = new ValkeyGlide();
+            $client->connect(
+                addresses: [['host' => $this->getHost(), 'port' => $this->getPort()]],
+                use_tls: $this->getTLS(),
+                request_timeout: 50,
+                advanced_config: $advanced_config
+            );
+            return $client;
+        };
+        $address = $this->getHost() . ':' . $this->getPort();
+        $client = $connect();
+
+        try {
+            $this->assertTrue($client->set('breaker:key', 'v'));
+            $trips = $client->getBreakerStats()['nodes'][$address]['trips'];
+
+            // A timeout opens the breaker, the next call isn't sent
+            $this->assertFalse($client->rawcommand('DEBUG', 'SLEEP', '0.2'));
+            try {
+                $client->get('breaker:key');
+                $this->fail('Should fail fast while the breaker is open');
+            } catch (ValkeyGlideCircuitOpenException $e) {
+                $this->assertTrue($e instanceof ValkeyGlideException);
+                $this->assertStringContains($address, $e->getMessage());
+            }
+
+            $stats = $client->getBreakerStats();
+            $this->assertEquals('open', $stats['nodes'][$address]['state']);
+            $this->assertEquals($trips + 1, $stats['nodes'][$address]['trips']);
+
+            // The breaker is kept by the process, a new client sees it open
+            $other = $connect();
+            $this->assertThrowsMatch($other, function ($other) {
+                $other->get('breaker:key');
+            }, '/Circuit breaker open for/');
+            $this->assertEquals(0, $other->getBreakerStats()['requests']);
+            $other->close();
+
+            // Once open_ms has passed a probe goes through and closes it
+            usleep(400000);
+            $this->assertEquals('v', $client->get('breaker:key'));
+
+            $stats = $client->getBreakerStats();
+            $this->assertEquals('closed', $stats['nodes'][$address]['state']);
+            $this->assertEquals(0, $stats['nodes'][$address]['failures']);
+            $this->assertGT(2, $stats['requests']);
+            $this->assertEquals(0, $stats['retries']);
+
+            $client->del('breaker:key');
+        } finally {
+            $client->close();
+        }
+    }
+
+    public function testCompressionDictionary()
+    {
+        $this->assertThrowsMatch($this->valkey_glide, function ($r) {
+            $r->loadCompressionDictionaries();
+        }, '/Dictionary compression is off/');
+
+        $dictionary_key = 'dictionary:' . uniqid();
+        $connect = function () use ($dictionary_key) {
+            $client = new ValkeyGlide();
+            $client->connect(
+                addresses: [['host' => $this->getHost(), 'port' => $this->getPort()]],
+                use_tls: $this->getTLS(),
+                advanced_config: $this->getTLS() ? ['tls_config' => ['use_insecure_tls' => true]] : null,
+                compression: ['enabled' => true, 'dictionary_key' => $dictionary_key]
+            );
+            return $client;
+        };
+
+        try {
+            $client = $connect();
+        } catch (ValkeyGlideException $e) {
+            if (strpos($e->getMessage(), 'libzstd') === false) {
+                throw $e;
+            }
+            $this->markTestSkipped('Built without libzstd');
+        }
+
+        $document = function ($i) {
+            return json_encode([
+                'id' => $i,
+                'name' => "user-$i",
+                'email' => "user-$i@example.com",
+                'roles' => ['reader', $i % 2 ? 'writer' : 'reviewer'],
+                'settings' => ['theme' => $i % 3 ? 'dark' : 'light', 'notifications' => true],
+            ]);
+        };
+
+        try {
+            // Nothing trained yet, values are compressed with plain zstd
+            $this->assertEquals(0, $client->loadCompressionDictionaries());
+            $this->assertTrue($client->set('dictionary:plain', $document(0)));
+            $this->assertEquals($document(0), $client->get('dictionary:plain'));
+
+            $id = $client->trainCompressionDictionary(array_map($document, range(1, 1000)), 4096);
+            $this->assertGT(0, $id);
+            $this->assertEquals((string) $id, $client->hget($dictionary_key, 'current'));
+
+            $value = $document(5000);
+            $this->assertTrue($client->set('dictionary:a', $value));
+            $this->assertLT(strlen($value), $client->strlen('dictionary:a'));
+            $this->assertEquals($value, $client->get('dictionary:a'));
+
+            $this->assertTrue($client->mset(['dictionary:b' => $document(5001), 'dictionary:c' => 'small']));
+            $this->assertEquals(
+                [$document(5001), 'small', $document(0), false],
+                $client->mget(['dictionary:b', 'dictionary:c', 'dictionary:plain', 'dictionary:none'])
+            );
+            $this->assertEquals($value, $client->getset('dictionary:a', $document(5002)));
+
+            // Bulk writes compress like set()
+            $this->assertEquals(1, $client->msetex(['dictionary:d' => $document(5003)], 100)->bitCount());
+            $this->assertLT(strlen($document(5003)), $client->strlen('dictionary:d'));
+            $this->assertEquals($document(5003), $client->get('dictionary:d'));
+
+            // A client connecting afterwards loads the dictionary from the server
+            $other = $connect();
+            try {
+                $this->assertEquals(1, $other->loadCompressionDictionaries());
+                $this->assertEquals($document(5002), $other->get('dictionary:a'));
+            } finally {
+                $other->close();
+            }
+
+            // Only tagged values are decoded, other zstd frames are user data
+            $frame = "\x28\xb5\x2f\xfd\x21\x07\x00\x01\x00\x00";
+            $client->rawcommand('SET', 'dictionary:frame', $frame);
+            $this->assertEquals($frame, $client->get('dictionary:frame'));
+
+            $client->rawcommand('SET', 'dictionary:mismatch', "\x00GD1\x00\x00\x00\x00" . $frame);
+            $this->assertThrowsMatch($client, function ($client) {
+                $client->get('dictionary:mismatch');
+            }, '/Invalid compressed value/');
+
+            // A tagged empty frame of dictionary 7: looked for once, not on every read
+            $hgets = function () use ($client) {
+                preg_match('/calls=(\d+)/', $client->info('commandstats')['cmdstat_hget'] ?? '', $m);
+                return (int) ($m[1] ?? 0);
+            };
+            $client->rawcommand('SET', 'dictionary:unknown', "\x00GD1\x00\x00\x00\x07" . $frame);
+            $before = $hgets();
+            $client->setOption(ValkeyGlide::OPT_NODE_STATS, true);
+            for ($i = 0; $i < 2; $i++) {
+                $this->assertThrowsMatch($client, function ($client) {
+                    $client->get('dictionary:unknown');
+                }, '/unknown dictionary 7/');
+            }
+            $this->assertEquals(2, $client->getNodeStats()['default']['requests']);
+            $client->setOption(ValkeyGlide::OPT_NODE_STATS, false);
+            $this->assertEquals($before + 1, $hgets());
+
+            $client->del(
+                $dictionary_key,
+                'dictionary:plain',
+                'dictionary:a',
+                'dictionary:b',
+                'dictionary:c',
+                'dictionary:d',
+                'dictionary:frame',
+                'dictionary:mismatch',
+                'dictionary:unknown'
+            );
+        } finally {
+            $client->close();
+        }
+    }
 }
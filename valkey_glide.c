@@ -12,11 +12,26 @@
 #include "logger.h"          // Include logger functionality
 #include "logger_arginfo.h"  // Include logger functions arginfo - MUST BE LAST for ext_functions
 #include "valkey_glide_arginfo.h"          // Include generated arginfo header
+#include "valkey_glide_async.h"
+#include "valkey_glide_bitmap.h"
+#include "valkey_glide_bloom.h"
+#include "valkey_glide_breaker.h"
 #include "valkey_glide_cluster_arginfo.h"  // Include generated arginfo header
 #include "valkey_glide_commands_common.h"
 #include "valkey_glide_core_common.h"
+#include "valkey_glide_deadline.h"
+#include "valkey_glide_dictionary.h"
+#include "valkey_glide_fiber.h"
+#include "valkey_glide_hedge.h"
+#include "valkey_glide_hot_keys.h"
+#include "valkey_glide_memory.h"
+#include "valkey_glide_metrics.h"
+#include "valkey_glide_node_stats.h"
 #include "valkey_glide_pubsub_common.h"
 #include "valkey_glide_pubsub_introspection.h"
+#include "valkey_glide_rate_limiter.h"
+#include "valkey_glide_slowlog.h"
+#include "valkey_glide_stream.h"
 
 // FFI function declarations
 extern struct CommandResult* command(const void*          client_adapter_ptr,
@@ -72,6 +87,8 @@ static const size_t      SSL_PREFIX_LEN = 6;
 
 zend_class_entry* valkey_glide_ce;
 zend_class_entry* valkey_glide_exception_ce;
+zend_class_entry* valkey_glide_timeout_exception_ce;
+zend_class_entry* valkey_glide_circuit_open_exception_ce;
 
 zend_class_entry* valkey_glide_cluster_ce;
 
@@ -87,10 +104,27 @@ zend_class_entry* get_valkey_glide_exception_ce(void) {
     return valkey_glide_exception_ce;
 }
 
+zend_class_entry* get_valkey_glide_timeout_exception_ce(void) {
+    return valkey_glide_timeout_exception_ce;
+}
+
+zend_class_entry* get_valkey_glide_circuit_open_exception_ce(void) {
+    return valkey_glide_circuit_open_exception_ce;
+}
+
 zend_class_entry* get_valkey_glide_cluster_ce(void) {
     return valkey_glide_cluster_ce;
 }
 
+bool valkey_glide_refuse_shared(const valkey_glide_object* valkey_glide, const char* feature) {
+    if (!valkey_glide->shared_client) {
+        return false;
+    }
+    zend_throw_exception_ex(
+        get_valkey_glide_exception_ce(), 0, "%s is not supported on shared clients", feature);
+    return true;
+}
+
 void free_valkey_glide_object(zend_object* object);
 void free_valkey_glide_cluster_object(zend_object* object);
 PHP_METHOD(ValkeyGlide, __construct);
@@ -143,6 +177,12 @@ static HashTable* _get_advanced_config_ht(valkey_glide_php_common_constructor_pa
 static HashTable* _get_advanced_tls_config_ht(valkey_glide_php_common_constructor_params_t* params);
 
 static int  _determine_connection_timeout(valkey_glide_php_common_constructor_params_t* params);
+static bool _determine_async_completions(valkey_glide_php_common_constructor_params_t* params);
+static int  _determine_fiber_threads(valkey_glide_php_common_constructor_params_t* params);
+static zval* _determine_fiber_suspend(valkey_glide_php_common_constructor_params_t* params);
+static bool  _determine_shared_client(valkey_glide_php_common_constructor_params_t* params);
+static bool _determine_breaker_config(valkey_glide_php_common_constructor_params_t* params,
+                                      valkey_glide_breaker_config_t*                config);
 static bool _determine_use_insecure_tls(valkey_glide_php_common_constructor_params_t* params);
 static bool _determine_use_tls(valkey_glide_php_common_constructor_params_t* params);
 
@@ -486,6 +526,24 @@ int valkey_glide_build_client_config_base(valkey_glide_php_common_constructor_pa
             zend_throw_exception(get_valkey_glide_exception_ce(), error_msg, 0);
             return FAILURE;
         }
+
+        /* Parse dictionary_key (optional, trained zstd dictionaries) */
+        zval* dictionary_key_zv =
+            zend_hash_str_find(compression_ht,
+                               VALKEY_GLIDE_COMPRESSION_DICTIONARY_KEY,
+                               sizeof(VALKEY_GLIDE_COMPRESSION_DICTIONARY_KEY) - 1);
+        if (dictionary_key_zv && Z_TYPE_P(dictionary_key_zv) == IS_STRING &&
+            Z_STRLEN_P(dictionary_key_zv) > 0) {
+            if (config->compression_config->backend != VALKEY_GLIDE_COMPRESSION_BACKEND_ZSTD) {
+                valkey_glide_cleanup_client_config(config);
+                zend_throw_exception(get_valkey_glide_exception_ce(),
+                                     "dictionary_key requires the zstd compression backend",
+                                     0);
+                return FAILURE;
+            }
+            config->compression_config->dictionary_key =
+                estrndup(Z_STRVAL_P(dictionary_key_zv), Z_STRLEN_P(dictionary_key_zv));
+        }
     } else {
         config->compression_config = NULL;
     }
@@ -500,10 +558,60 @@ const zend_function_entry valkey_glide_cluster_methods[] = {
            arginfo_class_ValkeyGlideCluster___construct,
            ZEND_ACC_PUBLIC | ZEND_ACC_CTOR) PHP_FE_END};
 
+ZEND_DECLARE_MODULE_GLOBALS(valkey_glide)
+
+/**
+ * PHP_GINIT_FUNCTION, once per thread under ZTS
+ */
+static PHP_GINIT_FUNCTION(valkey_glide) {
+#if defined(COMPILE_DL_VALKEY_GLIDE) && defined(ZTS)
+    ZEND_TSRMLS_CACHE_UPDATE();
+#endif
+    zend_hash_init(&valkey_glide_globals->fiber_clients, 8, NULL, NULL, 1);
+    zend_hash_init(&valkey_glide_globals->slow_logs, 8, NULL, NULL, 1);
+    zend_hash_init(&valkey_glide_globals->node_stats, 8, NULL, NULL, 1);
+    zend_hash_init(&valkey_glide_globals->hedges, 8, NULL, NULL, 1);
+    zend_hash_init(&valkey_glide_globals->breakers, 8, NULL, NULL, 1);
+    zend_hash_init(
+        &valkey_glide_globals->breaker_nodes, 8, NULL, valkey_glide_breaker_node_dtor, 1);
+    zend_hash_init(&valkey_glide_globals->blooms, 8, NULL, NULL, 1);
+    zend_hash_init(&valkey_glide_globals->otel_spans, 8, NULL, NULL, 1);
+
+    /* Distinct per thread, xorshift must not start from 0 */
+    uint64_t seed = (uint64_t) (uintptr_t) valkey_glide_globals ^ (uint64_t) time(NULL);
+    valkey_glide_globals->otel_rng_state = (seed * 0x9E3779B97F4A7C15ULL) | 1;
+    valkey_glide_globals->otel_next_span       = 0;
+    valkey_glide_globals->otel_parent_span     = 0;
+    valkey_glide_globals->stream_aliases       = NULL;
+    valkey_glide_globals->read_from_client     = NULL;
+    valkey_glide_globals->deadline_client      = NULL;
+    valkey_glide_globals->deadline_next_client = NULL;
+}
+
+static PHP_GSHUTDOWN_FUNCTION(valkey_glide) {
+    zend_hash_destroy(&valkey_glide_globals->fiber_clients);
+    zend_hash_destroy(&valkey_glide_globals->slow_logs);
+    zend_hash_destroy(&valkey_glide_globals->node_stats);
+    zend_hash_destroy(&valkey_glide_globals->hedges);
+    zend_hash_destroy(&valkey_glide_globals->breakers);
+    zend_hash_destroy(&valkey_glide_globals->breaker_nodes);
+    zend_hash_destroy(&valkey_glide_globals->blooms);
+    zend_hash_destroy(&valkey_glide_globals->otel_spans);
+}
+
 /**
  * PHP_MINIT_FUNCTION
  */
 PHP_MINIT_FUNCTION(valkey_glide) {
+    /* Process-wide registries shared between threads */
+    valkey_glide_pubsub_startup();
+    valkey_glide_otel_startup();
+    valkey_glide_shared_clients_startup();
+
+    if (valkey_glide_stream_startup() == FAILURE) {
+        php_error_docref(NULL, E_WARNING, "Failed to register the valkey:// stream wrapper");
+    }
+
     /* Initialize the logger system early to prevent crashes */
     int logger_result = valkey_glide_logger_init("warn", NULL);
     if (logger_result != 0) {
@@ -524,6 +632,15 @@ PHP_MINIT_FUNCTION(valkey_glide) {
     /* Register ClusterScanCursor class */
     register_cluster_scan_cursor_class();
 
+    /* Register ValkeyGlideBitmap class */
+    register_valkey_glide_bitmap_class();
+
+    /* Register ValkeyGlideBloom class */
+    register_valkey_glide_bloom_class();
+
+    /* Register ValkeyGlideRateLimiter and ValkeyGlideRateLimitResult classes */
+    register_valkey_glide_rate_limiter_class();
+
     /* Register mock constructor class used for testing only. */
     register_mock_constructor_class();
 
@@ -533,6 +650,19 @@ PHP_MINIT_FUNCTION(valkey_glide) {
         php_error_docref(NULL, E_ERROR, "Failed to register ValkeyGlideException class");
         return FAILURE;
     }
+    valkey_glide_timeout_exception_ce =
+        register_class_ValkeyGlideTimeoutException(valkey_glide_exception_ce);
+    if (!valkey_glide_timeout_exception_ce) {
+        php_error_docref(NULL, E_ERROR, "Failed to register ValkeyGlideTimeoutException class");
+        return FAILURE;
+    }
+    valkey_glide_circuit_open_exception_ce =
+        register_class_ValkeyGlideCircuitOpenException(valkey_glide_exception_ce);
+    if (!valkey_glide_circuit_open_exception_ce) {
+        php_error_docref(
+            NULL, E_ERROR, "Failed to register ValkeyGlideCircuitOpenException class");
+        return FAILURE;
+    }
 
     /* Set object creation handlers */
     if (valkey_glide_ce) {
@@ -545,7 +675,15 @@ PHP_MINIT_FUNCTION(valkey_glide) {
     return SUCCESS;
 }
 
+PHP_RSHUTDOWN_FUNCTION(valkey_glide) {
+    valkey_glide_otel_request_shutdown();
+    valkey_glide_stream_request_shutdown();
+    return SUCCESS;
+}
+
 PHP_MSHUTDOWN_FUNCTION(valkey_glide) {
+    valkey_glide_stream_shutdown();
+    valkey_glide_shared_clients_shutdown();
     valkey_glide_pubsub_shutdown();
     return SUCCESS;
 }
@@ -556,24 +694,61 @@ zend_module_entry valkey_glide_module_entry = {STANDARD_MODULE_HEADER,
                                                PHP_MINIT(valkey_glide),
                                                PHP_MSHUTDOWN(valkey_glide),
                                                NULL,
-                                               NULL,
+                                               PHP_RSHUTDOWN(valkey_glide),
                                                NULL,
                                                VALKEY_GLIDE_PHP_VERSION,
-                                               STANDARD_MODULE_PROPERTIES};
+                                               PHP_MODULE_GLOBALS(valkey_glide),
+                                               PHP_GINIT(valkey_glide),
+                                               PHP_GSHUTDOWN(valkey_glide),
+                                               NULL,
+                                               STANDARD_MODULE_PROPERTIES_EX};
 
 #ifdef COMPILE_DL_VALKEY_GLIDE
+#ifdef ZTS
+ZEND_TSRMLS_CACHE_DEFINE()
+#endif
 ZEND_GET_MODULE(valkey_glide)
 #endif
 
 void free_valkey_glide_object(zend_object* object) {
     valkey_glide_object* valkey_glide = VALKEY_GLIDE_PHP_GET_OBJECT(valkey_glide_object, object);
 
-    /* Free the Valkey Glide client if it exists */
+    /* Stop the Fiber offload workers before the client they use goes away */
+    valkey_glide_fiber_detach(valkey_glide);
+    valkey_glide_slowlog_release(valkey_glide);
+    valkey_glide_node_stats_release(valkey_glide);
+    valkey_glide_hedge_release(valkey_glide);
+    valkey_glide_breaker_release(valkey_glide);
+    valkey_glide_dictionary_release(valkey_glide);
+
+    /* A pending withReadFrom() or withDeadline() must not carry over to a client reusing it */
+    if (valkey_glide->glide_client &&
+        VALKEY_GLIDE_G(read_from_client) == valkey_glide->glide_client) {
+        VALKEY_GLIDE_G(read_from_client) = NULL;
+    }
+    valkey_glide_deadline_release(valkey_glide->glide_client);
+
+    /* Free the Valkey Glide client if it exists, shared clients live until module shutdown */
     if (valkey_glide->glide_client) {
-        close_glide_client(valkey_glide->glide_client);
+        if (!valkey_glide->shared_client) {
+            close_glide_client(valkey_glide->glide_client);
+        }
         valkey_glide->glide_client = NULL;
     }
 
+    /* Free the callback-mode client used for asynchronous completions */
+    if (valkey_glide->async_ctx) {
+        valkey_glide_async_close(valkey_glide->async_ctx);
+        valkey_glide->async_ctx = NULL;
+    }
+
+    valkey_glide_hot_keys_destroy(valkey_glide->hot_keys);
+    valkey_glide->hot_keys = NULL;
+
+    valkey_glide_bloom_release(valkey_glide);
+
+    valkey_glide_metrics_release(valkey_glide);
+
     /* Clean up the standard object */
     zend_object_std_dtor(&valkey_glide->std);
 }
@@ -615,6 +790,9 @@ void valkey_glide_cleanup_client_config(valkey_glide_base_client_configuration_t
     }
 
     if (config->compression_config) {
+        if (config->compression_config->dictionary_key) {
+            efree(config->compression_config->dictionary_key);
+        }
         efree(config->compression_config);
         config->compression_config = NULL;
     }
@@ -821,27 +999,78 @@ static int valkey_glide_create_connection(valkey_glide_object* valkey_glide,
         return FAILURE;
     }
 
-    /* Issue the connection request. */
-    const ConnectionResponse* conn_resp = create_glide_client(&client_config);
+    if (client_config.advanced_config && client_config.advanced_config->shared_client) {
+        /* Reuse the process-wide client for this configuration */
+        valkey_glide->glide_client = create_shared_glide_client(&client_config);
 
-    /* Clean up temporary addresses array if we created it */
-    if (created_addresses) {
-        zval_ptr_dtor(&addresses_array);
-    }
+        if (created_addresses) {
+            zval_ptr_dtor(&addresses_array);
+        }
+
+        if (!valkey_glide->glide_client) {
+            valkey_glide_cleanup_client_config(&client_config);
+            return FAILURE;
+        }
+        valkey_glide->shared_client = true;
+    } else {
+        /* Issue the connection request. */
+        const ConnectionResponse* conn_resp = create_glide_client(&client_config);
+
+        /* Clean up temporary addresses array if we created it */
+        if (created_addresses) {
+            zval_ptr_dtor(&addresses_array);
+        }
+
+        if (conn_resp->connection_error_message) {
+            VALKEY_LOG_ERROR("valkey_glide_create_connection",
+                             conn_resp->connection_error_message);
+            zend_throw_exception(
+                get_valkey_glide_exception_ce(), conn_resp->connection_error_message, 0);
+            free_connection_response((ConnectionResponse*) conn_resp);
+            valkey_glide_cleanup_client_config(&client_config);
+            return FAILURE;
+        }
+
+        VALKEY_LOG_INFO("valkey_glide_create_connection",
+                        "ValkeyGlide client connected successfully");
+        valkey_glide->glide_client = conn_resp->conn_ptr;
 
-    if (conn_resp->connection_error_message) {
-        VALKEY_LOG_ERROR("valkey_glide_create_connection", conn_resp->connection_error_message);
-        zend_throw_exception(
-            get_valkey_glide_exception_ce(), conn_resp->connection_error_message, 0);
         free_connection_response((ConnectionResponse*) conn_resp);
+    }
+
+    /* Create the callback-mode client for submit()/poll() if requested */
+    if (client_config.advanced_config && client_config.advanced_config->async_completions &&
+        valkey_glide_async_attach(valkey_glide, create_glide_async_client(&client_config)) ==
+            FAILURE) {
         valkey_glide_cleanup_client_config(&client_config);
         return FAILURE;
     }
 
-    VALKEY_LOG_INFO("valkey_glide_create_connection", "ValkeyGlide client connected successfully");
-    valkey_glide->glide_client = conn_resp->conn_ptr;
+    /* Start the worker pool for Fiber-aware execution if requested */
+    if (client_config.advanced_config && client_config.advanced_config->fiber_threads != 0 &&
+        valkey_glide_fiber_attach(valkey_glide,
+                                  client_config.advanced_config->fiber_threads,
+                                  client_config.advanced_config->fiber_suspend) == FAILURE) {
+        valkey_glide_cleanup_client_config(&client_config);
+        return FAILURE;
+    }
 
-    free_connection_response((ConnectionResponse*) conn_resp);
+    /* Gate calls with circuit breakers and a retry budget if requested */
+    if (client_config.advanced_config &&
+        (client_config.advanced_config->breaker.failures != 0 ||
+         client_config.advanced_config->breaker.retry_window_ms != 0)) {
+        valkey_glide_breaker_attach(
+            valkey_glide, &client_config.advanced_config->breaker, &client_config.addresses[0]);
+    }
+
+    /* Load the trained compression dictionaries if requested */
+    if (client_config.compression_config && client_config.compression_config->enabled &&
+        client_config.compression_config->dictionary_key &&
+        valkey_glide_dictionary_attach(valkey_glide, client_config.compression_config) ==
+            FAILURE) {
+        valkey_glide_cleanup_client_config(&client_config);
+        return FAILURE;
+    }
 
     /* Clean up temporary configuration structures */
     valkey_glide_cleanup_client_config(&client_config);
@@ -1012,6 +1241,70 @@ PHP_METHOD(ValkeyGlide, close) {
 GET_STATISTICS_METHOD_IMPL(ValkeyGlide)
 /* }}} */
 
+/* {{{ proto int ValkeyGlide::submit(string command [, mixed args ...]) */
+SUBMIT_METHOD_IMPL(ValkeyGlide)
+/* }}} */
+
+/* {{{ proto array ValkeyGlide::poll([int max]) */
+POLL_METHOD_IMPL(ValkeyGlide)
+/* }}} */
+
+/* {{{ proto resource ValkeyGlide::getCompletionFd() */
+GET_COMPLETION_FD_METHOD_IMPL(ValkeyGlide)
+/* }}} */
+
+/* {{{ proto bool ValkeyGlide::registerStreamAlias(string alias) */
+REGISTER_STREAM_ALIAS_METHOD_IMPL(ValkeyGlide)
+/* }}} */
+
+/* {{{ proto array ValkeyGlide::getHotKeys([int n]) */
+GET_HOT_KEYS_METHOD_IMPL(ValkeyGlide)
+/* }}} */
+
+/* {{{ proto array ValkeyGlide::getSlowLog() */
+GET_SLOW_LOG_METHOD_IMPL(ValkeyGlide)
+/* }}} */
+
+/* {{{ proto bool ValkeyGlide::resetSlowLog() */
+RESET_SLOW_LOG_METHOD_IMPL(ValkeyGlide)
+/* }}} */
+
+/* {{{ proto array ValkeyGlide::getNodeStats() */
+GET_NODE_STATS_METHOD_IMPL(ValkeyGlide)
+/* }}} */
+
+/* {{{ proto array ValkeyGlide::getBreakerStats() */
+GET_BREAKER_STATS_METHOD_IMPL(ValkeyGlide)
+/* }}} */
+
+/* {{{ proto int ValkeyGlide::trainCompressionDictionary(array $samples, int $size = 16384) */
+TRAIN_COMPRESSION_DICTIONARY_METHOD_IMPL(ValkeyGlide)
+/* }}} */
+
+/* {{{ proto int ValkeyGlide::loadCompressionDictionaries() */
+LOAD_COMPRESSION_DICTIONARIES_METHOD_IMPL(ValkeyGlide)
+/* }}} */
+
+/* {{{ proto array ValkeyGlide::getMemoryStats() */
+GET_MEMORY_STATS_METHOD_IMPL(ValkeyGlide)
+/* }}} */
+
+/* {{{ proto bool ValkeyGlide::setBloomFilter(?ValkeyGlideBloom bloom) */
+SET_BLOOM_FILTER_METHOD_IMPL(ValkeyGlide)
+/* }}} */
+
+/* {{{ proto ?ValkeyGlideBloom ValkeyGlide::getBloomFilter() */
+GET_BLOOM_FILTER_METHOD_IMPL(ValkeyGlide)
+/* }}} */
+
+/* {{{ proto array ValkeyGlide::metricsSnapshot([array fields]) */
+METRICS_SNAPSHOT_METHOD_IMPL(ValkeyGlide)
+/* }}} */
+
+/* {{{ proto mixed ValkeyGlide::withDeadline(int ms [, callable callback]) */
+WITH_DEADLINE_METHOD_IMPL(ValkeyGlide)
+/* }}} */
+
 PHP_METHOD(ValkeyGlide, setOtelSamplePercentage) {
     zend_long percentage;
 
@@ -1033,6 +1326,48 @@ PHP_METHOD(ValkeyGlide, getOtelSamplePercentage) {
 }
 /* }}} */
 
+/* {{{ proto int|false ValkeyGlide::startOtelSpan(string $name) */
+PHP_METHOD(ValkeyGlide, startOtelSpan) {
+    char*  name;
+    size_t name_len;
+
+    ZEND_PARSE_PARAMETERS_START(1, 1)
+    Z_PARAM_STRING(name, name_len)
+    ZEND_PARSE_PARAMETERS_END();
+
+    zend_long handle = valkey_glide_otel_start_span(name);
+    if (handle == 0) {
+        RETURN_FALSE;
+    }
+    RETURN_LONG(handle);
+}
+/* }}} */
+
+/* {{{ proto bool ValkeyGlide::endOtelSpan(int $span) */
+PHP_METHOD(ValkeyGlide, endOtelSpan) {
+    zend_long handle;
+
+    ZEND_PARSE_PARAMETERS_START(1, 1)
+    Z_PARAM_LONG(handle)
+    ZEND_PARSE_PARAMETERS_END();
+
+    RETURN_BOOL(valkey_glide_otel_end_span(handle));
+}
+/* }}} */
+
+/* {{{ proto bool ValkeyGlide::setOtelParentSpan(?int $span) */
+PHP_METHOD(ValkeyGlide, setOtelParentSpan) {
+    zend_long handle      = 0;
+    bool      handle_null = true;
+
+    ZEND_PARSE_PARAMETERS_START(1, 1)
+    Z_PARAM_LONG_OR_NULL(handle, handle_null)
+    ZEND_PARSE_PARAMETERS_END();
+
+    RETURN_BOOL(valkey_glide_otel_set_parent_span(handle_null ? 0 : handle));
+}
+/* }}} */
+
 /* {{{ proto string ValkeyGlide::updateConnectionPassword(string $password, bool $immediateAuth =
  * false)
  */
@@ -1458,6 +1793,184 @@ static int _determine_connection_timeout(valkey_glide_php_common_constructor_par
     return Z_LVAL_P(conn_timeout_val);
 }
 
+/**
+ * Determines whether asynchronous completions are requested in the given constructor parameters.
+ *
+ * @param params Pointer to the common constructor parameters structure.
+ * @return       true if a callback-mode client should be created, false otherwise.
+ */
+static bool _determine_async_completions(valkey_glide_php_common_constructor_params_t* params) {
+    HashTable* advanced_config_ht = _get_advanced_config_ht(params);
+    if (!advanced_config_ht) {
+        return false;
+    }
+
+    zval* async_val = zend_hash_str_find(advanced_config_ht,
+                                         VALKEY_GLIDE_ASYNC_COMPLETIONS,
+                                         sizeof(VALKEY_GLIDE_ASYNC_COMPLETIONS) - 1);
+    return async_val && zval_is_true(async_val);
+}
+
+/**
+ * Determines the number of Fiber offload worker threads from the given constructor parameters.
+ *
+ * @param params Pointer to the common constructor parameters structure.
+ * @return       0 if fiber_aware is not enabled, the requested thread count otherwise.
+ */
+static int _determine_fiber_threads(valkey_glide_php_common_constructor_params_t* params) {
+    HashTable* advanced_config_ht = _get_advanced_config_ht(params);
+    if (!advanced_config_ht) {
+        return 0;
+    }
+
+    zval* fiber_val = zend_hash_str_find(
+        advanced_config_ht, VALKEY_GLIDE_FIBER_AWARE, sizeof(VALKEY_GLIDE_FIBER_AWARE) - 1);
+    if (!fiber_val) {
+        return 0;
+    }
+
+    if (Z_TYPE_P(fiber_val) == IS_LONG) {
+        /* Out of range counts are rejected when the pool is started */
+        zend_long threads = Z_LVAL_P(fiber_val);
+        return threads < 0 ? -1 : (int) MIN(threads, VALKEY_GLIDE_FIBER_MAX_THREADS + 1);
+    }
+
+    return zval_is_true(fiber_val) ? VALKEY_GLIDE_FIBER_DEFAULT_THREADS : 0;
+}
+
+/**
+ * Determines the callable a Fiber waiting on a command suspends itself with, given a stream
+ * becoming readable once the reply is available.
+ *
+ * @param params Pointer to the common constructor parameters structure.
+ * @return       The fiber_suspend entry, NULL if not set.
+ */
+static zval* _determine_fiber_suspend(valkey_glide_php_common_constructor_params_t* params) {
+    HashTable* advanced_config_ht = _get_advanced_config_ht(params);
+    if (!advanced_config_ht) {
+        return NULL;
+    }
+
+    zval* suspend_val = zend_hash_str_find(
+        advanced_config_ht, VALKEY_GLIDE_FIBER_SUSPEND, sizeof(VALKEY_GLIDE_FIBER_SUSPEND) - 1);
+    return suspend_val && Z_TYPE_P(suspend_val) != IS_NULL ? suspend_val : NULL;
+}
+
+/**
+ * Determines whether the process-wide shared client is requested in the given constructor
+ * parameters.
+ *
+ * @param params Pointer to the common constructor parameters structure.
+ * @return       true if the client should be shared between threads, false otherwise.
+ */
+static bool _determine_shared_client(valkey_glide_php_common_constructor_params_t* params) {
+    HashTable* advanced_config_ht = _get_advanced_config_ht(params);
+    if (!advanced_config_ht) {
+        return false;
+    }
+
+    zval* shared_val = zend_hash_str_find(advanced_config_ht,
+                                          VALKEY_GLIDE_SHARED_CLIENT,
+                                          sizeof(VALKEY_GLIDE_SHARED_CLIENT) - 1);
+    return shared_val && zval_is_true(shared_val);
+}
+
+/**
+ * Reads a numeric entry of a circuit_breaker or retry_budget array, keeping the default in value
+ * when the entry is absent.
+ *
+ * @param ht    The configuration array.
+ * @param name  The entry name.
+ * @param min   The lowest value accepted.
+ * @param max   The highest value accepted.
+ * @param value The default, replaced by the entry.
+ * @return      false if the entry isn't a number within [min, max], true otherwise.
+ */
+static bool _breaker_option(
+    HashTable* ht, const char* name, double min, double max, double* value) {
+    zval* val = zend_hash_str_find(ht, name, strlen(name));
+    if (!val) {
+        return true;
+    }
+    if (Z_TYPE_P(val) != IS_LONG && Z_TYPE_P(val) != IS_DOUBLE) {
+        return false;
+    }
+
+    double number = zval_get_double(val);
+    if (number < min || number > max) {
+        return false;
+    }
+    *value = number;
+    return true;
+}
+
+/**
+ * Determines the circuit breaker and retry budget settings from the given constructor
+ * parameters. Each is enabled by true, for the defaults, or by an array overriding them.
+ * Throws an exception if either is invalid.
+ *
+ * @param params Pointer to the common constructor parameters structure.
+ * @param config The settings to fill, left zeroed for what isn't enabled.
+ * @return       false if an exception was thrown, true otherwise.
+ */
+static bool _determine_breaker_config(valkey_glide_php_common_constructor_params_t* params,
+                                      valkey_glide_breaker_config_t*                config) {
+    memset(config, 0, sizeof(valkey_glide_breaker_config_t));
+
+    HashTable* advanced_config_ht = _get_advanced_config_ht(params);
+    if (!advanced_config_ht) {
+        return true;
+    }
+
+    zval* breaker_val = zend_hash_str_find(advanced_config_ht,
+                                           VALKEY_GLIDE_CIRCUIT_BREAKER,
+                                           sizeof(VALKEY_GLIDE_CIRCUIT_BREAKER) - 1);
+    if (breaker_val && Z_TYPE_P(breaker_val) != IS_NULL && Z_TYPE_P(breaker_val) != IS_FALSE) {
+        double failures = 5;
+        double open_ms  = 5000;
+
+        HashTable* ht    = Z_TYPE_P(breaker_val) == IS_ARRAY ? Z_ARRVAL_P(breaker_val) : NULL;
+        bool       valid = ht ? _breaker_option(ht, "failures", 1, INT_MAX, &failures) &&
+                                    _breaker_option(ht, "open_ms", 1, INT_MAX, &open_ms)
+                              : Z_TYPE_P(breaker_val) == IS_TRUE;
+        if (!valid) {
+            zend_throw_exception(get_valkey_glide_exception_ce(),
+                                 "circuit_breaker must be true or an array with 'failures' and "
+                                 "'open_ms' of at least 1",
+                                 0);
+            return false;
+        }
+        config->failures = (int) failures;
+        config->open_ms  = (int) open_ms;
+    }
+
+    zval* budget_val = zend_hash_str_find(
+        advanced_config_ht, VALKEY_GLIDE_RETRY_BUDGET, sizeof(VALKEY_GLIDE_RETRY_BUDGET) - 1);
+    if (budget_val && Z_TYPE_P(budget_val) != IS_NULL && Z_TYPE_P(budget_val) != IS_FALSE) {
+        double ratio       = 0.1;
+        double window_ms   = 10000;
+        double min_retries = 3;
+
+        HashTable* ht    = Z_TYPE_P(budget_val) == IS_ARRAY ? Z_ARRVAL_P(budget_val) : NULL;
+        bool       valid = ht ? _breaker_option(ht, "ratio", 0, 1, &ratio) &&
+                                    _breaker_option(ht, "window_ms", 1, INT_MAX, &window_ms) &&
+                                    _breaker_option(ht, "min_retries", 0, INT_MAX, &min_retries)
+                              : Z_TYPE_P(budget_val) == IS_TRUE;
+        if (!valid) {
+            zend_throw_exception(get_valkey_glide_exception_ce(),
+                                 "retry_budget must be true or an array with a 'ratio' between 0 "
+                                 "and 1, 'window_ms' of at least 1 and 'min_retries' of at least 0",
+                                 0);
+            return false;
+        }
+        config->retry_ratio     = ratio;
+        config->retry_window_ms = (int) window_ms;
+        config->min_retries     = (int) min_retries;
+    }
+
+    return true;
+}
+
 /**
  * Determines whether to use TLS from the given constructor parameters.
  *
@@ -1602,6 +2115,44 @@ static valkey_glide_advanced_base_client_configuration_t* _build_advanced_config
         ecalloc(1, sizeof(valkey_glide_advanced_base_client_configuration_t));
 
     advanced_config->connection_timeout = _determine_connection_timeout(params);
+    advanced_config->async_completions  = _determine_async_completions(params);
+    advanced_config->fiber_threads      = _determine_fiber_threads(params);
+    advanced_config->fiber_suspend      = _determine_fiber_suspend(params);
+    advanced_config->shared_client      = _determine_shared_client(params);
+
+    if (advanced_config->fiber_suspend &&
+        (advanced_config->fiber_threads == 0 ||
+         !zend_is_callable(advanced_config->fiber_suspend, 0, NULL))) {
+        zend_throw_exception(get_valkey_glide_exception_ce(),
+                             "fiber_suspend must be a callable, used along with fiber_aware",
+                             0);
+        efree(advanced_config);
+        return NULL;
+    }
+
+    /* Fiber offload pools are keyed by glide client, which must then be private to the object */
+    if (advanced_config->shared_client && advanced_config->fiber_threads != 0) {
+        zend_throw_exception(get_valkey_glide_exception_ce(),
+                             "fiber_aware cannot be combined with shared_client",
+                             0);
+        efree(advanced_config);
+        return NULL;
+    }
+
+    if (!_determine_breaker_config(params, &advanced_config->breaker)) {
+        efree(advanced_config);
+        return NULL;
+    }
+
+    /* So are circuit breakers, a sharer's failures would open them for every other */
+    if (advanced_config->shared_client && advanced_config->breaker.failures != 0) {
+        zend_throw_exception(get_valkey_glide_exception_ce(),
+                             "circuit_breaker cannot be combined with shared_client",
+                             0);
+        efree(advanced_config);
+        return NULL;
+    }
+
     advanced_config->tls_config         = _build_advanced_tls_config(params, is_cluster);
 
     /* If TLS config build failed (exception thrown), clean up and return NULL */
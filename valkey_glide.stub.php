@@ -337,6 +337,66 @@ class ValkeyGlide
      */
     public const OPT_REPLY_LITERAL = UNKNOWN;
 
+    /**
+     * Runtime option: Deduplicate identical reads in pipelines
+     * When enabled, identical read-only commands (same command and arguments) queued in a
+     * pipeline without a write in between are sent once, and the reply is returned in every
+     * position they were queued at. MULTI transactions are always sent verbatim.
+     *
+     * @var int
+     * @cvalue VALKEY_GLIDE_OPT_PIPELINE_DEDUPE
+     *
+     */
+    public const OPT_PIPELINE_DEDUPE = UNKNOWN;
+
+    /**
+     * Runtime option: Hot-key sampling rate
+     * Fraction of commands, between 0 and 1, whose key is fed to the hot-key detector read
+     * with getHotKeys(). 0 (the default) turns the detector off. Setting a rate starts over.
+     *
+     * @var int
+     * @cvalue VALKEY_GLIDE_OPT_HOT_KEY_SAMPLING
+     *
+     */
+    public const OPT_HOT_KEY_SAMPLING = UNKNOWN;
+
+    /**
+     * Runtime option: Slow log threshold
+     * Commands and batches taking at least this many microseconds, measured around the call
+     * into the client core, are recorded for getSlowLog(). 0 records every call, a negative
+     * value (the default) turns recording off.
+     *
+     * @var int
+     * @cvalue VALKEY_GLIDE_OPT_SLOWLOG_THRESHOLD
+     *
+     */
+    public const OPT_SLOWLOG_THRESHOLD = UNKNOWN;
+
+    /**
+     * Runtime option: Columnar results
+     * When enabled, GEOSEARCH with WITH* options, ZRANGE-style WITHSCORES, XRANGE/XREVRANGE and
+     * the extended form of XPENDING return one packed array per field instead of one array per
+     * row, e.g. ['member' => [...], 'dist' => [...], 'lon' => [...], 'lat' => [...]].
+     *
+     * @var int
+     * @cvalue VALKEY_GLIDE_OPT_COLUMNAR
+     *
+     */
+    public const OPT_COLUMNAR = UNKNOWN;
+
+    /**
+     * Runtime option: Per-node statistics
+     * When enabled, every command is timed and counted against the node serving its key, for
+     * getNodeStats(). Cluster clients keep two small counter sets per node and a 32KB map of
+     * the node serving each hash slot, looked up when it is enabled.
+     * Disabling it discards the statistics.
+     *
+     * @var int
+     * @cvalue VALKEY_GLIDE_OPT_NODE_STATS
+     *
+     */
+    public const OPT_NODE_STATS = UNKNOWN;
+
     /**
      * Create a new ValkeyGlide instance with the provided configuration.
      *
@@ -371,10 +431,42 @@ class ValkeyGlide
      * @param int|null $database_id Database number (0-15 for standalone)
      * @param string|null $client_name Client identifier for debugging
      * @param string|null $client_az Availability zone for routing
-     * @param array|null $advanced_config Advanced TLS/connection settings
+     * @param array|null $advanced_config Advanced TLS/connection settings. Set 'async_completions' => true to
+     *                                     enable submit(), poll() and getCompletionFd(). Set 'fiber_aware' => true
+     *                                     (or a worker thread count, default 16) so that commands issued inside a
+     *                                     Fiber suspend it instead of blocking; poll() must then be called to
+     *                                     resume it once the reply is available. To have an event loop (Revolt,
+     *                                     Amp, ReactPHP) resume it instead, set 'fiber_suspend' to a callable
+     *                                     taking a stream that becomes readable once the reply is available, and
+     *                                     returning once it is, e.g. with Revolt:
+     *                                     fn($stream) => { $s = EventLoop::getSuspension();
+     *                                     $id = EventLoop::onReadable($stream, fn() => $s->resume());
+     *                                     $s->suspend(); EventLoop::cancel($id); }
+     *                                     It is called again if it returns earlier.
+     *                                     Offloaded commands run on the synchronous client from a pool of
+     *                                     worker threads started by connect() and joined by close(), one
+     *                                     command per thread: at most that many commands are in flight per
+     *                                     client, further Fibers wait for a free thread.
+     *                                     Set 'shared_client' => true to reuse a single multiplexed client per
+     *                                     process for identical configurations, across all threads of ZTS builds.
+     *                                     Shared clients stay connected until the process exits; they do not
+     *                                     support subscriptions, fiber_aware, circuit_breaker, select(),
+     *                                     withDeadline(), setBloomFilter(), OPT_SLOWLOG_THRESHOLD or
+     *                                     OPT_NODE_STATS, whose state every user of the client would see.
+     *                                     Set 'circuit_breaker' => ['failures' => 5, 'open_ms' => 5000] (or true
+     *                                     for these defaults) to fail calls fast with
+     *                                     ValkeyGlideCircuitOpenException after that many timeouts or lost
+     *                                     connections in a row, until a probe succeeds once open_ms has
+     *                                     passed; breakers outlive the request. Set 'retry_budget' =>
+     *                                     ['ratio' => 0.1, 'window_ms' => 10000, 'min_retries' => 3] (or true)
+     *                                     to send reads failing that way once more, within ratio of the
+     *                                     requests of each window. See getBreakerStats().
      * @param bool|null $lazy_connect Defer connection until first command (default: false)
      * @param resource|array|null $context Stream context resource or array for TLS configuration
      * @param array|null $compression Compression configuration: ['enabled' => true, 'backend' => COMPRESSION_BACKEND_ZSTD, 'compression_level' => 3, 'min_compression_size' => 64]
+     *                               Add 'dictionary_key' => 'app:zstd-dicts' to compress with the dictionaries
+     *                               trained by trainCompressionDictionary() and stored in that hash, loaded
+     *                               when first needed. Requires the ZSTD backend and libzstd at build time.
      * @return bool True on successful connection, false on failure
      *
      * @throws ValkeyGlideException If conflicting parameters are specified or connection fails
@@ -640,6 +732,398 @@ class ValkeyGlide
      */
     public function getStatistics(): array;
 
+    /**
+     * Submit a raw command without waiting for its reply.
+     *
+     * Requires `advanced_config: ['async_completions' => true]` when connecting, which creates an
+     * additional callback-mode client alongside the regular one. The reply is collected later with
+     * poll(), keyed by the returned request id.
+     *
+     * @param string $command The command name, e.g. 'GET'.
+     * @param mixed  $args    The command arguments.
+     *
+     * @return int|false The request id.
+     *
+     * @throws ValkeyGlideException If asynchronous completions are not enabled or the command
+     *                              could not be sent.
+     *
+     * @example
+     * $id = $client->submit('GET', 'key');
+     */
+    public function submit(string $command, mixed ...$args): int|false;
+
+    /**
+     * Drain replies of commands sent with submit().
+     *
+     * Never blocks. Failed commands are returned as ValkeyGlideException instances rather than thrown.
+     *
+     * On fiber_aware clients, Fibers waiting on a command are resumed from here as their replies
+     * arrive; they are not part of the returned array. Fibers are resumed before replies are
+     * collected, so if one throws, the exception propagates and the remaining replies are kept
+     * for the next call.
+     *
+     * @param int $max The maximum number of replies to return, 0 for all available ones.
+     *
+     * @return array|false An array of request id => reply.
+     *
+     * @throws ValkeyGlideException If asynchronous completions are not enabled.
+     * @throws Throwable           Whatever a resumed Fiber throws.
+     */
+    public function poll(int $max = 0): array|false;
+
+    /**
+     * Get a stream that becomes readable whenever poll() has replies to return.
+     *
+     * The stream is meant to be watched by an event loop (stream_select(), ReactPHP, Amp, Revolt,
+     * Swoole, ...), it should not be read from directly.
+     *
+     * @return resource|false A non-blocking stream resource.
+     *
+     * @throws ValkeyGlideException If asynchronous completions are not enabled.
+     *
+     * @example
+     * $fd = $client->getCompletionFd();
+     * Loop::onReadable($fd, function () use ($client) {
+     *     foreach ($client->poll() as $id => $reply) {
+     *         // ...
+     *     }
+     * });
+     */
+    public function getCompletionFd(): mixed;
+
+    /**
+     * Make this client reachable through the valkey:// stream wrapper.
+     *
+     * `valkey://<alias>/<key>` then opens the string value stored at the rawurlencoded <key> as a
+     * stream. Reads use windowed GETRANGE calls and writes use SET, APPEND or SETRANGE one chunk at a
+     * time, so values can be copied from or to files and sockets in constant memory. Reads prefetch
+     * the next windows in the background. Values aren't read atomically: a value modified while it
+     * is being read may be returned partially updated.
+     *
+     * Supported modes:
+     *   - 'r': read
+     *   - 'w': replace the value
+     *   - 'a': append to the value
+     *   - 'c': overwrite in place from the current position (seekable, SETRANGE)
+     *
+     * Context options, under 'valkey':
+     *   - 'client': a client to use instead of the alias in the URL
+     *   - 'chunk_size': bytes per command (1 KiB - 512 MiB, default 1 MiB)
+     *   - 'read_ahead': windows fetched ahead of the reader, 0 to disable (0 - 64, default 2)
+     *
+     * The alias keeps a reference to the client until the end of the request.
+     *
+     * @param string $alias The host part of valkey:// URLs to associate with this client.
+     *
+     * @return bool True on success.
+     *
+     * @throws ValkeyGlideException If the alias is empty or contains '/'.
+     *
+     * @example
+     * $client->registerStreamAlias('cache');
+     * $in = fopen('valkey://cache/' . rawurlencode('backup:2024'), 'r');
+     * $out = fopen('/tmp/backup.bin', 'w');
+     * stream_copy_to_stream($in, $out);
+     * unlink('valkey://cache/' . rawurlencode('backup:2024'));
+     */
+    public function registerStreamAlias(string $alias): bool;
+
+    /**
+     * Report the keys this client sends the most commands to.
+     *
+     * Requires OPT_HOT_KEY_SAMPLING. Sampled commands count towards their key in a count-min
+     * sketch, and the keys with the highest counts are tracked. Counts and request bytes are
+     * estimates, scaled back by the sampling rate, and can overestimate keys that share sketch
+     * cells with hotter ones. Cluster clients also report the busiest hash slots.
+     *
+     * @param int $n The number of keys (and slots) to return, at most 64.
+     *
+     * @return array|false An array with 'sample_rate', 'samples', 'keys' (a list of arrays with
+     *                     'key', 'count' and 'bytes', hottest first) and, for cluster clients,
+     *                     'slots' (arrays with 'count' and 'bytes', keyed by slot). False when
+     *                     sampling is off.
+     *
+     * @throws ValkeyGlideException If $n is less than 1.
+     *
+     * @example
+     * $client->setOption(ValkeyGlide::OPT_HOT_KEY_SAMPLING, 0.01);
+     * // ... serve traffic ...
+     * foreach ($client->getHotKeys(5)['keys'] as $hot) {
+     *     printf("%s: ~%d commands, ~%d bytes\n", $hot['key'], $hot['count'], $hot['bytes']);
+     * }
+     */
+    public function getHotKeys(int $n = 10): array|false;
+
+    /**
+     * Return the slowest commands recorded by this client since the last resetSlowLog().
+     *
+     * Requires OPT_SLOWLOG_THRESHOLD. The 128 slowest calls of the last 10 minutes are kept: a
+     * call faster than all of them once full isn't recorded, and entries older than 10 minutes
+     * are dropped so that a past spike doesn't hide later slow calls. Unlike the server's SLOWLOG,
+     * durations include network round trips and queueing inside the client. Keys are truncated
+     * to 64 bytes and up to 4 further arguments to 32 bytes, like "abc... (N more bytes)".
+     *
+     * @return array|false Entries, slowest first, with:
+     *                     - 'id': increasing entry number
+     *                     - 'timestamp': Unix time the call returned, as a float
+     *                     - 'duration_us': wall time of the call in microseconds
+     *                     - 'command': the command name, such as 'GET' or 'CLIENT GETNAME', or
+     *                       'MULTI' / 'PIPELINE'
+     *                     - 'key': the first argument, the key of keyed commands
+     *                     - 'args', 'arg_count': further arguments, for single commands
+     *                     - 'commands': the number of commands, for batches
+     *                     - 'arg_bytes', 'reply_bytes': request and reply payload sizes
+     *                     - 'failed': whether the call returned an error
+     *                     - 'route': 'default', a slot, a node address or a fan-out route
+     *                     - 'fingerprint': hash of the command and all of its arguments
+     *                     False when recording is off.
+     *
+     * @example
+     * $client->setOption(ValkeyGlide::OPT_SLOWLOG_THRESHOLD, 10000); // 10ms
+     * foreach ($client->getSlowLog() as $entry) {
+     *     error_log(sprintf('%dus %s', $entry['duration_us'], $entry['key']));
+     * }
+     */
+    public function getSlowLog(): array|false;
+
+    /**
+     * Clear the entries recorded for getSlowLog().
+     *
+     * @return bool True on success, false when recording is off.
+     */
+    public function resetSlowLog(): bool;
+
+    /**
+     * Report request counts and latencies by node.
+     *
+     * Requires OPT_NODE_STATS. Times are measured around the call into the client core, so they
+     * include the network and the client's own queueing. Cluster clients count each command
+     * against the primary serving the hash slot of its key, as of the last CLUSTER SLOTS lookup:
+     * one is made when recording starts and again by each call of this method. Reads sent to a
+     * replica, with withReadFrom() or won by a hedged read, are counted under 'replicas' of the
+     * slot's primary. Commands without a single key, such as fan-outs, are reported under ''.
+     * Standalone clients report a single 'default' entry.
+     *
+     * @return array|false An array keyed by node address, false when recording is off. Each
+     *                     entry has:
+     *                     - 'role': 'primary', or null for a node that no longer serves slots
+     *                     - 'slots': the hash slots the node serves
+     *                     - 'requests': the commands sent
+     *                     - 'errors': the commands that failed, including the two below
+     *                     - 'timeouts': the commands that timed out
+     *                     - 'disconnects': the commands that failed on a lost connection
+     *                     - 'rtt_avg_us': the moving average round trip, in microseconds
+     *                     - 'rtt_p99_us': the 99th percentile round trip, to a power of two
+     *                     Cluster nodes also have 'replicas', the same counters from 'requests'
+     *                     on for the reads their replicas served.
+     *
+     * @example
+     * $client->setOption(ValkeyGlide::OPT_NODE_STATS, true);
+     * foreach ($client->getNodeStats() as $node => $stats) {
+     *     if ($stats['rtt_p99_us'] > 10000) {
+     *         error_log("$node is slow");
+     *     }
+     * }
+     */
+    public function getNodeStats(): array|false;
+
+    /**
+     * Report the circuit breakers and the retry budget.
+     *
+     * Requires 'circuit_breaker' or 'retry_budget' in advanced_config. Cluster clients keep a
+     * breaker per primary, learnt from CLUSTER SLOTS on their first keyed call and again after
+     * a breaker opens; calls without a single key aren't gated. Standalone clients keep a
+     * single breaker, named by their first address.
+     *
+     * The breakers are kept by the PHP process (by the thread under ZTS) across requests, and
+     * shared by its clients going to the same node, so a node that tripped in one request stays
+     * open for the next ones; each FPM worker still learns about a failing node from its own
+     * calls. The counters of the nodes are process-wide too. 'requests', 'retries' and
+     * 'retries_denied', and the retry budget itself, belong to this client object.
+     *
+     * @return array|false ['requests' => int, 'retries' => int, 'retries_denied' => int,
+     *                     'nodes' => array], false when neither is configured. 'nodes' is keyed
+     *                     by node address, each entry having:
+     *                     - 'state': 'closed', 'open' or 'half_open' while a probe is in flight
+     *                     - 'failures': the timeouts and lost connections in a row
+     *                     - 'trips': the times the breaker opened
+     *                     - 'rejected': the calls failed fast while it was open
+     *
+     * @example
+     * $client = new ValkeyGlide(addresses: [['host' => 'localhost', 'port' => 6379]],
+     *                           advanced_config: ['circuit_breaker' => true, 'retry_budget' => true]);
+     * try {
+     *     $value = $client->get('key');
+     * } catch (ValkeyGlideCircuitOpenException $e) {
+     *     $value = $fallback;
+     * }
+     * print_r($client->getBreakerStats()['nodes']);
+     */
+    public function getBreakerStats(): array|false;
+
+    /**
+     * Train a zstd dictionary for compressing small values and make it the current one.
+     *
+     * Requires 'dictionary_key' in the compression configuration. Values that are small and
+     * alike, such as JSON documents of the same shape, compress poorly on their own; a
+     * dictionary trained from a representative sample of them holds what they share. The
+     * dictionary is stored in the hash at dictionary_key under its ID, which becomes the
+     * 'current' one, and SET, SETEX, PSETEX, SETNX, GETSET, MSET and MSETNX compress the values
+     * of at least min_compression_size bytes with it from then on, keeping those that don't
+     * shrink as they are. Until a dictionary is trained they use plain zstd. GET, MGET and the
+     * GET option of SET decompress them; other commands see the compressed bytes. With
+     * dictionary_key set, no other command compresses its values, and the values compressed
+     * before it was set are still read.
+     *
+     * Compressed values start with a tag naming the dictionary, so values written before a new
+     * dictionary was trained are still read, and values stored by other means, zstd frames
+     * included, are returned as they are. Other clients read the current dictionary before
+     * their first write and when calling loadCompressionDictionaries(), and load any other
+     * dictionary when first reading a value compressed with it, keeping 16 at most. Reading a
+     * value whose dictionary can't be found throws, looking for it at most once a second.
+     *
+     * @param array $samples Sample values, a few hundred or more.
+     * @param int   $size    Maximum size of the dictionary in bytes, 256 to 1 MiB.
+     *
+     * @return int The ID of the new dictionary.
+     *
+     * @throws ValkeyGlideException When dictionary compression is off or zstd can't train a
+     *                              dictionary from the samples, such as too few of them.
+     *
+     * @example
+     * $client = new ValkeyGlide(addresses: [['host' => 'localhost', 'port' => 6379]],
+     *                           compression: ['enabled' => true, 'dictionary_key' => 'app:dicts']);
+     * $client->trainCompressionDictionary($sampleDocuments);
+     * $client->set('user:1', json_encode($user));
+     */
+    public function trainCompressionDictionary(array $samples, int $size = 16384): int|false;
+
+    /**
+     * Switch to the dictionary marked current at dictionary_key, loading it.
+     *
+     * Requires 'dictionary_key' in the compression configuration. Values are compressed with the
+     * current dictionary as read before the first write, until this is called.
+     *
+     * @return int The number of dictionaries this client has loaded.
+     *
+     * @throws ValkeyGlideException When dictionary compression is off or the hash can't be read.
+     */
+    public function loadCompressionDictionaries(): int|false;
+
+    /**
+     * Report the memory the extension holds, by subsystem.
+     *
+     * Counters are kept for the subsystems that hold memory between calls, across every
+     * client of the process. A live_bytes figure that keeps growing under a steady load
+     * points at the subsystem that leaks.
+     *
+     * @return array An array with, for each of 'batch' (multi()/pipeline() buffers), 'pubsub'
+     *               (messages queued for subscribe() callbacks), 'scan' (ClusterScanCursor
+     *               objects) and 'response' (reply conversion scratch space):
+     *               - 'live_bytes': bytes currently held
+     *               - 'peak_bytes': the most ever held at once
+     *               - 'allocations': allocations made so far
+     *               - 'live_allocations': allocations not freed yet
+     *               'pubsub' also has 'queue_depth', the messages waiting for their callback, and
+     *               'scan' has 'rust_cursors', the cluster scan cursors glide-core still keeps.
+     *               The top level adds 'live_bytes', the total, and 'php_usage' and
+     *               'php_real_usage', as memory_get_usage() reports them.
+     *
+     * @example
+     * $stats = $client->getMemoryStats();
+     * printf("batch: %d bytes\n", $stats['batch']['live_bytes']);
+     * printf("queued messages: %d\n", $stats['pubsub']['queue_depth']);
+     */
+    public function getMemoryStats(): array;
+
+    /**
+     * Attach a Bloom filter of the keys that may exist, or detach it with null.
+     *
+     * With a filter attached, get(), hGet() and exists() return false, false and 0 without a
+     * round trip for keys the filter has never seen. The keys of every command sent through
+     * this client are added to it, including rawcommand(), eval(), batches, submit() and
+     * valkey:// streams. Keys created any other way must be added with ValkeyGlideBloom::add(),
+     * or they would read as missing.
+     *
+     * The filter describes the current database: select() detaches it, and a raw SELECT stops
+     * reads from being answered locally until it is attached again. Not supported on shared
+     * clients.
+     *
+     * @param ValkeyGlideBloom|null $bloom The filter, which can be shared between clients.
+     *
+     * @return bool True on success.
+     *
+     * @example
+     * $client->setBloomFilter(ValkeyGlideBloom::fromScan($client));
+     * $client->get('user:missing'); // false, answered locally
+     */
+    public function setBloomFilter(?ValkeyGlideBloom $bloom): bool;
+
+    /**
+     * Get the Bloom filter attached with setBloomFilter().
+     *
+     * @return ValkeyGlideBloom|null The filter, or null if none is attached.
+     */
+    public function getBloomFilter(): ?ValkeyGlideBloom;
+
+    /**
+     * Read a few INFO fields as numbers, with the rates since the previous snapshot.
+     *
+     * Only the requested fields are picked out of the reply, and when they all belong to known
+     * sections only those sections are requested. The counters are kept between calls, so the
+     * rates cover the interval since the previous snapshot of the same node; the first snapshot,
+     * or one after a restart, reports the server's instantaneous rates with an interval of 0.
+     *
+     * @param array $fields The INFO fields to return, such as 'used_memory'. When empty,
+     *                      used_memory, connected_clients, total_commands_processed,
+     *                      keyspace_hits, keyspace_misses, evicted_keys and expired_keys.
+     *
+     * @return array|false The fields in the requested order, ints and floats for numbers and
+     *                     null when the server does not report them, and 'rates' with:
+     *                     - 'ops_per_sec': commands processed per second
+     *                     - 'hit_ratio': hits over lookups, null without lookups
+     *                     - 'net_input_bytes_per_sec': bytes read per second
+     *                     - 'net_output_bytes_per_sec': bytes written per second
+     *                     - 'interval': the seconds the rates were measured over
+     *                     ValkeyGlideCluster returns one such array per node, keyed by address,
+     *                     or a single one when routed to an address.
+     *
+     * @example
+     * $client->metricsSnapshot(['used_memory']);
+     * sleep(10);
+     * $client->metricsSnapshot(['used_memory'])['rates']['ops_per_sec'];
+     */
+    public function metricsSnapshot(array $fields = []): array|false;
+
+    /**
+     * Give calls a time budget.
+     *
+     * Without a callback the budget applies to the next call only, and the client is returned so
+     * the call can be chained; inside MULTI or PIPELINE that call is exec(). With a callback every
+     * call the callback makes on this client shares one deadline; the callback receives the client
+     * and its return value is returned. A nested budget can't extend an enclosing one.
+     *
+     * Calls are sent with the time left as their timeout and without retries, so the client core
+     * gives up once the budget is spent, and calls made after it aren't sent at all. Either way a
+     * ValkeyGlideTimeoutException is thrown. Commands given an explicit route, and those with
+     * their own reply handling (DEL, UNLINK, SORT, LCS, INFO, OBJECT, the FUNCTION and script
+     * commands), are only checked against the deadline before they are sent, and are otherwise
+     * bounded by request_timeout.
+     *
+     * @param int           $ms       The budget in milliseconds.
+     * @param callable|null $callback function (ValkeyGlide $client): mixed
+     *
+     * @return mixed The client, or the return value of the callback.
+     * @throws ValkeyGlideTimeoutException when the budget is spent.
+     *
+     * @example
+     * $value = $client->withDeadline(15)->get('key');
+     * $page = $client->withDeadline(50, function ($c) use ($id) {
+     *     return [$c->hGetAll("user:$id"), $c->lRange("feed:$id", 0, 19)];
+     * });
+     */
+    public function withDeadline(int $ms, ?callable $callback = null): mixed;
+
     /**
      * Set the OpenTelemetry sample percentage at runtime.
      *
@@ -655,6 +1139,46 @@ class ValkeyGlide
      */
     public static function getOtelSamplePercentage(): ?int;
 
+    /**
+     * Open an OpenTelemetry span around application code.
+     *
+     * The span is identified by the returned handle. Pass it to setOtelParentSpan() to have the
+     * spans of commands and MULTI/PIPELINE batches issued by the current thread created as its
+     * children, so they appear under the application's operation in the trace. Spans still open
+     * at the end of the request are ended automatically.
+     *
+     * @param string $name The span name
+     * @return int|false The span handle, or false if the span could not be created
+     * @throws ValkeyGlideException if OpenTelemetry traces are not configured
+     *
+     * @example
+     * $span = ValkeyGlide::startOtelSpan('checkout');
+     * ValkeyGlide::setOtelParentSpan($span);
+     * $client->get('cart:42');
+     * ValkeyGlide::setOtelParentSpan(null);
+     * ValkeyGlide::endOtelSpan($span);
+     */
+    public static function startOtelSpan(string $name): int|false;
+
+    /**
+     * End a span opened with startOtelSpan(). If it is the parent span, commands stop using it.
+     *
+     * @param int $span The handle returned by startOtelSpan()
+     * @return bool False if the span is not open
+     */
+    public static function endOtelSpan(int $span): bool;
+
+    /**
+     * Set the parent of the command and batch spans created on the current thread.
+     *
+     * Only spans opened with startOtelSpan() can be parents: glide-core links spans it created
+     * itself, not spans of an OpenTelemetry SDK running in PHP.
+     *
+     * @param int|null $span A handle returned by startOtelSpan(), or null for root spans
+     * @return bool False if the span is not open
+     */
+    public static function setOtelParentSpan(?int $span): bool;
+
     /**
      * Update the connection password.
      *
@@ -932,6 +1456,102 @@ class ValkeyGlide
      */
     public function exec(): ValkeyGlide|array|false;
 
+    /**
+     * Bulk load a file of commands into the server.
+     *
+     * The file is memory-mapped and parsed in C, and commands are sent as non-atomic
+     * batches of at most `$window` commands, so no PHP values are created per command.
+     *
+     * Supported formats:
+     *   - 'resp': RESP-encoded commands (arrays of bulk strings), e.g. the output of
+     *             `valkey-cli --pipe` generators. Any command may be used.
+     *   - 'csv' / 'tsv': one `key,value[,ttl]` line per entry, each sent as SET (with EX
+     *             when a TTL column is present). Fields are taken verbatim, without quoting.
+     *             Empty lines and lines starting with '#' are ignored. Every record must end
+     *             with a newline: a final line without one is treated as truncated, so it is
+     *             not imported and 'complete' is false.
+     *
+     * @param string $path   Path of the file to ingest, subject to open_basedir.
+     * @param string $format One of 'resp', 'csv' or 'tsv'.
+     * @param int    $window The maximum number of commands sent per batch (1 - 100000).
+     * @param int    $offset The byte offset to start from, e.g. the 'offset' of a previous run.
+     *
+     * @return array|false An associative array with the following keys, or false on failure:
+     *   - commands: Number of commands acknowledged by the server
+     *   - errors: Number of those commands that replied with an error
+     *   - batches: Number of batches sent
+     *   - bytes: Number of input bytes consumed
+     *   - offset: Byte offset just past the last acknowledged batch, to resume from
+     *   - size: Size of the file in bytes
+     *   - complete: Whether the whole file was ingested
+     *   - elapsed: Wall clock time spent, in seconds
+     *   - commands_per_sec: Command throughput
+     *   - bytes_per_sec: Input throughput
+     *   - error: The reason ingestion stopped early, or null
+     *
+     * @example
+     * $stats = $valkey_glide->ingestFile('/data/cache.resp', 'resp', 5000);
+     * if (!$stats['complete']) {
+     *     // Resume where the previous run stopped
+     *     $stats = $valkey_glide->ingestFile('/data/cache.resp', 'resp', 5000, $stats['offset']);
+     * }
+     */
+    public function ingestFile(string $path, string $format = 'resp', int $window = 1000, int $offset = 0): array|false;
+
+    /**
+     * Set many keys, each with an expiry, in a single pipelined round trip.
+     *
+     * Every entry is sent as `SET key value EX ttl` in one non-atomic batch built directly
+     * from the array, which makes this the cheap way to warm up a cache whose entries need
+     * different TTLs. Cannot be used inside multi() or pipeline().
+     *
+     * @param array     $kv  An associative array of keys and values.
+     * @param int|array $ttl The TTL in seconds for every key, or an array of TTLs by key.
+     *                       Every key needs a positive TTL.
+     *
+     * @return ValkeyGlideBitmap|false A bitmap with bit i set when the ith entry was stored, in
+     *                                 the order of $kv, or false if the batch failed as a whole.
+     *
+     * @example
+     * $stored = $valkey_glide->msetex(['a' => 'x', 'b' => 'y'], ['a' => 60, 'b' => 3600]);
+     * if ($stored->bitCount() != 2) {
+     *     // Some entries failed, $stored->getBit(i) tells which
+     * }
+     */
+    public function msetex(array $kv, int|array $ttl): ValkeyGlideBitmap|false;
+
+    /**
+     * Set fields on many hashes in a single pipelined round trip.
+     *
+     * Sends one `HSET key field value ...` per hash, as a single non-atomic batch.
+     * Cannot be used inside multi() or pipeline().
+     *
+     * @param array $hashes An array of field => value arrays by key.
+     *
+     * @return ValkeyGlideBitmap|false A bitmap with bit i set when the ith hash was written, or
+     *                                 false if the batch failed as a whole.
+     *
+     * @example
+     * $valkey_glide->hmsetMulti(['user:1' => ['name' => 'Ann'], 'user:2' => ['name' => 'Bob']]);
+     */
+    public function hmsetMulti(array $hashes): ValkeyGlideBitmap|false;
+
+    /**
+     * Add members to many sorted sets in a single pipelined round trip.
+     *
+     * Sends one `ZADD key score member ...` per sorted set, as a single non-atomic batch.
+     * Cannot be used inside multi() or pipeline().
+     *
+     * @param array $sets An array of member => score arrays by key.
+     *
+     * @return ValkeyGlideBitmap|false A bitmap with bit i set when the ith sorted set was written,
+     *                                 or false if the batch failed as a whole.
+     *
+     * @example
+     * $valkey_glide->zaddMulti(['board:a' => ['ann' => 10, 'bob' => 7.5], 'board:b' => ['eve' => 3]]);
+     */
+    public function zaddMulti(array $sets): ValkeyGlideBitmap|false;
+
     /**
      * Test if one or more keys exist.
      *
@@ -1233,6 +1853,26 @@ class ValkeyGlide
      */
     public function getBit(string $key, int $idx): ValkeyGlide|int|false;
 
+    /**
+     * Fetch a string key as a ValkeyGlideBitmap, to count, combine, and search its bits locally.
+     *
+     * This is a GET whose value is wrapped in a bitmap instead of returned as a string. A key that
+     * does not exist reads as an empty bitmap, the same way GETBIT and BITCOUNT treat it. Write a
+     * bitmap back with set().
+     *
+     * @param string $key The key to fetch.
+     *
+     * @return ValkeyGlide|ValkeyGlideBitmap|false The bitmap, or false on failure.
+     *
+     * @see https://valkey.io/commands/get
+     *
+     * @example
+     * $seen = $valkey_glide->getBitmap('seen:today');
+     * $seen->setBit(1337);
+     * $valkey_glide->set('seen:today', $seen);
+     */
+    public function getBitmap(string $key): ValkeyGlide|ValkeyGlideBitmap|false;
+
     /**
      * Get the value of a key and optionally set it's expiration.
      *
@@ -2900,7 +3540,8 @@ class ValkeyGlide
      * Create or set a ValkeyGlide STRING key to a value.
      *
      * @param string    $key     The key name to set.
-     * @param mixed     $value   The value to set the key to.
+     * @param mixed     $value   The value to set the key to. A ValkeyGlideBitmap is stored as
+     *                           its raw bytes.
      * @param array|int $options Either an array with options for how to perform the set or an
      *                           integer with an expiration.  If an expiration is set PhpValkeyGlide
      *                           will actually send the `SETEX` command.
@@ -4387,3 +5028,11 @@ class ValkeyGlide
 class ValkeyGlideException extends RuntimeException
 {
 }
+
+class ValkeyGlideTimeoutException extends ValkeyGlideException
+{
+}
+
+class ValkeyGlideCircuitOpenException extends ValkeyGlideException
+{
+}
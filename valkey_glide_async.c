@@ -0,0 +1,553 @@
+/** Copyright Valkey GLIDE Project Contributors - SPDX Identifier: Apache-2.0 */
+
+#include "valkey_glide_async.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <zend_exceptions.h>
+
+#ifdef __linux__
+#include <sys/eventfd.h>
+#endif
+
+#include "command_response.h"
+#include "logger.h"
+#include "valkey_glide_bloom.h"
+#include "valkey_glide_commands_common.h"
+#include "valkey_glide_fiber.h"
+#include "valkey_glide_pubsub_common.h"
+
+/*
+ * Everything reachable from the glide-core callbacks runs on glide-core threads, so the context,
+ * the in-flight requests and the completion queue are allocated with malloc() rather than the
+ * request-bound Zend allocator, and are only ever touched under ctx->lock.
+ */
+
+/* A reply waiting to be drained by poll() */
+typedef struct valkey_glide_async_completion {
+    uint64_t                              id;
+    CommandResponse*                      response;  /* Owned, NULL on error */
+    char*                                 error;     /* Owned, NULL on success */
+    valkey_glide_fiber_job*               fiber_job; /* Set for replies awaited by a Fiber */
+    struct valkey_glide_async_completion* next;
+} valkey_glide_async_completion;
+
+/* The index handed to glide-core for each submitted command */
+typedef struct {
+    valkey_glide_async_context* ctx;
+    uint64_t                    id;
+} valkey_glide_async_request;
+
+struct valkey_glide_async_context {
+    const void*                    client;   /* Callback-mode glide client, NULL if not enabled */
+    int                            read_fd;  /* Readable while completions are queued */
+    int                            write_fd; /* Same as read_fd for eventfd */
+    mutex_t                        lock;
+    valkey_glide_async_completion* head;
+    valkey_glide_async_completion* tail;
+    uint64_t                       next_id;
+    size_t                         in_flight; /* Submitted but not yet called back */
+    bool                           closed;    /* Owner gone, last callback frees */
+};
+
+static void async_free_completion(valkey_glide_async_completion* completion) {
+    if (completion->response) {
+        free_command_response(completion->response);
+    }
+    if (completion->fiber_job) {
+        valkey_glide_fiber_job_release(completion->fiber_job);
+    }
+    free(completion->error);
+    free(completion);
+}
+
+static void async_free_context(valkey_glide_async_context* ctx) {
+    valkey_glide_async_completion* completion = ctx->head;
+    while (completion) {
+        valkey_glide_async_completion* next = completion->next;
+        async_free_completion(completion);
+        completion = next;
+    }
+
+    if (ctx->write_fd != ctx->read_fd) {
+        close(ctx->write_fd);
+    }
+    close(ctx->read_fd);
+    mutex_destroy(&ctx->lock);
+    free(ctx);
+}
+
+static int async_open_notifier(valkey_glide_async_context* ctx) {
+#ifdef __linux__
+    int fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (fd < 0) {
+        return -1;
+    }
+    ctx->read_fd  = fd;
+    ctx->write_fd = fd;
+#else
+    int fds[2];
+    if (pipe(fds) != 0) {
+        return -1;
+    }
+    for (int i = 0; i < 2; i++) {
+        fcntl(fds[i], F_SETFL, fcntl(fds[i], F_GETFL) | O_NONBLOCK);
+        fcntl(fds[i], F_SETFD, FD_CLOEXEC);
+    }
+    ctx->read_fd  = fds[0];
+    ctx->write_fd = fds[1];
+#endif
+    return 0;
+}
+
+static void async_notify(valkey_glide_async_context* ctx) {
+#ifdef __linux__
+    uint64_t one = 1;
+    ssize_t  ret = write(ctx->write_fd, &one, sizeof(one));
+#else
+    char    byte = 1;
+    ssize_t ret  = write(ctx->write_fd, &byte, 1);
+#endif
+    (void) ret; /* EAGAIN means the fd is already readable */
+}
+
+static void async_drain_notifier(valkey_glide_async_context* ctx) {
+    char buf[64];
+    while (read(ctx->read_fd, buf, sizeof(buf)) > 0) {
+    }
+}
+
+/* Append a completion to the queue, ctx->lock must be held */
+static void async_enqueue(valkey_glide_async_context*    ctx,
+                          valkey_glide_async_completion* completion) {
+    bool was_empty   = ctx->head == NULL;
+    completion->next = NULL;
+    if (ctx->tail) {
+        ctx->tail->next = completion;
+    } else {
+        ctx->head = completion;
+    }
+    ctx->tail = completion;
+
+    /* Only the empty -> non-empty transition needs a wakeup */
+    if (was_empty) {
+        async_notify(ctx);
+    }
+}
+
+/* Queue a completion and wake up pollers. Called on a glide-core thread. */
+static void async_complete(uintptr_t index_ptr, CommandResponse* response, char* error) {
+    valkey_glide_async_request* request = (valkey_glide_async_request*) index_ptr;
+    valkey_glide_async_context* ctx     = request->ctx;
+    uint64_t                    id      = request->id;
+    free(request);
+
+    mutex_lock(&ctx->lock);
+    ctx->in_flight--;
+
+    if (ctx->closed) {
+        bool last = ctx->in_flight == 0;
+        mutex_unlock(&ctx->lock);
+        if (response) {
+            free_command_response(response);
+        }
+        free(error);
+        if (last) {
+            async_free_context(ctx);
+        }
+        return;
+    }
+
+    valkey_glide_async_completion* completion = malloc(sizeof(valkey_glide_async_completion));
+    if (!completion) {
+        mutex_unlock(&ctx->lock);
+        if (response) {
+            free_command_response(response);
+        }
+        free(error);
+        return;
+    }
+    completion->id        = id;
+    completion->response  = response;
+    completion->error     = error;
+    completion->fiber_job = NULL;
+
+    async_enqueue(ctx, completion);
+    mutex_unlock(&ctx->lock);
+}
+
+void valkey_glide_async_success_callback(uintptr_t                     index_ptr,
+                                         const struct CommandResponse* message) {
+    async_complete(index_ptr, (CommandResponse*) message, NULL);
+}
+
+void valkey_glide_async_failure_callback(uintptr_t             index_ptr,
+                                         const char*           error_message,
+                                         enum RequestErrorType error_type) {
+    char* error = strdup(error_message ? error_message : "Unknown error");
+    if (error_message) {
+        free_error_message((char*) error_message);
+    }
+    async_complete(index_ptr, NULL, error);
+}
+
+void valkey_glide_async_push_fiber_job(valkey_glide_async_context* ctx,
+                                       valkey_glide_fiber_job*     job) {
+    valkey_glide_async_completion* completion = calloc(1, sizeof(valkey_glide_async_completion));
+    if (!completion) {
+        /* The Fiber still notices completion through the job itself when resumed */
+        valkey_glide_fiber_job_release(job);
+        return;
+    }
+    completion->fiber_job = job;
+
+    mutex_lock(&ctx->lock);
+    async_enqueue(ctx, completion);
+    mutex_unlock(&ctx->lock);
+}
+
+static valkey_glide_async_context* async_create_context(const void* client) {
+    valkey_glide_async_context* ctx = calloc(1, sizeof(valkey_glide_async_context));
+    if (!ctx) {
+        return NULL;
+    }
+    if (async_open_notifier(ctx) != 0) {
+        free(ctx);
+        return NULL;
+    }
+
+    mutex_init(&ctx->lock);
+    ctx->client  = client;
+    ctx->next_id = 1;
+    return ctx;
+}
+
+int valkey_glide_async_ensure_context(valkey_glide_object* valkey_glide) {
+    if (valkey_glide->async_ctx) {
+        return SUCCESS;
+    }
+
+    valkey_glide->async_ctx = async_create_context(NULL);
+    if (!valkey_glide->async_ctx) {
+        zend_throw_exception(
+            get_valkey_glide_exception_ce(), "Failed to create completion descriptor", 0);
+        return FAILURE;
+    }
+    return SUCCESS;
+}
+
+int valkey_glide_async_attach(valkey_glide_object*      valkey_glide,
+                              const ConnectionResponse* conn_resp) {
+    if (!conn_resp) {
+        zend_throw_exception(
+            get_valkey_glide_exception_ce(), "Failed to create asynchronous client", 0);
+        return FAILURE;
+    }
+
+    if (conn_resp->connection_error_message) {
+        VALKEY_LOG_ERROR("async_completions", conn_resp->connection_error_message);
+        zend_throw_exception(
+            get_valkey_glide_exception_ce(), conn_resp->connection_error_message, 0);
+        free_connection_response((ConnectionResponse*) conn_resp);
+        return FAILURE;
+    }
+
+    valkey_glide_async_context* ctx = async_create_context(conn_resp->conn_ptr);
+    if (!ctx) {
+        close_glide_client(conn_resp->conn_ptr);
+        free_connection_response((ConnectionResponse*) conn_resp);
+        zend_throw_exception(
+            get_valkey_glide_exception_ce(), "Failed to create completion descriptor", 0);
+        return FAILURE;
+    }
+
+    valkey_glide->async_ctx = ctx;
+
+    free_connection_response((ConnectionResponse*) conn_resp);
+    VALKEY_LOG_DEBUG("async_completions", "Asynchronous completion client attached");
+    return SUCCESS;
+}
+
+void valkey_glide_async_close(valkey_glide_async_context* ctx) {
+    if (!ctx) {
+        return;
+    }
+
+    if (ctx->client) {
+        close_glide_client(ctx->client);
+    }
+
+    mutex_lock(&ctx->lock);
+    ctx->closed = true;
+    bool idle   = ctx->in_flight == 0;
+    mutex_unlock(&ctx->lock);
+
+    /* Otherwise the last outstanding callback releases the context */
+    if (idle) {
+        async_free_context(ctx);
+    }
+}
+
+static valkey_glide_async_context* async_get_context(zval* object) {
+    valkey_glide_object* valkey_glide =
+        VALKEY_GLIDE_PHP_ZVAL_GET_OBJECT(valkey_glide_object, object);
+
+    if (!valkey_glide || !valkey_glide->glide_client) {
+        return NULL;
+    }
+    if (!valkey_glide->async_ctx) {
+        zend_throw_exception(get_valkey_glide_exception_ce(),
+                             "Asynchronous completions are not enabled, set "
+                             "advanced_config['async_completions'] when connecting",
+                             0);
+        return NULL;
+    }
+    return valkey_glide->async_ctx;
+}
+
+/* Execute submit() - send a raw command without waiting for its reply */
+int execute_submit_command(zval* object, int argc, zval* return_value, zend_class_entry* ce) {
+    valkey_glide_async_context* ctx;
+    zval*                       z_args     = NULL;
+    int                         z_args_len = 0;
+    char*                       cmd        = NULL;
+    size_t                      cmd_len    = 0;
+
+    if (zend_parse_method_parameters(
+            argc, object, "Os*", &object, ce, &cmd, &cmd_len, &z_args, &z_args_len) == FAILURE) {
+        return 0;
+    }
+
+    ctx = async_get_context(object);
+    if (!ctx) {
+        return 0;
+    }
+    if (!ctx->client) {
+        zend_throw_exception(get_valkey_glide_exception_ce(),
+                             "Asynchronous completions are not enabled, set "
+                             "advanced_config['async_completions'] when connecting",
+                             0);
+        return 0;
+    }
+
+    unsigned long  arg_count = (unsigned long) z_args_len + 1;
+    uintptr_t*     args      = (uintptr_t*) emalloc(arg_count * sizeof(uintptr_t));
+    unsigned long* args_len  = (unsigned long*) emalloc(arg_count * sizeof(unsigned long));
+    char**         to_free   = (char**) ecalloc(arg_count, sizeof(char*));
+    int            i;
+
+    args[0]     = (uintptr_t) cmd;
+    args_len[0] = cmd_len;
+    for (i = 0; i < z_args_len; i++) {
+        size_t len       = 0;
+        int    need_free = 0;
+        char*  str       = zval_to_string_safe(&z_args[i], &len, &need_free);
+
+        args[i + 1]     = (uintptr_t) str;
+        args_len[i + 1] = len;
+        if (need_free) {
+            to_free[i + 1] = str;
+        }
+    }
+
+    valkey_glide_async_request* request = malloc(sizeof(valkey_glide_async_request));
+    if (!request) {
+        free_allocated_strings(to_free, arg_count);
+        efree(args);
+        efree(args_len);
+        return 0;
+    }
+
+    mutex_lock(&ctx->lock);
+    request->ctx = ctx;
+    request->id  = ctx->next_id++;
+    ctx->in_flight++;
+    mutex_unlock(&ctx->lock);
+
+    uint64_t id = request->id;
+
+    /* Sent on the completion client, settings for the next call of the object don't apply */
+    const void* glide_client =
+        VALKEY_GLIDE_PHP_ZVAL_GET_OBJECT(valkey_glide_object, object)->glide_client;
+    valkey_glide_drop_next_call_options(glide_client);
+    valkey_glide_bloom_record(glide_client, CustomCommand, args, args_len, arg_count);
+
+    /* The arguments are copied before command() returns; the reply arrives via the callbacks */
+    CommandResult* result = command(
+        ctx->client, (uintptr_t) request, CustomCommand, arg_count, args, args_len, NULL, 0, 0);
+
+    free_allocated_strings(to_free, arg_count);
+    efree(args);
+    efree(args_len);
+
+    /* A result returned right away means the command wasn't sent, no callback will follow */
+    if (result) {
+        mutex_lock(&ctx->lock);
+        ctx->in_flight--;
+        mutex_unlock(&ctx->lock);
+        free(request);
+
+        zend_throw_exception(get_valkey_glide_exception_ce(),
+                             result->command_error
+                                 ? result->command_error->command_error_message
+                                 : "Failed to submit the command",
+                             0);
+        free_command_result(result);
+        return 0;
+    }
+
+    ZVAL_LONG(return_value, (zend_long) id);
+    return 1;
+}
+
+/* Put completions back at the head of the queue */
+static void async_requeue(valkey_glide_async_context* ctx, valkey_glide_async_completion* list) {
+    if (!list) {
+        return;
+    }
+
+    valkey_glide_async_completion* last = list;
+    while (last->next) {
+        last = last->next;
+    }
+
+    mutex_lock(&ctx->lock);
+    last->next = ctx->head;
+    ctx->head  = list;
+    if (!ctx->tail) {
+        ctx->tail = last;
+    }
+    async_notify(ctx);
+    mutex_unlock(&ctx->lock);
+}
+
+/* Execute poll() - drain completed replies as an array of request id => reply */
+int execute_poll_command(zval* object, int argc, zval* return_value, zend_class_entry* ce) {
+    valkey_glide_async_context* ctx;
+    zend_long                   max = 0;
+
+    if (zend_parse_method_parameters(argc, object, "O|l", &object, ce, &max) == FAILURE) {
+        return 0;
+    }
+
+    ctx = async_get_context(object);
+    if (!ctx) {
+        return 0;
+    }
+
+    /* Detach up to max completions while holding the lock, convert them after */
+    mutex_lock(&ctx->lock);
+    valkey_glide_async_completion* list  = ctx->head;
+    valkey_glide_async_completion* last  = NULL;
+    valkey_glide_async_completion* it    = list;
+    zend_long                      taken = 0;
+
+    while (it && (max <= 0 || taken < max)) {
+        last = it;
+        it   = it->next;
+        taken++;
+    }
+    if (last) {
+        ctx->head  = last->next;
+        last->next = NULL;
+        if (!ctx->head) {
+            ctx->tail = NULL;
+        }
+    }
+    async_drain_notifier(ctx);
+    if (ctx->head) {
+        /* Leftovers: keep the descriptor readable */
+        async_notify(ctx);
+    }
+    mutex_unlock(&ctx->lock);
+
+    /*
+     * Resume the Fibers awaiting replies first. If one throws, nothing has been converted yet,
+     * so every completion that was not consumed goes back to the queue for the next poll().
+     */
+    valkey_glide_async_completion*  kept      = NULL;
+    valkey_glide_async_completion** kept_tail = &kept;
+    while (list) {
+        valkey_glide_async_completion* next = list->next;
+
+        if (!list->fiber_job) {
+            *kept_tail = list;
+            kept_tail  = &list->next;
+            list       = next;
+            continue;
+        }
+
+        valkey_glide_fiber_job* job = list->fiber_job;
+        list->fiber_job             = NULL;
+        async_free_completion(list);
+        list = next;
+
+        valkey_glide_fiber_resume(job);
+        if (EG(exception)) {
+            *kept_tail = list;
+            async_requeue(ctx, kept);
+            return 0;
+        }
+    }
+    *kept_tail = NULL;
+
+    array_init(return_value);
+    while (kept) {
+        valkey_glide_async_completion* next = kept->next;
+        zval                           value;
+
+        if (kept->error) {
+            object_init_ex(&value, get_valkey_glide_exception_ce());
+            zend_update_property_string(
+                zend_ce_exception, Z_OBJ(value), "message", sizeof("message") - 1, kept->error);
+        } else if (command_response_to_zval(
+                       kept->response, &value, COMMAND_RESPONSE_NOT_ASSOSIATIVE, false) < 0) {
+            ZVAL_FALSE(&value);
+        }
+        add_index_zval(return_value, (zend_ulong) kept->id, &value);
+
+        async_free_completion(kept);
+        kept = next;
+    }
+
+    return 1;
+}
+
+/* Execute getCompletionFd() - a stream that becomes readable when poll() has work */
+int execute_get_completion_fd_command(zval*             object,
+                                      int               argc,
+                                      zval*             return_value,
+                                      zend_class_entry* ce) {
+    valkey_glide_async_context* ctx;
+
+    if (zend_parse_method_parameters(argc, object, "O", &object, ce) == FAILURE) {
+        return 0;
+    }
+
+    ctx = async_get_context(object);
+    if (!ctx) {
+        return 0;
+    }
+
+    /* The stream owns a duplicate so closing it never affects the client */
+    int fd = dup(ctx->read_fd);
+    if (fd < 0) {
+        zend_throw_exception_ex(get_valkey_glide_exception_ce(),
+                                0,
+                                "Unable to duplicate completion descriptor: %s",
+                                strerror(errno));
+        return 0;
+    }
+
+    php_stream* stream = php_stream_fopen_from_fd(fd, "r", NULL);
+    if (!stream) {
+        close(fd);
+        return 0;
+    }
+    php_stream_set_option(stream, PHP_STREAM_OPTION_BLOCKING, 0, NULL);
+    php_stream_to_zval(stream, return_value);
+    return 1;
+}
@@ -0,0 +1,95 @@
+/** Copyright Valkey GLIDE Project Contributors - SPDX Identifier: Apache-2.0 */
+
+#ifndef VALKEY_GLIDE_ASYNC_H
+#define VALKEY_GLIDE_ASYNC_H
+
+#include "common.h"
+#include "include/glide_bindings.h"
+
+/*
+ * Asynchronous completions.
+ *
+ * When a client is created with advanced_config['async_completions'] enabled, a second glide
+ * client is created in callback mode next to the synchronous one. Commands submitted through it
+ * return immediately; replies are delivered by glide-core on its own threads, queued, and
+ * signalled on a file descriptor (eventfd on Linux, a pipe elsewhere) so that event loops can
+ * watch it and drain the queue with poll().
+ */
+typedef struct valkey_glide_async_context valkey_glide_async_context;
+typedef struct valkey_glide_fiber_job     valkey_glide_fiber_job;
+
+/* Advanced configuration key */
+#define VALKEY_GLIDE_ASYNC_COMPLETIONS "async_completions"
+
+/* Callbacks handed to glide-core when creating the callback-mode client */
+void valkey_glide_async_success_callback(uintptr_t                     index_ptr,
+                                         const struct CommandResponse* message);
+void valkey_glide_async_failure_callback(uintptr_t             index_ptr,
+                                         const char*           error_message,
+                                         enum RequestErrorType error_type);
+
+/*
+ * Attach the callback-mode client described by conn_resp to valkey_glide.
+ * Takes ownership of conn_resp. Throws and returns FAILURE if the client could not be created.
+ */
+int  valkey_glide_async_attach(valkey_glide_object*      valkey_glide,
+                               const ConnectionResponse* conn_resp);
+void valkey_glide_async_close(valkey_glide_async_context* ctx);
+
+/* Create a completion queue without a callback-mode client, e.g. for Fiber-aware execution */
+int valkey_glide_async_ensure_context(valkey_glide_object* valkey_glide);
+
+/* Queue the completion of a Fiber job so that poll() resumes its Fiber. Thread-safe. */
+void valkey_glide_async_push_fiber_job(valkey_glide_async_context* ctx,
+                                       valkey_glide_fiber_job*     job);
+
+int execute_submit_command(zval* object, int argc, zval* return_value, zend_class_entry* ce);
+int execute_poll_command(zval* object, int argc, zval* return_value, zend_class_entry* ce);
+int execute_get_completion_fd_command(zval*             object,
+                                      int               argc,
+                                      zval*             return_value,
+                                      zend_class_entry* ce);
+
+#define SUBMIT_METHOD_IMPL(class_name)                                            \
+    PHP_METHOD(class_name, submit) {                                              \
+        if (execute_submit_command(getThis(),                                     \
+                                   ZEND_NUM_ARGS(),                               \
+                                   return_value,                                  \
+                                   strcmp(#class_name, "ValkeyGlideCluster") == 0 \
+                                       ? get_valkey_glide_cluster_ce()            \
+                                       : get_valkey_glide_ce())) {                \
+            return;                                                               \
+        }                                                                         \
+        zval_dtor(return_value);                                                  \
+        RETURN_FALSE;                                                             \
+    }
+
+#define POLL_METHOD_IMPL(class_name)                                            \
+    PHP_METHOD(class_name, poll) {                                              \
+        if (execute_poll_command(getThis(),                                     \
+                                 ZEND_NUM_ARGS(),                               \
+                                 return_value,                                  \
+                                 strcmp(#class_name, "ValkeyGlideCluster") == 0 \
+                                     ? get_valkey_glide_cluster_ce()            \
+                                     : get_valkey_glide_ce())) {                \
+            return;                                                             \
+        }                                                                       \
+        zval_dtor(return_value);                                                \
+        RETURN_FALSE;                                                           \
+    }
+
+#define GET_COMPLETION_FD_METHOD_IMPL(class_name)                                            \
+    PHP_METHOD(class_name, getCompletionFd) {                                                \
+        if (execute_get_completion_fd_command(getThis(),                                     \
+                                              ZEND_NUM_ARGS(),                               \
+                                              return_value,                                  \
+                                              strcmp(#class_name, "ValkeyGlideCluster") == 0 \
+                                                  ? get_valkey_glide_cluster_ce()            \
+                                                  : get_valkey_glide_ce())) {                \
+            return;                                                                          \
+        }                                                                                    \
+        zval_dtor(return_value);                                                             \
+        RETURN_FALSE;                                                                        \
+    }
+
+#endif /* VALKEY_GLIDE_ASYNC_H */
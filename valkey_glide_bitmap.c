@@ -0,0 +1,650 @@
+/** Copyright Valkey GLIDE Project Contributors - SPDX Identifier: Apache-2.0 */
+
+#include "valkey_glide_bitmap.h"
+
+#include <zend_exceptions.h>
+#include <zend_interfaces.h>
+
+#include "command_response.h"
+#include "valkey_glide_bitmap_arginfo.h"
+#include "valkey_glide_core_common.h"
+
+static zend_class_entry*    valkey_glide_bitmap_ce;
+static zend_object_handlers valkey_glide_bitmap_object_handlers;
+
+/* ====================================================================
+ * WORD-AT-A-TIME BIT OPERATIONS
+ * ==================================================================== */
+
+static zend_always_inline uint64_t bitmap_load(const unsigned char* p) {
+    uint64_t word;
+    memcpy(&word, p, sizeof(word));
+    return word;
+}
+
+static zend_always_inline uint64_t bitmap_popcount_words(const unsigned char* p, size_t len) {
+    uint64_t a = 0, b = 0, c = 0, d = 0;
+    size_t   i = 0;
+
+    /* Four accumulators keep the popcounts independent of each other */
+    for (; i + 32 <= len; i += 32) {
+        a += __builtin_popcountll(bitmap_load(p + i));
+        b += __builtin_popcountll(bitmap_load(p + i + 8));
+        c += __builtin_popcountll(bitmap_load(p + i + 16));
+        d += __builtin_popcountll(bitmap_load(p + i + 24));
+    }
+    for (; i + 8 <= len; i += 8) {
+        a += __builtin_popcountll(bitmap_load(p + i));
+    }
+    for (; i < len; i++) {
+        a += __builtin_popcount(p[i]);
+    }
+    return a + b + c + d;
+}
+
+#if defined(__x86_64__) && defined(__GNUC__) && !defined(__POPCNT__)
+/* Baseline x86-64 has no POPCNT instruction, so pick a build of the loop that uses it at startup */
+static uint64_t bitmap_popcount_generic(const unsigned char* p, size_t len) {
+    return bitmap_popcount_words(p, len);
+}
+
+__attribute__((target("popcnt"))) static uint64_t bitmap_popcount_native(const unsigned char* p,
+                                                                         size_t len) {
+    return bitmap_popcount_words(p, len);
+}
+
+static uint64_t (*bitmap_popcount_impl)(const unsigned char*, size_t) = bitmap_popcount_generic;
+
+#define bitmap_popcount(p, len) bitmap_popcount_impl(p, len)
+#else
+#define bitmap_popcount(p, len) bitmap_popcount_words(p, len)
+#endif
+
+/* Offset of the first set bit at or after from, -1 if there is none */
+static int64_t bitmap_next_set_bit(const zend_string* bytes, uint64_t from) {
+    const unsigned char* p    = (const unsigned char*) ZSTR_VAL(bytes);
+    size_t               len  = ZSTR_LEN(bytes);
+    size_t               byte = from >> 3;
+    unsigned int         bits;
+
+    if (byte >= len) {
+        return -1;
+    }
+
+    bits = p[byte] & (0xFFu >> (from & 7));
+    if (bits) {
+        return ((int64_t) byte << 3) + __builtin_clz(bits) - 24;
+    }
+
+    /* Skip empty words, then find the byte inside the first one that is not */
+    for (byte++; byte + 8 <= len && bitmap_load(p + byte) == 0; byte += 8) {
+    }
+    for (; byte < len; byte++) {
+        if (p[byte]) {
+            return ((int64_t) byte << 3) + __builtin_clz(p[byte]) - 24;
+        }
+    }
+    return -1;
+}
+
+/* Number of set bits at offsets up to and including offset */
+static uint64_t bitmap_rank(const zend_string* bytes, uint64_t offset) {
+    const unsigned char* p    = (const unsigned char*) ZSTR_VAL(bytes);
+    size_t               byte = offset >> 3;
+
+    if (byte >= ZSTR_LEN(bytes)) {
+        return bitmap_popcount(p, ZSTR_LEN(bytes));
+    }
+    return bitmap_popcount(p, byte) +
+           __builtin_popcount(p[byte] & (0xFFu << (7 - (offset & 7))) & 0xFFu);
+}
+
+/* Offset of the nth set bit, counting from 0, -1 if there are not that many */
+static int64_t bitmap_select(const zend_string* bytes, uint64_t n) {
+    const unsigned char* p   = (const unsigned char*) ZSTR_VAL(bytes);
+    size_t               len = ZSTR_LEN(bytes);
+    size_t               i   = 0;
+    unsigned int         bits, count;
+
+    for (; i + 8 <= len; i += 8) {
+        count = __builtin_popcountll(bitmap_load(p + i));
+        if (n < count) {
+            break;
+        }
+        n -= count;
+    }
+    for (; i < len; i++) {
+        count = __builtin_popcount(p[i]);
+        if (n < count) {
+            /* Drop the n highest set bits, the next one is the answer */
+            for (bits = p[i]; n > 0; n--) {
+                bits &= ~(0x80u >> (__builtin_clz(bits) - 24));
+            }
+            return ((int64_t) i << 3) + __builtin_clz(bits) - 24;
+        }
+        n -= count;
+    }
+    return -1;
+}
+
+typedef enum { BITMAP_AND, BITMAP_OR, BITMAP_XOR, BITMAP_ANDNOT } bitmap_op_t;
+
+#define BITMAP_COMBINE(expr)                 \
+    for (i = 0; i + 8 <= common; i += 8) {   \
+        uint64_t x = bitmap_load(pa + i);    \
+        uint64_t y = bitmap_load(pb + i);    \
+        uint64_t r = (expr);                 \
+        memcpy(out + i, &r, sizeof(r));      \
+    }                                        \
+    for (; i < common; i++) {                \
+        uint64_t x = pa[i];                  \
+        uint64_t y = pb[i];                  \
+        out[i]     = (unsigned char) (expr); \
+    }
+
+/*
+ * Combine two bitmaps the way BITOP does: the shorter one reads as zeros past its end, and the
+ * result is as long as the longer one.
+ */
+static zend_string* bitmap_combine(const zend_string* a, const zend_string* b, bitmap_op_t op) {
+    const unsigned char* pa     = (const unsigned char*) ZSTR_VAL(a);
+    const unsigned char* pb     = (const unsigned char*) ZSTR_VAL(b);
+    size_t               common = MIN(ZSTR_LEN(a), ZSTR_LEN(b));
+    size_t               len    = MAX(ZSTR_LEN(a), ZSTR_LEN(b));
+    zend_string*         result = zend_string_alloc(len, 0);
+    unsigned char*       out    = (unsigned char*) ZSTR_VAL(result);
+    size_t               i;
+
+    switch (op) {
+        case BITMAP_AND:
+            BITMAP_COMBINE(x & y);
+            break;
+        case BITMAP_OR:
+            BITMAP_COMBINE(x | y);
+            break;
+        case BITMAP_XOR:
+            BITMAP_COMBINE(x ^ y);
+            break;
+        case BITMAP_ANDNOT:
+            BITMAP_COMBINE(x & ~y);
+            break;
+    }
+
+    /* Past the shorter input only OR, XOR, and ANDNOT with a longer left side keep bits */
+    if (len > common) {
+        const zend_string* longer = ZSTR_LEN(a) > common ? a : b;
+        if (op == BITMAP_AND || (op == BITMAP_ANDNOT && longer == b)) {
+            memset(out + common, 0, len - common);
+        } else {
+            memcpy(out + common, ZSTR_VAL(longer) + common, len - common);
+        }
+    }
+
+    out[len] = '\0';
+    return result;
+}
+
+#undef BITMAP_COMBINE
+
+/* ====================================================================
+ * OBJECT HANDLERS
+ * ==================================================================== */
+
+static zend_object* create_valkey_glide_bitmap_object(zend_class_entry* ce) {
+    valkey_glide_bitmap_object* bitmap =
+        ecalloc(1, sizeof(valkey_glide_bitmap_object) + zend_object_properties_size(ce));
+
+    zend_object_std_init(&bitmap->std, ce);
+    object_properties_init(&bitmap->std, ce);
+
+    bitmap->bytes        = ZSTR_EMPTY_ALLOC();
+    bitmap->std.handlers = &valkey_glide_bitmap_object_handlers;
+
+    return &bitmap->std;
+}
+
+static void free_valkey_glide_bitmap_object(zend_object* object) {
+    valkey_glide_bitmap_object* bitmap = VALKEY_GLIDE_BITMAP_GET_OBJECT(object);
+
+    zend_string_release(bitmap->bytes);
+    zend_object_std_dtor(&bitmap->std);
+}
+
+static zend_object* clone_valkey_glide_bitmap_object(zend_object* object) {
+    valkey_glide_bitmap_object* source = VALKEY_GLIDE_BITMAP_GET_OBJECT(object);
+    zend_object*                copy   = create_valkey_glide_bitmap_object(object->ce);
+
+    zend_objects_clone_members(copy, object);
+    VALKEY_GLIDE_BITMAP_GET_OBJECT(copy)->bytes = zend_string_copy(source->bytes);
+
+    return copy;
+}
+
+/* Bitmaps are equal when their bytes are, which also makes "==" ignore object identity */
+static int compare_valkey_glide_bitmap_objects(zval* a, zval* b) {
+    ZEND_COMPARE_OBJECTS_FALLBACK(a, b);
+
+    if (Z_OBJCE_P(a) != Z_OBJCE_P(b)) {
+        return ZEND_UNCOMPARABLE;
+    }
+    return zend_string_equals(VALKEY_GLIDE_BITMAP_ZVAL_GET_OBJECT(a)->bytes,
+                              VALKEY_GLIDE_BITMAP_ZVAL_GET_OBJECT(b)->bytes)
+               ? 0
+               : ZEND_UNCOMPARABLE;
+}
+
+/* ====================================================================
+ * SET-BIT ITERATOR
+ * ==================================================================== */
+
+typedef struct {
+    zend_object_iterator it;
+    int64_t              offset; /* Current set bit, -1 once past the last one */
+    zend_long            index;
+    zval                 current;
+} valkey_glide_bitmap_iterator;
+
+static zend_string* bitmap_iterator_bytes(zend_object_iterator* it) {
+    return VALKEY_GLIDE_BITMAP_ZVAL_GET_OBJECT(&it->data)->bytes;
+}
+
+static void bitmap_iterator_dtor(zend_object_iterator* it) {
+    zval_ptr_dtor(&it->data);
+}
+
+static zend_result bitmap_iterator_valid(zend_object_iterator* it) {
+    return ((valkey_glide_bitmap_iterator*) it)->offset >= 0 ? SUCCESS : FAILURE;
+}
+
+static zval* bitmap_iterator_get_current_data(zend_object_iterator* it) {
+    valkey_glide_bitmap_iterator* iter = (valkey_glide_bitmap_iterator*) it;
+
+    ZVAL_LONG(&iter->current, (zend_long) iter->offset);
+    return &iter->current;
+}
+
+static void bitmap_iterator_get_current_key(zend_object_iterator* it, zval* key) {
+    ZVAL_LONG(key, ((valkey_glide_bitmap_iterator*) it)->index);
+}
+
+static void bitmap_iterator_move_forward(zend_object_iterator* it) {
+    valkey_glide_bitmap_iterator* iter = (valkey_glide_bitmap_iterator*) it;
+
+    if (iter->offset >= 0) {
+        iter->offset = bitmap_next_set_bit(bitmap_iterator_bytes(it), iter->offset + 1);
+        iter->index++;
+    }
+}
+
+static void bitmap_iterator_rewind(zend_object_iterator* it) {
+    valkey_glide_bitmap_iterator* iter = (valkey_glide_bitmap_iterator*) it;
+
+    iter->offset = bitmap_next_set_bit(bitmap_iterator_bytes(it), 0);
+    iter->index  = 0;
+}
+
+static const zend_object_iterator_funcs valkey_glide_bitmap_iterator_funcs = {
+    .dtor               = bitmap_iterator_dtor,
+    .valid              = bitmap_iterator_valid,
+    .get_current_data   = bitmap_iterator_get_current_data,
+    .get_current_key    = bitmap_iterator_get_current_key,
+    .move_forward       = bitmap_iterator_move_forward,
+    .rewind             = bitmap_iterator_rewind,
+    .invalidate_current = NULL,
+};
+
+static zend_object_iterator* valkey_glide_bitmap_get_iterator(zend_class_entry* ce,
+                                                              zval*             object,
+                                                              int               by_ref) {
+    valkey_glide_bitmap_iterator* iter;
+
+    if (by_ref) {
+        zend_throw_error(NULL, "An iterator cannot be used with foreach by reference");
+        return NULL;
+    }
+
+    iter = ecalloc(1, sizeof(valkey_glide_bitmap_iterator));
+    zend_iterator_init(&iter->it);
+    ZVAL_OBJ_COPY(&iter->it.data, Z_OBJ_P(object));
+    iter->it.funcs = &valkey_glide_bitmap_iterator_funcs;
+    iter->offset   = -1;
+
+    return &iter->it;
+}
+
+/* ====================================================================
+ * CLASS METHODS
+ * ==================================================================== */
+
+/* Validate a bit offset argument, throwing if it is out of range */
+static bool bitmap_check_offset(zend_long offset) {
+    if (offset < 0 || (int64_t) offset >= VALKEY_GLIDE_BITMAP_MAX_BITS) {
+        zend_throw_exception(
+            get_valkey_glide_exception_ce(), "Bit offset must be between 0 and 4294967295", 0);
+        return false;
+    }
+    return true;
+}
+
+static void bitmap_binary_method(INTERNAL_FUNCTION_PARAMETERS, bitmap_op_t op) {
+    zval* other;
+
+    ZEND_PARSE_PARAMETERS_START(1, 1)
+    Z_PARAM_OBJECT_OF_CLASS(other, valkey_glide_bitmap_ce)
+    ZEND_PARSE_PARAMETERS_END_EX(RETURN_THROWS());
+
+    valkey_glide_bitmap_from_string(
+        return_value,
+        bitmap_combine(VALKEY_GLIDE_BITMAP_ZVAL_GET_OBJECT(ZEND_THIS)->bytes,
+                       VALKEY_GLIDE_BITMAP_ZVAL_GET_OBJECT(other)->bytes,
+                       op));
+}
+
+/**
+ * Constructor: new ValkeyGlideBitmap($bytes = "")
+ */
+PHP_METHOD(ValkeyGlideBitmap, __construct) {
+    zend_string*                bytes = NULL;
+    valkey_glide_bitmap_object* bitmap;
+
+    ZEND_PARSE_PARAMETERS_START(0, 1)
+    Z_PARAM_OPTIONAL
+    Z_PARAM_STR(bytes)
+    ZEND_PARSE_PARAMETERS_END_EX(RETURN_THROWS());
+
+    if (bytes) {
+        bitmap = VALKEY_GLIDE_BITMAP_ZVAL_GET_OBJECT(ZEND_THIS);
+        zend_string_release(bitmap->bytes);
+        bitmap->bytes = zend_string_copy(bytes);
+    }
+}
+
+/**
+ * bitCount(): Number of set bits
+ */
+PHP_METHOD(ValkeyGlideBitmap, bitCount) {
+    zend_string* bytes;
+
+    ZEND_PARSE_PARAMETERS_NONE();
+
+    bytes = VALKEY_GLIDE_BITMAP_ZVAL_GET_OBJECT(ZEND_THIS)->bytes;
+    RETURN_LONG((zend_long) bitmap_popcount((const unsigned char*) ZSTR_VAL(bytes),
+                                            ZSTR_LEN(bytes)));
+}
+
+/**
+ * length(): Number of bits, set or not
+ */
+PHP_METHOD(ValkeyGlideBitmap, length) {
+    ZEND_PARSE_PARAMETERS_NONE();
+
+    RETURN_LONG((zend_long) ZSTR_LEN(VALKEY_GLIDE_BITMAP_ZVAL_GET_OBJECT(ZEND_THIS)->bytes) * 8);
+}
+
+/**
+ * getBit($offset): Whether the bit is set, false past the end
+ */
+PHP_METHOD(ValkeyGlideBitmap, getBit) {
+    zend_long    offset;
+    zend_string* bytes;
+
+    ZEND_PARSE_PARAMETERS_START(1, 1)
+    Z_PARAM_LONG(offset)
+    ZEND_PARSE_PARAMETERS_END_EX(RETURN_THROWS());
+
+    if (!bitmap_check_offset(offset)) {
+        RETURN_THROWS();
+    }
+
+    bytes = VALKEY_GLIDE_BITMAP_ZVAL_GET_OBJECT(ZEND_THIS)->bytes;
+    if ((size_t) (offset >> 3) >= ZSTR_LEN(bytes)) {
+        RETURN_FALSE;
+    }
+    RETURN_BOOL(((unsigned char) ZSTR_VAL(bytes)[offset >> 3]) & (0x80u >> (offset & 7)));
+}
+
+/**
+ * setBit($offset, $value = true): Set or clear a bit, growing the bitmap like SETBIT does
+ */
+PHP_METHOD(ValkeyGlideBitmap, setBit) {
+    zend_long                   offset;
+    bool                        value = true;
+    valkey_glide_bitmap_object* bitmap;
+    size_t                      byte, len;
+
+    ZEND_PARSE_PARAMETERS_START(1, 2)
+    Z_PARAM_LONG(offset)
+    Z_PARAM_OPTIONAL
+    Z_PARAM_BOOL(value)
+    ZEND_PARSE_PARAMETERS_END_EX(RETURN_THROWS());
+
+    if (!bitmap_check_offset(offset)) {
+        RETURN_THROWS();
+    }
+
+    bitmap = VALKEY_GLIDE_BITMAP_ZVAL_GET_OBJECT(ZEND_THIS);
+    byte   = (size_t) (offset >> 3);
+    len    = ZSTR_LEN(bitmap->bytes);
+
+    if (byte >= len) {
+        if (!value) {
+            return;
+        }
+        bitmap->bytes = zend_string_realloc(bitmap->bytes, byte + 1, 0);
+        memset(ZSTR_VAL(bitmap->bytes) + len, 0, byte + 1 - len);
+        ZSTR_VAL(bitmap->bytes)[byte + 1] = '\0';
+    } else {
+        bitmap->bytes = zend_string_separate(bitmap->bytes, 0);
+    }
+
+    if (value) {
+        ZSTR_VAL(bitmap->bytes)[byte] |= (char) (0x80u >> (offset & 7));
+    } else {
+        ZSTR_VAL(bitmap->bytes)[byte] &= (char) ~(0x80u >> (offset & 7));
+    }
+    zend_string_forget_hash_val(bitmap->bytes);
+}
+
+/**
+ * and($other): Bits set in both bitmaps
+ */
+PHP_METHOD(ValkeyGlideBitmap, and) {
+    bitmap_binary_method(INTERNAL_FUNCTION_PARAM_PASSTHRU, BITMAP_AND);
+}
+
+/**
+ * or($other): Bits set in either bitmap
+ */
+PHP_METHOD(ValkeyGlideBitmap, or) {
+    bitmap_binary_method(INTERNAL_FUNCTION_PARAM_PASSTHRU, BITMAP_OR);
+}
+
+/**
+ * xor($other): Bits set in exactly one of the bitmaps
+ */
+PHP_METHOD(ValkeyGlideBitmap, xor) {
+    bitmap_binary_method(INTERNAL_FUNCTION_PARAM_PASSTHRU, BITMAP_XOR);
+}
+
+/**
+ * andNot($other): Bits set in this bitmap and not in the other
+ */
+PHP_METHOD(ValkeyGlideBitmap, andNot) {
+    bitmap_binary_method(INTERNAL_FUNCTION_PARAM_PASSTHRU, BITMAP_ANDNOT);
+}
+
+/**
+ * rank($offset): Number of set bits up to and including the offset
+ */
+PHP_METHOD(ValkeyGlideBitmap, rank) {
+    zend_long offset;
+
+    ZEND_PARSE_PARAMETERS_START(1, 1)
+    Z_PARAM_LONG(offset)
+    ZEND_PARSE_PARAMETERS_END_EX(RETURN_THROWS());
+
+    if (!bitmap_check_offset(offset)) {
+        RETURN_THROWS();
+    }
+
+    RETURN_LONG(
+        (zend_long) bitmap_rank(VALKEY_GLIDE_BITMAP_ZVAL_GET_OBJECT(ZEND_THIS)->bytes, offset));
+}
+
+/**
+ * select($n): Offset of the nth set bit, counting from 0, false if there are not that many
+ */
+PHP_METHOD(ValkeyGlideBitmap, select) {
+    zend_long n;
+    int64_t   offset;
+
+    ZEND_PARSE_PARAMETERS_START(1, 1)
+    Z_PARAM_LONG(n)
+    ZEND_PARSE_PARAMETERS_END_EX(RETURN_THROWS());
+
+    if (n < 0) {
+        RETURN_FALSE;
+    }
+
+    offset = bitmap_select(VALKEY_GLIDE_BITMAP_ZVAL_GET_OBJECT(ZEND_THIS)->bytes, (uint64_t) n);
+    if (offset < 0) {
+        RETURN_FALSE;
+    }
+    RETURN_LONG((zend_long) offset);
+}
+
+/**
+ * toArray(): Offsets of the set bits, in order
+ */
+PHP_METHOD(ValkeyGlideBitmap, toArray) {
+    zend_string* bytes;
+    int64_t      offset;
+
+    ZEND_PARSE_PARAMETERS_NONE();
+
+    bytes = VALKEY_GLIDE_BITMAP_ZVAL_GET_OBJECT(ZEND_THIS)->bytes;
+    array_init_size(return_value,
+                    (uint32_t) bitmap_popcount((const unsigned char*) ZSTR_VAL(bytes),
+                                               ZSTR_LEN(bytes)));
+
+    for (offset = bitmap_next_set_bit(bytes, 0); offset >= 0;
+         offset = bitmap_next_set_bit(bytes, offset + 1)) {
+        add_next_index_long(return_value, (zend_long) offset);
+    }
+}
+
+/**
+ * getIterator(): Iterate over the offsets of the set bits
+ */
+PHP_METHOD(ValkeyGlideBitmap, getIterator) {
+    ZEND_PARSE_PARAMETERS_NONE();
+
+    zend_create_internal_iterator_zval(return_value, ZEND_THIS);
+}
+
+/**
+ * __toString(): The raw bytes, as stored in Valkey
+ */
+PHP_METHOD(ValkeyGlideBitmap, __toString) {
+    ZEND_PARSE_PARAMETERS_NONE();
+
+    RETURN_STR_COPY(VALKEY_GLIDE_BITMAP_ZVAL_GET_OBJECT(ZEND_THIS)->bytes);
+}
+
+/* ====================================================================
+ * CLIENT SIDE
+ * ==================================================================== */
+
+void valkey_glide_bitmap_from_string(zval* return_value, zend_string* bytes) {
+    valkey_glide_bitmap_object* bitmap;
+
+    object_init_ex(return_value, valkey_glide_bitmap_ce);
+    bitmap = VALKEY_GLIDE_BITMAP_ZVAL_GET_OBJECT(return_value);
+    zend_string_release(bitmap->bytes);
+    bitmap->bytes = bytes;
+}
+
+zend_string* valkey_glide_bitmap_bytes(zval* value) {
+    if (Z_TYPE_P(value) != IS_OBJECT ||
+        !instanceof_function(Z_OBJCE_P(value), valkey_glide_bitmap_ce)) {
+        return NULL;
+    }
+    return VALKEY_GLIDE_BITMAP_ZVAL_GET_OBJECT(value)->bytes;
+}
+
+/* A missing key reads as an empty bitmap, the same way GETBIT and BITCOUNT see it */
+static int process_bitmap_result(CommandResponse* response, void* output, zval* return_value) {
+    if (!response) {
+        ZVAL_NULL(return_value);
+        return 0;
+    }
+
+    if (response->response_type == String) {
+        valkey_glide_bitmap_from_string(return_value,
+                                        valkey_glide_string_from_response(response));
+        return 1;
+    } else if (response->response_type == Null) {
+        valkey_glide_bitmap_from_string(return_value, ZSTR_EMPTY_ALLOC());
+        return 1;
+    }
+
+    ZVAL_NULL(return_value);
+    return 0;
+}
+
+/* Execute a GET command, returning the value as a ValkeyGlideBitmap */
+int execute_get_bitmap_command(zval* object, int argc, zval* return_value, zend_class_entry* ce) {
+    valkey_glide_object* valkey_glide;
+    char*                key = NULL;
+    size_t               key_len;
+
+    if (zend_parse_method_parameters(argc, object, "Os", &object, ce, &key, &key_len) == FAILURE) {
+        return 0;
+    }
+
+    valkey_glide = VALKEY_GLIDE_PHP_ZVAL_GET_OBJECT(valkey_glide_object, object);
+    if (!valkey_glide || !valkey_glide->glide_client) {
+        return 0;
+    }
+
+    core_command_args_t args = {0};
+    args.glide_client        = valkey_glide->glide_client;
+    args.cmd_type            = Get;
+    args.key                 = key;
+    args.key_len             = key_len;
+
+    if (execute_core_command(valkey_glide, &args, NULL, process_bitmap_result, return_value)) {
+        if (valkey_glide->is_in_batch_mode) {
+            /* In batch mode, return $this for method chaining */
+            ZVAL_COPY(return_value, object);
+        }
+        return 1;
+    }
+
+    return 0;
+}
+
+/* Class registration function using generated arginfo */
+void register_valkey_glide_bitmap_class(void) {
+    valkey_glide_bitmap_ce                = register_class_ValkeyGlideBitmap(zend_ce_aggregate);
+    valkey_glide_bitmap_ce->create_object = create_valkey_glide_bitmap_object;
+    valkey_glide_bitmap_ce->get_iterator  = valkey_glide_bitmap_get_iterator;
+
+    memcpy(&valkey_glide_bitmap_object_handlers,
+           zend_get_std_object_handlers(),
+           sizeof(valkey_glide_bitmap_object_handlers));
+    valkey_glide_bitmap_object_handlers.offset    = XtOffsetOf(valkey_glide_bitmap_object, std);
+    valkey_glide_bitmap_object_handlers.free_obj  = free_valkey_glide_bitmap_object;
+    valkey_glide_bitmap_object_handlers.clone_obj = clone_valkey_glide_bitmap_object;
+    valkey_glide_bitmap_object_handlers.compare   = compare_valkey_glide_bitmap_objects;
+
+#if defined(__x86_64__) && defined(__GNUC__) && !defined(__POPCNT__)
+    if (__builtin_cpu_supports("popcnt")) {
+        bitmap_popcount_impl = bitmap_popcount_native;
+    }
+#endif
+}
+
+zend_class_entry* get_valkey_glide_bitmap_ce(void) {
+    return valkey_glide_bitmap_ce;
+}
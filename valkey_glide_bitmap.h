@@ -0,0 +1,56 @@
+/** Copyright Valkey GLIDE Project Contributors - SPDX Identifier: Apache-2.0 */
+
+#ifndef VALKEY_GLIDE_BITMAP_H
+#define VALKEY_GLIDE_BITMAP_H
+
+#include "common.h"
+#include "php.h"
+
+/*
+ * ValkeyGlideBitmap, a string value fetched with getBitmap() and worked on locally.
+ *
+ * Bits are numbered the way SETBIT/GETBIT number them: bit 0 is the most significant bit of the
+ * first byte. Counting, the bitwise operations and set-bit search run a machine word at a time.
+ * Writing the bitmap back is a plain set($key, $bitmap).
+ */
+#define VALKEY_GLIDE_BITMAP_MAX_BITS 4294967296LL /* 512MB, the largest string value */
+
+typedef struct {
+    zend_string* bytes; /* Never NULL, shared with the strings it came from until modified */
+    zend_object  std;
+} valkey_glide_bitmap_object;
+
+#define VALKEY_GLIDE_BITMAP_GET_OBJECT(obj) \
+    VALKEY_GLIDE_PHP_GET_OBJECT(valkey_glide_bitmap_object, obj)
+#define VALKEY_GLIDE_BITMAP_ZVAL_GET_OBJECT(zv) \
+    VALKEY_GLIDE_PHP_ZVAL_GET_OBJECT(valkey_glide_bitmap_object, zv)
+
+void              register_valkey_glide_bitmap_class(void);
+zend_class_entry* get_valkey_glide_bitmap_ce(void);
+
+/* Make return_value a bitmap holding bytes, taking the reference passed in */
+void valkey_glide_bitmap_from_string(zval* return_value, zend_string* bytes);
+
+/* The bytes of a bitmap zval, NULL if it is not one */
+zend_string* valkey_glide_bitmap_bytes(zval* value);
+
+int execute_get_bitmap_command(zval*             object,
+                               int               argc,
+                               zval*             return_value,
+                               zend_class_entry* ce);
+
+#define GET_BITMAP_METHOD_IMPL(class_name)                                            \
+    PHP_METHOD(class_name, getBitmap) {                                               \
+        if (execute_get_bitmap_command(getThis(),                                     \
+                                       ZEND_NUM_ARGS(),                               \
+                                       return_value,                                  \
+                                       strcmp(#class_name, "ValkeyGlideCluster") == 0 \
+                                           ? get_valkey_glide_cluster_ce()            \
+                                           : get_valkey_glide_ce())) {                \
+            return;                                                                   \
+        }                                                                             \
+        zval_dtor(return_value);                                                      \
+        RETURN_FALSE;                                                                 \
+    }
+
+#endif /* VALKEY_GLIDE_BITMAP_H */
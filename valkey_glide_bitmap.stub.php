@@ -0,0 +1,153 @@
+<?php
+
+/**
+ * @generate-function-entries
+ * @generate-legacy-arginfo
+ * @generate-class-entries
+ */
+
+/**
+ * ValkeyGlideBitmap is a bitmap value fetched with getBitmap() and worked on in memory.
+ *
+ * Bits are numbered like SETBIT and GETBIT number them, bit 0 being the most significant bit of
+ * the first byte, so offsets read here match the ones used on the server. Iterating a bitmap
+ * yields the offsets of its set bits. A bitmap is written back with set($key, $bitmap).
+ *
+ * @example
+ * $active = $client->getBitmap('active:2024-06-01')->and($client->getBitmap('active:2024-06-02'));
+ * echo $active->bitCount();
+ * $client->set('active:both', $active);
+ */
+final class ValkeyGlideBitmap implements IteratorAggregate
+{
+    /**
+     * Create a bitmap from raw bytes.
+     *
+     * @param string $bytes The bitmap as stored in Valkey. Defaults to an empty bitmap.
+     */
+    public function __construct(string $bytes = "")
+    {
+    }
+
+    /**
+     * Count the set bits, like BITCOUNT over the whole value.
+     *
+     * @return int The number of set bits.
+     */
+    public function bitCount(): int
+    {
+    }
+
+    /**
+     * Get the size of the bitmap.
+     *
+     * @return int The number of bits, set or not, which is eight times the byte length.
+     */
+    public function length(): int
+    {
+    }
+
+    /**
+     * Check a single bit.
+     *
+     * @param int $offset The bit offset.
+     *
+     * @return bool Whether the bit is set. Bits past the end are not.
+     */
+    public function getBit(int $offset): bool
+    {
+    }
+
+    /**
+     * Set or clear a single bit. Setting a bit past the end grows the bitmap with zeros.
+     *
+     * @param int  $offset The bit offset, up to 2^32 - 1.
+     * @param bool $value  Whether to set or clear the bit.
+     */
+    public function setBit(int $offset, bool $value = true): void
+    {
+    }
+
+    /**
+     * Bits set in both bitmaps, as BITOP AND computes them.
+     *
+     * @param ValkeyGlideBitmap $other The other bitmap. The shorter one is padded with zeros.
+     *
+     * @return ValkeyGlideBitmap A new bitmap as long as the longer of the two.
+     */
+    public function and(ValkeyGlideBitmap $other): ValkeyGlideBitmap
+    {
+    }
+
+    /**
+     * Bits set in either bitmap, as BITOP OR computes them.
+     *
+     * @see ValkeyGlideBitmap::and
+     */
+    public function or(ValkeyGlideBitmap $other): ValkeyGlideBitmap
+    {
+    }
+
+    /**
+     * Bits set in exactly one of the bitmaps, as BITOP XOR computes them.
+     *
+     * @see ValkeyGlideBitmap::and
+     */
+    public function xor(ValkeyGlideBitmap $other): ValkeyGlideBitmap
+    {
+    }
+
+    /**
+     * Bits set in this bitmap but not in the other one.
+     *
+     * @see ValkeyGlideBitmap::and
+     */
+    public function andNot(ValkeyGlideBitmap $other): ValkeyGlideBitmap
+    {
+    }
+
+    /**
+     * Count the set bits up to and including an offset.
+     *
+     * @param int $offset The bit offset.
+     *
+     * @return int The number of set bits in [0, $offset].
+     */
+    public function rank(int $offset): int
+    {
+    }
+
+    /**
+     * Find the nth set bit, the inverse of rank().
+     *
+     * @param int $n Which set bit to find, counting from 0.
+     *
+     * @return int|false The offset of the bit, or false if fewer than $n + 1 bits are set.
+     */
+    public function select(int $n): int|false
+    {
+    }
+
+    /**
+     * List the offsets of the set bits.
+     *
+     * @return array The offsets, in ascending order.
+     */
+    public function toArray(): array
+    {
+    }
+
+    /**
+     * Iterate over the offsets of the set bits in ascending order, keyed from 0.
+     */
+    public function getIterator(): Iterator
+    {
+    }
+
+    /**
+     * Get the raw bytes, as stored in Valkey.
+     */
+    public function __toString(): string
+    {
+    }
+}
@@ -0,0 +1,801 @@
+/** Copyright Valkey GLIDE Project Contributors - SPDX Identifier: Apache-2.0 */
+
+#include "valkey_glide_bloom.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+#include <zend_exceptions.h>
+
+#include "include/glide_bindings.h"
+#include "valkey_glide_bitmap.h"
+#include "valkey_glide_bloom_arginfo.h"
+#include "valkey_glide_commands_common.h"
+
+static zend_class_entry*    valkey_glide_bloom_ce;
+static zend_object_handlers valkey_glide_bloom_object_handlers;
+
+#define BLOOM_MIN_SCAN_CAPACITY 1024
+
+#define BLOOM_SEED 0x2d358dccaa6c78a5ULL
+#define BLOOM_PRIME 0x9e3779b97f4a7c15ULL
+
+/* ====================================================================
+ * HASHING
+ *
+ * One 64-bit hash per key. Its high half picks the block, its low half and a remix give the
+ * start and the stride of the bit positions inside the block. Words are read little-endian
+ * whatever the host, so a saved filter works on any machine.
+ * ==================================================================== */
+
+static zend_always_inline uint64_t bloom_load(const unsigned char* p, size_t len) {
+    uint64_t word = 0;
+    size_t   i;
+
+    for (i = 0; i < len; i++) {
+        word |= (uint64_t) p[i] << (8 * i);
+    }
+    return word;
+}
+
+static zend_always_inline uint64_t bloom_mix(uint64_t h) {
+    h ^= h >> 30;
+    h *= 0xbf58476d1ce4e5b9ULL;
+    h ^= h >> 27;
+    h *= 0x94d049bb133111ebULL;
+    return h ^ (h >> 31);
+}
+
+static uint64_t bloom_hash(const char* key, size_t len) {
+    const unsigned char* p = (const unsigned char*) key;
+    uint64_t             h = BLOOM_SEED ^ ((uint64_t) len * BLOOM_PRIME);
+
+    for (; len >= 8; p += 8, len -= 8) {
+        h = (h ^ bloom_load(p, 8)) * BLOOM_PRIME;
+        h ^= h >> 29;
+    }
+    if (len > 0) {
+        h = (h ^ bloom_load(p, len)) * BLOOM_PRIME;
+    }
+    return bloom_mix(h);
+}
+
+static zend_always_inline unsigned char* bloom_block(const valkey_glide_bloom_object* bloom,
+                                                     uint64_t                         h) {
+    return bloom->bits + ((h >> 32) * bloom->blocks >> 32) * VALKEY_GLIDE_BLOOM_BLOCK_BYTES;
+}
+
+void valkey_glide_bloom_add(valkey_glide_bloom_object* bloom, const char* key, size_t key_len) {
+    uint64_t       h     = bloom_hash(key, key_len);
+    unsigned char* block = bloom_block(bloom, h);
+    uint32_t       bit   = (uint32_t) h;
+    uint32_t       step  = (uint32_t) (bloom_mix(h) >> 32) | 1;
+    int            i;
+
+    /* Bit 0 is the most significant bit of the first byte, as SETBIT numbers them */
+    for (i = 0; i < bloom->hashes; i++, bit += step) {
+        uint32_t pos = bit & (VALKEY_GLIDE_BLOOM_BLOCK_BITS - 1);
+        block[pos >> 3] |= 0x80 >> (pos & 7);
+    }
+    bloom->items++;
+}
+
+bool valkey_glide_bloom_might_contain(const valkey_glide_bloom_object* bloom,
+                                      const char*                      key,
+                                      size_t                           key_len) {
+    uint64_t             h     = bloom_hash(key, key_len);
+    const unsigned char* block = bloom_block(bloom, h);
+    uint32_t             bit   = (uint32_t) h;
+    uint32_t             step  = (uint32_t) (bloom_mix(h) >> 32) | 1;
+    int                  i;
+
+    for (i = 0; i < bloom->hashes; i++, bit += step) {
+        uint32_t pos = bit & (VALKEY_GLIDE_BLOOM_BLOCK_BITS - 1);
+        if (!(block[pos >> 3] & (0x80 >> (pos & 7)))) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/* ====================================================================
+ * OBJECT HANDLERS
+ * ==================================================================== */
+
+static zend_object* create_valkey_glide_bloom_object(zend_class_entry* ce) {
+    valkey_glide_bloom_object* bloom =
+        ecalloc(1, sizeof(valkey_glide_bloom_object) + zend_object_properties_size(ce));
+
+    zend_object_std_init(&bloom->std, ce);
+    object_properties_init(&bloom->std, ce);
+    bloom->std.handlers = &valkey_glide_bloom_object_handlers;
+
+    return &bloom->std;
+}
+
+static void free_valkey_glide_bloom_object(zend_object* object) {
+    valkey_glide_bloom_object* bloom = VALKEY_GLIDE_BLOOM_GET_OBJECT(object);
+
+    if (bloom->allocation) {
+        efree(bloom->allocation);
+    }
+    zend_object_std_dtor(&bloom->std);
+}
+
+/*
+ * Blocking costs some accuracy, the keys sharing a block crowd it, and the more so the lower the
+ * rate asked for. 15% more bits than an unblocked filter per decade of rate buys it back.
+ */
+static double bloom_blocking_overhead(double rate) {
+    return 1.0 - 0.15 * log10(rate);
+}
+
+/* Allocate the zeroed bits of a filter, aligning them to a cache line */
+static void bloom_allocate(valkey_glide_bloom_object* bloom, zend_ulong blocks, int hashes) {
+    bloom->allocation =
+        safe_emalloc(blocks, VALKEY_GLIDE_BLOOM_BLOCK_BYTES, VALKEY_GLIDE_BLOOM_BLOCK_BYTES - 1);
+    bloom->bits   = (unsigned char*) ZEND_MM_ALIGNED_SIZE_EX((uintptr_t) bloom->allocation,
+                                                           VALKEY_GLIDE_BLOOM_BLOCK_BYTES);
+    bloom->blocks = blocks;
+    bloom->hashes = hashes;
+    memset(bloom->bits, 0, blocks * VALKEY_GLIDE_BLOOM_BLOCK_BYTES);
+}
+
+/* Size a filter for capacity keys at the given false positive rate, throwing if it can't be */
+static bool bloom_init(valkey_glide_bloom_object* bloom, zend_long capacity, double rate) {
+    double bits_per_key = -log(rate) / (M_LN2 * M_LN2);
+    double bits         = (double) capacity * bits_per_key * bloom_blocking_overhead(rate);
+    double blocks       = ceil(bits / VALKEY_GLIDE_BLOOM_BLOCK_BITS);
+    int    hashes       = (int) lround(bits_per_key * M_LN2);
+
+    if (blocks > VALKEY_GLIDE_BLOOM_MAX_BLOCKS) {
+        zend_throw_exception(get_valkey_glide_exception_ce(),
+                             "The Bloom filter would be larger than a string value can be",
+                             0);
+        return false;
+    }
+
+    bloom_allocate(
+        bloom, (zend_ulong) blocks, MAX(1, MIN(hashes, VALKEY_GLIDE_BLOOM_MAX_HASHES)));
+    bloom->capacity = capacity;
+    return true;
+}
+
+static bool bloom_valid_rate(double rate, uint32_t arg_num) {
+    if (!(rate > 0.0 && rate < 1.0)) {
+        zend_argument_value_error(arg_num, "must be between 0 and 1, exclusive");
+        return false;
+    }
+    return true;
+}
+
+/* The filter behind $this, NULL after throwing if it was never initialized */
+static valkey_glide_bloom_object* bloom_from_this(zval* this_ptr) {
+    valkey_glide_bloom_object* bloom = VALKEY_GLIDE_BLOOM_ZVAL_GET_OBJECT(this_ptr);
+
+    if (!bloom->bits) {
+        zend_throw_error(NULL, "ValkeyGlideBloom has not been initialized");
+        return NULL;
+    }
+    return bloom;
+}
+
+/* ====================================================================
+ * BUILDING FROM THE SERVER
+ * ==================================================================== */
+
+/* Throw the error of a failed command, or a generic one */
+static void bloom_throw_result(CommandResult* result, const char* fallback) {
+    zend_throw_exception(get_valkey_glide_exception_ce(),
+                         result && result->command_error &&
+                                 result->command_error->command_error_message
+                             ? result->command_error->command_error_message
+                             : fallback,
+                         0);
+}
+
+static zend_long bloom_dbsize(const void* glide_client) {
+    CommandResult* result   = execute_command(glide_client, DBSize, 0, NULL, NULL);
+    zend_long      key_count = -1;
+
+    if (result && !result->command_error && result->response &&
+        result->response->response_type == Int) {
+        key_count = (zend_long) result->response->int_value;
+    } else {
+        bloom_throw_result(result, "DBSIZE failed");
+    }
+    if (result) {
+        free_command_result(result);
+    }
+    return key_count;
+}
+
+/* SCAN the whole keyspace, adding every key returned */
+static bool bloom_scan(valkey_glide_bloom_object* bloom,
+                       const void*                glide_client,
+                       zend_string*               pattern,
+                       zend_long                  count) {
+    char          cursor[32] = "0";
+    char          count_str[24];
+    uintptr_t     args[5];
+    unsigned long args_len[5];
+    int           arg_count;
+
+    size_t count_len = snprintf(count_str, sizeof(count_str), ZEND_LONG_FMT, count);
+
+    do {
+        arg_count             = 0;
+        args[arg_count]       = (uintptr_t) cursor;
+        args_len[arg_count++] = strlen(cursor);
+        if (pattern) {
+            args[arg_count]       = (uintptr_t) "MATCH";
+            args_len[arg_count++] = 5;
+            args[arg_count]       = (uintptr_t) ZSTR_VAL(pattern);
+            args_len[arg_count++] = ZSTR_LEN(pattern);
+        }
+        args[arg_count]       = (uintptr_t) "COUNT";
+        args_len[arg_count++] = 5;
+        args[arg_count]       = (uintptr_t) count_str;
+        args_len[arg_count++] = count_len;
+
+        CommandResult* result = execute_command(glide_client, Scan, arg_count, args, args_len);
+
+        /* The reply is [next cursor, [keys...]] */
+        if (!result || result->command_error || !result->response ||
+            result->response->response_type != Array || result->response->array_value_len != 2 ||
+            result->response->array_value[0].response_type != String ||
+            result->response->array_value[0].string_value_len >= (long) sizeof(cursor) ||
+            result->response->array_value[1].response_type != Array) {
+            bloom_throw_result(result, "SCAN returned an unexpected reply");
+            if (result) {
+                free_command_result(result);
+            }
+            return false;
+        }
+
+        const CommandResponse* keys = &result->response->array_value[1];
+        for (long i = 0; i < keys->array_value_len; i++) {
+            if (keys->array_value[i].response_type == String) {
+                valkey_glide_bloom_add(bloom,
+                                       (const char*) keys->array_value[i].string_value,
+                                       (size_t) keys->array_value[i].string_value_len);
+            }
+        }
+
+        memcpy(cursor,
+               result->response->array_value[0].string_value,
+               result->response->array_value[0].string_value_len);
+        cursor[result->response->array_value[0].string_value_len] = '\0';
+        free_command_result(result);
+    } while (strcmp(cursor, "0") != 0);
+
+    return true;
+}
+
+/* ====================================================================
+ * METHODS
+ * ==================================================================== */
+
+/**
+ * Constructor: new ValkeyGlideBloom($capacity, $falsePositiveRate = 0.01)
+ */
+PHP_METHOD(ValkeyGlideBloom, __construct) {
+    zend_long                  capacity;
+    double                     rate = 0.01;
+    valkey_glide_bloom_object* bloom;
+
+    ZEND_PARSE_PARAMETERS_START(1, 2)
+    Z_PARAM_LONG(capacity)
+    Z_PARAM_OPTIONAL
+    Z_PARAM_DOUBLE(rate)
+    ZEND_PARSE_PARAMETERS_END_EX(RETURN_THROWS());
+
+    bloom = VALKEY_GLIDE_BLOOM_ZVAL_GET_OBJECT(ZEND_THIS);
+    if (bloom->bits) {
+        zend_throw_error(NULL, "ValkeyGlideBloom is already initialized");
+        RETURN_THROWS();
+    }
+    if (capacity <= 0) {
+        zend_argument_value_error(1, "must be greater than 0");
+        RETURN_THROWS();
+    }
+    if (!bloom_valid_rate(rate, 2) || !bloom_init(bloom, capacity, rate)) {
+        RETURN_THROWS();
+    }
+}
+
+/**
+ * fromScan($client, $pattern = null, $falsePositiveRate = 0.01, $count = 1000): Build from SCAN
+ */
+PHP_METHOD(ValkeyGlideBloom, fromScan) {
+    zval*                client;
+    zend_string*         pattern = NULL;
+    double               rate    = 0.01;
+    zend_long            count   = 1000;
+    valkey_glide_object* valkey_glide;
+    zend_long            key_count;
+
+    ZEND_PARSE_PARAMETERS_START(1, 4)
+    Z_PARAM_OBJECT_OF_CLASS(client, get_valkey_glide_ce())
+    Z_PARAM_OPTIONAL
+    Z_PARAM_STR_OR_NULL(pattern)
+    Z_PARAM_DOUBLE(rate)
+    Z_PARAM_LONG(count)
+    ZEND_PARSE_PARAMETERS_END_EX(RETURN_THROWS());
+
+    if (!bloom_valid_rate(rate, 3)) {
+        RETURN_THROWS();
+    }
+    if (count <= 0) {
+        zend_argument_value_error(4, "must be greater than 0");
+        RETURN_THROWS();
+    }
+
+    valkey_glide = VALKEY_GLIDE_PHP_ZVAL_GET_OBJECT(valkey_glide_object, client);
+    if (!valkey_glide->glide_client) {
+        zend_throw_exception(get_valkey_glide_exception_ce(), "The client is not connected", 0);
+        RETURN_THROWS();
+    }
+    if (valkey_glide->is_in_batch_mode) {
+        zend_throw_exception(get_valkey_glide_exception_ce(),
+                             "ValkeyGlideBloom::fromScan() cannot run inside a batch",
+                             0);
+        RETURN_THROWS();
+    }
+
+    /* Leave room for the database to double before the rate degrades */
+    key_count = bloom_dbsize(valkey_glide->glide_client);
+    if (key_count < 0) {
+        RETURN_THROWS();
+    }
+
+    object_init_ex(return_value, valkey_glide_bloom_ce);
+    valkey_glide_bloom_object* bloom = VALKEY_GLIDE_BLOOM_ZVAL_GET_OBJECT(return_value);
+
+    if (!bloom_init(bloom, MAX(BLOOM_MIN_SCAN_CAPACITY, 2 * key_count), rate) ||
+        !bloom_scan(bloom, valkey_glide->glide_client, pattern, count)) {
+        zval_ptr_dtor(return_value);
+        ZVAL_UNDEF(return_value);
+        RETURN_THROWS();
+    }
+}
+
+/**
+ * fromBitmap($bits, $hashes): Load a filter saved with __toString()
+ */
+PHP_METHOD(ValkeyGlideBloom, fromBitmap) {
+    zval*                      bits;
+    zend_long                  hashes;
+    zend_string*               bytes;
+    valkey_glide_bloom_object* bloom;
+
+    ZEND_PARSE_PARAMETERS_START(2, 2)
+    Z_PARAM_ZVAL(bits)
+    Z_PARAM_LONG(hashes)
+    ZEND_PARSE_PARAMETERS_END_EX(RETURN_THROWS());
+
+    if (Z_TYPE_P(bits) == IS_STRING) {
+        bytes = Z_STR_P(bits);
+    } else if (!(bytes = valkey_glide_bitmap_bytes(bits))) {
+        zend_argument_type_error(
+            1, "must be of type ValkeyGlideBitmap|string, %s given", zend_zval_type_name(bits));
+        RETURN_THROWS();
+    }
+    if (ZSTR_LEN(bytes) == 0 || ZSTR_LEN(bytes) % VALKEY_GLIDE_BLOOM_BLOCK_BYTES != 0) {
+        zend_argument_value_error(1, "must be a non-empty multiple of 64 bytes");
+        RETURN_THROWS();
+    }
+    if (hashes < 1 || hashes > VALKEY_GLIDE_BLOOM_MAX_HASHES) {
+        zend_argument_value_error(2, "must be between 1 and %d", VALKEY_GLIDE_BLOOM_MAX_HASHES);
+        RETURN_THROWS();
+    }
+
+    object_init_ex(return_value, valkey_glide_bloom_ce);
+    bloom = VALKEY_GLIDE_BLOOM_ZVAL_GET_OBJECT(return_value);
+    bloom_allocate(bloom, ZSTR_LEN(bytes) / VALKEY_GLIDE_BLOOM_BLOCK_BYTES, (int) hashes);
+    memcpy(bloom->bits, ZSTR_VAL(bytes), ZSTR_LEN(bytes));
+
+    /* The load that many hashes was chosen for, at a rate of 2^-hashes */
+    bloom->capacity = (zend_long) (ZSTR_LEN(bytes) * 8 * M_LN2 /
+                                   (hashes * bloom_blocking_overhead(pow(2.0, -hashes))));
+}
+
+/**
+ * add($keys, ...$other_keys): Add a key, an array of keys, or several keys
+ */
+PHP_METHOD(ValkeyGlideBloom, add) {
+    zval*                      keys;
+    zval*                      other_keys = NULL;
+    int                        other_count = 0;
+    zend_long                  added       = 0;
+    valkey_glide_bloom_object* bloom;
+    zval*                      entry;
+    int                        i;
+
+    ZEND_PARSE_PARAMETERS_START(1, -1)
+    Z_PARAM_ZVAL(keys)
+    Z_PARAM_VARIADIC('*', other_keys, other_count)
+    ZEND_PARSE_PARAMETERS_END_EX(RETURN_THROWS());
+
+    if (!(bloom = bloom_from_this(ZEND_THIS))) {
+        RETURN_THROWS();
+    }
+
+    if (Z_TYPE_P(keys) == IS_ARRAY) {
+        ZEND_HASH_FOREACH_VAL(Z_ARRVAL_P(keys), entry) {
+            zend_string* tmp;
+            zend_string* key = zval_get_tmp_string(entry, &tmp);
+
+            valkey_glide_bloom_add(bloom, ZSTR_VAL(key), ZSTR_LEN(key));
+            zend_tmp_string_release(tmp);
+            added++;
+        }
+        ZEND_HASH_FOREACH_END();
+    } else {
+        zend_string* tmp;
+        zend_string* key = zval_get_tmp_string(keys, &tmp);
+
+        valkey_glide_bloom_add(bloom, ZSTR_VAL(key), ZSTR_LEN(key));
+        zend_tmp_string_release(tmp);
+        added++;
+    }
+
+    for (i = 0; i < other_count; i++) {
+        valkey_glide_bloom_add(bloom, Z_STRVAL(other_keys[i]), Z_STRLEN(other_keys[i]));
+        added++;
+    }
+
+    RETURN_LONG(added);
+}
+
+/**
+ * mightContain($key): False if the key was never added
+ */
+PHP_METHOD(ValkeyGlideBloom, mightContain) {
+    zend_string*               key;
+    valkey_glide_bloom_object* bloom;
+
+    ZEND_PARSE_PARAMETERS_START(1, 1)
+    Z_PARAM_STR(key)
+    ZEND_PARSE_PARAMETERS_END_EX(RETURN_THROWS());
+
+    if (!(bloom = bloom_from_this(ZEND_THIS))) {
+        RETURN_THROWS();
+    }
+    RETURN_BOOL(valkey_glide_bloom_might_contain(bloom, ZSTR_VAL(key), ZSTR_LEN(key)));
+}
+
+/**
+ * clear(): Forget every key
+ */
+PHP_METHOD(ValkeyGlideBloom, clear) {
+    valkey_glide_bloom_object* bloom;
+
+    ZEND_PARSE_PARAMETERS_NONE();
+
+    if (!(bloom = bloom_from_this(ZEND_THIS))) {
+        RETURN_THROWS();
+    }
+    memset(bloom->bits, 0, bloom->blocks * VALKEY_GLIDE_BLOOM_BLOCK_BYTES);
+    bloom->items = 0;
+}
+
+/**
+ * getStats(): Shape, fill and lookup counters
+ */
+PHP_METHOD(ValkeyGlideBloom, getStats) {
+    valkey_glide_bloom_object* bloom;
+    uint64_t                   set_bits = 0;
+    size_t                     bytes, i;
+    double                     fill;
+
+    ZEND_PARSE_PARAMETERS_NONE();
+
+    if (!(bloom = bloom_from_this(ZEND_THIS))) {
+        RETURN_THROWS();
+    }
+
+    bytes = bloom->blocks * VALKEY_GLIDE_BLOOM_BLOCK_BYTES;
+    for (i = 0; i < bytes; i += 8) {
+        set_bits += __builtin_popcountll(bloom_load(bloom->bits + i, 8));
+    }
+    fill = (double) set_bits / (double) (bytes * 8);
+
+    array_init(return_value);
+    add_assoc_long(return_value, "capacity", bloom->capacity);
+    add_assoc_long(return_value, "hashes", bloom->hashes);
+    add_assoc_long(return_value, "bytes", (zend_long) bytes);
+    add_assoc_long(return_value, "items", bloom->items);
+    add_assoc_double(return_value, "fill_ratio", fill);
+    add_assoc_double(return_value, "false_positive_rate", pow(fill, bloom->hashes));
+    add_assoc_long(return_value, "lookups", bloom->lookups);
+    add_assoc_long(return_value, "short_circuits", bloom->short_circuits);
+}
+
+/**
+ * __toString(): The bits, as a bitmap string value
+ */
+PHP_METHOD(ValkeyGlideBloom, __toString) {
+    valkey_glide_bloom_object* bloom;
+
+    ZEND_PARSE_PARAMETERS_NONE();
+
+    if (!(bloom = bloom_from_this(ZEND_THIS))) {
+        RETURN_THROWS();
+    }
+    RETURN_STRINGL((const char*) bloom->bits, bloom->blocks * VALKEY_GLIDE_BLOOM_BLOCK_BYTES);
+}
+
+/* ====================================================================
+ * CLIENT SIDE
+ * ==================================================================== */
+
+bool valkey_glide_bloom_note_command(valkey_glide_bloom_object* bloom,
+                                     enum RequestType           cmd_type,
+                                     const uintptr_t*           args,
+                                     const unsigned long*       args_len,
+                                     unsigned long              arg_count) {
+    unsigned long i;
+
+    if (!bloom->bits || !args || arg_count == 0) {
+        return true;
+    }
+
+    switch (cmd_type) {
+        /* Reads, and commands that only remove keys, create nothing */
+        case Get:
+        case GetDel:
+        case MGet:
+        case Exists:
+        case Strlen:
+        case Type:
+        case TTL:
+        case PTTL:
+        case ExpireTime:
+        case PExpireTime:
+        case Dump:
+        case GetRange:
+        case GetBit:
+        case BitCount:
+        case BitPos:
+        case PfCount:
+        case Touch:
+        case Watch:
+        case Del:
+        case Unlink:
+        case Move:
+        case HGet:
+        case HMGet:
+        case HExists:
+        case HStrlen:
+        case HLen:
+        case HKeys:
+        case HVals:
+        case HGetAll:
+        case HRandField:
+        case HTtl:
+        case HPTtl:
+        case HExpireTime:
+        case HPExpireTime:
+        case HDel:
+        case Select:
+            return true;
+
+        /* Commands creating the key in their second argument */
+        case Rename:
+        case RenameNX:
+        case Copy:
+        case BitOp:
+        case SMove:
+        case LMove:
+        case BLMove:
+        case RPopLPush:
+        case BRPopLPush:
+            if (arg_count > 1) {
+                valkey_glide_bloom_add(bloom, (const char*) args[1], args_len[1]);
+            }
+            return true;
+
+        /* A raw command, EVAL among them, can write a key anywhere after its name */
+        case CustomCommand:
+            if (args_len[0] == 6 && strncasecmp((const char*) args[0], "SELECT", 6) == 0) {
+                return false;
+            }
+            for (i = 1; i < arg_count; i++) {
+                valkey_glide_bloom_add(bloom, (const char*) args[i], args_len[i]);
+            }
+            return true;
+
+        /* SORT ... STORE destination */
+        case Sort:
+            for (i = 1; i + 1 < arg_count; i++) {
+                if (args_len[i] == 5 && strncasecmp((const char*) args[i], "STORE", 5) == 0) {
+                    valkey_glide_bloom_add(bloom, (const char*) args[i + 1], args_len[i + 1]);
+                }
+            }
+            return true;
+
+        /* Functions take their keys after the name and their count */
+        case FCall:
+            for (i = 2; i < arg_count; i++) {
+                valkey_glide_bloom_add(bloom, (const char*) args[i], args_len[i]);
+            }
+            return true;
+
+        case MSet:
+        case MSetNX:
+            for (i = 0; i + 1 < arg_count; i += 2) {
+                valkey_glide_bloom_add(bloom, (const char*) args[i], args_len[i]);
+            }
+            return true;
+
+        /* Anything else may create its first argument: an extra key costs a little accuracy */
+        default:
+            valkey_glide_bloom_add(bloom, (const char*) args[0], args_len[0]);
+            return true;
+    }
+}
+
+/* Count a lookup, and whether the filter answered it */
+static bool bloom_lookup(valkey_glide_bloom_object* bloom, const char* key, size_t key_len) {
+    bloom->lookups++;
+    if (valkey_glide_bloom_might_contain(bloom, key, key_len)) {
+        return false;
+    }
+    bloom->short_circuits++;
+    return true;
+}
+
+bool valkey_glide_bloom_rules_out(valkey_glide_object* valkey_glide,
+                                  const char*          key,
+                                  size_t               key_len) {
+    valkey_glide_bloom_object* bloom;
+
+    if (EXPECTED(valkey_glide->bloom == NULL) || valkey_glide->is_in_batch_mode) {
+        return false;
+    }
+    /* Registered while the client stays on the database the filter describes */
+    bloom = valkey_glide_bloom_find(valkey_glide->glide_client);
+    return bloom && bloom->bits && bloom_lookup(bloom, key, key_len);
+}
+
+/* exists() takes keys of any scalar type, converting them the way the command would */
+static bool bloom_might_contain_zval(const valkey_glide_bloom_object* bloom, zval* key) {
+    zend_string* tmp;
+    zend_string* str   = zval_get_tmp_string(key, &tmp);
+    bool         found = valkey_glide_bloom_might_contain(bloom, ZSTR_VAL(str), ZSTR_LEN(str));
+
+    zend_tmp_string_release(tmp);
+    return found;
+}
+
+bool valkey_glide_bloom_rules_out_keys(valkey_glide_object* valkey_glide, zval* keys, int argc) {
+    valkey_glide_bloom_object* bloom;
+    HashTable*                 array = NULL;
+    uint32_t                   count, i = 0;
+    zval*                      key;
+
+    if (EXPECTED(valkey_glide->bloom == NULL) || valkey_glide->is_in_batch_mode) {
+        return false;
+    }
+    bloom = valkey_glide_bloom_find(valkey_glide->glide_client);
+    if (!bloom) {
+        return false;
+    }
+
+    if (argc == 1 && Z_TYPE(keys[0]) == IS_ARRAY) {
+        array = Z_ARRVAL(keys[0]);
+    }
+    count = array ? zend_hash_num_elements(array) : (uint32_t) argc;
+    if (!bloom->bits || count == 0) {
+        return false;
+    }
+
+    bloom->lookups++;
+    if (array) {
+        ZEND_HASH_FOREACH_VAL(array, key) {
+            if (bloom_might_contain_zval(bloom, key)) {
+                return false;
+            }
+        }
+        ZEND_HASH_FOREACH_END();
+    } else {
+        for (i = 0; i < count; i++) {
+            if (bloom_might_contain_zval(bloom, &keys[i])) {
+                return false;
+            }
+        }
+    }
+
+    bloom->short_circuits++;
+    return true;
+}
+
+void valkey_glide_bloom_release(valkey_glide_object* valkey_glide) {
+    if (!valkey_glide->bloom) {
+        return;
+    }
+
+    zend_ulong index = (zend_ulong) (uintptr_t) valkey_glide->glide_client;
+    if (zend_hash_index_find_ptr(&VALKEY_GLIDE_G(blooms), index) ==
+        VALKEY_GLIDE_BLOOM_GET_OBJECT(valkey_glide->bloom)) {
+        zend_hash_index_del(&VALKEY_GLIDE_G(blooms), index);
+    }
+
+    OBJ_RELEASE(valkey_glide->bloom);
+    valkey_glide->bloom = NULL;
+}
+
+/* Execute setBloomFilter() - attach a filter to the client, or detach it with null */
+int execute_set_bloom_filter_command(zval*             object,
+                                     int               argc,
+                                     zval*             return_value,
+                                     zend_class_entry* ce) {
+    valkey_glide_object* valkey_glide;
+    zval*                z_bloom = NULL;
+
+    if (zend_parse_method_parameters(
+            argc, object, "OO!", &object, ce, &z_bloom, valkey_glide_bloom_ce) == FAILURE) {
+        return 0;
+    }
+
+    valkey_glide = VALKEY_GLIDE_PHP_ZVAL_GET_OBJECT(valkey_glide_object, object);
+    if (z_bloom && !VALKEY_GLIDE_BLOOM_ZVAL_GET_OBJECT(z_bloom)->bits) {
+        zend_throw_error(NULL, "ValkeyGlideBloom has not been initialized");
+        return 0;
+    }
+
+    valkey_glide_bloom_release(valkey_glide);
+    if (z_bloom) {
+        /* Keys are recorded by the client handle, which only exists once connected */
+        if (!valkey_glide->glide_client ||
+            valkey_glide_refuse_shared(valkey_glide, "setBloomFilter()")) {
+            return 0;
+        }
+        valkey_glide->bloom = Z_OBJ_P(z_bloom);
+        GC_ADDREF(valkey_glide->bloom);
+        zend_hash_index_update_ptr(&VALKEY_GLIDE_G(blooms),
+                                   (zend_ulong) (uintptr_t) valkey_glide->glide_client,
+                                   VALKEY_GLIDE_BLOOM_GET_OBJECT(valkey_glide->bloom));
+    }
+
+    ZVAL_TRUE(return_value);
+    return 1;
+}
+
+/* Execute getBloomFilter() - the attached filter, or null */
+int execute_get_bloom_filter_command(zval*             object,
+                                     int               argc,
+                                     zval*             return_value,
+                                     zend_class_entry* ce) {
+    valkey_glide_object* valkey_glide;
+
+    if (zend_parse_method_parameters(argc, object, "O", &object, ce) == FAILURE) {
+        return 0;
+    }
+
+    valkey_glide = VALKEY_GLIDE_PHP_ZVAL_GET_OBJECT(valkey_glide_object, object);
+    if (valkey_glide->bloom) {
+        ZVAL_OBJ_COPY(return_value, valkey_glide->bloom);
+    } else {
+        ZVAL_NULL(return_value);
+    }
+    return 1;
+}
+
+/* Class registration function using generated arginfo */
+void register_valkey_glide_bloom_class(void) {
+    valkey_glide_bloom_ce                = register_class_ValkeyGlideBloom();
+    valkey_glide_bloom_ce->create_object = create_valkey_glide_bloom_object;
+
+    memcpy(&valkey_glide_bloom_object_handlers,
+           zend_get_std_object_handlers(),
+           sizeof(valkey_glide_bloom_object_handlers));
+    valkey_glide_bloom_object_handlers.offset    = XtOffsetOf(valkey_glide_bloom_object, std);
+    valkey_glide_bloom_object_handlers.free_obj  = free_valkey_glide_bloom_object;
+    valkey_glide_bloom_object_handlers.clone_obj = NULL;
+}
+
+zend_class_entry* get_valkey_glide_bloom_ce(void) {
+    return valkey_glide_bloom_ce;
+}
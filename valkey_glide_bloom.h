@@ -0,0 +1,146 @@
+/** Copyright Valkey GLIDE Project Contributors - SPDX Identifier: Apache-2.0 */
+
+#ifndef VALKEY_GLIDE_BLOOM_H
+#define VALKEY_GLIDE_BLOOM_H
+
+#include "common.h"
+#include "include/glide_bindings.h"
+#include "php.h"
+
+/*
+ * ValkeyGlideBloom, a client-side Bloom filter over the keys of a database.
+ *
+ * The filter is blocked: a key hashes once, picks one 64-byte block and sets its bits within
+ * that block, so a lookup touches a single cache line. Attached to a client with
+ * setBloomFilter(), it is registered by glide client and fed the keys of every command the
+ * client sends, single, routed, batched, submitted or written through valkey:// streams, and
+ * get(), hGet() and exists() answer "missing" without a round trip for keys it has never seen.
+ * Keys created any other way (other clients, server-side moves) must be added to it, a key the
+ * filter misses would read as absent. select() detaches it, as it describes one database. Bits
+ * are laid out the way SETBIT numbers them, so a filter round-trips through a plain string key.
+ */
+#define VALKEY_GLIDE_BLOOM_BLOCK_BYTES 64
+#define VALKEY_GLIDE_BLOOM_BLOCK_BITS (VALKEY_GLIDE_BLOOM_BLOCK_BYTES * 8)
+#define VALKEY_GLIDE_BLOOM_MAX_HASHES 16
+#define VALKEY_GLIDE_BLOOM_MAX_BLOCKS 8388608 /* 512MB, the largest string value */
+
+typedef struct {
+    unsigned char* bits; /* blocks * VALKEY_GLIDE_BLOOM_BLOCK_BYTES, aligned to a cache line */
+    void*          allocation;
+    zend_ulong     blocks;
+    int            hashes;
+    zend_long      capacity;       /* Keys the filter was sized for */
+    zend_long      items;          /* Keys added, counting repeats */
+    zend_long      lookups;        /* Reads a client consulted the filter for */
+    zend_long      short_circuits; /* Of those, the ones answered without a round trip */
+    zend_object    std;
+} valkey_glide_bloom_object;
+
+#define VALKEY_GLIDE_BLOOM_GET_OBJECT(obj) \
+    VALKEY_GLIDE_PHP_GET_OBJECT(valkey_glide_bloom_object, obj)
+#define VALKEY_GLIDE_BLOOM_ZVAL_GET_OBJECT(zv) \
+    VALKEY_GLIDE_PHP_ZVAL_GET_OBJECT(valkey_glide_bloom_object, zv)
+
+void              register_valkey_glide_bloom_class(void);
+zend_class_entry* get_valkey_glide_bloom_ce(void);
+
+void valkey_glide_bloom_add(valkey_glide_bloom_object* bloom, const char* key, size_t key_len);
+bool valkey_glide_bloom_might_contain(const valkey_glide_bloom_object* bloom,
+                                      const char*                      key,
+                                      size_t                           key_len);
+
+/* Filter attached to glide_client, NULL if there is none */
+static inline valkey_glide_bloom_object* valkey_glide_bloom_find(const void* glide_client) {
+    if (EXPECTED(zend_hash_num_elements(&VALKEY_GLIDE_G(blooms)) == 0)) {
+        return NULL;
+    }
+    return zend_hash_index_find_ptr(&VALKEY_GLIDE_G(blooms),
+                                    (zend_ulong) (uintptr_t) glide_client);
+}
+
+/*
+ * Add the keys a command may create, args holding its arguments as sent. false when the command
+ * switches the connection to another database, which the filter doesn't describe.
+ */
+bool valkey_glide_bloom_note_command(valkey_glide_bloom_object* bloom,
+                                     enum RequestType           cmd_type,
+                                     const uintptr_t*           args,
+                                     const unsigned long*       args_len,
+                                     unsigned long              arg_count);
+
+/* Called wherever commands are sent, costs a hash size test while no filter is attached */
+static inline void valkey_glide_bloom_record(const void*          glide_client,
+                                             enum RequestType     cmd_type,
+                                             const uintptr_t*     args,
+                                             const unsigned long* args_len,
+                                             unsigned long        arg_count) {
+    valkey_glide_bloom_object* bloom = valkey_glide_bloom_find(glide_client);
+    if (UNEXPECTED(bloom != NULL) &&
+        !valkey_glide_bloom_note_command(bloom, cmd_type, args, args_len, arg_count)) {
+        /* A raw SELECT: stop answering reads for the client until select() or setBloomFilter() */
+        zend_hash_index_del(&VALKEY_GLIDE_G(blooms), (zend_ulong) (uintptr_t) glide_client);
+    }
+}
+
+/* The same for a key written outside of a command, such as by a stream */
+static inline void valkey_glide_bloom_record_key(const void* glide_client,
+                                                 const char* key,
+                                                 size_t      key_len) {
+    valkey_glide_bloom_object* bloom = valkey_glide_bloom_find(glide_client);
+    if (UNEXPECTED(bloom != NULL) && bloom->bits) {
+        valkey_glide_bloom_add(bloom, key, key_len);
+    }
+}
+
+/* Detach the filter of the client, when the object is freed or changes database */
+void valkey_glide_bloom_release(valkey_glide_object* valkey_glide);
+
+/*
+ * Whether a read of key can be answered "missing" locally. Never true in batch mode, where
+ * every call must leave a reply slot.
+ */
+bool valkey_glide_bloom_rules_out(valkey_glide_object* valkey_glide,
+                                  const char*          key,
+                                  size_t               key_len);
+
+/* The same for exists(): keys is either a single array or argc separate keys */
+bool valkey_glide_bloom_rules_out_keys(valkey_glide_object* valkey_glide, zval* keys, int argc);
+
+int execute_set_bloom_filter_command(zval*             object,
+                                     int               argc,
+                                     zval*             return_value,
+                                     zend_class_entry* ce);
+int execute_get_bloom_filter_command(zval*             object,
+                                     int               argc,
+                                     zval*             return_value,
+                                     zend_class_entry* ce);
+
+#define SET_BLOOM_FILTER_METHOD_IMPL(class_name)                                            \
+    PHP_METHOD(class_name, setBloomFilter) {                                                \
+        if (execute_set_bloom_filter_command(getThis(),                                     \
+                                             ZEND_NUM_ARGS(),                               \
+                                             return_value,                                  \
+                                             strcmp(#class_name, "ValkeyGlideCluster") == 0 \
+                                                 ? get_valkey_glide_cluster_ce()            \
+                                                 : get_valkey_glide_ce())) {                \
+            return;                                                                         \
+        }                                                                                   \
+        zval_dtor(return_value);                                                            \
+        RETURN_FALSE;                                                                       \
+    }
+
+#define GET_BLOOM_FILTER_METHOD_IMPL(class_name)                                            \
+    PHP_METHOD(class_name, getBloomFilter) {                                                \
+        if (execute_get_bloom_filter_command(getThis(),                                     \
+                                             ZEND_NUM_ARGS(),                               \
+                                             return_value,                                  \
+                                             strcmp(#class_name, "ValkeyGlideCluster") == 0 \
+                                                 ? get_valkey_glide_cluster_ce()            \
+                                                 : get_valkey_glide_ce())) {                \
+            return;                                                                         \
+        }                                                                                   \
+        zval_dtor(return_value);                                                            \
+        RETURN_FALSE;                                                                       \
+    }
+
+#endif /* VALKEY_GLIDE_BLOOM_H */
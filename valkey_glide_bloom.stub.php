@@ -0,0 +1,126 @@
+<?php
+
+/**
+ * @generate-function-entries
+ * @generate-legacy-arginfo
+ * @generate-class-entries
+ */
+
+/**
+ * ValkeyGlideBloom is a client-side Bloom filter of the keys that may exist.
+ *
+ * Attached to a client with setBloomFilter(), it lets get(), hGet() and exists() answer "missing"
+ * for a key it has never seen without a round trip, and it learns the keys the client writes.
+ * A Bloom filter has false positives but no false negatives, as long as it sees every key that
+ * gets created: keys written by other clients or processes, by scripts, or moved on the server
+ * must be added with add(), or the filter rebuilt.
+ *
+ * The filter is blocked: each key maps to one 64-byte block, a single cache line, and all of its
+ * bits live there. Bits are numbered like SETBIT numbers them, so a filter can be saved with
+ * set($key, (string) $bloom) and loaded back with fromBitmap($client->getBitmap($key), $hashes).
+ *
+ * @example
+ * $bloom = ValkeyGlideBloom::fromScan($client, 'user:*');
+ * $client->setBloomFilter($bloom);
+ * $client->get('user:404'); // false, answered locally
+ */
+final class ValkeyGlideBloom
+{
+    /**
+     * Create an empty filter.
+     *
+     * @param int   $capacity          The number of keys the filter is sized for.
+     * @param float $falsePositiveRate The rate of false positives at that many keys.
+     */
+    public function __construct(int $capacity, float $falsePositiveRate = 0.01)
+    {
+    }
+
+    /**
+     * Build a filter from the keys SCAN returns. Standalone clients only, with a cluster client
+     * add() the keys of each ClusterScanCursor iteration.
+     *
+     * @param ValkeyGlide $client            The client to scan through.
+     * @param string|null $pattern           Only add the keys matching this MATCH pattern.
+     * @param float       $falsePositiveRate The rate of false positives once the database has
+     *                                       doubled in size, which is what the filter is sized for.
+     * @param int         $count             The COUNT hint of each SCAN call.
+     *
+     * @return ValkeyGlideBloom The filter, holding every key found.
+     */
+    public static function fromScan(
+        ValkeyGlide $client,
+        ?string $pattern = null,
+        float $falsePositiveRate = 0.01,
+        int $count = 1000
+    ): ValkeyGlideBloom {
+    }
+
+    /**
+     * Load a filter from its bits, as __toString() returns them.
+     *
+     * @param ValkeyGlideBitmap|string $bits   The bits, a multiple of 64 bytes.
+     * @param int                      $hashes The number of bits set per key, see getStats().
+     *
+     * @return ValkeyGlideBloom The filter.
+     */
+    public static function fromBitmap(ValkeyGlideBitmap|string $bits, int $hashes): ValkeyGlideBloom
+    {
+    }
+
+    /**
+     * Add one or more keys.
+     *
+     * @param string|array $keys          A key, or an array of keys such as a scan() batch.
+     * @param string       ...$other_keys More keys.
+     *
+     * @return int The number of keys added.
+     */
+    public function add(string|array $keys, string ...$other_keys): int
+    {
+    }
+
+    /**
+     * Check whether a key may exist.
+     *
+     * @param string $key The key.
+     *
+     * @return bool False if the key was never added, true if it may have been.
+     */
+    public function mightContain(string $key): bool
+    {
+    }
+
+    /**
+     * Forget every key.
+     */
+    public function clear(): void
+    {
+    }
+
+    /**
+     * Get the shape and the usage of the filter.
+     *
+     * @return array An array with:
+     *               - 'capacity': the keys the filter was sized for
+     *               - 'hashes': the bits set per key
+     *               - 'bytes': the size of the filter
+     *               - 'items': the keys added, counting repeats
+     *               - 'fill_ratio': the fraction of bits set
+     *               - 'false_positive_rate': the current rate, estimated from fill_ratio
+     *               - 'lookups': the reads of attached clients that consulted the filter
+     *               - 'short_circuits': of those, the ones answered without a round trip
+     */
+    public function getStats(): array
+    {
+    }
+
+    /**
+     * Get the bits of the filter.
+     *
+     * @return string The filter as a bitmap, ready to be stored with set().
+     */
+    public function __toString(): string
+    {
+    }
+}
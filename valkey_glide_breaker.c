@@ -0,0 +1,359 @@
+/** Copyright Valkey GLIDE Project Contributors - SPDX Identifier: Apache-2.0 */
+
+#include "valkey_glide_breaker.h"
+
+#include <string.h>
+#include <zend_exceptions.h>
+
+#include "logger.h"
+#include "valkey_glide_slowlog.h"
+
+#define BREAKER_NS_PER_MS 1000000
+#define BREAKER_MAX_NODES 1024 /* Closed, unused nodes are dropped past this many */
+
+enum { BREAKER_CLOSED, BREAKER_OPEN, BREAKER_HALF_OPEN };
+
+static const char* const breaker_state_names[] = {"closed", "open", "half_open"};
+
+/* Kept across requests in the breaker_nodes global, by address */
+struct valkey_glide_breaker_node {
+    zend_string* address; /* Persistent */
+    int          state;
+    uint32_t     failures;  /* Failed calls in a row */
+    uint64_t     opened_ns; /* When it opened, or when the probe of a half open one was let in */
+    uint32_t     trips;
+    uint32_t     rejected;
+    uint32_t     refcount; /* Breakers of live objects going through the node */
+};
+
+struct valkey_glide_breaker {
+    valkey_glide_breaker_config_t config;
+    const void*                   glide_client;
+    bool                          cluster;
+    int                           next_slot;    /* Slot of the key noted for the next call */
+    bool                          stale;        /* The slot owners are to be fetched again */
+    uint64_t                      refreshed_ns; /* Last attempt at fetching them, 0 if none */
+    HashTable                     nodes;        /* Address => node, referenced, of this client */
+    valkey_glide_breaker_node**   owner_nodes;  /* Nodes by their index in owners */
+    uint32_t                      owner_count;
+    uint64_t                      window_start_ns;
+    uint32_t                      window_requests;
+    uint32_t                      window_retries;
+    uint64_t                      requests;
+    uint64_t                      retries;
+    uint64_t                      retries_denied;
+    uint16_t                      owners[]; /* Index of each slot's primary, cluster clients */
+};
+
+void valkey_glide_breaker_node_dtor(zval* entry) {
+    valkey_glide_breaker_node* node = Z_PTR_P(entry);
+
+    zend_string_release_ex(node->address, 1);
+    pefree(node, 1);
+}
+
+static void breaker_node_unref(zval* entry) {
+    valkey_glide_breaker_node* node = Z_PTR_P(entry);
+
+    node->refcount--;
+}
+
+static int breaker_node_unused(zval* entry) {
+    valkey_glide_breaker_node* node = Z_PTR_P(entry);
+
+    return node->refcount == 0 && node->state == BREAKER_CLOSED ? ZEND_HASH_APPLY_REMOVE
+                                                                : ZEND_HASH_APPLY_KEEP;
+}
+
+/* The node at address, shared by the objects of this process that go through it */
+static valkey_glide_breaker_node* breaker_node(valkey_glide_breaker* breaker,
+                                               const char*           address,
+                                               size_t                address_len) {
+    HashTable*                 known = &VALKEY_GLIDE_G(breaker_nodes);
+    valkey_glide_breaker_node* node;
+
+    node = zend_hash_str_find_ptr(&breaker->nodes, address, address_len);
+    if (node) {
+        return node;
+    }
+
+    node = zend_hash_str_find_ptr(known, address, address_len);
+    if (!node) {
+        if (zend_hash_num_elements(known) >= BREAKER_MAX_NODES) {
+            zend_hash_apply(known, breaker_node_unused);
+        }
+        node          = pecalloc(1, sizeof(valkey_glide_breaker_node), 1);
+        node->address = zend_string_init(address, address_len, 1);
+        zend_hash_str_add_new_ptr(known, address, address_len, node);
+    }
+    node->refcount++;
+    zend_hash_str_add_new_ptr(&breaker->nodes, address, address_len, node);
+    return node;
+}
+
+/* Calls the node is failing: the client core gave up waiting or lost the connection */
+static bool breaker_failed(const CommandResult* result) {
+    return result && result->command_error &&
+           (result->command_error->command_error_type == Timeout ||
+            result->command_error->command_error_type == Disconnect);
+}
+
+/* Map the slots to their primaries, keeping the state of the nodes already known */
+static void breaker_refresh(valkey_glide_breaker* breaker, uint64_t now_ns) {
+    zval         nodes;
+    zend_string* address;
+    zval*        index;
+
+    breaker->refreshed_ns = now_ns;
+    if (!valkey_glide_slot_owners(breaker->glide_client, breaker->owners, &nodes)) {
+        /* The previous mapping stays until the next attempt, the call goes on */
+        VALKEY_LOG_WARN("circuit_breaker", "Failed to fetch the slot owners");
+        zend_clear_exception();
+        return;
+    }
+
+    uint32_t count       = zend_hash_num_elements(Z_ARRVAL(nodes));
+    breaker->owner_nodes = erealloc(breaker->owner_nodes,
+                                    MAX(count, 1) * sizeof(valkey_glide_breaker_node*));
+    ZEND_HASH_FOREACH_STR_KEY_VAL(Z_ARRVAL(nodes), address, index) {
+        breaker->owner_nodes[Z_LVAL_P(index)] =
+            breaker_node(breaker, ZSTR_VAL(address), ZSTR_LEN(address));
+    }
+    ZEND_HASH_FOREACH_END();
+    breaker->owner_count = count;
+    breaker->stale       = false;
+
+    zval_ptr_dtor(&nodes);
+}
+
+/* Start a new retry budget window once the current one is over */
+static void breaker_window(valkey_glide_breaker* breaker) {
+    uint64_t now_ns = valkey_glide_slowlog_now();
+
+    if (now_ns - breaker->window_start_ns >=
+        (uint64_t) breaker->config.retry_window_ms * BREAKER_NS_PER_MS) {
+        breaker->window_start_ns = now_ns;
+        breaker->window_requests = 0;
+        breaker->window_retries  = 0;
+    }
+}
+
+void valkey_glide_breaker_note_key(valkey_glide_object* valkey_glide,
+                                   const char*          key,
+                                   size_t               key_len) {
+    valkey_glide_breaker* breaker = valkey_glide->breaker;
+
+    /* Batched commands are sent later, all at once */
+    if (valkey_glide->is_in_batch_mode || !breaker->cluster) {
+        return;
+    }
+    breaker->next_slot = valkey_glide_key_slot(key, key_len);
+}
+
+bool valkey_glide_breaker_allow(valkey_glide_breaker*       breaker,
+                                int                         slot,
+                                valkey_glide_breaker_node** node) {
+    valkey_glide_breaker_node* target = NULL;
+
+    if (slot == VALKEY_GLIDE_BREAKER_UNKEYED) {
+        slot = breaker->next_slot;
+    }
+    breaker->next_slot = VALKEY_GLIDE_BREAKER_UNKEYED;
+    *node              = NULL;
+
+    if (breaker->config.failures == 0) {
+        return true;
+    }
+
+    uint64_t now_ns  = valkey_glide_slowlog_now();
+    uint64_t open_ns = (uint64_t) breaker->config.open_ms * BREAKER_NS_PER_MS;
+
+    if (!breaker->cluster) {
+        target = breaker->owner_nodes[0];
+    } else if (slot != VALKEY_GLIDE_BREAKER_UNKEYED) {
+        /* Fetched before the first keyed call, then at most once per open_ms after a trip */
+        if (breaker->stale &&
+            (breaker->refreshed_ns == 0 || now_ns - breaker->refreshed_ns >= open_ns)) {
+            breaker_refresh(breaker, now_ns);
+        }
+        if (breaker->owners[slot] < breaker->owner_count) {
+            target = breaker->owner_nodes[breaker->owners[slot]];
+        }
+    }
+    if (!target) {
+        return true;
+    }
+
+    if (target->state != BREAKER_CLOSED && now_ns - target->opened_ns >= open_ns) {
+        /*
+         * This call probes whether the node is back, the others wait for its outcome. A probe
+         * whose outcome never came, its request having ended first, is replaced after open_ms.
+         */
+        target->state     = BREAKER_HALF_OPEN;
+        target->opened_ns = now_ns;
+    } else if (target->state != BREAKER_CLOSED) {
+        target->rejected++;
+        zend_throw_exception_ex(get_valkey_glide_circuit_open_exception_ce(),
+                                0,
+                                "Circuit breaker open for %s",
+                                ZSTR_VAL(target->address));
+        return false;
+    }
+
+    *node = target;
+    return true;
+}
+
+void valkey_glide_breaker_add(valkey_glide_breaker*      breaker,
+                              valkey_glide_breaker_node* node,
+                              const CommandResult*       result,
+                              bool                       retry) {
+    if (!retry) {
+        breaker_window(breaker);
+        breaker->window_requests++;
+        breaker->requests++;
+    }
+    /* Without a result, nothing was learnt about the node */
+    if (!node || !result) {
+        return;
+    }
+
+    if (!breaker_failed(result)) {
+        node->failures = 0;
+        node->state    = BREAKER_CLOSED;
+        return;
+    }
+
+    node->failures++;
+    if (node->state == BREAKER_HALF_OPEN ||
+        (node->state == BREAKER_CLOSED && node->failures >= (uint32_t) breaker->config.failures)) {
+        node->state     = BREAKER_OPEN;
+        node->opened_ns = valkey_glide_slowlog_now();
+        node->trips++;
+
+        /* The node may be failing over, its slots moving to a replica */
+        breaker->stale = breaker->cluster;
+    }
+}
+
+bool valkey_glide_breaker_retry(valkey_glide_breaker*      breaker,
+                                valkey_glide_breaker_node* node,
+                                const CommandResult*       result) {
+    if (breaker->config.retry_window_ms == 0 || !breaker_failed(result)) {
+        return false;
+    }
+
+    /* A node whose breaker is no longer closed is left alone */
+    if (node && node->state != BREAKER_CLOSED) {
+        return false;
+    }
+
+    breaker_window(breaker);
+    double allowed = MAX((double) breaker->config.min_retries,
+                         breaker->config.retry_ratio * breaker->window_requests);
+    if (breaker->window_retries >= allowed) {
+        breaker->retries_denied++;
+        return false;
+    }
+
+    breaker->window_retries++;
+    breaker->retries++;
+    return true;
+}
+
+void valkey_glide_breaker_attach(valkey_glide_object*                 valkey_glide,
+                                 const valkey_glide_breaker_config_t* config,
+                                 const valkey_glide_node_address_t*   server) {
+    bool                  cluster = server == NULL;
+    size_t                owners  = cluster ? VALKEY_GLIDE_CLUSTER_SLOTS : 0;
+    valkey_glide_breaker* breaker =
+        ecalloc(1, sizeof(valkey_glide_breaker) + owners * sizeof(uint16_t));
+
+    /* A reconnected object starts over */
+    valkey_glide_breaker_release(valkey_glide);
+
+    breaker->config          = *config;
+    breaker->glide_client    = valkey_glide->glide_client;
+    breaker->cluster         = cluster;
+    breaker->next_slot       = VALKEY_GLIDE_BREAKER_UNKEYED;
+    breaker->stale           = cluster;
+    breaker->window_start_ns = valkey_glide_slowlog_now();
+    zend_hash_init(&breaker->nodes, 8, NULL, breaker_node_unref, 0);
+
+    if (!cluster) {
+        /* Every call goes to the one node */
+        zend_string* address    = zend_strpprintf(0, "%s:%d", server->host, server->port);
+        breaker->owner_nodes    = emalloc(sizeof(valkey_glide_breaker_node*));
+        breaker->owner_nodes[0] = breaker_node(breaker, ZSTR_VAL(address), ZSTR_LEN(address));
+        breaker->owner_count    = 1;
+        zend_string_release(address);
+    }
+
+    valkey_glide->breaker = breaker;
+    zend_hash_index_update_ptr(&VALKEY_GLIDE_G(breakers),
+                               (zend_ulong) (uintptr_t) valkey_glide->glide_client,
+                               breaker);
+}
+
+void valkey_glide_breaker_release(valkey_glide_object* valkey_glide) {
+    valkey_glide_breaker* breaker = valkey_glide->breaker;
+
+    if (!breaker) {
+        return;
+    }
+
+    /* Objects sharing a client go through the breakers registered last */
+    zend_ulong index      = (zend_ulong) (uintptr_t) valkey_glide->glide_client;
+    void*      registered = zend_hash_index_find_ptr(&VALKEY_GLIDE_G(breakers), index);
+    if (registered == breaker) {
+        zend_hash_index_del(&VALKEY_GLIDE_G(breakers), index);
+    }
+
+    zend_hash_destroy(&breaker->nodes);
+    if (breaker->owner_nodes) {
+        efree(breaker->owner_nodes);
+    }
+    efree(breaker);
+    valkey_glide->breaker = NULL;
+}
+
+int execute_get_breaker_stats_command(zval*             object,
+                                      int               argc,
+                                      zval*             return_value,
+                                      zend_class_entry* ce) {
+    if (zend_parse_method_parameters(argc, object, "O", &object, ce) == FAILURE) {
+        return 0;
+    }
+
+    valkey_glide_object* valkey_glide =
+        VALKEY_GLIDE_PHP_ZVAL_GET_OBJECT(valkey_glide_object, object);
+    if (!valkey_glide || !valkey_glide->breaker) {
+        /* Neither circuit_breaker nor retry_budget was set */
+        return 0;
+    }
+
+    valkey_glide_breaker*      breaker = valkey_glide->breaker;
+    valkey_glide_breaker_node* node;
+    zval                       nodes;
+
+    array_init(&nodes);
+    ZEND_HASH_FOREACH_PTR(&breaker->nodes, node) {
+        zval entry;
+
+        array_init_size(&entry, 4);
+        add_assoc_string(&entry, "state", (char*) breaker_state_names[node->state]);
+        add_assoc_long(&entry, "failures", node->failures);
+        add_assoc_long(&entry, "trips", node->trips);
+        add_assoc_long(&entry, "rejected", node->rejected);
+        zend_hash_str_update(
+            Z_ARRVAL(nodes), ZSTR_VAL(node->address), ZSTR_LEN(node->address), &entry);
+    }
+    ZEND_HASH_FOREACH_END();
+
+    array_init_size(return_value, 4);
+    add_assoc_long(return_value, "requests", (zend_long) breaker->requests);
+    add_assoc_long(return_value, "retries", (zend_long) breaker->retries);
+    add_assoc_long(return_value, "retries_denied", (zend_long) breaker->retries_denied);
+    add_assoc_zval(return_value, "nodes", &nodes);
+    return 1;
+}
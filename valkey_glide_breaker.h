@@ -0,0 +1,108 @@
+/** Copyright Valkey GLIDE Project Contributors - SPDX Identifier: Apache-2.0 */
+
+#ifndef VALKEY_GLIDE_BREAKER_H
+#define VALKEY_GLIDE_BREAKER_H
+
+#include "common.h"
+#include "include/glide_bindings.h"
+#include "valkey_glide_slot.h"
+
+/*
+ * Circuit breakers and a retry budget, set with advanced_config when connecting.
+ *
+ * 'circuit_breaker' keeps a breaker per primary, learnt from CLUSTER SLOTS on cluster clients
+ * and refreshed when a breaker opens. Calls that time out or lose their connection count against
+ * the node of their key; after 'failures' of them in a row the breaker opens and calls to the
+ * node throw ValkeyGlideCircuitOpenException without being sent. Once 'open_ms' has passed a
+ * single call is let through as a probe, closing the breaker when it succeeds and reopening it
+ * otherwise. Calls without a single key aren't gated on cluster clients.
+ *
+ * 'retry_budget' sends repeatable reads failing that way once more, as long as the retries of
+ * the current window stay below 'ratio' of its requests, or 'min_retries'.
+ *
+ * The breakers are kept by node address in the breaker_nodes global, so they outlive the
+ * request that opened them and are shared by the clients of a process (of a thread under ZTS)
+ * going to that node; each FPM worker learns about a failing node from its own calls. Standalone
+ * nodes are named by the first configured address. The slot map, the retry budget and the
+ * request counters belong to the client object and start over with it.
+ */
+#define VALKEY_GLIDE_CIRCUIT_BREAKER "circuit_breaker"
+#define VALKEY_GLIDE_RETRY_BUDGET "retry_budget"
+#define VALKEY_GLIDE_BREAKER_UNKEYED VALKEY_GLIDE_CLUSTER_SLOTS
+
+typedef struct valkey_glide_breaker      valkey_glide_breaker;
+typedef struct valkey_glide_breaker_node valkey_glide_breaker_node;
+
+/* Breakers and retry budget of glide_client, NULL if it has neither */
+static inline valkey_glide_breaker* valkey_glide_breaker_find(const void* glide_client) {
+    if (EXPECTED(zend_hash_num_elements(&VALKEY_GLIDE_G(breakers)) == 0)) {
+        return NULL;
+    }
+    return zend_hash_index_find_ptr(&VALKEY_GLIDE_G(breakers),
+                                    (zend_ulong) (uintptr_t) glide_client);
+}
+
+/* Called by the command executors before a command is sent, with the key it is routed by */
+void valkey_glide_breaker_note_key(valkey_glide_object* valkey_glide,
+                                   const char*          key,
+                                   size_t               key_len);
+
+static inline void valkey_glide_breaker_record(valkey_glide_object* valkey_glide,
+                                               const char*          key,
+                                               size_t               key_len) {
+    if (UNEXPECTED(valkey_glide->breaker != NULL) && key && key_len > 0) {
+        valkey_glide_breaker_note_key(valkey_glide, key, key_len);
+    }
+}
+
+/*
+ * Whether a call to slot, or to the key noted last when slot is VALKEY_GLIDE_BREAKER_UNKEYED,
+ * may be sent, setting the node its outcome counts against, NULL if none. Throws
+ * ValkeyGlideCircuitOpenException and returns false when the node's breaker is open.
+ */
+bool valkey_glide_breaker_allow(valkey_glide_breaker*       breaker,
+                                int                         slot,
+                                valkey_glide_breaker_node** node);
+
+/* Record the outcome of a call, or of its retry, against node */
+void valkey_glide_breaker_add(valkey_glide_breaker*      breaker,
+                              valkey_glide_breaker_node* node,
+                              const CommandResult*       result,
+                              bool                       retry);
+
+/* Whether a repeatable read that failed with result may be sent once more, spending the budget */
+bool valkey_glide_breaker_retry(valkey_glide_breaker*      breaker,
+                                valkey_glide_breaker_node* node,
+                                const CommandResult*       result);
+
+/* Start gating the calls of a connected client, per config; server is NULL for a cluster */
+void valkey_glide_breaker_attach(valkey_glide_object*                 valkey_glide,
+                                 const valkey_glide_breaker_config_t* config,
+                                 const valkey_glide_node_address_t*   server);
+
+/* Destructor of the breaker_nodes global */
+void valkey_glide_breaker_node_dtor(zval* entry);
+
+/* Drop the breakers, when the object is freed */
+void valkey_glide_breaker_release(valkey_glide_object* valkey_glide);
+
+int execute_get_breaker_stats_command(zval*             object,
+                                      int               argc,
+                                      zval*             return_value,
+                                      zend_class_entry* ce);
+
+#define GET_BREAKER_STATS_METHOD_IMPL(class_name)                                            \
+    PHP_METHOD(class_name, getBreakerStats) {                                                \
+        if (execute_get_breaker_stats_command(getThis(),                                     \
+                                              ZEND_NUM_ARGS(),                               \
+                                              return_value,                                  \
+                                              strcmp(#class_name, "ValkeyGlideCluster") == 0 \
+                                                  ? get_valkey_glide_cluster_ce()            \
+                                                  : get_valkey_glide_ce())) {                \
+            return;                                                                          \
+        }                                                                                    \
+        zval_dtor(return_value);                                                             \
+        RETURN_FALSE;                                                                        \
+    }
+
+#endif /* VALKEY_GLIDE_BREAKER_H */
@@ -0,0 +1,501 @@
+/** Copyright Valkey GLIDE Project Contributors - SPDX Identifier: Apache-2.0 */
+
+#include <stdio.h>
+#include <string.h>
+#include <zend.h>
+#include <zend_API.h>
+#include <zend_exceptions.h>
+
+#include "command_response.h"
+#include "include/glide_bindings.h"
+#include "logger.h"
+#include "valkey_glide_bitmap.h"
+#include "valkey_glide_commands_common.h"
+#include "valkey_glide_dictionary.h"
+#include "valkey_glide_hot_keys.h"
+
+/* ====================================================================
+ * PIPELINED BULK WRITES
+ *
+ * msetex(), hmsetMulti() and zaddMulti() send one non-atomic batch of SET EX, HSET or ZADD
+ * commands, one per key of the input array. The batch is laid out straight from the input:
+ * string keys and values are referenced in place, numbers are formatted into a single arena and
+ * every command is a slice of one argument pool, so nothing is queued through the batch buffer.
+ * msetex() values are compressed with the trained dictionary like those of set(). The result is
+ * a ValkeyGlideBitmap with bit i set when the ith command succeeded.
+ * ==================================================================== */
+
+#define BULK_NUMBER_MAX 32 /* Room for a formatted zend_long or double */
+
+/* The batch being assembled, sized up front so the pools never move */
+typedef struct {
+    const uint8_t**  args;          /* Flat argument pointer pool */
+    uintptr_t*       args_len;      /* Flat argument length pool */
+    size_t           arg_count;     /* Arguments used in the pool */
+    struct CmdInfo*  cmds;          /* Command descriptors */
+    struct CmdInfo** cmd_ptrs;      /* Pointers handed to BatchInfo */
+    size_t           cmd_count;     /* Commands in the batch */
+    size_t           first_arg;     /* Pool index of the current command's first argument */
+    char*            numbers;       /* Arena holding formatted numbers */
+    size_t           number_count;  /* Numbers formatted so far */
+    zend_string**    strings;       /* Values converted to strings, released with the batch */
+    size_t           string_count;  /* Strings converted so far */
+    size_t           payload_bytes; /* Total argument size, for tracing and the slow log */
+} bulk_batch_t;
+
+static void bulk_batch_init(bulk_batch_t* b, size_t cmds, size_t args, size_t numbers) {
+    memset(b, 0, sizeof(*b));
+    b->args     = (const uint8_t**) safe_emalloc(args, sizeof(uint8_t*), 0);
+    b->args_len = (uintptr_t*) safe_emalloc(args, sizeof(uintptr_t), 0);
+    b->cmds     = (struct CmdInfo*) safe_emalloc(cmds, sizeof(struct CmdInfo), 0);
+    b->cmd_ptrs = (struct CmdInfo**) safe_emalloc(cmds, sizeof(struct CmdInfo*), 0);
+    b->numbers  = numbers > 0 ? (char*) safe_emalloc(numbers, BULK_NUMBER_MAX, 0) : NULL;
+    b->strings  = (zend_string**) safe_emalloc(args, sizeof(zend_string*), 0);
+}
+
+static void bulk_batch_free(bulk_batch_t* b) {
+    size_t i;
+
+    for (i = 0; i < b->string_count; i++) {
+        zend_string_release(b->strings[i]);
+    }
+    efree(b->args);
+    efree(b->args_len);
+    efree(b->cmds);
+    efree(b->cmd_ptrs);
+    if (b->numbers) {
+        efree(b->numbers);
+    }
+    efree(b->strings);
+}
+
+static zend_always_inline bool bulk_is_number(zval* value) {
+    ZVAL_DEREF(value);
+    return Z_TYPE_P(value) == IS_LONG || Z_TYPE_P(value) == IS_DOUBLE;
+}
+
+static void bulk_push(bulk_batch_t* b, const char* arg, size_t len) {
+    b->args[b->arg_count]     = (const uint8_t*) arg;
+    b->args_len[b->arg_count] = len;
+    b->arg_count++;
+    b->payload_bytes += len;
+}
+
+static void bulk_push_long(bulk_batch_t* b, zend_long value) {
+    char* buf = b->numbers + b->number_count++ * BULK_NUMBER_MAX;
+    int   len = snprintf(buf, BULK_NUMBER_MAX, ZEND_LONG_FMT, value);
+    bulk_push(b, buf, (size_t) len);
+}
+
+/* Scores only: enough digits for the server to parse back the exact same double */
+static void bulk_push_score(bulk_batch_t* b, double value) {
+    char* buf = b->numbers + b->number_count++ * BULK_NUMBER_MAX;
+    int   len = snprintf(buf, BULK_NUMBER_MAX, "%.17g", value);
+    bulk_push(b, buf, (size_t) len);
+}
+
+/* Add an array key, which PHP stores as an integer when it looks like one */
+static void bulk_push_key(bulk_batch_t* b, zend_string* key, zend_ulong index) {
+    if (key) {
+        bulk_push(b, ZSTR_VAL(key), ZSTR_LEN(key));
+    } else {
+        bulk_push_long(b, (zend_long) index);
+    }
+}
+
+/*
+ * Add a scalar value. Strings are referenced in place and integers formatted into the arena,
+ * anything else goes through zval_try_get_string() so that floats are stored as PHP prints them
+ * ("0.1", not "0.10000000000000001"), as set() and hSet() do. Fails on arrays, or with the
+ * exception of a conversion that threw.
+ */
+static bool bulk_push_value(bulk_batch_t* b, zval* value) {
+    ZVAL_DEREF(value);
+    switch (Z_TYPE_P(value)) {
+        case IS_STRING:
+            bulk_push(b, Z_STRVAL_P(value), Z_STRLEN_P(value));
+            return true;
+        case IS_LONG:
+            bulk_push_long(b, Z_LVAL_P(value));
+            return true;
+        case IS_ARRAY:
+            return false;
+        default: {
+            zend_string* str = zval_try_get_string(value);
+            if (!str) {
+                return false;
+            }
+            b->strings[b->string_count++] = str;
+            bulk_push(b, ZSTR_VAL(str), ZSTR_LEN(str));
+            return true;
+        }
+    }
+}
+
+/* Replace the value just added by its dictionary compressed copy, as set() would send it */
+static void bulk_compress_value(valkey_glide_object* valkey_glide, bulk_batch_t* b) {
+    size_t       last   = b->arg_count - 1;
+    zend_string* packed = valkey_glide_dictionary_compress(
+        valkey_glide, (const char*) b->args[last], b->args_len[last]);
+    if (!packed) {
+        return;
+    }
+
+    b->strings[b->string_count++] = packed;
+    b->payload_bytes              = b->payload_bytes - b->args_len[last] + ZSTR_LEN(packed);
+    b->args[last]                 = (const uint8_t*) ZSTR_VAL(packed);
+    b->args_len[last]             = ZSTR_LEN(packed);
+}
+
+/* Numeric strings and the infinities ZADD accepts */
+static bool bulk_is_score_string(zval* value) {
+    if (Z_TYPE_P(value) != IS_STRING) {
+        return false;
+    }
+    if (is_numeric_string(Z_STRVAL_P(value), Z_STRLEN_P(value), NULL, NULL, 0)) {
+        return true;
+    }
+    return zend_string_equals_literal_ci(Z_STR_P(value), "inf") ||
+           zend_string_equals_literal_ci(Z_STR_P(value), "+inf") ||
+           zend_string_equals_literal_ci(Z_STR_P(value), "-inf");
+}
+
+static void bulk_begin_command(bulk_batch_t* b, enum RequestType type) {
+    struct CmdInfo* cmd = &b->cmds[b->cmd_count];
+
+    cmd->request_type = type;
+    cmd->args         = (const uint8_t* const*) &b->args[b->arg_count];
+    cmd->args_len     = (const uintptr_t*) &b->args_len[b->arg_count];
+    b->first_arg      = b->arg_count;
+}
+
+static void bulk_end_command(valkey_glide_object* valkey_glide, bulk_batch_t* b) {
+    struct CmdInfo* cmd  = &b->cmds[b->cmd_count];
+    size_t          used = b->arg_count - b->first_arg;
+
+    cmd->arg_count            = used;
+    b->cmd_ptrs[b->cmd_count] = cmd;
+    b->cmd_count++;
+
+    /* The key always comes first */
+    valkey_glide_hot_keys_record(valkey_glide,
+                                 (const char*) b->args[b->first_arg],
+                                 b->args_len[b->first_arg],
+                                 (const unsigned long*) &b->args_len[b->first_arg],
+                                 (int) used);
+}
+
+/*
+ * Send the batch and turn the replies into the success bitmap. A batch that fails as a whole
+ * returns false, a command that replies with an error just leaves its bit clear.
+ */
+static int bulk_batch_execute(valkey_glide_object* valkey_glide,
+                              bulk_batch_t*        b,
+                              zval*                return_value) {
+    size_t i;
+
+    struct BatchInfo batch_info = {.cmd_count = b->cmd_count,
+                                   .cmds      = (const struct CmdInfo* const*) b->cmd_ptrs,
+                                   .is_atomic = false};
+
+    struct CommandResult* result =
+        valkey_glide_send_batch(valkey_glide, &batch_info, b->payload_bytes);
+
+    if (!result) {
+        return 0;
+    }
+    if (result->command_error || !result->response || result->response->response_type != Array ||
+        (size_t) result->response->array_value_len != b->cmd_count) {
+        free_command_result(result);
+        return 0;
+    }
+
+    zend_string* bits = zend_string_alloc((b->cmd_count + 7) / 8, 0);
+    memset(ZSTR_VAL(bits), 0, ZSTR_LEN(bits));
+    ZSTR_VAL(bits)[ZSTR_LEN(bits)] = '\0';
+
+    /* Bit 0 is the most significant bit of the first byte, as in SETBIT */
+    for (i = 0; i < b->cmd_count; i++) {
+        if (result->response->array_value[i].response_type != Error) {
+            ZSTR_VAL(bits)[i >> 3] |= (char) (0x80 >> (i & 7));
+        }
+    }
+
+    free_command_result(result);
+    valkey_glide_bitmap_from_string(return_value, bits);
+    return 1;
+}
+
+/* Common preamble: resolve the client and refuse to run inside MULTI/pipeline mode */
+static valkey_glide_object* bulk_get_client(zval* object, const char* method) {
+    valkey_glide_object* valkey_glide =
+        VALKEY_GLIDE_PHP_ZVAL_GET_OBJECT(valkey_glide_object, object);
+
+    if (!valkey_glide || !valkey_glide->glide_client) {
+        return NULL;
+    }
+    if (valkey_glide->is_in_batch_mode) {
+        VALKEY_LOG_ERROR_FMT("bulk_write", "%s() cannot be used in batch mode", method);
+        return NULL;
+    }
+    return valkey_glide;
+}
+
+/* Execute msetex() - SET key value EX ttl for every entry, TTLs shared or per key */
+int execute_msetex_command(zval* object, int argc, zval* return_value, zend_class_entry* ce) {
+    valkey_glide_object* valkey_glide;
+    zval*                z_kv;
+    zval*                z_ttl;
+    zend_string*         key;
+    zend_ulong           index;
+    zval*                value;
+
+    if (zend_parse_method_parameters(argc, object, "Oaz", &object, ce, &z_kv, &z_ttl) ==
+        FAILURE) {
+        return 0;
+    }
+
+    valkey_glide = bulk_get_client(object, "msetex");
+    if (!valkey_glide) {
+        return 0;
+    }
+
+    if (Z_TYPE_P(z_ttl) != IS_LONG && Z_TYPE_P(z_ttl) != IS_ARRAY) {
+        zend_throw_exception(get_valkey_glide_exception_ce(),
+                             "msetex() TTL must be an integer or an array of integers by key",
+                             0);
+        return 0;
+    }
+    if (Z_TYPE_P(z_ttl) == IS_LONG && Z_LVAL_P(z_ttl) <= 0) {
+        zend_throw_exception(get_valkey_glide_exception_ce(),
+                             "msetex() TTL must be a positive number of seconds",
+                             0);
+        return 0;
+    }
+
+    HashTable* ht    = Z_ARRVAL_P(z_kv);
+    size_t     count = zend_hash_num_elements(ht);
+    if (count == 0) {
+        valkey_glide_bitmap_from_string(return_value, ZSTR_EMPTY_ALLOC());
+        return 1;
+    }
+
+    /* SET key value EX ttl: the key, the value and the TTL may all be numbers */
+    bulk_batch_t b;
+    bulk_batch_init(&b, count, count * 4, count * 3);
+
+    ZEND_HASH_FOREACH_KEY_VAL(ht, index, key, value) {
+        zend_long ttl = 0;
+
+        if (Z_TYPE_P(z_ttl) == IS_LONG) {
+            ttl = Z_LVAL_P(z_ttl);
+        } else {
+            zval* z_key_ttl = key ? zend_hash_find(Z_ARRVAL_P(z_ttl), key)
+                                  : zend_hash_index_find(Z_ARRVAL_P(z_ttl), index);
+            if (z_key_ttl) {
+                ttl = zval_get_long(z_key_ttl);
+            }
+        }
+        if (ttl <= 0) {
+            bulk_batch_free(&b);
+            if (key) {
+                zend_throw_exception_ex(get_valkey_glide_exception_ce(),
+                                        0,
+                                        "msetex() has no positive TTL for key '%s'",
+                                        ZSTR_VAL(key));
+            } else {
+                zend_throw_exception_ex(get_valkey_glide_exception_ce(),
+                                        0,
+                                        "msetex() has no positive TTL for key '" ZEND_LONG_FMT "'",
+                                        (zend_long) index);
+            }
+            return 0;
+        }
+
+        bulk_begin_command(&b, Set);
+        bulk_push_key(&b, key, index);
+        if (!bulk_push_value(&b, value)) {
+            bulk_batch_free(&b);
+            if (!EG(exception)) {
+                zend_throw_exception(
+                    get_valkey_glide_exception_ce(), "msetex() values must be scalars", 0);
+            }
+            return 0;
+        }
+        bulk_compress_value(valkey_glide, &b);
+        bulk_push(&b, "EX", 2);
+        bulk_push_long(&b, ttl);
+        bulk_end_command(valkey_glide, &b);
+    }
+    ZEND_HASH_FOREACH_END();
+
+    int status = bulk_batch_execute(valkey_glide, &b, return_value);
+    bulk_batch_free(&b);
+    return status;
+}
+
+/*
+ * Size a batch of one command per key of a [key => [name => value, ...]] array, as HSET and ZADD
+ * take. Fails, throwing, if an entry is not a non-empty array.
+ */
+static bool bulk_count_nested(HashTable*  ht,
+                              const char* method,
+                              size_t*     arg_count,
+                              size_t*     number_count) {
+    zend_string* name;
+    zval*        inner;
+    zval*        value;
+
+    *arg_count    = 0;
+    *number_count = 0;
+
+    ZEND_HASH_FOREACH_VAL(ht, inner) {
+        ZVAL_DEREF(inner);
+        if (Z_TYPE_P(inner) != IS_ARRAY || zend_hash_num_elements(Z_ARRVAL_P(inner)) == 0) {
+            zend_throw_exception_ex(get_valkey_glide_exception_ce(),
+                                    0,
+                                    "%s() expects a non-empty array for every key",
+                                    method);
+            return false;
+        }
+
+        (*arg_count)++;
+        ZEND_HASH_FOREACH_STR_KEY_VAL(Z_ARRVAL_P(inner), name, value) {
+            *arg_count += 2;
+            *number_count += (name == NULL) + bulk_is_number(value);
+        }
+        ZEND_HASH_FOREACH_END();
+    }
+    ZEND_HASH_FOREACH_END();
+
+    /* The keys themselves may be integers */
+    *number_count += zend_hash_num_elements(ht);
+    return true;
+}
+
+/* Execute hmsetMulti() - one HSET key field value ... per hash */
+int execute_hmset_multi_command(zval* object, int argc, zval* return_value, zend_class_entry* ce) {
+    valkey_glide_object* valkey_glide;
+    zval*                z_hashes;
+    zend_string*         key;
+    zend_ulong           index;
+    zval*                fields;
+    zend_string*         field;
+    zend_ulong           field_index;
+    zval*                value;
+    size_t               arg_count, number_count;
+
+    if (zend_parse_method_parameters(argc, object, "Oa", &object, ce, &z_hashes) == FAILURE) {
+        return 0;
+    }
+
+    valkey_glide = bulk_get_client(object, "hmsetMulti");
+    if (!valkey_glide) {
+        return 0;
+    }
+
+    HashTable* ht    = Z_ARRVAL_P(z_hashes);
+    size_t     count = zend_hash_num_elements(ht);
+    if (count == 0) {
+        valkey_glide_bitmap_from_string(return_value, ZSTR_EMPTY_ALLOC());
+        return 1;
+    }
+    if (!bulk_count_nested(ht, "hmsetMulti", &arg_count, &number_count)) {
+        return 0;
+    }
+
+    bulk_batch_t b;
+    bulk_batch_init(&b, count, arg_count, number_count);
+
+    ZEND_HASH_FOREACH_KEY_VAL(ht, index, key, fields) {
+        ZVAL_DEREF(fields);
+
+        bulk_begin_command(&b, HSet);
+        bulk_push_key(&b, key, index);
+        ZEND_HASH_FOREACH_KEY_VAL(Z_ARRVAL_P(fields), field_index, field, value) {
+            bulk_push_key(&b, field, field_index);
+            if (!bulk_push_value(&b, value)) {
+                bulk_batch_free(&b);
+                if (!EG(exception)) {
+                    zend_throw_exception(get_valkey_glide_exception_ce(),
+                                         "hmsetMulti() field values must be scalars",
+                                         0);
+                }
+                return 0;
+            }
+        }
+        ZEND_HASH_FOREACH_END();
+        bulk_end_command(valkey_glide, &b);
+    }
+    ZEND_HASH_FOREACH_END();
+
+    int status = bulk_batch_execute(valkey_glide, &b, return_value);
+    bulk_batch_free(&b);
+    return status;
+}
+
+/* Execute zaddMulti() - one ZADD key score member ... per sorted set */
+int execute_zadd_multi_command(zval* object, int argc, zval* return_value, zend_class_entry* ce) {
+    valkey_glide_object* valkey_glide;
+    zval*                z_sets;
+    zend_string*         key;
+    zend_ulong           index;
+    zval*                members;
+    zend_string*         member;
+    zend_ulong           member_index;
+    zval*                score;
+    size_t               arg_count, number_count;
+
+    if (zend_parse_method_parameters(argc, object, "Oa", &object, ce, &z_sets) == FAILURE) {
+        return 0;
+    }
+
+    valkey_glide = bulk_get_client(object, "zaddMulti");
+    if (!valkey_glide) {
+        return 0;
+    }
+
+    HashTable* ht    = Z_ARRVAL_P(z_sets);
+    size_t     count = zend_hash_num_elements(ht);
+    if (count == 0) {
+        valkey_glide_bitmap_from_string(return_value, ZSTR_EMPTY_ALLOC());
+        return 1;
+    }
+    if (!bulk_count_nested(ht, "zaddMulti", &arg_count, &number_count)) {
+        return 0;
+    }
+
+    bulk_batch_t b;
+    bulk_batch_init(&b, count, arg_count, number_count);
+
+    ZEND_HASH_FOREACH_KEY_VAL(ht, index, key, members) {
+        ZVAL_DEREF(members);
+
+        /* Members map to their scores, ZADD wants the score first */
+        bulk_begin_command(&b, ZAdd);
+        bulk_push_key(&b, key, index);
+        ZEND_HASH_FOREACH_KEY_VAL(Z_ARRVAL_P(members), member_index, member, score) {
+            ZVAL_DEREF(score);
+            if (Z_TYPE_P(score) != IS_LONG && Z_TYPE_P(score) != IS_DOUBLE &&
+                !bulk_is_score_string(score)) {
+                bulk_batch_free(&b);
+                zend_throw_exception(
+                    get_valkey_glide_exception_ce(), "zaddMulti() scores must be numbers", 0);
+                return 0;
+            }
+            if (Z_TYPE_P(score) == IS_DOUBLE) {
+                bulk_push_score(&b, Z_DVAL_P(score));
+            } else {
+                bulk_push_value(&b, score);
+            }
+            bulk_push_key(&b, member, member_index);
+        }
+        ZEND_HASH_FOREACH_END();
+        bulk_end_command(valkey_glide, &b);
+    }
+    ZEND_HASH_FOREACH_END();
+
+    int status = bulk_batch_execute(valkey_glide, &b, return_value);
+    bulk_batch_free(&b);
+    return status;
+}
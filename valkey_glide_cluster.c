@@ -13,14 +13,29 @@
 #include "common.h"
 #include "ext/standard/info.h"
 #include "logger.h"
+#include "valkey_glide_async.h"
+#include "valkey_glide_bitmap.h"
+#include "valkey_glide_bloom.h"
+#include "valkey_glide_breaker.h"
 #include "valkey_glide_commands_common.h"
 #include "valkey_glide_core_common.h"
+#include "valkey_glide_deadline.h"
+#include "valkey_glide_dictionary.h"
+#include "valkey_glide_fiber.h"
 #include "valkey_glide_geo_common.h"
 #include "valkey_glide_hash_common.h" /* Include hash command framework */
+#include "valkey_glide_hedge.h"
+#include "valkey_glide_hot_keys.h"
 #include "valkey_glide_list_common.h"
+#include "valkey_glide_memory.h"
+#include "valkey_glide_metrics.h"
+#include "valkey_glide_node_stats.h"
 #include "valkey_glide_pubsub_common.h"
 #include "valkey_glide_pubsub_introspection.h"
 #include "valkey_glide_s_common.h"
+#include "valkey_glide_slot.h"
+#include "valkey_glide_slowlog.h"
+#include "valkey_glide_stream.h"
 #include "valkey_glide_x_common.h"
 #include "valkey_glide_z_common.h"
 
@@ -76,22 +91,72 @@ static int valkey_glide_cluster_create_connection(
         }
     }
 
-    /* Issue the connection request. */
-    const ConnectionResponse* conn_resp = create_glide_cluster_client(&client_config);
+    if (client_config.base.advanced_config && client_config.base.advanced_config->shared_client) {
+        /* Reuse the process-wide client for this configuration */
+        valkey_glide->glide_client = create_shared_glide_cluster_client(&client_config);
+        if (!valkey_glide->glide_client) {
+            valkey_glide_cleanup_client_config(&client_config.base);
+            return FAILURE;
+        }
+        valkey_glide->shared_client = true;
+    } else {
+        /* Issue the connection request. */
+        const ConnectionResponse* conn_resp = create_glide_cluster_client(&client_config);
+
+        if (conn_resp->connection_error_message) {
+            VALKEY_LOG_ERROR("cluster_construct", conn_resp->connection_error_message);
+            zend_throw_exception(
+                get_valkey_glide_exception_ce(), conn_resp->connection_error_message, 0);
+            free_connection_response((ConnectionResponse*) conn_resp);
+            valkey_glide_cleanup_client_config(&client_config.base);
+            return FAILURE;
+        } else {
+            VALKEY_LOG_INFO("cluster_construct",
+                            "ValkeyGlide cluster client created successfully");
+            valkey_glide->glide_client = conn_resp->conn_ptr;
+        }
 
-    if (conn_resp->connection_error_message) {
-        VALKEY_LOG_ERROR("cluster_construct", conn_resp->connection_error_message);
-        zend_throw_exception(
-            get_valkey_glide_exception_ce(), conn_resp->connection_error_message, 0);
         free_connection_response((ConnectionResponse*) conn_resp);
+    }
+
+    /* Hedged reads go to replicas only when the client reads from them */
+    valkey_glide->read_from = client_config.base.read_from;
+
+    /* Create the callback-mode client for submit()/poll() if requested */
+    if (client_config.base.advanced_config &&
+        client_config.base.advanced_config->async_completions &&
+        valkey_glide_async_attach(valkey_glide,
+                                  create_glide_async_cluster_client(&client_config)) == FAILURE) {
         valkey_glide_cleanup_client_config(&client_config.base);
         return FAILURE;
-    } else {
-        VALKEY_LOG_INFO("cluster_construct", "ValkeyGlide cluster client created successfully");
-        valkey_glide->glide_client = conn_resp->conn_ptr;
     }
 
-    free_connection_response((ConnectionResponse*) conn_resp);
+    /* Start the worker pool for Fiber-aware execution if requested */
+    if (client_config.base.advanced_config &&
+        client_config.base.advanced_config->fiber_threads != 0 &&
+        valkey_glide_fiber_attach(valkey_glide,
+                                  client_config.base.advanced_config->fiber_threads,
+                                  client_config.base.advanced_config->fiber_suspend) == FAILURE) {
+        valkey_glide_cleanup_client_config(&client_config.base);
+        return FAILURE;
+    }
+
+    /* Gate calls with circuit breakers and a retry budget if requested */
+    if (client_config.base.advanced_config &&
+        (client_config.base.advanced_config->breaker.failures != 0 ||
+         client_config.base.advanced_config->breaker.retry_window_ms != 0)) {
+        valkey_glide_breaker_attach(
+            valkey_glide, &client_config.base.advanced_config->breaker, NULL);
+    }
+
+    /* Load the trained compression dictionaries if requested */
+    if (client_config.base.compression_config && client_config.base.compression_config->enabled &&
+        client_config.base.compression_config->dictionary_key &&
+        valkey_glide_dictionary_attach(valkey_glide, client_config.base.compression_config) ==
+            FAILURE) {
+        valkey_glide_cleanup_client_config(&client_config.base);
+        return FAILURE;
+    }
 
     /* Clean up temporary configuration structures */
     valkey_glide_cleanup_client_config(&client_config.base);
@@ -669,6 +734,10 @@ APPEND_METHOD_IMPL(ValkeyGlideCluster)
 GETBIT_METHOD_IMPL(ValkeyGlideCluster)
 /* }}} */
 
+/* {{{ proto ValkeyGlideBitmap ValkeyGlideCluster::getBitmap(string key) */
+GET_BITMAP_METHOD_IMPL(ValkeyGlideCluster)
+/* }}} */
+
 /* {{{ proto long ValkeyGlideCluster::setbit(string key, long offset, bool onoff) */
 SETBIT_METHOD_IMPL(ValkeyGlideCluster)
 
@@ -909,6 +978,267 @@ UNWATCH_METHOD_IMPL(ValkeyGlideCluster)
 /* {{{ proto array ValkeyGlideCluster::exec() */
 EXEC_METHOD_IMPL(ValkeyGlideCluster)
 
+/* {{{ proto int ValkeyGlideCluster::submit(string command [, mixed args ...]) */
+SUBMIT_METHOD_IMPL(ValkeyGlideCluster)
+
+/* {{{ proto array ValkeyGlideCluster::poll([int max]) */
+POLL_METHOD_IMPL(ValkeyGlideCluster)
+
+/* {{{ proto resource ValkeyGlideCluster::getCompletionFd() */
+GET_COMPLETION_FD_METHOD_IMPL(ValkeyGlideCluster)
+
+/* {{{ proto bool ValkeyGlideCluster::registerStreamAlias(string alias) */
+REGISTER_STREAM_ALIAS_METHOD_IMPL(ValkeyGlideCluster)
+
+/* {{{ proto array ValkeyGlideCluster::getHotKeys([int n]) */
+GET_HOT_KEYS_METHOD_IMPL(ValkeyGlideCluster)
+
+/* {{{ proto array ValkeyGlideCluster::getSlowLog() */
+GET_SLOW_LOG_METHOD_IMPL(ValkeyGlideCluster)
+
+/* {{{ proto bool ValkeyGlideCluster::resetSlowLog() */
+RESET_SLOW_LOG_METHOD_IMPL(ValkeyGlideCluster)
+
+/* {{{ proto array ValkeyGlideCluster::getNodeStats() */
+GET_NODE_STATS_METHOD_IMPL(ValkeyGlideCluster)
+
+/* {{{ proto array ValkeyGlideCluster::getBreakerStats() */
+GET_BREAKER_STATS_METHOD_IMPL(ValkeyGlideCluster)
+
+/* {{{ proto int ValkeyGlideCluster::trainCompressionDictionary(array $samples, int $size) */
+TRAIN_COMPRESSION_DICTIONARY_METHOD_IMPL(ValkeyGlideCluster)
+
+/* {{{ proto int ValkeyGlideCluster::loadCompressionDictionaries() */
+LOAD_COMPRESSION_DICTIONARIES_METHOD_IMPL(ValkeyGlideCluster)
+
+/* {{{ proto array ValkeyGlideCluster::getMemoryStats() */
+GET_MEMORY_STATS_METHOD_IMPL(ValkeyGlideCluster)
+
+/* {{{ proto bool ValkeyGlideCluster::setBloomFilter(?ValkeyGlideBloom bloom) */
+SET_BLOOM_FILTER_METHOD_IMPL(ValkeyGlideCluster)
+
+/* {{{ proto ?ValkeyGlideBloom ValkeyGlideCluster::getBloomFilter() */
+GET_BLOOM_FILTER_METHOD_IMPL(ValkeyGlideCluster)
+
+/* {{{ proto array ValkeyGlideCluster::metricsSnapshot([array fields [, mixed route]]) */
+METRICS_SNAPSHOT_METHOD_IMPL(ValkeyGlideCluster)
+
+/* {{{ proto mixed ValkeyGlideCluster::withDeadline(int ms [, callable callback]) */
+WITH_DEADLINE_METHOD_IMPL(ValkeyGlideCluster)
+
+/* {{{ proto mixed ValkeyGlideCluster::withReadFrom(int read_from [, callable callback]) */
+PHP_METHOD(ValkeyGlideCluster, withReadFrom) {
+    zend_long             read_from;
+    zend_fcall_info       fci = empty_fcall_info;
+    zend_fcall_info_cache fcc = empty_fcall_info_cache;
+
+    ZEND_PARSE_PARAMETERS_START(1, 2)
+    Z_PARAM_LONG(read_from)
+    Z_PARAM_OPTIONAL
+    Z_PARAM_FUNC_OR_NULL(fci, fcc)
+    ZEND_PARSE_PARAMETERS_END();
+
+    if (read_from < VALKEY_GLIDE_READ_FROM_PRIMARY ||
+        read_from > VALKEY_GLIDE_READ_FROM_AZ_AFFINITY_REPLICAS_AND_PRIMARY) {
+        zend_throw_exception(get_valkey_glide_exception_ce(), "Invalid read_from value", 0);
+        RETURN_THROWS();
+    }
+
+    /* Overrides become a slot route to the primary or a replica, which carries no AZ */
+    if (read_from == VALKEY_GLIDE_READ_FROM_AZ_AFFINITY ||
+        read_from == VALKEY_GLIDE_READ_FROM_AZ_AFFINITY_REPLICAS_AND_PRIMARY) {
+        zend_throw_exception(get_valkey_glide_exception_ce(),
+                             "withReadFrom() supports READ_FROM_PRIMARY and "
+                             "READ_FROM_PREFER_REPLICA only",
+                             0);
+        RETURN_THROWS();
+    }
+
+    valkey_glide_object* valkey_glide =
+        VALKEY_GLIDE_PHP_ZVAL_GET_OBJECT(valkey_glide_object, ZEND_THIS);
+    if (!valkey_glide || !valkey_glide->glide_client) {
+        zend_throw_exception(get_valkey_glide_exception_ce(), "Client is not connected", 0);
+        RETURN_THROWS();
+    }
+    if (valkey_glide_refuse_shared(valkey_glide, "withReadFrom()")) {
+        RETURN_THROWS();
+    }
+    if (valkey_glide->is_in_batch_mode) {
+        zend_throw_exception(get_valkey_glide_exception_ce(),
+                             "withReadFrom() cannot be used inside MULTI or PIPELINE",
+                             0);
+        RETURN_THROWS();
+    }
+
+    if (!ZEND_FCI_INITIALIZED(fci)) {
+        /* Applies to the next command only */
+        VALKEY_GLIDE_G(read_from_client) = valkey_glide->glide_client;
+        VALKEY_GLIDE_G(read_from)        = read_from;
+        VALKEY_GLIDE_G(read_from_once)   = true;
+        RETURN_OBJ_COPY(Z_OBJ_P(ZEND_THIS));
+    }
+
+    /* Applies to every command issued by callback, restoring the enclosing scope afterwards */
+    const void* prev_client = VALKEY_GLIDE_G(read_from_client);
+    zend_long   prev_value  = VALKEY_GLIDE_G(read_from);
+    bool        prev_once   = VALKEY_GLIDE_G(read_from_once);
+
+    VALKEY_GLIDE_G(read_from_client) = valkey_glide->glide_client;
+    VALKEY_GLIDE_G(read_from)        = read_from;
+    VALKEY_GLIDE_G(read_from_once)   = false;
+
+    fci.retval      = return_value;
+    fci.params      = ZEND_THIS;
+    fci.param_count = 1;
+    zend_call_function(&fci, &fcc);
+
+    VALKEY_GLIDE_G(read_from_client) = prev_client;
+    VALKEY_GLIDE_G(read_from)        = prev_value;
+    VALKEY_GLIDE_G(read_from_once)   = prev_once;
+}
+/* }}} */
+
+/* {{{ proto array ValkeyGlideCluster::getHedgeStats() */
+PHP_METHOD(ValkeyGlideCluster, getHedgeStats) {
+    ZEND_PARSE_PARAMETERS_NONE();
+
+    valkey_glide_object* valkey_glide =
+        VALKEY_GLIDE_PHP_ZVAL_GET_OBJECT(valkey_glide_object, ZEND_THIS);
+    if (!valkey_glide || !valkey_glide_hedge_stats(valkey_glide, return_value)) {
+        RETURN_FALSE;
+    }
+}
+/* }}} */
+
+/* {{{ proto int ValkeyGlideCluster::keySlot(string key) */
+PHP_METHOD(ValkeyGlideCluster, keySlot) {
+    zend_string* key;
+
+    ZEND_PARSE_PARAMETERS_START(1, 1)
+    Z_PARAM_STR(key)
+    ZEND_PARSE_PARAMETERS_END();
+
+    RETURN_LONG(valkey_glide_key_slot(ZSTR_VAL(key), ZSTR_LEN(key)));
+}
+/* }}} */
+
+/* Append value to the list at index of groups, creating the list */
+static void cluster_group_add(HashTable* groups, zend_ulong index, zval* value) {
+    zval* list = zend_hash_index_find(groups, index);
+    if (!list) {
+        zval empty;
+        array_init(&empty);
+        list = zend_hash_index_add_new(groups, index, &empty);
+    }
+    Z_TRY_ADDREF_P(value);
+    add_next_index_zval(list, value);
+}
+
+/* {{{ proto array ValkeyGlideCluster::groupKeysBySlot(array keys [, bool by_node]) */
+PHP_METHOD(ValkeyGlideCluster, groupKeysBySlot) {
+    HashTable* keys;
+    bool       by_node = false;
+    zval*      key;
+    uint16_t*  owners = NULL;
+    zval       nodes;
+
+    ZEND_PARSE_PARAMETERS_START(1, 2)
+    Z_PARAM_ARRAY_HT(keys)
+    Z_PARAM_OPTIONAL
+    Z_PARAM_BOOL(by_node)
+    ZEND_PARSE_PARAMETERS_END();
+
+    ZEND_HASH_FOREACH_VAL(keys, key) {
+        if (Z_TYPE_P(key) != IS_STRING) {
+            zend_argument_type_error(1, "must contain only strings");
+            RETURN_THROWS();
+        }
+    }
+    ZEND_HASH_FOREACH_END();
+
+    array_init(return_value);
+    if (!by_node) {
+        ZEND_HASH_FOREACH_VAL(keys, key) {
+            cluster_group_add(Z_ARRVAL_P(return_value),
+                              valkey_glide_key_slot(Z_STRVAL_P(key), Z_STRLEN_P(key)),
+                              key);
+        }
+        ZEND_HASH_FOREACH_END();
+        return;
+    }
+
+    valkey_glide_object* valkey_glide =
+        VALKEY_GLIDE_PHP_ZVAL_GET_OBJECT(valkey_glide_object, ZEND_THIS);
+    if (!valkey_glide || !valkey_glide->glide_client) {
+        zend_throw_exception(get_valkey_glide_exception_ce(), "Client is not connected", 0);
+        RETURN_THROWS();
+    }
+    if (valkey_glide->is_in_batch_mode) {
+        zend_throw_exception(get_valkey_glide_exception_ce(),
+                             "groupKeysBySlot() cannot look up nodes inside MULTI or PIPELINE",
+                             0);
+        RETURN_THROWS();
+    }
+
+    owners = safe_emalloc(VALKEY_GLIDE_CLUSTER_SLOTS, sizeof(uint16_t), 0);
+    if (!valkey_glide_slot_owners(valkey_glide->glide_client, owners, &nodes)) {
+        efree(owners);
+        RETURN_THROWS();
+    }
+
+    /* Group by node index first, keyed by address once every key is placed */
+    zval by_index;
+    array_init(&by_index);
+    ZEND_HASH_FOREACH_VAL(keys, key) {
+        uint16_t slot  = valkey_glide_key_slot(Z_STRVAL_P(key), Z_STRLEN_P(key));
+        zval*    slots = zend_hash_index_find(Z_ARRVAL(by_index), owners[slot]);
+
+        if (!slots) {
+            zval empty;
+            array_init(&empty);
+            slots = zend_hash_index_add_new(Z_ARRVAL(by_index), owners[slot], &empty);
+        }
+        cluster_group_add(Z_ARRVAL_P(slots), slot, key);
+    }
+    ZEND_HASH_FOREACH_END();
+
+    zend_string* node;
+    zval*        index;
+    ZEND_HASH_FOREACH_STR_KEY_VAL(Z_ARRVAL(nodes), node, index) {
+        zval* slots = zend_hash_index_find(Z_ARRVAL(by_index), Z_LVAL_P(index));
+        if (slots) {
+            Z_ADDREF_P(slots);
+            zend_hash_update(Z_ARRVAL_P(return_value), node, slots);
+        }
+    }
+    ZEND_HASH_FOREACH_END();
+
+    /* Keys of slots no node serves, during a resharding */
+    zval* orphans = zend_hash_index_find(Z_ARRVAL(by_index), VALKEY_GLIDE_CLUSTER_SLOTS);
+    if (orphans) {
+        Z_ADDREF_P(orphans);
+        zend_hash_str_update(Z_ARRVAL_P(return_value), "", 0, orphans);
+    }
+
+    zval_ptr_dtor(&by_index);
+    zval_ptr_dtor(&nodes);
+    efree(owners);
+}
+/* }}} */
+
+/* {{{ proto array ValkeyGlideCluster::ingestFile(string path [, string format, int window, int
+ * offset]) */
+INGEST_FILE_METHOD_IMPL(ValkeyGlideCluster)
+
+/* {{{ proto ValkeyGlideBitmap ValkeyGlideCluster::msetex(array kv, int|array ttl) */
+MSETEX_METHOD_IMPL(ValkeyGlideCluster)
+
+/* {{{ proto ValkeyGlideBitmap ValkeyGlideCluster::hmsetMulti(array hashes) */
+HMSET_MULTI_METHOD_IMPL(ValkeyGlideCluster)
+
+/* {{{ proto ValkeyGlideBitmap ValkeyGlideCluster::zaddMulti(array sets) */
+ZADD_MULTI_METHOD_IMPL(ValkeyGlideCluster)
+
 /* {{{ proto bool ValkeyGlideCluster::discard() */
 DISCARD_METHOD_IMPL(ValkeyGlideCluster)
 
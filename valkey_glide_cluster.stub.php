@@ -196,6 +196,86 @@ class ValkeyGlideCluster
      */
     public const OPT_REPLY_LITERAL = UNKNOWN;
 
+    /**
+     * Runtime option: Deduplicate identical reads in pipelines
+     * When enabled, identical read-only commands (same command and arguments) queued in a
+     * pipeline without a write in between are sent once, and the reply is returned in every
+     * position they were queued at. MULTI transactions are always sent verbatim.
+     *
+     * @var int
+     * @cvalue VALKEY_GLIDE_OPT_PIPELINE_DEDUPE
+     *
+     */
+    public const OPT_PIPELINE_DEDUPE = UNKNOWN;
+
+    /**
+     * Runtime option: Hot-key sampling rate
+     * Fraction of commands, between 0 and 1, whose key is fed to the hot-key detector read
+     * with getHotKeys(). 0 (the default) turns the detector off. Setting a rate starts over.
+     *
+     * @var int
+     * @cvalue VALKEY_GLIDE_OPT_HOT_KEY_SAMPLING
+     *
+     */
+    public const OPT_HOT_KEY_SAMPLING = UNKNOWN;
+
+    /**
+     * Runtime option: Slow log threshold
+     * Commands and batches taking at least this many microseconds, measured around the call
+     * into the client core, are recorded for getSlowLog(). 0 records every call, a negative
+     * value (the default) turns recording off.
+     *
+     * @var int
+     * @cvalue VALKEY_GLIDE_OPT_SLOWLOG_THRESHOLD
+     *
+     */
+    public const OPT_SLOWLOG_THRESHOLD = UNKNOWN;
+
+    /**
+     * Runtime option: Columnar results
+     * When enabled, GEOSEARCH with WITH* options, ZRANGE-style WITHSCORES, XRANGE/XREVRANGE and
+     * the extended form of XPENDING return one packed array per field instead of one array per
+     * row, e.g. ['member' => [...], 'dist' => [...], 'lon' => [...], 'lat' => [...]].
+     *
+     * @var int
+     * @cvalue VALKEY_GLIDE_OPT_COLUMNAR
+     *
+     */
+    public const OPT_COLUMNAR = UNKNOWN;
+
+    /**
+     * Runtime option: Per-node statistics
+     * When enabled, every command is timed and counted against the node serving its key, for
+     * getNodeStats(). Cluster clients keep two small counter sets per node and a 32KB map of
+     * the node serving each hash slot, looked up when it is enabled.
+     * Disabling it discards the statistics.
+     *
+     * @var int
+     * @cvalue VALKEY_GLIDE_OPT_NODE_STATS
+     *
+     */
+    public const OPT_NODE_STATS = UNKNOWN;
+
+    /**
+     * Runtime option: Hedged reads
+     * When a repeatable read of a single slot gets no reply from the slot's primary within the
+     * hedge delay, the same read is sent to one of the slot's replicas, taken round robin whatever
+     * the read_from and client_az settings, and the first successful reply is returned.
+     * The value is true to use the p95 of recent primary latencies as the delay, a delay in
+     * milliseconds, or ['delay' => ms (0 for the p95), 'max_rate' => fraction of reads that may
+     * be hedged, 0.05 by default]. Hedging uses a pool of 4 worker threads: while fewer than two
+     * are idle, or until the delay is learned, reads are sent directly from the calling thread
+     * and aren't hedged. A replica may lag behind its primary. See getHedgeStats().
+     * Clients configured with READ_FROM_PRIMARY can't enable it. The worker threads and the
+     * learned delay belong to the client object: a new object starts its own threads, and learns
+     * the delay again over its first 32 reads, so under FPM prefer a fixed delay.
+     *
+     * @var int
+     * @cvalue VALKEY_GLIDE_OPT_HEDGED_READS
+     *
+     */
+    public const OPT_HEDGED_READS = UNKNOWN;
+
     /**
      * Create a new ValkeyGlideCluster instance with the provided configuration.
      * Supports both PHPRedis RedisCluster-style and ValkeyGlide-style parameters.
@@ -233,6 +313,23 @@ class ValkeyGlideCluster
      *                                          - 'tls_config' => ['use_insecure_tls' => false]
      *                                          - 'refresh_topology_from_initial_nodes' => false (default: false)
      *                                            When true, topology updates use only initial nodes instead of internal cluster view.
+     *                                          - 'async_completions' => true enables submit(), poll() and getCompletionFd()
+     *                                          - 'fiber_aware' => true (or a worker thread count, default 16): commands issued
+     *                                            inside a Fiber suspend it instead of blocking; poll() must be called to resume it.
+     *                                            Each in-flight command holds one worker thread. @see ValkeyGlide::connect
+     *                                          - 'fiber_suspend' => callable($stream) suspending the Fiber until $stream becomes
+     *                                            readable, for event loops to resume it rather than poll(). @see ValkeyGlide::connect
+     *                                          - 'shared_client' => true reuses a single multiplexed client per process for
+     *                                            identical configurations, across all threads of ZTS builds. Shared clients
+     *                                            stay connected until the process exits and do not support subscriptions,
+     *                                            fiber_aware, circuit_breaker, select(), withReadFrom(), withDeadline(),
+     *                                            OPT_SLOWLOG_THRESHOLD, OPT_NODE_STATS or OPT_HEDGED_READS.
+     *                                          - 'circuit_breaker' => ['failures' => 5, 'open_ms' => 5000] (or true): calls to a
+     *                                            primary that timed out or lost its connection that many times in a row
+     *                                            throw ValkeyGlideCircuitOpenException until a probe succeeds.
+     *                                          - 'retry_budget' => ['ratio' => 0.1, 'window_ms' => 10000, 'min_retries' => 3]
+     *                                            (or true): reads failing that way are sent once more, within ratio of
+     *                                            the requests of each window. See getBreakerStats().
      *                                          - 'otel' => OpenTelemetryConfig::builder()
      *                                                        ->traces(TracesConfig::builder()
      *                                                          ->endpoint('grpc://localhost:4317')
@@ -249,6 +346,8 @@ class ValkeyGlideCluster
      *                                          For cluster mode, requires Valkey 9.0+ with cluster-databases > 1.
      *                                          If not specified, defaults to database 0.
      * @param array|null $compression           Compression configuration: ['enabled' => true, 'backend' => COMPRESSION_BACKEND_ZSTD, 'compression_level' => 3, 'min_compression_size' => 64]
+     *                                          Add 'dictionary_key' => 'app:zstd-dicts' to compress with trained
+     *                                          dictionaries, see ValkeyGlide::trainCompressionDictionary().
      *
      * Note: Cannot mix PHPRedis-style and ValkeyGlide-style parameters.
      */
@@ -392,6 +491,175 @@ class ValkeyGlideCluster
      */
     public function getStatistics(): array;
 
+    /**
+     * @see ValkeyGlide::submit
+     */
+    public function submit(string $command, mixed ...$args): int|false;
+
+    /**
+     * @see ValkeyGlide::poll
+     */
+    public function poll(int $max = 0): array|false;
+
+    /**
+     * @see ValkeyGlide::getCompletionFd
+     */
+    public function getCompletionFd(): mixed;
+
+    /**
+     * @see ValkeyGlide::registerStreamAlias
+     */
+    public function registerStreamAlias(string $alias): bool;
+
+    /**
+     * @see ValkeyGlide::getHotKeys
+     */
+    public function getHotKeys(int $n = 10): array|false;
+
+    /**
+     * @see ValkeyGlide::getSlowLog
+     */
+    public function getSlowLog(): array|false;
+
+    /**
+     * @see ValkeyGlide::resetSlowLog
+     */
+    public function resetSlowLog(): bool;
+
+    /**
+     * @see ValkeyGlide::getNodeStats
+     */
+    public function getNodeStats(): array|false;
+
+    /**
+     * @see ValkeyGlide::getBreakerStats
+     */
+    public function getBreakerStats(): array|false;
+
+    /**
+     * @see ValkeyGlide::trainCompressionDictionary
+     */
+    public function trainCompressionDictionary(array $samples, int $size = 16384): int|false;
+
+    /**
+     * @see ValkeyGlide::loadCompressionDictionaries
+     */
+    public function loadCompressionDictionaries(): int|false;
+
+    /**
+     * Report how hedged reads went.
+     *
+     * Requires OPT_HEDGED_READS. Reads are the reads eligible for hedging, sent to their primary;
+     * hedged counts those also sent to a replica, wins those the replica answered first, and
+     * capped those that outlasted the delay but were left to the primary, because max_rate was
+     * reached or no worker was idle.
+     *
+     * @return array|false ['reads' => int, 'hedged' => int, 'wins' => int, 'capped' => int,
+     *                     'delay_ms' => float|null], delay_ms being null until enough primary
+     *                     latencies were seen to learn it. False when hedging is off.
+     *
+     * @example
+     * $cluster->setOption(ValkeyGlideCluster::OPT_HEDGED_READS, ['delay' => 0, 'max_rate' => 0.02]);
+     * $stats = $cluster->getHedgeStats();
+     * printf("%.2f%% of reads won by a replica\n", 100 * $stats['wins'] / max(1, $stats['reads']));
+     */
+    public function getHedgeStats(): array|false;
+
+    /**
+     * @see ValkeyGlide::getMemoryStats
+     */
+    public function getMemoryStats(): array;
+
+    /**
+     * @see ValkeyGlide::setBloomFilter
+     */
+    public function setBloomFilter(?ValkeyGlideBloom $bloom): bool;
+
+    /**
+     * @see ValkeyGlide::getBloomFilter
+     */
+    public function getBloomFilter(): ?ValkeyGlideBloom;
+
+    /**
+     * @see ValkeyGlide::metricsSnapshot
+     *
+     * Returns one array per node, keyed by address. The rates are kept per node, so the route
+     * must name the nodes: 'allPrimaries', 'allNodes' or a routeByAddress array, whose snapshot
+     * is a single array for that address. 'randomNode' and key or slot routes are rejected.
+     */
+    public function metricsSnapshot(array $fields = [], mixed $route = 'allPrimaries'): array|false;
+
+    /**
+     * @see ValkeyGlide::withDeadline
+     */
+    public function withDeadline(int $ms, ?callable $callback = null): mixed;
+
+    /**
+     * Override the client's read strategy for some reads.
+     *
+     * Without a callback the override applies to the next command only, and the client is
+     * returned so the command can be chained. With a callback it applies to every command the
+     * callback issues on this client; the callback receives the client and its return value is
+     * returned.
+     *
+     * Read-only single key commands, and multi-key reads whose keys share a slot, are routed to a
+     * replica of the key's slot for READ_FROM_PREFER_REPLICA, or to its primary for
+     * READ_FROM_PRIMARY (e.g. read-your-writes on a client configured with READ_FROM_PREFER_REPLICA).
+     * The override is sent as a route to the slot's replicas, which glide-core picks among without
+     * regard to availability zones, so READ_FROM_AZ_AFFINITY and
+     * READ_FROM_AZ_AFFINITY_REPLICAS_AND_PRIMARY are rejected: configure them on the client instead.
+     * Writes, commands without keys and reads spanning several slots keep the default routing.
+     * Not available inside MULTI or PIPELINE.
+     *
+     * @param int           $read_from ValkeyGlide::READ_FROM_PRIMARY or READ_FROM_PREFER_REPLICA.
+     * @param callable|null $callback  function (ValkeyGlideCluster $client): mixed
+     *
+     * @return mixed The client, or the return value of the callback.
+     *
+     * @example
+     * $value = $cluster->withReadFrom(ValkeyGlide::READ_FROM_PREFER_REPLICA)->get('key');
+     * $profiles = $cluster->withReadFrom(ValkeyGlide::READ_FROM_PREFER_REPLICA, function ($c) use ($ids) {
+     *     return array_map(fn ($id) => $c->hGetAll("profile:$id"), $ids);
+     * });
+     */
+    public function withReadFrom(int $read_from, ?callable $callback = null): mixed;
+
+    /**
+     * Compute the hash slot of a key, honouring {hash tags}, without a round trip.
+     *
+     * @param string $key The key.
+     *
+     * @return int The slot, between 0 and 16383.
+     *
+     * @example
+     * $cluster->keySlot('{user:1}:cart') === $cluster->keySlot('user:1'); // true
+     */
+    public function keySlot(string $key): int;
+
+    /**
+     * Group keys by hash slot, so that each group can go into a MULTI or a pipeline that never
+     * spans nodes.
+     *
+     * @param array $keys    The keys, as strings.
+     * @param bool  $by_node Also group the slots by the primary serving them. This asks a node
+     *                       for CLUSTER SLOTS, so the grouping reflects the topology at the time
+     *                       of the call.
+     *
+     * @return array The keys by slot, [slot => [key, ...]], in the order they were given. With
+     *               $by_node, those arrays by primary address, ['host:port' => [slot => [...]]],
+     *               keys of slots no node serves under ''.
+     *
+     * @example
+     * foreach ($cluster->groupKeysBySlot($keys) as $slot => $group) {
+     *     $cluster->multi();
+     *     foreach ($group as $key) {
+     *         $cluster->incr($key);
+     *     }
+     *     $cluster->exec();
+     * }
+     */
+    public function groupKeysBySlot(array $keys, bool $by_node = false): array;
+
     /**
      * @see ValkeyGlide::updateConnectionPassword
      */
@@ -478,6 +746,26 @@ class ValkeyGlideCluster
      */
     public function exec(): array|false;
 
+    /**
+     * @see ValkeyGlide::ingestFile()
+     */
+    public function ingestFile(string $path, string $format = 'resp', int $window = 1000, int $offset = 0): array|false;
+
+    /**
+     * @see ValkeyGlide::msetex()
+     */
+    public function msetex(array $kv, int|array $ttl): ValkeyGlideBitmap|false;
+
+    /**
+     * @see ValkeyGlide::hmsetMulti()
+     */
+    public function hmsetMulti(array $hashes): ValkeyGlideBitmap|false;
+
+    /**
+     * @see ValkeyGlide::zaddMulti()
+     */
+    public function zaddMulti(array $sets): ValkeyGlideBitmap|false;
+
     /**
      * @see ValkeyGlide::exists
      */
@@ -568,6 +856,11 @@ class ValkeyGlideCluster
      */
     public function getBit(string $key, int $idx): ValkeyGlideCluster|int|false;
 
+    /**
+     * @see ValkeyGlide::getBitmap
+     */
+    public function getBitmap(string $key): ValkeyGlideCluster|ValkeyGlideBitmap|false;
+
     /**
      * @see ValkeyGlide::getrange
      */
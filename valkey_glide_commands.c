@@ -21,8 +21,10 @@
 #include "include/glide_bindings.h"
 #include "logger.h"
 #include "php.h"
+#include "valkey_glide_bloom.h"
 #include "valkey_glide_commands_common.h"
 #include "valkey_glide_core_common.h"
+#include "valkey_glide_dictionary.h"
 #include "valkey_glide_z_common.h"
 #include "zend_exceptions.h"
 
@@ -45,14 +47,23 @@ int execute_mset_command(zval* object, int argc, zval* return_value, zend_class_
         args.glide_client        = valkey_glide->glide_client;
         args.cmd_type            = MSet;
 
+        /* Values are sent compressed when the client has a trained dictionary */
+        zval packed;
+        bool compressed = valkey_glide_dictionary_compress_pairs(valkey_glide, z_arr, &packed);
+
         /* Set up array argument for key-value pairs */
         args.args[0].type                 = CORE_ARG_TYPE_ARRAY;
-        args.args[0].data.array_arg.array = z_arr;
+        args.args[0].data.array_arg.array = compressed ? &packed : z_arr;
         args.args[0].data.array_arg.count = zend_hash_num_elements(Z_ARRVAL_P(z_arr));
         args.arg_count                    = 1;
 
-        if (execute_core_command(
-                valkey_glide, &args, NULL, process_core_bool_result, return_value)) {
+        int result =
+            execute_core_command(valkey_glide, &args, NULL, process_core_bool_result, return_value);
+        if (compressed) {
+            zval_ptr_dtor(&packed);
+        }
+
+        if (result) {
             if (valkey_glide->is_in_batch_mode) {
                 /* In batch mode, return $this for method chaining */
                 ZVAL_COPY(return_value, object);
@@ -85,14 +96,23 @@ int execute_msetnx_command(zval* object, int argc, zval* return_value, zend_clas
         args.glide_client        = valkey_glide->glide_client;
         args.cmd_type            = MSetNX;
 
+        /* Values are sent compressed when the client has a trained dictionary */
+        zval packed;
+        bool compressed = valkey_glide_dictionary_compress_pairs(valkey_glide, z_arr, &packed);
+
         /* Set up array argument for key-value pairs */
         args.args[0].type                 = CORE_ARG_TYPE_ARRAY;
-        args.args[0].data.array_arg.array = z_arr;
+        args.args[0].data.array_arg.array = compressed ? &packed : z_arr;
         args.args[0].data.array_arg.count = zend_hash_num_elements(Z_ARRVAL_P(z_arr));
         args.arg_count                    = 1;
 
-        if (execute_core_command(
-                valkey_glide, &args, NULL, process_core_bool_result, return_value)) {
+        int result =
+            execute_core_command(valkey_glide, &args, NULL, process_core_bool_result, return_value);
+        if (compressed) {
+            zval_ptr_dtor(&packed);
+        }
+
+        if (result) {
             if (valkey_glide->is_in_batch_mode) {
                 /* In batch mode, return $this for method chaining */
                 ZVAL_COPY(return_value, object);
@@ -831,6 +851,11 @@ int execute_select_command(zval* object, int argc, zval* return_value, zend_clas
         return 0;
     }
 
+    /* Every user of a shared client would switch database */
+    if (valkey_glide_refuse_shared(valkey_glide, "select()")) {
+        return 0;
+    }
+
     /* SELECT cannot be used in batch mode */
     if (valkey_glide->is_in_batch_mode) {
         VALKEY_LOG_ERROR("batch_validation", "SELECT command cannot be used in batch mode");
@@ -839,6 +864,8 @@ int execute_select_command(zval* object, int argc, zval* return_value, zend_clas
 
     /* Execute the SELECT command using the Glide client */
     if (execute_select_command_internal(valkey_glide, dbindex, return_value)) {
+        /* A Bloom filter describes the keys of the database it was attached on */
+        valkey_glide_bloom_release(valkey_glide);
         return 1;
     }
 
@@ -16,8 +16,10 @@
 
 #include "command_response.h" /* Include command_response.h for string conversion functions */
 #include "php.h"
+#include "valkey_glide_bloom.h"
 #include "valkey_glide_commands_common.h"
 #include "valkey_glide_core_common.h"
+#include "valkey_glide_dictionary.h"
 
 #if PHP_VERSION_ID < 80400
 #include <ext/standard/php_random.h>
@@ -536,7 +538,12 @@ int execute_mget_command(zval* object, int argc, zval* return_value, zend_class_
     args.args[0].data.array_arg.count = zend_hash_num_elements(Z_ARRVAL_P(z_array));
     args.arg_count                    = 1;
 
-    if (execute_core_command(valkey_glide, &args, NULL, process_core_array_result, return_value)) {
+    /* Values compressed with a trained dictionary are decoded along with the reply */
+    void*                output    = NULL;
+    z_result_processor_t processor =
+        valkey_glide_dictionary_processor(valkey_glide, process_core_array_result, &output);
+
+    if (execute_core_command(valkey_glide, &args, output, processor, return_value)) {
         if (valkey_glide->is_in_batch_mode) {
             /* In batch mode, return $this for method chaining */
             ZVAL_COPY(return_value, object);
@@ -566,6 +573,12 @@ int execute_exists_command(zval* object, int argc, zval* return_value, zend_clas
         return 0;
     }
 
+    /* None of the keys can exist if the Bloom filter has seen none of them */
+    if (valkey_glide_bloom_rules_out_keys(valkey_glide, z_args, argc)) {
+        ZVAL_LONG(return_value, 0);
+        return 1;
+    }
+
     /* Check if we received an array as a single argument */
     if (argc == 1 && Z_TYPE_P(z_args) == IS_ARRAY) {
         /* Single array argument - pass directly to EXISTS command */
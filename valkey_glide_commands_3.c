@@ -19,13 +19,20 @@
 #include <zend.h>
 #include <zend_API.h>
 #include <zend_exceptions.h>
+#include <zend_smart_str.h>
 
 #include "command_response.h"
 #include "ext/standard/php_var.h"
 #include "include/glide_bindings.h"
+#include "valkey_glide_bloom.h"
 #include "valkey_glide_commands_common.h"
 #include "valkey_glide_core_common.h"
+#include "valkey_glide_deadline.h"
+#include "valkey_glide_fiber.h"
 #include "valkey_glide_hash_common.h"
+#include "valkey_glide_memory.h"
+#include "valkey_glide_otel.h"
+#include "valkey_glide_slowlog.h"
 #include "valkey_glide_z_common.h"
 
 /* Helper functions for batch state management */
@@ -129,6 +136,19 @@ int execute_wait_command(zval* object, int argc, zval* return_value, zend_class_
 
 /* Helper function implementations */
 
+/* Bytes a buffered command holds in argument copies, for memory accounting */
+static size_t batch_command_bytes(const struct batch_command* cmd) {
+    size_t bytes = cmd->arg_count * (sizeof(uint8_t*) + sizeof(uintptr_t));
+    size_t j;
+
+    for (j = 0; j < cmd->arg_count; j++) {
+        if (cmd->args[j]) {
+            bytes += cmd->arg_lengths[j] + 1;
+        }
+    }
+    return bytes;
+}
+
 /* Clear batch state and free buffered commands */
 static void clear_batch_state(valkey_glide_object* valkey_glide) {
     if (!valkey_glide) {
@@ -144,6 +164,7 @@ static void clear_batch_state(valkey_glide_object* valkey_glide) {
 
             /* Free argument arrays */
             if (cmd->args) {
+                valkey_glide_mem_free(VALKEY_GLIDE_MEM_BATCH, batch_command_bytes(cmd));
                 for (j = 0; j < cmd->arg_count; j++) {
                     if (cmd->args[j]) {
                         efree(cmd->args[j]);
@@ -157,6 +178,8 @@ static void clear_batch_state(valkey_glide_object* valkey_glide) {
             }
         }
 
+        valkey_glide_mem_free(VALKEY_GLIDE_MEM_BATCH,
+                              valkey_glide->command_capacity * sizeof(struct batch_command));
         efree(valkey_glide->buffered_commands);
         valkey_glide->buffered_commands = NULL;
         valkey_glide->command_capacity  = 0;
@@ -182,6 +205,9 @@ static void expand_command_buffer(valkey_glide_object* valkey_glide) {
         valkey_glide->buffered_commands, new_capacity * sizeof(struct batch_command));
 
     if (new_buffer) {
+        valkey_glide_mem_realloc(VALKEY_GLIDE_MEM_BATCH,
+                                 valkey_glide->command_capacity * sizeof(struct batch_command),
+                                 new_capacity * sizeof(struct batch_command));
         valkey_glide->buffered_commands = new_buffer;
         valkey_glide->command_capacity  = new_capacity;
 
@@ -243,6 +269,7 @@ int buffer_command_for_batch(valkey_glide_object* valkey_glide,
                 cmd->arg_lengths[i] = 0;
             }
         }
+        valkey_glide_mem_alloc(VALKEY_GLIDE_MEM_BATCH, batch_command_bytes(cmd));
     } else {
         cmd->args        = NULL;
         cmd->arg_lengths = NULL;
@@ -844,6 +871,8 @@ static int initialize_batch_mode(valkey_glide_object* valkey_glide,
         valkey_glide->command_capacity  = 16; /* Initial capacity */
         valkey_glide->buffered_commands = (struct batch_command*) ecalloc(
             valkey_glide->command_capacity, sizeof(struct batch_command));
+        valkey_glide_mem_alloc(VALKEY_GLIDE_MEM_BATCH,
+                               valkey_glide->command_capacity * sizeof(struct batch_command));
     }
 
     /* Return $this for method chaining */
@@ -914,6 +943,127 @@ int execute_discard_command(zval* object, int argc, zval* return_value, zend_cla
     }
 }
 
+/*
+ * Collapse identical reads of a pipeline: slot_to_unique[i] receives the index of the command
+ * actually sent for buffered command i, and unique_to_slot the buffered command sent at each
+ * index. Reads are only merged with an identical read queued after the last write, since any
+ * other command may change what they return. Returns the number of commands to send.
+ */
+static size_t dedupe_batch_commands(valkey_glide_object* valkey_glide,
+                                    size_t*              slot_to_unique,
+                                    size_t*              unique_to_slot) {
+    HashTable seen;
+    size_t    unique_count = 0;
+
+    zend_hash_init(&seen, 16, NULL, NULL, 0);
+
+    for (size_t i = 0; i < valkey_glide->command_count; i++) {
+        struct batch_command* buffered = &valkey_glide->buffered_commands[i];
+
+        if (!valkey_glide_is_idempotent_read(buffered->request_type)) {
+            zend_hash_clean(&seen);
+            unique_to_slot[unique_count] = i;
+            slot_to_unique[i]            = unique_count++;
+            continue;
+        }
+
+        /* Fingerprint: request type, then every argument prefixed with its length */
+        smart_str fingerprint = {0};
+        smart_str_appendl(&fingerprint,
+                          (const char*) &buffered->request_type,
+                          sizeof(buffered->request_type));
+        for (uintptr_t arg = 0; arg < buffered->arg_count; arg++) {
+            size_t len = buffered->arg_lengths[arg];
+            smart_str_appendl(&fingerprint, (const char*) &len, sizeof(len));
+            smart_str_appendl(&fingerprint, (const char*) buffered->args[arg], len);
+        }
+        smart_str_0(&fingerprint);
+
+        zval* existing = zend_hash_find(&seen, fingerprint.s);
+        if (existing) {
+            slot_to_unique[i] = (size_t) Z_LVAL_P(existing);
+        } else {
+            zval index;
+            ZVAL_LONG(&index, (zend_long) unique_count);
+            zend_hash_add_new(&seen, fingerprint.s, &index);
+            unique_to_slot[unique_count] = i;
+            slot_to_unique[i]            = unique_count++;
+        }
+        smart_str_free(&fingerprint);
+    }
+
+    zend_hash_destroy(&seen);
+    return unique_count;
+}
+
+struct CommandResult* valkey_glide_send_batch(valkey_glide_object*    valkey_glide,
+                                              const struct BatchInfo* batch_info,
+                                              size_t                  payload_bytes) {
+    /* A withDeadline() budget bounds the whole batch, without retries */
+    struct BatchOptionsInfo        deadline_options;
+    const struct BatchOptionsInfo* options = NULL;
+    int64_t                        deadline_ms;
+    bool deadline = valkey_glide_deadline_take(valkey_glide->glide_client, &deadline_ms);
+    if (deadline) {
+        if (deadline_ms == 0) {
+            valkey_glide_deadline_exceeded(false);
+            return NULL;
+        }
+        valkey_glide_deadline_options(&deadline_options, deadline_ms);
+        options = &deadline_options;
+    }
+
+    /* Batches are routed by glide-core, a withReadFrom() for the next call doesn't apply */
+    valkey_glide_drop_next_call_options(valkey_glide->glide_client);
+
+    /* Keys the commands may create, for a Bloom filter attached to the client */
+    for (size_t i = 0; i < batch_info->cmd_count; i++) {
+        const struct CmdInfo* cmd = batch_info->cmds[i];
+        valkey_glide_bloom_record(valkey_glide->glide_client,
+                                  cmd->request_type,
+                                  (const uintptr_t*) cmd->args,
+                                  (const unsigned long*) cmd->args_len,
+                                  cmd->arg_count);
+    }
+
+    /* One span for the whole MULTI/PIPELINE */
+    uint64_t span_ptr = valkey_glide_create_batch_span(batch_info->cmd_count, payload_bytes);
+    uint64_t start_ns = valkey_glide->slowlog ? valkey_glide_slowlog_now() : 0;
+
+    /* Execute via FFI batch() function, suspending the current Fiber on fiber-aware clients */
+    struct CommandResult* result;
+    if (valkey_glide_fiber_should_offload(valkey_glide->glide_client)) {
+        result = valkey_glide_fiber_batch(
+            valkey_glide->glide_client, batch_info, false, options, span_ptr);
+    } else {
+        result = batch(valkey_glide->glide_client,
+                       0, /* callback_index (not used for sync) */
+                       batch_info,
+                       false, /* raise_on_error */
+                       options,
+                       span_ptr);
+    }
+
+    valkey_glide_drop_span(span_ptr);
+
+    uint64_t duration_us;
+    if (valkey_glide->slowlog &&
+        valkey_glide_slowlog_is_slow(valkey_glide->slowlog, start_ns, &duration_us)) {
+        valkey_glide_slowlog_add_batch(valkey_glide->slowlog,
+                                       duration_us,
+                                       batch_info->is_atomic,
+                                       batch_info->cmd_count,
+                                       payload_bytes,
+                                       result);
+    }
+
+    if (deadline) {
+        result = valkey_glide_deadline_check(result);
+    }
+
+    return result;
+}
+
 /* Execute an EXEC command using the Valkey Glide client - UPDATED FOR BUFFERING */
 int execute_exec_command(zval* object, int argc, zval* return_value, zend_class_entry* ce) {
     valkey_glide_object* valkey_glide;
@@ -936,20 +1086,35 @@ int execute_exec_command(zval* object, int argc, zval* return_value, zend_class_
         return 0;
     }
 
+    /* Identical reads of a non-atomic pipeline are sent once when OPT_PIPELINE_DEDUPE is set */
+    size_t  cmd_count      = valkey_glide->command_count;
+    size_t* slot_to_unique = NULL;
+    size_t* unique_to_slot = NULL;
+    if (valkey_glide->opt_pipeline_dedupe && valkey_glide->batch_type != MULTI) {
+        slot_to_unique = (size_t*) emalloc(valkey_glide->command_count * sizeof(size_t));
+        unique_to_slot = (size_t*) emalloc(valkey_glide->command_count * sizeof(size_t));
+        cmd_count      = dedupe_batch_commands(valkey_glide, slot_to_unique, unique_to_slot);
+    }
+
     /* Convert buffered commands to FFI BatchInfo structure */
-    struct CmdInfo** cmd_infos =
-        (struct CmdInfo**) emalloc(valkey_glide->command_count * sizeof(struct CmdInfo*));
+    struct CmdInfo** cmd_infos = (struct CmdInfo**) emalloc(cmd_count * sizeof(struct CmdInfo*));
     if (!cmd_infos) {
+        if (slot_to_unique) {
+            efree(slot_to_unique);
+            efree(unique_to_slot);
+        }
         clear_batch_state(valkey_glide);
         ZVAL_FALSE(return_value);
         return 0;
     }
 
-    /* Create CmdInfo structures for each buffered command */
+    /* Create CmdInfo structures for each command to send */
     size_t i;
-    for (i = 0; i < valkey_glide->command_count; i++) {
-        struct batch_command* buffered = &valkey_glide->buffered_commands[i];
-        struct CmdInfo*       cmd_info = (struct CmdInfo*) emalloc(sizeof(struct CmdInfo));
+    size_t payload_bytes = 0;
+    for (i = 0; i < cmd_count; i++) {
+        struct batch_command* buffered =
+            &valkey_glide->buffered_commands[unique_to_slot ? unique_to_slot[i] : i];
+        struct CmdInfo* cmd_info = (struct CmdInfo*) emalloc(sizeof(struct CmdInfo));
 
         if (!cmd_info) {
             /* Cleanup on error */
@@ -957,6 +1122,10 @@ int execute_exec_command(zval* object, int argc, zval* return_value, zend_class_
                 efree(cmd_infos[j]);
             }
             efree(cmd_infos);
+            if (slot_to_unique) {
+                efree(slot_to_unique);
+                efree(unique_to_slot);
+            }
             clear_batch_state(valkey_glide);
             ZVAL_FALSE(return_value);
             return 0;
@@ -967,34 +1136,38 @@ int execute_exec_command(zval* object, int argc, zval* return_value, zend_class_
         cmd_info->arg_count    = buffered->arg_count;
         cmd_info->args_len     = (const uintptr_t*) buffered->arg_lengths;
 
+        for (uintptr_t arg = 0; arg < buffered->arg_count; arg++) {
+            payload_bytes += buffered->arg_lengths[arg];
+        }
+
         cmd_infos[i] = cmd_info;
     }
 
     /* Create BatchInfo structure */
-    struct BatchInfo batch_info = {.cmd_count = valkey_glide->command_count,
+    struct BatchInfo batch_info = {.cmd_count = cmd_count,
                                    .cmds      = (const struct CmdInfo* const*) cmd_infos,
                                    .is_atomic = (valkey_glide->batch_type == MULTI)};
 
-    /* Execute via FFI batch() function */
-    struct CommandResult* result = batch(valkey_glide->glide_client,
-                                         0, /* callback_index (not used for sync) */
-                                         &batch_info,
-                                         false, /* raise_on_error */
-                                         NULL,  /* options */
-                                         0      /* span_ptr */
-    );
+    struct CommandResult* result =
+        valkey_glide_send_batch(valkey_glide, &batch_info, payload_bytes);
 
     /* Free CmdInfo structures */
-    for (i = 0; i < valkey_glide->command_count; i++) {
+    for (i = 0; i < cmd_count; i++) {
         efree(cmd_infos[i]);
     }
     efree(cmd_infos);
+    if (unique_to_slot) {
+        efree(unique_to_slot);
+    }
 
     /* Process results and clear batch state */
     int status = 0;
     if (result) {
         if (result->command_error) {
             /* Command failed */
+            if (slot_to_unique) {
+                efree(slot_to_unique);
+            }
             free_command_result(result);
             clear_batch_state(valkey_glide);
             ZVAL_FALSE(return_value);
@@ -1003,18 +1176,23 @@ int execute_exec_command(zval* object, int argc, zval* return_value, zend_class_
         status = 1; /* Assume success unless we find issues */
         if (result->response) {
             if (result->response->response_type != Array ||
-                result->response->array_value_len != valkey_glide->command_count) {
+                result->response->array_value_len != cmd_count) {
                 ZVAL_FALSE(return_value);
                 status = 0;
+                if (slot_to_unique) {
+                    efree(slot_to_unique);
+                }
                 free_command_result(result);
                 clear_batch_state(valkey_glide);
                 return status;
             }
-            array_init(return_value);
-            for (int64_t idx = 0; idx < result->response->array_value_len; idx++) {
-                zval value;
-                int  process_status = valkey_glide->buffered_commands[idx].process_result(
-                    &result->response->array_value[idx],
+            array_init_size(return_value, valkey_glide->command_count);
+            /* Every buffered command processes its reply, shared or not, on its own */
+            for (size_t idx = 0; idx < valkey_glide->command_count; idx++) {
+                size_t reply          = slot_to_unique ? slot_to_unique[idx] : idx;
+                zval   value;
+                int    process_status = valkey_glide->buffered_commands[idx].process_result(
+                    &result->response->array_value[reply],
                     valkey_glide->buffered_commands[idx].result_ptr,
                     &value);
 
@@ -1036,6 +1214,9 @@ int execute_exec_command(zval* object, int argc, zval* return_value, zend_class_
         }
     }
 
+    if (slot_to_unique) {
+        efree(slot_to_unique);
+    }
     free_command_result(result);
     clear_batch_state(valkey_glide);
     return status;
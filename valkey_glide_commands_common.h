@@ -67,6 +67,10 @@ static inline void handle_command_result_or_throw(CommandResult* result,
                                                   const char*    command_name,
                                                   zval*          return_value) {
     if (!result) {
+        if (EG(exception)) {
+            /* Already reported, e.g. a withDeadline() timeout */
+            return;
+        }
         char* error_msg;
         spprintf(&error_msg, 0, "%s: Failed to execute command", command_name);
         zend_throw_exception(get_valkey_glide_exception_ce(), error_msg, 0);
@@ -121,6 +125,20 @@ const ConnectionResponse* create_glide_client(valkey_glide_base_client_configura
 const ConnectionResponse* create_glide_cluster_client(
     valkey_glide_cluster_client_configuration_t* config);
 
+const ConnectionResponse* create_glide_async_client(
+    valkey_glide_base_client_configuration_t* config);
+
+const ConnectionResponse* create_glide_async_cluster_client(
+    valkey_glide_cluster_client_configuration_t* config);
+
+/* Process-wide clients for advanced_config['shared_client'], closed at module shutdown */
+#define VALKEY_GLIDE_SHARED_CLIENT "shared_client"
+const void* create_shared_glide_client(valkey_glide_base_client_configuration_t* config);
+const void* create_shared_glide_cluster_client(
+    valkey_glide_cluster_client_configuration_t* config);
+void valkey_glide_shared_clients_startup(void);
+void valkey_glide_shared_clients_shutdown(void);
+
 /* Return the protobuf message representing the connection request. Caller must free the result with
  * efree() */
 uint8_t* create_connection_request(size_t*                                   len,
@@ -238,6 +256,15 @@ int execute_multi_command(zval* object, int argc, zval* return_value, zend_class
 int execute_pipeline_command(zval* object, int argc, zval* return_value, zend_class_entry* ce);
 int execute_discard_command(zval* object, int argc, zval* return_value, zend_class_entry* ce);
 int execute_exec_command(zval* object, int argc, zval* return_value, zend_class_entry* ce);
+
+/* Send a batch the way exec() does: traced, offloaded to the Fiber poller, and slow-logged */
+struct CommandResult* valkey_glide_send_batch(valkey_glide_object*    valkey_glide,
+                                              const struct BatchInfo* batch_info,
+                                              size_t                  payload_bytes);
+int execute_ingest_file_command(zval* object, int argc, zval* return_value, zend_class_entry* ce);
+int execute_msetex_command(zval* object, int argc, zval* return_value, zend_class_entry* ce);
+int execute_hmset_multi_command(zval* object, int argc, zval* return_value, zend_class_entry* ce);
+int execute_zadd_multi_command(zval* object, int argc, zval* return_value, zend_class_entry* ce);
 int execute_fcall_command(zval* object, int argc, zval* return_value, zend_class_entry* ce);
 int execute_fcall_ro_command(zval* object, int argc, zval* return_value, zend_class_entry* ce);
 
@@ -1181,6 +1208,62 @@ int execute_unlink_command(zval* object, int argc, zval* return_value, zend_clas
         RETURN_FALSE;                                                           \
     }
 
+#define INGEST_FILE_METHOD_IMPL(class_name)                                            \
+    PHP_METHOD(class_name, ingestFile) {                                               \
+        if (execute_ingest_file_command(getThis(),                                     \
+                                        ZEND_NUM_ARGS(),                               \
+                                        return_value,                                  \
+                                        strcmp(#class_name, "ValkeyGlideCluster") == 0 \
+                                            ? get_valkey_glide_cluster_ce()            \
+                                            : get_valkey_glide_ce())) {                \
+            return;                                                                    \
+        }                                                                              \
+        zval_dtor(return_value);                                                       \
+        RETURN_FALSE;                                                                  \
+    }
+
+#define MSETEX_METHOD_IMPL(class_name)                                            \
+    PHP_METHOD(class_name, msetex) {                                              \
+        if (execute_msetex_command(getThis(),                                     \
+                                   ZEND_NUM_ARGS(),                               \
+                                   return_value,                                  \
+                                   strcmp(#class_name, "ValkeyGlideCluster") == 0 \
+                                       ? get_valkey_glide_cluster_ce()            \
+                                       : get_valkey_glide_ce())) {                \
+            return;                                                               \
+        }                                                                         \
+        zval_dtor(return_value);                                                  \
+        RETURN_FALSE;                                                             \
+    }
+
+#define HMSET_MULTI_METHOD_IMPL(class_name)                                            \
+    PHP_METHOD(class_name, hmsetMulti) {                                               \
+        if (execute_hmset_multi_command(getThis(),                                     \
+                                        ZEND_NUM_ARGS(),                               \
+                                        return_value,                                  \
+                                        strcmp(#class_name, "ValkeyGlideCluster") == 0 \
+                                            ? get_valkey_glide_cluster_ce()            \
+                                            : get_valkey_glide_ce())) {                \
+            return;                                                                    \
+        }                                                                              \
+        zval_dtor(return_value);                                                       \
+        RETURN_FALSE;                                                                  \
+    }
+
+#define ZADD_MULTI_METHOD_IMPL(class_name)                                            \
+    PHP_METHOD(class_name, zaddMulti) {                                               \
+        if (execute_zadd_multi_command(getThis(),                                     \
+                                       ZEND_NUM_ARGS(),                               \
+                                       return_value,                                  \
+                                       strcmp(#class_name, "ValkeyGlideCluster") == 0 \
+                                           ? get_valkey_glide_cluster_ce()            \
+                                           : get_valkey_glide_ce())) {                \
+            return;                                                                   \
+        }                                                                             \
+        zval_dtor(return_value);                                                      \
+        RETURN_FALSE;                                                                 \
+    }
+
 #define FCALL_METHOD_IMPL(class_name)                                            \
     PHP_METHOD(class_name, fcall) {                                              \
         if (execute_fcall_command(getThis(),                                     \
@@ -1497,51 +1580,87 @@ void execute_script_command(zval* object, int argc, zval* return_value, zend_cla
     } while (0)
 
 /* Option methods - matching PHPRedis setOption/getOption API */
-#define SETOPTION_METHOD_IMPL(class_name)                                     \
-    PHP_METHOD(class_name, setOption) {                                       \
-        zend_long option;                                                     \
-        zval*     value;                                                      \
-                                                                              \
-        ZEND_PARSE_PARAMETERS_START(2, 2)                                     \
-        Z_PARAM_LONG(option)                                                  \
-        Z_PARAM_ZVAL(value)                                                   \
-        ZEND_PARSE_PARAMETERS_END();                                          \
-                                                                              \
-        valkey_glide_object* valkey_glide =                                   \
-            VALKEY_GLIDE_PHP_ZVAL_GET_OBJECT(valkey_glide_object, getThis()); \
-        if (!valkey_glide) {                                                  \
-            RETURN_FALSE;                                                     \
-        }                                                                     \
-                                                                              \
-        switch (option) {                                                     \
-            case VALKEY_GLIDE_OPT_REPLY_LITERAL:                              \
-                valkey_glide->opt_reply_literal = zval_is_true(value);        \
-                RETURN_TRUE;                                                  \
-            default:                                                          \
-                RETURN_FALSE;                                                 \
-        }                                                                     \
-    }
-
-#define GETOPTION_METHOD_IMPL(class_name)                                     \
-    PHP_METHOD(class_name, getOption) {                                       \
-        zend_long option;                                                     \
-                                                                              \
-        ZEND_PARSE_PARAMETERS_START(1, 1)                                     \
-        Z_PARAM_LONG(option)                                                  \
-        ZEND_PARSE_PARAMETERS_END();                                          \
-                                                                              \
-        valkey_glide_object* valkey_glide =                                   \
-            VALKEY_GLIDE_PHP_ZVAL_GET_OBJECT(valkey_glide_object, getThis()); \
-        if (!valkey_glide) {                                                  \
-            RETURN_FALSE;                                                     \
-        }                                                                     \
-                                                                              \
-        switch (option) {                                                     \
-            case VALKEY_GLIDE_OPT_REPLY_LITERAL:                              \
-                RETURN_BOOL(valkey_glide->opt_reply_literal);                 \
-            default:                                                          \
-                RETURN_FALSE;                                                 \
-        }                                                                     \
+#define SETOPTION_METHOD_IMPL(class_name)                                             \
+    PHP_METHOD(class_name, setOption) {                                               \
+        zend_long option;                                                             \
+        zval*     value;                                                              \
+                                                                                      \
+        ZEND_PARSE_PARAMETERS_START(2, 2)                                             \
+        Z_PARAM_LONG(option)                                                          \
+        Z_PARAM_ZVAL(value)                                                           \
+        ZEND_PARSE_PARAMETERS_END();                                                  \
+                                                                                      \
+        valkey_glide_object* valkey_glide =                                           \
+            VALKEY_GLIDE_PHP_ZVAL_GET_OBJECT(valkey_glide_object, getThis());         \
+        if (!valkey_glide) {                                                          \
+            RETURN_FALSE;                                                             \
+        }                                                                             \
+                                                                                      \
+        switch (option) {                                                             \
+            case VALKEY_GLIDE_OPT_REPLY_LITERAL:                                      \
+                valkey_glide->opt_reply_literal = zval_is_true(value);                \
+                RETURN_TRUE;                                                          \
+            case VALKEY_GLIDE_OPT_PIPELINE_DEDUPE:                                    \
+                valkey_glide->opt_pipeline_dedupe = zval_is_true(value);              \
+                RETURN_TRUE;                                                          \
+            case VALKEY_GLIDE_OPT_COLUMNAR:                                           \
+                valkey_glide->opt_columnar = zval_is_true(value);                     \
+                RETURN_TRUE;                                                          \
+            case VALKEY_GLIDE_OPT_HOT_KEY_SAMPLING:                                   \
+                RETURN_BOOL(valkey_glide_set_hot_key_sampling(                        \
+                    valkey_glide,                                                     \
+                    value,                                                            \
+                    strcmp(#class_name, "ValkeyGlideCluster") == 0));                 \
+            case VALKEY_GLIDE_OPT_SLOWLOG_THRESHOLD:                                  \
+                RETURN_BOOL(valkey_glide_set_slowlog_threshold(valkey_glide, value)); \
+            case VALKEY_GLIDE_OPT_NODE_STATS:                                         \
+                RETURN_BOOL(valkey_glide_set_node_stats(                              \
+                    valkey_glide,                                                     \
+                    value,                                                            \
+                    strcmp(#class_name, "ValkeyGlideCluster") == 0));                 \
+            case VALKEY_GLIDE_OPT_HEDGED_READS:                                       \
+                RETURN_BOOL(valkey_glide_set_hedged_reads(                            \
+                    valkey_glide,                                                     \
+                    value,                                                            \
+                    strcmp(#class_name, "ValkeyGlideCluster") == 0));                 \
+            default:                                                                  \
+                RETURN_FALSE;                                                         \
+        }                                                                             \
+    }
+
+#define GETOPTION_METHOD_IMPL(class_name)                                                 \
+    PHP_METHOD(class_name, getOption) {                                                   \
+        zend_long option;                                                                 \
+                                                                                          \
+        ZEND_PARSE_PARAMETERS_START(1, 1)                                                 \
+        Z_PARAM_LONG(option)                                                              \
+        ZEND_PARSE_PARAMETERS_END();                                                      \
+                                                                                          \
+        valkey_glide_object* valkey_glide =                                               \
+            VALKEY_GLIDE_PHP_ZVAL_GET_OBJECT(valkey_glide_object, getThis());             \
+        if (!valkey_glide) {                                                              \
+            RETURN_FALSE;                                                                 \
+        }                                                                                 \
+                                                                                          \
+        switch (option) {                                                                 \
+            case VALKEY_GLIDE_OPT_REPLY_LITERAL:                                          \
+                RETURN_BOOL(valkey_glide->opt_reply_literal);                             \
+            case VALKEY_GLIDE_OPT_PIPELINE_DEDUPE:                                        \
+                RETURN_BOOL(valkey_glide->opt_pipeline_dedupe);                           \
+            case VALKEY_GLIDE_OPT_COLUMNAR:                                               \
+                RETURN_BOOL(valkey_glide->opt_columnar);                                  \
+            case VALKEY_GLIDE_OPT_HOT_KEY_SAMPLING:                                       \
+                RETURN_DOUBLE(valkey_glide_hot_keys_sample_rate(valkey_glide->hot_keys)); \
+            case VALKEY_GLIDE_OPT_SLOWLOG_THRESHOLD:                                      \
+                RETURN_LONG(valkey_glide_slowlog_threshold(valkey_glide));                \
+            case VALKEY_GLIDE_OPT_NODE_STATS:                                             \
+                RETURN_BOOL(valkey_glide->node_stats != NULL);                            \
+            case VALKEY_GLIDE_OPT_HEDGED_READS:                                           \
+                valkey_glide_hedged_reads_option(valkey_glide, return_value);             \
+                return;                                                                   \
+            default:                                                                      \
+                RETURN_FALSE;                                                             \
+        }                                                                                 \
     }
 
 /* FFI Compression functions - Statistics struct already defined in glide_bindings.h */
@@ -28,8 +28,12 @@
 #include "common.h"
 #include "include/glide_bindings.h"
 #include "logger.h"
+#include "valkey_glide_async.h"
+#include "valkey_glide_bitmap.h"
+#include "valkey_glide_bloom.h"
 #include "valkey_glide_commands_common.h"
 #include "valkey_glide_core_common.h"
+#include "valkey_glide_dictionary.h"
 #include "valkey_glide_list_common.h"
 #include "valkey_glide_z_common.h"
 
@@ -197,6 +201,10 @@ uint8_t* create_connection_request(size_t*                                   len
         CONNECTION_REQUEST__COMPRESSION_CONFIG__INIT;
 
     if (config->compression_config) {
+        /*
+         * Kept on with dictionary_key too, so the core still decompresses the values it wrote
+         * before, but never compresses again: the extension compresses those values itself.
+         */
         compression_cfg.enabled = config->compression_config->enabled;
 
         compression_cfg.backend =
@@ -204,7 +212,10 @@ uint8_t* create_connection_request(size_t*                                   len
                 ? CONNECTION_REQUEST__COMPRESSION_BACKEND__LZ4
                 : CONNECTION_REQUEST__COMPRESSION_BACKEND__ZSTD;
 
-        compression_cfg.min_compression_size = config->compression_config->min_compression_size;
+        compression_cfg.min_compression_size =
+            config->compression_config->dictionary_key
+                ? UINT32_MAX
+                : config->compression_config->min_compression_size;
 
         if (config->compression_config->compression_level >= 0) {
             compression_cfg.compression_level = config->compression_config->compression_level;
@@ -241,7 +252,8 @@ static const ConnectionResponse* create_base_glide_client(
     valkey_glide_base_client_configuration_t* config,
     valkey_glide_periodic_checks_status_t     periodic_checks,
     bool                                      is_cluster,
-    bool                                      refresh_topology_from_initial_nodes) {
+    bool                                      refresh_topology_from_initial_nodes,
+    const ClientType*                         client_type) {
     size_t   len;
     uint8_t* request_bytes = create_connection_request(
         &len, config, periodic_checks, is_cluster, refresh_topology_from_initial_nodes);
@@ -250,13 +262,9 @@ static const ConnectionResponse* create_base_glide_client(
         return NULL;
     }
 
-    /* Set up client type for synchronous operation */
-    ClientType client_type;
-    client_type.tag = SyncClient;
-
     /* Create the client with pubsub callback registered at creation time */
     const ConnectionResponse* conn_resp =
-        create_client(request_bytes, len, &client_type, valkey_glide_pubsub_callback);
+        create_client(request_bytes, len, client_type, valkey_glide_pubsub_callback);
 
     /* Free the request bytes as they're no longer needed */
     efree(request_bytes);
@@ -269,9 +277,19 @@ static const ConnectionResponse* create_base_glide_client(
     return conn_resp;
 }
 
+/* Client type for synchronous operation */
+static const ClientType sync_client_type = {.tag = SyncClient};
+
+/* Client type for callback-mode operation, replies are delivered to the async completion queue */
+static const ClientType async_client_type = {
+    .tag          = AsyncClient,
+    .async_client = {.success_callback = valkey_glide_async_success_callback,
+                     .failure_callback = valkey_glide_async_failure_callback}};
+
 /* Create a Valkey Glide client */
 const ConnectionResponse* create_glide_client(valkey_glide_base_client_configuration_t* config) {
-    return create_base_glide_client(config, VALKEY_GLIDE_PERIODIC_CHECKS_DISABLED, false, false);
+    return create_base_glide_client(
+        config, VALKEY_GLIDE_PERIODIC_CHECKS_DISABLED, false, false, &sync_client_type);
 }
 
 const ConnectionResponse* create_glide_cluster_client(
@@ -279,12 +297,105 @@ const ConnectionResponse* create_glide_cluster_client(
     return create_base_glide_client(&config->base,
                                     config->periodic_checks_status,
                                     true,
-                                    config->refresh_topology_from_initial_nodes);
+                                    config->refresh_topology_from_initial_nodes,
+                                    &sync_client_type);
+}
+
+/* Create a callback-mode Valkey Glide client */
+const ConnectionResponse* create_glide_async_client(
+    valkey_glide_base_client_configuration_t* config) {
+    return create_base_glide_client(
+        config, VALKEY_GLIDE_PERIODIC_CHECKS_DISABLED, false, false, &async_client_type);
+}
+
+const ConnectionResponse* create_glide_async_cluster_client(
+    valkey_glide_cluster_client_configuration_t* config) {
+    return create_base_glide_client(&config->base,
+                                    config->periodic_checks_status,
+                                    true,
+                                    config->refresh_topology_from_initial_nodes,
+                                    &async_client_type);
+}
+
+/* Process-wide clients shared by all threads, keyed by their serialized connection request */
+static HashTable shared_clients;
+static mutex_t   shared_clients_lock;
+
+void valkey_glide_shared_clients_startup(void) {
+    mutex_init(&shared_clients_lock);
+    zend_hash_init(&shared_clients, 8, NULL, NULL, 1);
+}
+
+void valkey_glide_shared_clients_shutdown(void) {
+    const void* glide_client;
+    ZEND_HASH_FOREACH_PTR(&shared_clients, glide_client) {
+        close_glide_client(glide_client);
+    }
+    ZEND_HASH_FOREACH_END();
+
+    zend_hash_destroy(&shared_clients);
+    mutex_destroy(&shared_clients_lock);
+}
+
+/* Get the shared client for a configuration, connecting it on first use. Throws on failure. */
+static const void* acquire_shared_glide_client(
+    valkey_glide_base_client_configuration_t* config,
+    valkey_glide_periodic_checks_status_t     periodic_checks,
+    bool                                      is_cluster,
+    bool                                      refresh_topology_from_initial_nodes) {
+    size_t   len;
+    uint8_t* request_bytes = create_connection_request(
+        &len, config, periodic_checks, is_cluster, refresh_topology_from_initial_nodes);
+
+    if (!request_bytes) {
+        zend_throw_exception(
+            get_valkey_glide_exception_ce(), "Failed to build connection request", 0);
+        return NULL;
+    }
+
+    /* Held while connecting so that concurrent first uses create a single client */
+    mutex_lock(&shared_clients_lock);
+    const void* glide_client =
+        zend_hash_str_find_ptr(&shared_clients, (const char*) request_bytes, len);
+
+    if (!glide_client) {
+        const ConnectionResponse* conn_resp =
+            create_client(request_bytes, len, &sync_client_type, valkey_glide_pubsub_callback);
+
+        if (conn_resp->connection_error_message) {
+            VALKEY_LOG_ERROR("client_creation", conn_resp->connection_error_message);
+            zend_throw_exception(
+                get_valkey_glide_exception_ce(), conn_resp->connection_error_message, 0);
+        } else {
+            glide_client = conn_resp->conn_ptr;
+            zend_hash_str_add_ptr(
+                &shared_clients, (const char*) request_bytes, len, (void*) glide_client);
+            VALKEY_LOG_INFO("client_creation", "Created shared ValkeyGlide client");
+        }
+        free_connection_response((ConnectionResponse*) conn_resp);
+    }
+    mutex_unlock(&shared_clients_lock);
+
+    efree(request_bytes);
+    return glide_client;
+}
+
+const void* create_shared_glide_client(valkey_glide_base_client_configuration_t* config) {
+    return acquire_shared_glide_client(config, VALKEY_GLIDE_PERIODIC_CHECKS_DISABLED, false, false);
+}
+
+const void* create_shared_glide_cluster_client(
+    valkey_glide_cluster_client_configuration_t* config) {
+    return acquire_shared_glide_client(&config->base,
+                                       config->periodic_checks_status,
+                                       true,
+                                       config->refresh_topology_from_initial_nodes);
 }
 
 /* Custom result processor for SET commands with GET option support */
 struct set_result_data {
-    int has_get;
+    int                      has_get;
+    valkey_glide_dictionary* dictionary; /* Decodes the old value, NULL if none */
 };
 
 static int process_set_result(CommandResponse* response, void* output, zval* return_value) {
@@ -307,15 +418,8 @@ static int process_set_result(CommandResponse* response, void* output, zval* ret
         case String:
             /* GET option returned a value */
             if (data->has_get && response->string_value) {
-                char*  old_val     = emalloc(response->string_value_len + 1);
-                size_t old_val_len = response->string_value_len;
-                if (old_val) {
-                    memcpy(old_val, response->string_value, response->string_value_len);
-                    (old_val)[response->string_value_len] = '\0';
-                }
-
-                ZVAL_STRINGL(return_value, old_val, old_val_len);
-                efree(old_val);
+                ZVAL_STR(return_value, valkey_glide_string_from_response(response));
+                valkey_glide_dictionary_decode(data->dictionary, return_value);
             }
             efree(output);
             return 2; /* GET option returned a value */
@@ -654,6 +758,16 @@ int execute_set_command(zval* object, int argc, zval* return_value, zend_class_e
             val_len  = 0;
             free_val = 1;
             break;
+        case IS_OBJECT: {
+            /* A ValkeyGlideBitmap is stored as its bytes */
+            zend_string* bitmap = valkey_glide_bitmap_bytes(z_value);
+            if (!bitmap) {
+                return 0;
+            }
+            val     = ZSTR_VAL(bitmap);
+            val_len = ZSTR_LEN(bitmap);
+            break;
+        }
         default:
             /* Unsupported type */
             return 0;
@@ -736,11 +850,25 @@ int execute_set_command_internal(valkey_glide_object* valkey_glide,
         args.options.has_expire     = 1;
     }
 
+    /* Values are sent compressed when the client has a trained dictionary */
+    zend_string* packed = valkey_glide_dictionary_compress(valkey_glide, val, val_len);
+    if (packed) {
+        args.args[0].data.string_arg.value = ZSTR_VAL(packed);
+        args.args[0].data.string_arg.len   = ZSTR_LEN(packed);
+    }
+
     /* Prepare result data for GET option */
     struct set_result_data* result_data = emalloc(sizeof(struct set_result_data));
     result_data->has_get                = args.options.get_old_value;
+    result_data->dictionary             = valkey_glide->dictionary;
 
-    return execute_core_command(valkey_glide, &args, result_data, process_set_result, return_value);
+    int result =
+        execute_core_command(valkey_glide, &args, result_data, process_set_result, return_value);
+
+    if (packed) {
+        zend_string_release(packed);
+    }
+    return result;
 }
 
 /* Execute a SETEX command using the Valkey Glide client - UNIFIED IMPLEMENTATION */
@@ -1362,6 +1490,12 @@ int execute_get_command(zval* object, int argc, zval* return_value, zend_class_e
         return 0;
     }
 
+    /* A key the Bloom filter has never seen cannot exist */
+    if (valkey_glide_bloom_rules_out(valkey_glide, key, key_len)) {
+        ZVAL_FALSE(return_value);
+        return 1;
+    }
+
     /* Execute using core framework */
     core_command_args_t args = {0};
     args.glide_client        = valkey_glide->glide_client;
@@ -1369,10 +1503,12 @@ int execute_get_command(zval* object, int argc, zval* return_value, zend_class_e
     args.key                 = key;
     args.key_len             = key_len;
 
-    /* Allocate string result processor on heap for batch support */
-
+    /* Values compressed with a trained dictionary are decoded along with the reply */
+    void*                output    = NULL;
+    z_result_processor_t processor =
+        valkey_glide_dictionary_processor(valkey_glide, process_core_string_result, &output);
 
-    if (execute_core_command(valkey_glide, &args, NULL, process_core_string_result, return_value)) {
+    if (execute_core_command(valkey_glide, &args, output, processor, return_value)) {
         if (valkey_glide->is_in_batch_mode) {
             /* In batch mode, return $this for method chaining */
             /* Note: output will be freed later in process_core_string_result */
@@ -1421,13 +1557,11 @@ int execute_randomkey_command(zval* object, int argc, zval* return_value, zend_c
             valkey_glide->glide_client, RandomKey, 0, NULL, NULL, &args[0]);
 
         /* Use the generic handler to process the result */
-        char*  response     = NULL;
-        size_t response_len = 0;
-        result              = handle_string_response(cmd_result, &response, &response_len);
+        zend_string* response = NULL;
+        result                = handle_string_response(cmd_result, &response);
         if (result == 1) {
             if (response != NULL) {
-                ZVAL_STRINGL(return_value, response, response_len);
-                efree(response);
+                ZVAL_STR(return_value, response);
                 return 1;
             } else {
                 ZVAL_NULL(return_value);
@@ -22,6 +22,9 @@
 #include <zend_exceptions.h>
 
 #include "logger.h"
+#include "valkey_glide_breaker.h"
+#include "valkey_glide_hot_keys.h"
+#include "valkey_glide_node_stats.h"
 #include "valkey_glide_otel.h"
 #include "valkey_glide_pubsub_common.h"
 #include "valkey_glide_z_common.h"
@@ -72,13 +75,14 @@ int execute_core_command(valkey_glide_object* valkey_glide,
                          args->cmd_type,
                          valkey_glide->is_in_batch_mode ? "yes" : "no");
 
-    uintptr_t*     cmd_args          = NULL;
-    unsigned long* cmd_args_len      = NULL;
-    char**         allocated_strings = NULL;
-    int            allocated_count   = 0;
-    int            arg_count         = 0;
-    int            res               = 0;
-    CommandResult* result            = NULL;
+    uintptr_t*       cmd_args          = NULL;
+    unsigned long*   cmd_args_len      = NULL;
+    char**           allocated_strings = NULL;
+    int              allocated_count   = 0;
+    int              arg_count         = 0;
+    int              res               = 0;
+    CommandResult*   result            = NULL;
+    CommandResponse* reply             = NULL;
 
     debug_print_core_args(args);
 
@@ -94,6 +98,9 @@ int execute_core_command(valkey_glide_object* valkey_glide,
     }
 
     VALKEY_LOG_DEBUG_FMT("command_execution", "Argument count: %d", arg_count);
+    valkey_glide_hot_keys_record(valkey_glide, args->key, args->key_len, cmd_args_len, arg_count);
+    valkey_glide_node_stats_record(valkey_glide, args->key, args->key_len);
+    valkey_glide_breaker_record(valkey_glide, args->key, args->key_len);
 
     /* Check for batch mode */
     if (valkey_glide->is_in_batch_mode) {
@@ -132,10 +139,11 @@ int execute_core_command(valkey_glide_object* valkey_glide,
                                             cmd_args,
                                             cmd_args_len,
                                             args->route_param);
+        reply = result ? result->response : NULL;
     } else {
         /* Non-cluster mode or no routing */
-        result =
-            execute_command(args->glide_client, args->cmd_type, arg_count, cmd_args, cmd_args_len);
+        result = execute_command_for_reply(
+            args->glide_client, args->cmd_type, arg_count, cmd_args, cmd_args_len, &reply);
     }
 
     debug_print_command_result(result);
@@ -143,9 +151,9 @@ int execute_core_command(valkey_glide_object* valkey_glide,
     /* Process result using appropriate handler */
     VALKEY_LOG_DEBUG("command_execution", "Processing command result");
     if (result) {
-        if (result->response) {
+        if (reply) {
             /* Non-routed commands use standard processor */
-            res = processor(result->response, result_ptr, return_value);
+            res = processor(reply, result_ptr, return_value);
         } else {
             VALKEY_LOG_ERROR("execute_core_command", "Command execution returned no response");
             efree(result_ptr);
@@ -1536,45 +1544,13 @@ int process_core_int_result(CommandResponse* response, void* output, zval* retur
  * Batch-compatible wrapper for string results
  */
 int process_core_string_result(CommandResponse* response, void* output, zval* return_value) {
-    char*  result = NULL;
-    size_t result_len;
-
-
     if (!response) {
         ZVAL_NULL(return_value);
         return 0;
     }
 
     if (response->response_type == String) {
-        if (response->string_value_len == 0) {
-            result = emalloc(1);
-            if (!result) {
-                VALKEY_LOG_ERROR("memory_allocation",
-                                 "Failed to allocate memory for empty string result");
-                ZVAL_NULL(return_value);
-                return 0;
-            }
-            result[0]  = '\0';
-            result_len = 0;
-        } else {
-            result = emalloc(response->string_value_len + 1);
-            if (!result) {
-                VALKEY_LOG_ERROR("memory_allocation",
-                                 "Failed to allocate memory for string result");
-                ZVAL_NULL(return_value);
-                return 0;
-            }
-            memcpy(result, response->string_value, response->string_value_len);
-            result[response->string_value_len] = '\0';
-            result_len                         = response->string_value_len;
-        }
-        if (result) {
-            ZVAL_STRINGL(return_value, result, result_len);
-            efree(result);
-        } else {
-            ZVAL_NULL(return_value);
-        }
-
+        ZVAL_STR(return_value, valkey_glide_string_from_response(response));
         return 1;
     } else if (response->response_type == Null) {
         ZVAL_FALSE(return_value);
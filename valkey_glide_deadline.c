@@ -0,0 +1,165 @@
+/** Copyright Valkey GLIDE Project Contributors - SPDX Identifier: Apache-2.0 */
+
+#include "valkey_glide_deadline.h"
+
+#include <string.h>
+#include <zend_exceptions.h>
+
+#include "valkey_glide_commands_common.h"
+#include "valkey_glide_fiber.h"
+#include "valkey_glide_slowlog.h"
+
+#define DEADLINE_NS_PER_MS 1000000
+
+/* Milliseconds until deadline_ns, rounded up so that a budget isn't spent before its end */
+static int64_t deadline_remaining_ms(uint64_t deadline_ns) {
+    int64_t left_ns = (int64_t) (deadline_ns - valkey_glide_slowlog_now());
+
+    return left_ns <= 0 ? 0 : (left_ns + DEADLINE_NS_PER_MS - 1) / DEADLINE_NS_PER_MS;
+}
+
+bool valkey_glide_deadline_take_slow(const void* glide_client, int64_t* remaining_ms) {
+    uint64_t deadline_ns;
+
+    if (VALKEY_GLIDE_G(deadline_next_client) == glide_client) {
+        deadline_ns                          = VALKEY_GLIDE_G(deadline_next_ns);
+        VALKEY_GLIDE_G(deadline_next_client) = NULL;
+
+        /* A call inside a callback of the same client can't outlast the callback's budget */
+        if (VALKEY_GLIDE_G(deadline_client) == glide_client &&
+            VALKEY_GLIDE_G(deadline_ns) < deadline_ns) {
+            deadline_ns = VALKEY_GLIDE_G(deadline_ns);
+        }
+    } else {
+        deadline_ns = VALKEY_GLIDE_G(deadline_ns);
+    }
+
+    *remaining_ms = deadline_remaining_ms(deadline_ns);
+    return true;
+}
+
+void valkey_glide_deadline_options(struct BatchOptionsInfo* options, int64_t remaining_ms) {
+    memset(options, 0, sizeof(struct BatchOptionsInfo));
+    options->retry_server_error     = false;
+    options->retry_connection_error = false;
+    options->has_timeout            = true;
+    options->timeout                = (uint32_t) MIN(remaining_ms, UINT32_MAX);
+    options->route_info             = NULL;
+}
+
+CommandResult* valkey_glide_deadline_command(const void*          glide_client,
+                                             enum RequestType     command_type,
+                                             unsigned long        arg_count,
+                                             const uintptr_t*     args,
+                                             const unsigned long* args_len,
+                                             int64_t              remaining_ms,
+                                             uint64_t             span_ptr) {
+    struct CmdInfo cmd = {.request_type = command_type,
+                          .args         = (const uint8_t* const*) args,
+                          .arg_count    = arg_count,
+                          .args_len     = (const uintptr_t*) args_len};
+    const struct CmdInfo*   cmds[1]    = {&cmd};
+    struct BatchInfo        batch_info = {.cmd_count = 1, .cmds = cmds, .is_atomic = false};
+    struct BatchOptionsInfo options;
+
+    valkey_glide_deadline_options(&options, remaining_ms);
+
+    /* Errors are raised rather than returned as elements, leaving one reply in the array */
+    CommandResult* result;
+    if (valkey_glide_fiber_should_offload(glide_client)) {
+        result = valkey_glide_fiber_batch(glide_client, &batch_info, true, &options, span_ptr);
+    } else {
+        result = batch(glide_client, 0, &batch_info, true, &options, span_ptr);
+    }
+
+    return result;
+}
+
+void valkey_glide_deadline_exceeded(bool sent) {
+    zend_throw_exception(get_valkey_glide_timeout_exception_ce(),
+                         sent ? "Deadline exceeded" : "Deadline exceeded before the call was sent",
+                         0);
+}
+
+CommandResult* valkey_glide_deadline_check(CommandResult* result) {
+    if (result && result->command_error &&
+        result->command_error->command_error_type == Timeout) {
+        free_command_result(result);
+        valkey_glide_deadline_exceeded(true);
+        return NULL;
+    }
+    return result;
+}
+
+void valkey_glide_deadline_release(const void* glide_client) {
+    if (!glide_client) {
+        return;
+    }
+    if (VALKEY_GLIDE_G(deadline_client) == glide_client) {
+        VALKEY_GLIDE_G(deadline_client) = NULL;
+    }
+    if (VALKEY_GLIDE_G(deadline_next_client) == glide_client) {
+        VALKEY_GLIDE_G(deadline_next_client) = NULL;
+    }
+}
+
+int execute_with_deadline_command(zval*             object,
+                                  int               argc,
+                                  zval*             return_value,
+                                  zend_class_entry* ce) {
+    zend_long             ms;
+    zend_fcall_info       fci = empty_fcall_info;
+    zend_fcall_info_cache fcc = empty_fcall_info_cache;
+
+    if (zend_parse_method_parameters(
+            argc, object, "Ol|f!", &object, ce, &ms, &fci, &fcc) == FAILURE) {
+        return 0;
+    }
+
+    if (ms <= 0) {
+        zend_argument_value_error(1, "must be greater than 0");
+        return 0;
+    }
+
+    valkey_glide_object* valkey_glide =
+        VALKEY_GLIDE_PHP_ZVAL_GET_OBJECT(valkey_glide_object, object);
+    if (!valkey_glide || !valkey_glide->glide_client) {
+        zend_throw_exception(get_valkey_glide_exception_ce(), "Client is not connected", 0);
+        return 0;
+    }
+    /* Budgets are tracked by the client handle, sharers would inherit them */
+    if (valkey_glide_refuse_shared(valkey_glide, "withDeadline()")) {
+        return 0;
+    }
+
+    uint64_t deadline_ns = valkey_glide_slowlog_now() + (uint64_t) ms * DEADLINE_NS_PER_MS;
+
+    if (!ZEND_FCI_INITIALIZED(fci)) {
+        /* Applies to the next call only, exec() inside MULTI or PIPELINE */
+        VALKEY_GLIDE_G(deadline_next_client) = valkey_glide->glide_client;
+        VALKEY_GLIDE_G(deadline_next_ns)     = deadline_ns;
+        ZVAL_OBJ_COPY(return_value, Z_OBJ_P(object));
+        return 1;
+    }
+
+    /* Applies to every call made by callback, restoring the enclosing scope afterwards */
+    const void* prev_client = VALKEY_GLIDE_G(deadline_client);
+    uint64_t    prev_ns     = VALKEY_GLIDE_G(deadline_ns);
+
+    /* A nested scope of the same client can't outlast the enclosing one */
+    if (prev_client == valkey_glide->glide_client && prev_ns < deadline_ns) {
+        deadline_ns = prev_ns;
+    }
+    VALKEY_GLIDE_G(deadline_client) = valkey_glide->glide_client;
+    VALKEY_GLIDE_G(deadline_ns)     = deadline_ns;
+
+    fci.retval      = return_value;
+    fci.params      = object;
+    fci.param_count = 1;
+    zend_call_function(&fci, &fcc);
+
+    VALKEY_GLIDE_G(deadline_client) = prev_client;
+    VALKEY_GLIDE_G(deadline_ns)     = prev_ns;
+
+    return EG(exception) ? 0 : 1;
+}
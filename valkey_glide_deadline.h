@@ -0,0 +1,75 @@
+/** Copyright Valkey GLIDE Project Contributors - SPDX Identifier: Apache-2.0 */
+
+#ifndef VALKEY_GLIDE_DEADLINE_H
+#define VALKEY_GLIDE_DEADLINE_H
+
+#include "common.h"
+#include "include/glide_bindings.h"
+
+/*
+ * Time budgets set with withDeadline(), for the next call of a client or for every call made by
+ * a callback, which then share one deadline.
+ *
+ * command() takes no timeout, so a call with a budget is sent through batch() as the only
+ * command of a non-atomic batch, with the time left as the batch timeout and retries off;
+ * glide-core gives up once it is spent. exec() passes the same options with the whole batch.
+ * Calls made after the deadline aren't sent. Either way ValkeyGlideTimeoutException is thrown.
+ * The batch replies with a one element array, which execute_command_for_reply() hands out the
+ * element of; callers of plain execute_command(), and commands with an explicit route, keep
+ * command(), the deadline is then only checked before they are sent.
+ */
+
+/* Slow path of valkey_glide_deadline_take(), consuming a next-call budget */
+bool valkey_glide_deadline_take_slow(const void* glide_client, int64_t* remaining_ms);
+
+/* Whether a budget applies to the next call of glide_client, setting what is left of it */
+static inline bool valkey_glide_deadline_take(const void* glide_client, int64_t* remaining_ms) {
+    if (EXPECTED(VALKEY_GLIDE_G(deadline_client) != glide_client &&
+                 VALKEY_GLIDE_G(deadline_next_client) != glide_client) ||
+        !glide_client) {
+        return false;
+    }
+    return valkey_glide_deadline_take_slow(glide_client, remaining_ms);
+}
+
+/* batch() options bounding a call to remaining_ms, without retries */
+void valkey_glide_deadline_options(struct BatchOptionsInfo* options, int64_t remaining_ms);
+
+/* Send a single command under a budget, replying with a one element array */
+CommandResult* valkey_glide_deadline_command(const void*          glide_client,
+                                             enum RequestType     command_type,
+                                             unsigned long        arg_count,
+                                             const uintptr_t*     args,
+                                             const unsigned long* args_len,
+                                             int64_t              remaining_ms,
+                                             uint64_t             span_ptr);
+
+/* Throw ValkeyGlideTimeoutException for a call the budget ran out before or during */
+void valkey_glide_deadline_exceeded(bool sent);
+
+/* The result of a call under a budget, NULL once a timeout was thrown in its place */
+CommandResult* valkey_glide_deadline_check(CommandResult* result);
+
+/* Drop the budgets of glide_client, when the object is freed */
+void valkey_glide_deadline_release(const void* glide_client);
+
+int execute_with_deadline_command(zval*             object,
+                                  int               argc,
+                                  zval*             return_value,
+                                  zend_class_entry* ce);
+
+#define WITH_DEADLINE_METHOD_IMPL(class_name)                                            \
+    PHP_METHOD(class_name, withDeadline) {                                               \
+        if (execute_with_deadline_command(getThis(),                                     \
+                                          ZEND_NUM_ARGS(),                               \
+                                          return_value,                                  \
+                                          strcmp(#class_name, "ValkeyGlideCluster") == 0 \
+                                              ? get_valkey_glide_cluster_ce()            \
+                                              : get_valkey_glide_ce())) {                \
+            return;                                                                      \
+        }                                                                                \
+        zval_dtor(return_value);                                                         \
+        RETURN_FALSE;                                                                    \
+    }
+
+#endif /* VALKEY_GLIDE_DEADLINE_H */
@@ -0,0 +1,701 @@
+/** Copyright Valkey GLIDE Project Contributors - SPDX Identifier: Apache-2.0 */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include "valkey_glide_dictionary.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <zend_exceptions.h>
+#include <zend_smart_str.h>
+
+#ifdef HAVE_VALKEY_GLIDE_ZSTD
+#include <zdict.h>
+#include <zstd.h>
+#endif
+
+#include "command_response.h"
+#include "include/glide_bindings.h"
+#include "logger.h"
+#include "valkey_glide_slowlog.h"
+
+#define DICTIONARY_CURRENT "current"  /* Field of the hash holding the current dictionary ID */
+#define DICTIONARY_MIN_SIZE 256       /* Smallest dictionary zstd trains */
+#define DICTIONARY_MAX_SIZE (1 << 20) /* Dictionaries are loaded by every client */
+#define DICTIONARY_ID_LEN 10          /* Digits of the largest dictionary ID */
+#define DICTIONARY_RETRY_MS 1000      /* Between two lookups of the same dictionary */
+#define DICTIONARY_MISSING_MAX 64     /* Unknown IDs remembered at once */
+#define DICTIONARY_LOADED_MAX 16      /* Dictionaries held at once, by each client */
+#define DICTIONARY_TAG "\0GD1"        /* Starts every value the extension compressed */
+#define DICTIONARY_TAG_LEN 4
+#define DICTIONARY_HEADER_LEN 8 /* Tag then the big-endian dictionary ID, 0 for plain zstd */
+
+#ifdef HAVE_VALKEY_GLIDE_ZSTD
+
+typedef struct {
+    ZSTD_CDict* cdict;
+    ZSTD_DDict* ddict;
+} dictionary_entry;
+
+struct valkey_glide_dictionary {
+    const void*  glide_client;
+    zend_string* key;
+    int          level;
+    uint32_t     min_size;
+    uint32_t     current;    /* ID of the dictionary values are compressed with, 0 if none */
+    bool         picked;     /* Whether the current ID was read from the server */
+    uint64_t     picked_ns;  /* When the current ID was last looked for */
+    HashTable    entries;    /* Dictionary ID => dictionary_entry, oldest first */
+    HashTable    missing;    /* Unknown dictionary ID => when it was last looked for, in ns */
+    ZSTD_CCtx*   cctx;
+    ZSTD_DCtx*   dctx;
+};
+
+/* Reply processor and the dictionaries its reply is decoded with */
+typedef struct {
+    valkey_glide_dictionary* dictionary;
+    z_result_processor_t     processor;
+} dictionary_output;
+
+/* The client compressing with dictionaries, throwing unless dictionary_key was set */
+static valkey_glide_dictionary* dictionary_of(zval* object) {
+    valkey_glide_object* valkey_glide =
+        VALKEY_GLIDE_PHP_ZVAL_GET_OBJECT(valkey_glide_object, object);
+
+    if (!valkey_glide || !valkey_glide->dictionary) {
+        zend_throw_exception(get_valkey_glide_exception_ce(),
+                             "Dictionary compression is off, see the compression dictionary_key",
+                             0);
+        return NULL;
+    }
+    return valkey_glide->dictionary;
+}
+
+static void dictionary_entry_dtor(zval* entry) {
+    dictionary_entry* dictionary = Z_PTR_P(entry);
+
+    ZSTD_freeCDict(dictionary->cdict);
+    ZSTD_freeDDict(dictionary->ddict);
+    efree(dictionary);
+}
+
+/* Add the dictionary made of bytes, which must be the one with the ID id */
+static bool dictionary_add(valkey_glide_dictionary* dictionary,
+                           uint32_t                 id,
+                           const char*              bytes,
+                           size_t                   len) {
+    if (id == 0 || ZDICT_getDictID(bytes, len) != id) {
+        return false;
+    }
+    if (zend_hash_index_exists(&dictionary->entries, id)) {
+        return true;
+    }
+
+    dictionary_entry* entry = emalloc(sizeof(dictionary_entry));
+    entry->cdict            = ZSTD_createCDict(bytes, len, dictionary->level);
+    entry->ddict            = ZSTD_createDDict(bytes, len);
+    if (!entry->cdict || !entry->ddict) {
+        ZSTD_freeCDict(entry->cdict);
+        ZSTD_freeDDict(entry->ddict);
+        efree(entry);
+        return false;
+    }
+
+    /* Make room by dropping the oldest dictionary values aren't compressed with */
+    if (zend_hash_num_elements(&dictionary->entries) >= DICTIONARY_LOADED_MAX) {
+        zend_ulong oldest = 0;
+
+        ZEND_HASH_FOREACH_NUM_KEY(&dictionary->entries, oldest) {
+            if (oldest != dictionary->current) {
+                break;
+            }
+        }
+        ZEND_HASH_FOREACH_END();
+        zend_hash_index_del(&dictionary->entries, oldest);
+    }
+
+    zend_hash_index_add_new_ptr(&dictionary->entries, id, entry);
+    return true;
+}
+
+/*
+ * Read the field of the hash at key into value, NULL when the field doesn't exist. Returns false
+ * with an exception thrown when the hash can't be read.
+ */
+static bool dictionary_fetch(valkey_glide_dictionary* dictionary,
+                             const char*              field,
+                             size_t                   field_len,
+                             zend_string**            value) {
+    uintptr_t     args[2]     = {(uintptr_t) ZSTR_VAL(dictionary->key), (uintptr_t) field};
+    unsigned long args_len[2] = {ZSTR_LEN(dictionary->key), field_len};
+
+    /* Straight to the client core, so it can be sent while preparing another command */
+    CommandResult* result = command(dictionary->glide_client,
+                                    0, /* callback_index (not used for sync) */
+                                    HGet,
+                                    2,
+                                    args,
+                                    args_len,
+                                    NULL, /* route_bytes */
+                                    0,
+                                    0);
+
+    if (!result || result->command_error || !result->response ||
+        (result->response->response_type != String && result->response->response_type != Null)) {
+        zend_throw_exception(get_valkey_glide_exception_ce(),
+                             result && result->command_error
+                                 ? result->command_error->command_error_message
+                                 : "Failed to load the compression dictionaries",
+                             0);
+        if (result) {
+            free_command_result(result);
+        }
+        return false;
+    }
+
+    *value = result->response->response_type == String
+                 ? zend_string_init(result->response->string_value,
+                                    result->response->string_value_len,
+                                    0)
+                 : NULL;
+    free_command_result(result);
+    return true;
+}
+
+/* Load the dictionary with the ID id unless it is, false with an exception thrown */
+static bool dictionary_load(valkey_glide_dictionary* dictionary, uint32_t id) {
+    char         id_str[DICTIONARY_ID_LEN + 1];
+    int          id_len = snprintf(id_str, sizeof(id_str), "%u", id);
+    zend_string* bytes;
+
+    if (zend_hash_index_exists(&dictionary->entries, id)) {
+        return true;
+    }
+    if (!dictionary_fetch(dictionary, id_str, id_len, &bytes)) {
+        return false;
+    }
+    if (bytes && !dictionary_add(dictionary, id, ZSTR_VAL(bytes), ZSTR_LEN(bytes))) {
+        VALKEY_LOG_WARN("compression_dictionary", "Ignoring an invalid dictionary");
+    }
+    if (bytes) {
+        zend_string_release(bytes);
+    }
+    return true;
+}
+
+/*
+ * Switch to the dictionary marked current at key, loading it. Returns how many dictionaries are
+ * loaded, -1 with an exception thrown.
+ */
+static zend_long dictionary_refresh(valkey_glide_dictionary* dictionary) {
+    zend_string* current_str;
+    uint32_t     current = 0;
+
+    if (!dictionary_fetch(
+            dictionary, DICTIONARY_CURRENT, sizeof(DICTIONARY_CURRENT) - 1, &current_str)) {
+        return -1;
+    }
+    if (current_str) {
+        current = (uint32_t) ZEND_STRTOUL(ZSTR_VAL(current_str), NULL, 10);
+        zend_string_release(current_str);
+    }
+
+    /* Values keep being compressed with the previous dictionary until the current one loads */
+    if (current != 0 && !dictionary_load(dictionary, current)) {
+        return -1;
+    }
+    if (current != 0 && zend_hash_index_exists(&dictionary->entries, current)) {
+        dictionary->current = current;
+    }
+    dictionary->picked = true;
+    return zend_hash_num_elements(&dictionary->entries);
+}
+
+/* Read the current dictionary ID before the first value is compressed, retrying on failures */
+static void dictionary_pick(valkey_glide_dictionary* dictionary) {
+    if (EXPECTED(dictionary->picked)) {
+        return;
+    }
+
+    uint64_t now_ns = valkey_glide_slowlog_now();
+    if (dictionary->picked_ns != 0 &&
+        now_ns - dictionary->picked_ns < (uint64_t) DICTIONARY_RETRY_MS * 1000000) {
+        return;
+    }
+    dictionary->picked_ns = now_ns;
+
+    /* The value is compressed without it meanwhile, the write itself reports the failure */
+    if (dictionary_refresh(dictionary) < 0) {
+        VALKEY_LOG_WARN("compression_dictionary", "Failed to read the current dictionary");
+        zend_clear_exception();
+    }
+}
+
+/* Whether value starts like a zstd frame */
+static bool dictionary_is_frame(const char* value, size_t len) {
+    const unsigned char* bytes = (const unsigned char*) value;
+
+    return len >= 4 && ((uint32_t) bytes[0] | (uint32_t) bytes[1] << 8 |
+                        (uint32_t) bytes[2] << 16 | (uint32_t) bytes[3] << 24) == ZSTD_MAGICNUMBER;
+}
+
+/*
+ * Original of a value the extension compressed, NULL if value isn't one or on exceptions. Only
+ * values starting with the tag are decoded: zstd frames stored by anyone else are user data.
+ */
+static zend_string* dictionary_unpack(valkey_glide_dictionary* dictionary,
+                                      const char*              value,
+                                      size_t                   len) {
+    if (len < DICTIONARY_HEADER_LEN || memcmp(value, DICTIONARY_TAG, DICTIONARY_TAG_LEN) != 0) {
+        return NULL;
+    }
+
+    const unsigned char* header    = (const unsigned char*) value + DICTIONARY_TAG_LEN;
+    const char*          frame     = value + DICTIONARY_HEADER_LEN;
+    size_t               frame_len = len - DICTIONARY_HEADER_LEN;
+    uint32_t             id        = (uint32_t) header[0] << 24 | (uint32_t) header[1] << 16 |
+                    (uint32_t) header[2] << 8 | (uint32_t) header[3];
+
+    if (!dictionary_is_frame(frame, frame_len) ||
+        ZSTD_getDictID_fromFrame(frame, frame_len) != id) {
+        zend_throw_exception(get_valkey_glide_exception_ce(), "Invalid compressed value", 0);
+        return NULL;
+    }
+
+    dictionary_entry* entry = id != 0 ? zend_hash_index_find_ptr(&dictionary->entries, id) : NULL;
+    if (id != 0 && !entry) {
+        /*
+         * Trained by another client, or dropped to make room. Reads of values whose dictionary
+         * was deleted would otherwise look for it each time.
+         */
+        uint64_t now_ns = valkey_glide_slowlog_now();
+        zval*    missed = zend_hash_index_find(&dictionary->missing, id);
+        if (!missed ||
+            now_ns - (uint64_t) Z_LVAL_P(missed) >= (uint64_t) DICTIONARY_RETRY_MS * 1000000) {
+            zval looked;
+            if (!missed && zend_hash_num_elements(&dictionary->missing) >= DICTIONARY_MISSING_MAX) {
+                zend_hash_clean(&dictionary->missing);
+            }
+            ZVAL_LONG(&looked, (zend_long) now_ns);
+            zend_hash_index_update(&dictionary->missing, id, &looked);
+
+            if (!dictionary_load(dictionary, id)) {
+                return NULL;
+            }
+            entry = zend_hash_index_find_ptr(&dictionary->entries, id);
+        }
+        if (!entry) {
+            zend_throw_exception_ex(get_valkey_glide_exception_ce(),
+                                    0,
+                                    "Value compressed with unknown dictionary %u",
+                                    id);
+            return NULL;
+        }
+        zend_hash_index_del(&dictionary->missing, id);
+    }
+
+    unsigned long long size = ZSTD_getFrameContentSize(frame, frame_len);
+    if (size == ZSTD_CONTENTSIZE_UNKNOWN || size == ZSTD_CONTENTSIZE_ERROR ||
+        size > ZSTR_MAX_LEN) {
+        zend_throw_exception(get_valkey_glide_exception_ce(), "Invalid compressed value", 0);
+        return NULL;
+    }
+
+    zend_string* original = zend_string_alloc((size_t) size, 0);
+    size_t       original_len;
+    if (entry) {
+        original_len = ZSTD_decompress_usingDDict(
+            dictionary->dctx, ZSTR_VAL(original), (size_t) size, frame, frame_len, entry->ddict);
+    } else {
+        original_len = ZSTD_decompressDCtx(
+            dictionary->dctx, ZSTR_VAL(original), (size_t) size, frame, frame_len);
+    }
+    if (ZSTD_isError(original_len) || original_len != size) {
+        zend_string_efree(original);
+        zend_throw_exception_ex(get_valkey_glide_exception_ce(),
+                                0,
+                                "Failed to decompress a value: %s",
+                                ZSTD_isError(original_len) ? ZSTD_getErrorName(original_len)
+                                                           : "Truncated value");
+        return NULL;
+    }
+
+    ZSTR_VAL(original)[original_len] = '\0';
+    return original;
+}
+
+static void dictionary_decode_value(valkey_glide_dictionary* dictionary, zval* value) {
+    if (Z_TYPE_P(value) != IS_STRING) {
+        return;
+    }
+
+    zend_string* original = dictionary_unpack(dictionary, Z_STRVAL_P(value), Z_STRLEN_P(value));
+    if (original) {
+        zval_ptr_dtor(value);
+        ZVAL_STR(value, original);
+    }
+}
+
+static int dictionary_process(CommandResponse* response, void* output, zval* return_value) {
+    dictionary_output*       wrapped    = output;
+    valkey_glide_dictionary* dictionary = wrapped->dictionary;
+    int                      res        = wrapped->processor(response, NULL, return_value);
+
+    efree(wrapped);
+    valkey_glide_dictionary_decode(dictionary, return_value);
+    return res;
+}
+
+zend_string* valkey_glide_dictionary_pack(valkey_glide_dictionary* dictionary,
+                                          const char*              value,
+                                          size_t                   value_len) {
+    if (value_len < dictionary->min_size) {
+        return NULL;
+    }
+    dictionary_pick(dictionary);
+
+    /* Plain zstd, tagged with ID 0, until a dictionary is trained */
+    dictionary_entry* entry  = zend_hash_index_find_ptr(&dictionary->entries, dictionary->current);
+    uint32_t          id     = entry ? dictionary->current : 0;
+    size_t            bound  = ZSTD_compressBound(value_len);
+    zend_string*      packed = zend_string_alloc(DICTIONARY_HEADER_LEN + bound, 0);
+    unsigned char*    header = (unsigned char*) ZSTR_VAL(packed);
+    char*             frame  = ZSTR_VAL(packed) + DICTIONARY_HEADER_LEN;
+    size_t            frame_len;
+
+    if (entry) {
+        frame_len = ZSTD_compress_usingCDict(
+            dictionary->cctx, frame, bound, value, value_len, entry->cdict);
+    } else {
+        frame_len = ZSTD_compressCCtx(
+            dictionary->cctx, frame, bound, value, value_len, dictionary->level);
+    }
+
+    /* Values that don't shrink are stored as they are */
+    if (ZSTD_isError(frame_len) || DICTIONARY_HEADER_LEN + frame_len >= value_len) {
+        zend_string_efree(packed);
+        return NULL;
+    }
+
+    memcpy(header, DICTIONARY_TAG, DICTIONARY_TAG_LEN);
+    header[4] = (unsigned char) (id >> 24);
+    header[5] = (unsigned char) (id >> 16);
+    header[6] = (unsigned char) (id >> 8);
+    header[7] = (unsigned char) id;
+
+    packed = zend_string_truncate(packed, DICTIONARY_HEADER_LEN + frame_len, 0);
+    ZSTR_VAL(packed)[ZSTR_LEN(packed)] = '\0';
+    return packed;
+}
+
+bool valkey_glide_dictionary_compress_pairs(valkey_glide_object* valkey_glide,
+                                            zval*                pairs,
+                                            zval*                packed) {
+    valkey_glide_dictionary* dictionary = valkey_glide->dictionary;
+    zend_ulong               index;
+    zend_string*             key;
+    zval*                    value;
+
+    if (EXPECTED(dictionary == NULL)) {
+        return false;
+    }
+
+    array_init_size(packed, zend_hash_num_elements(Z_ARRVAL_P(pairs)));
+    ZEND_HASH_FOREACH_KEY_VAL(Z_ARRVAL_P(pairs), index, key, value) {
+        zend_string* original = zval_get_string(value);
+        zend_string* compressed =
+            valkey_glide_dictionary_pack(dictionary, ZSTR_VAL(original), ZSTR_LEN(original));
+        zval copy;
+
+        if (compressed) {
+            zend_string_release(original);
+            ZVAL_STR(&copy, compressed);
+        } else {
+            ZVAL_STR(&copy, original);
+        }
+
+        if (key) {
+            zend_hash_add_new(Z_ARRVAL_P(packed), key, &copy);
+        } else {
+            zend_hash_index_add_new(Z_ARRVAL_P(packed), index, &copy);
+        }
+    }
+    ZEND_HASH_FOREACH_END();
+    return true;
+}
+
+void valkey_glide_dictionary_decode(valkey_glide_dictionary* dictionary, zval* value) {
+    zval* element;
+
+    if (!dictionary) {
+        return;
+    }
+
+    if (Z_TYPE_P(value) != IS_ARRAY) {
+        dictionary_decode_value(dictionary, value);
+        return;
+    }
+
+    SEPARATE_ARRAY(value);
+    ZEND_HASH_FOREACH_VAL(Z_ARRVAL_P(value), element) {
+        dictionary_decode_value(dictionary, element);
+        if (EG(exception)) {
+            break;
+        }
+    }
+    ZEND_HASH_FOREACH_END();
+}
+
+z_result_processor_t valkey_glide_dictionary_wrap(valkey_glide_dictionary* dictionary,
+                                                  z_result_processor_t     processor,
+                                                  void**                   output) {
+    dictionary_output* wrapped = emalloc(sizeof(dictionary_output));
+
+    wrapped->dictionary = dictionary;
+    wrapped->processor  = processor;
+    *output             = wrapped;
+    return dictionary_process;
+}
+
+int valkey_glide_dictionary_attach(valkey_glide_object*                     valkey_glide,
+                                   const valkey_glide_compression_config_t* config) {
+    valkey_glide_dictionary* dictionary = ecalloc(1, sizeof(valkey_glide_dictionary));
+
+    /* A reconnected object starts over */
+    valkey_glide_dictionary_release(valkey_glide);
+
+    dictionary->glide_client = valkey_glide->glide_client;
+    dictionary->key =
+        zend_string_init(config->dictionary_key, strlen(config->dictionary_key), 0);
+    dictionary->level = config->compression_level >= 0 ? config->compression_level
+                                                       : ZSTD_CLEVEL_DEFAULT;
+    dictionary->min_size     = config->min_compression_size;
+    dictionary->cctx         = ZSTD_createCCtx();
+    dictionary->dctx         = ZSTD_createDCtx();
+    zend_hash_init(&dictionary->entries, 4, NULL, dictionary_entry_dtor, 0);
+    zend_hash_init(&dictionary->missing, 0, NULL, NULL, 0);
+    valkey_glide->dictionary = dictionary;
+
+    /* The dictionaries themselves are loaded when first needed */
+    if (!dictionary->cctx || !dictionary->dctx) {
+        zend_throw_exception(
+            get_valkey_glide_exception_ce(), "Failed to allocate the zstd contexts", 0);
+        valkey_glide_dictionary_release(valkey_glide);
+        return FAILURE;
+    }
+    return SUCCESS;
+}
+
+void valkey_glide_dictionary_release(valkey_glide_object* valkey_glide) {
+    valkey_glide_dictionary* dictionary = valkey_glide->dictionary;
+
+    if (!dictionary) {
+        return;
+    }
+
+    zend_hash_destroy(&dictionary->entries);
+    zend_hash_destroy(&dictionary->missing);
+    ZSTD_freeCCtx(dictionary->cctx);
+    ZSTD_freeDCtx(dictionary->dctx);
+    zend_string_release(dictionary->key);
+    efree(dictionary);
+    valkey_glide->dictionary = NULL;
+}
+
+int execute_train_compression_dictionary_command(zval*             object,
+                                                 int               argc,
+                                                 zval*             return_value,
+                                                 zend_class_entry* ce) {
+    zval*     samples;
+    zend_long size = VALKEY_GLIDE_DICTIONARY_SIZE;
+    zval*     sample;
+
+    if (zend_parse_method_parameters(argc, object, "Oa|l", &object, ce, &samples, &size) ==
+        FAILURE) {
+        return 0;
+    }
+
+    valkey_glide_dictionary* dictionary = dictionary_of(object);
+    if (!dictionary) {
+        return 0;
+    }
+
+    uint32_t count = zend_hash_num_elements(Z_ARRVAL_P(samples));
+    if (count == 0) {
+        zend_argument_value_error(1, "must not be empty");
+        return 0;
+    }
+    if (size < DICTIONARY_MIN_SIZE || size > DICTIONARY_MAX_SIZE) {
+        zend_argument_value_error(
+            2, "must be between %d and %d", DICTIONARY_MIN_SIZE, DICTIONARY_MAX_SIZE);
+        return 0;
+    }
+
+    /* zstd takes the samples one after the other, with the size of each */
+    smart_str buffer = {0};
+    size_t*   sizes  = safe_emalloc(count, sizeof(size_t), 0);
+    uint32_t  n      = 0;
+
+    ZEND_HASH_FOREACH_VAL(Z_ARRVAL_P(samples), sample) {
+        zend_string* bytes = zval_get_string(sample);
+
+        smart_str_append(&buffer, bytes);
+        sizes[n++] = ZSTR_LEN(bytes);
+        zend_string_release(bytes);
+    }
+    ZEND_HASH_FOREACH_END();
+    smart_str_0(&buffer);
+
+    zend_string* trained     = zend_string_alloc((size_t) size, 0);
+    size_t       trained_len = ZDICT_trainFromBuffer(ZSTR_VAL(trained),
+                                               (size_t) size,
+                                               buffer.s ? ZSTR_VAL(buffer.s) : "",
+                                               sizes,
+                                               n);
+    smart_str_free(&buffer);
+    efree(sizes);
+
+    if (ZDICT_isError(trained_len)) {
+        zend_string_efree(trained);
+        zend_throw_exception_ex(get_valkey_glide_exception_ce(),
+                                0,
+                                "Failed to train a compression dictionary: %s",
+                                ZDICT_getErrorName(trained_len));
+        return 0;
+    }
+    ZSTR_LEN(trained)              = trained_len;
+    ZSTR_VAL(trained)[trained_len] = '\0';
+
+    /* Stored along with the current ID in one HSET, no client sees the ID without the dictionary */
+    uint32_t       id = ZDICT_getDictID(ZSTR_VAL(trained), trained_len);
+    char           id_str[DICTIONARY_ID_LEN + 1];
+    int            id_len      = snprintf(id_str, sizeof(id_str), "%u", id);
+    uintptr_t      args[5]     = {(uintptr_t) ZSTR_VAL(dictionary->key),
+                                  (uintptr_t) id_str,
+                                  (uintptr_t) ZSTR_VAL(trained),
+                                  (uintptr_t) DICTIONARY_CURRENT,
+                                  (uintptr_t) id_str};
+    unsigned long  args_len[5] = {ZSTR_LEN(dictionary->key),
+                                  id_len,
+                                  trained_len,
+                                  sizeof(DICTIONARY_CURRENT) - 1,
+                                  id_len};
+    CommandResult* result      = command(dictionary->glide_client,
+                                         0, /* callback_index (not used for sync) */
+                                         HSet,
+                                         5,
+                                         args,
+                                         args_len,
+                                         NULL, /* route_bytes */
+                                         0,
+                                         0);
+
+    if (!result || result->command_error) {
+        zend_throw_exception(get_valkey_glide_exception_ce(),
+                             result && result->command_error
+                                 ? result->command_error->command_error_message
+                                 : "Failed to store the compression dictionary",
+                             0);
+        if (result) {
+            free_command_result(result);
+        }
+        zend_string_release(trained);
+        return 0;
+    }
+    free_command_result(result);
+
+    if (dictionary_add(dictionary, id, ZSTR_VAL(trained), trained_len)) {
+        dictionary->current = id;
+        dictionary->picked  = true;
+    }
+    zend_string_release(trained);
+
+    ZVAL_LONG(return_value, id);
+    return 1;
+}
+
+int execute_load_compression_dictionaries_command(zval*             object,
+                                                  int               argc,
+                                                  zval*             return_value,
+                                                  zend_class_entry* ce) {
+    if (zend_parse_method_parameters(argc, object, "O", &object, ce) == FAILURE) {
+        return 0;
+    }
+
+    valkey_glide_dictionary* dictionary = dictionary_of(object);
+    if (!dictionary) {
+        return 0;
+    }
+
+    zend_long count = dictionary_refresh(dictionary);
+    if (count < 0) {
+        return 0;
+    }
+
+    ZVAL_LONG(return_value, count);
+    return 1;
+}
+
+#else /* !HAVE_VALKEY_GLIDE_ZSTD */
+
+/* Built without libzstd: no client gets dictionaries, connecting with dictionary_key throws */
+#define DICTIONARY_UNAVAILABLE \
+    "Dictionary compression requires the extension to be built with libzstd"
+
+zend_string* valkey_glide_dictionary_pack(valkey_glide_dictionary* dictionary,
+                                          const char*              value,
+                                          size_t                   value_len) {
+    return NULL;
+}
+
+bool valkey_glide_dictionary_compress_pairs(valkey_glide_object* valkey_glide,
+                                            zval*                pairs,
+                                            zval*                packed) {
+    return false;
+}
+
+void valkey_glide_dictionary_decode(valkey_glide_dictionary* dictionary, zval* value) {}
+
+z_result_processor_t valkey_glide_dictionary_wrap(valkey_glide_dictionary* dictionary,
+                                                  z_result_processor_t     processor,
+                                                  void**                   output) {
+    return processor;
+}
+
+int valkey_glide_dictionary_attach(valkey_glide_object*                     valkey_glide,
+                                   const valkey_glide_compression_config_t* config) {
+    zend_throw_exception(get_valkey_glide_exception_ce(), DICTIONARY_UNAVAILABLE, 0);
+    return FAILURE;
+}
+
+void valkey_glide_dictionary_release(valkey_glide_object* valkey_glide) {}
+
+int execute_train_compression_dictionary_command(zval*             object,
+                                                 int               argc,
+                                                 zval*             return_value,
+                                                 zend_class_entry* ce) {
+    zval*     samples;
+    zend_long size = VALKEY_GLIDE_DICTIONARY_SIZE;
+
+    if (zend_parse_method_parameters(argc, object, "Oa|l", &object, ce, &samples, &size) ==
+        FAILURE) {
+        return 0;
+    }
+    zend_throw_exception(get_valkey_glide_exception_ce(), DICTIONARY_UNAVAILABLE, 0);
+    return 0;
+}
+
+int execute_load_compression_dictionaries_command(zval*             object,
+                                                  int               argc,
+                                                  zval*             return_value,
+                                                  zend_class_entry* ce) {
+    if (zend_parse_method_parameters(argc, object, "O", &object, ce) == FAILURE) {
+        return 0;
+    }
+    zend_throw_exception(get_valkey_glide_exception_ce(), DICTIONARY_UNAVAILABLE, 0);
+    return 0;
+}
+
+#endif /* HAVE_VALKEY_GLIDE_ZSTD */
@@ -0,0 +1,123 @@
+/** Copyright Valkey GLIDE Project Contributors - SPDX Identifier: Apache-2.0 */
+
+#ifndef VALKEY_GLIDE_DICTIONARY_H
+#define VALKEY_GLIDE_DICTIONARY_H
+
+#include "common.h"
+
+/*
+ * Trained dictionary compression, 'dictionary_key' in the compression settings.
+ *
+ * Small values share most of their bytes with each other, JSON field names and the like, which
+ * plain zstd can't take advantage of within a single value. trainCompressionDictionary() builds
+ * a zstd dictionary from sample values and stores it in the hash at dictionary_key, under its
+ * dictionary ID, which becomes the 'current' one. Clients using the same dictionary_key read the
+ * current ID before their first write and compress the values they write with that dictionary,
+ * or with plain zstd while none is trained.
+ *
+ * Compressed values start with a tag and the ID of their dictionary, 0 for plain zstd, so values
+ * written with an older dictionary are still read after a new one was trained, and values
+ * without the tag are left alone. A dictionary is loaded when first needed, one HGET for its ID,
+ * looked for at most once a second when missing. A client holds a few at most, dropping the
+ * oldest.
+ *
+ * Values are compressed by the extension rather than by the client core, which can't be given a
+ * dictionary: SET, SETEX, PSETEX, SETNX and GETSET, MSET, MSETNX and msetex() write compressed
+ * values and GET, MGET and the GET option of SET return them decompressed. The core no longer
+ * compresses anything, so no value is compressed twice, but still decompresses the values it
+ * wrote before. Requires libzstd at build time.
+ */
+#define VALKEY_GLIDE_DICTIONARY_SIZE 16384 /* Default size of a trained dictionary */
+
+typedef struct valkey_glide_dictionary valkey_glide_dictionary;
+
+/* Tagged copy of value compressed with the current dictionary, NULL if it isn't worth it */
+zend_string* valkey_glide_dictionary_pack(valkey_glide_dictionary* dictionary,
+                                          const char*              value,
+                                          size_t                   value_len);
+
+static inline zend_string* valkey_glide_dictionary_compress(valkey_glide_object* valkey_glide,
+                                                            const char*          value,
+                                                            size_t               value_len) {
+    if (EXPECTED(valkey_glide->dictionary == NULL)) {
+        return NULL;
+    }
+    return valkey_glide_dictionary_pack(valkey_glide->dictionary, value, value_len);
+}
+
+/*
+ * Copy of the key => value pairs of MSET with the values compressed into packed, false when
+ * the pairs are to be sent as they are.
+ */
+bool valkey_glide_dictionary_compress_pairs(valkey_glide_object* valkey_glide,
+                                            zval*                pairs,
+                                            zval*                packed);
+
+/*
+ * Replace value, or the elements of an array value, by their original when compressed with a
+ * dictionary. Throws ValkeyGlideException when a value was compressed with an unknown one.
+ */
+void valkey_glide_dictionary_decode(valkey_glide_dictionary* dictionary, zval* value);
+
+/*
+ * Processor decoding the reply of processor, which takes no output, setting output to what the
+ * returned processor takes. processor is returned as it is if the client has no dictionaries.
+ */
+z_result_processor_t valkey_glide_dictionary_wrap(valkey_glide_dictionary* dictionary,
+                                                  z_result_processor_t     processor,
+                                                  void**                   output);
+
+static inline z_result_processor_t valkey_glide_dictionary_processor(
+    valkey_glide_object* valkey_glide, z_result_processor_t processor, void** output) {
+    if (EXPECTED(valkey_glide->dictionary == NULL)) {
+        return processor;
+    }
+    return valkey_glide_dictionary_wrap(valkey_glide->dictionary, processor, output);
+}
+
+/* Set up dictionary compression for a connected client, FAILURE with an exception thrown */
+int valkey_glide_dictionary_attach(valkey_glide_object*                     valkey_glide,
+                                   const valkey_glide_compression_config_t* config);
+
+/* Drop the dictionaries, when the object is freed */
+void valkey_glide_dictionary_release(valkey_glide_object* valkey_glide);
+
+int execute_train_compression_dictionary_command(zval*             object,
+                                                 int               argc,
+                                                 zval*             return_value,
+                                                 zend_class_entry* ce);
+
+int execute_load_compression_dictionaries_command(zval*             object,
+                                                  int               argc,
+                                                  zval*             return_value,
+                                                  zend_class_entry* ce);
+
+#define TRAIN_COMPRESSION_DICTIONARY_METHOD_IMPL(class_name)                                   \
+    PHP_METHOD(class_name, trainCompressionDictionary) {                                       \
+        if (execute_train_compression_dictionary_command(                                      \
+                getThis(),                                                                     \
+                ZEND_NUM_ARGS(),                                                               \
+                return_value,                                                                  \
+                strcmp(#class_name, "ValkeyGlideCluster") == 0 ? get_valkey_glide_cluster_ce() \
+                                                               : get_valkey_glide_ce())) {     \
+            return;                                                                            \
+        }                                                                                      \
+        zval_dtor(return_value);                                                               \
+        RETURN_FALSE;                                                                          \
+    }
+
+#define LOAD_COMPRESSION_DICTIONARIES_METHOD_IMPL(class_name)                                  \
+    PHP_METHOD(class_name, loadCompressionDictionaries) {                                      \
+        if (execute_load_compression_dictionaries_command(                                     \
+                getThis(),                                                                     \
+                ZEND_NUM_ARGS(),                                                               \
+                return_value,                                                                  \
+                strcmp(#class_name, "ValkeyGlideCluster") == 0 ? get_valkey_glide_cluster_ce() \
+                                                               : get_valkey_glide_ce())) {     \
+            return;                                                                            \
+        }                                                                                      \
+        zval_dtor(return_value);                                                               \
+        RETURN_FALSE;                                                                          \
+    }
+
+#endif /* VALKEY_GLIDE_DICTIONARY_H */
@@ -0,0 +1,398 @@
+/** Copyright Valkey GLIDE Project Contributors - SPDX Identifier: Apache-2.0 */
+
+#include "valkey_glide_fiber.h"
+
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <zend_exceptions.h>
+#include <zend_fibers.h>
+#include <zend_interfaces.h>
+
+#include "logger.h"
+#include "valkey_glide_async.h"
+
+/* Offload pool of one fiber-aware client */
+typedef struct {
+    const void*                 glide_client;
+    valkey_glide_async_context* async_ctx; /* Completion queue drained by poll() */
+    pthread_t*                  threads;
+    int                         thread_count;
+    pthread_mutex_t             lock;
+    pthread_cond_t              job_cond;  /* Signalled when a job is queued */
+    pthread_cond_t              done_cond; /* Broadcast when a job completes */
+    valkey_glide_fiber_job*     head;
+    valkey_glide_fiber_job*     tail;
+    bool                        stopping;
+    zval                        suspend; /* fiber_suspend callable, undef if not set */
+} valkey_glide_fiber_context;
+
+struct valkey_glide_fiber_job {
+    valkey_glide_fiber_context* ctx;
+
+    /* Call description, pointing into the suspended Fiber's frame */
+    enum RequestType               command_type;
+    unsigned long                  arg_count;
+    const uintptr_t*               args;
+    const unsigned long*           args_len;
+    const uint8_t*                 route_bytes;
+    uintptr_t                      route_bytes_len;
+    const struct BatchInfo*        batch_info; /* Non-NULL for batch() */
+    bool                           raise_on_error;
+    const struct BatchOptionsInfo* options;
+    uint64_t                       span_ptr;
+
+    CommandResult* result;
+    int            notify_fd; /* Written once done with fiber_suspend, -1 to queue for poll() */
+    zval           fiber;    /* The waiting Fiber, released once it took the result */
+    bool           done;     /* Set by the worker under ctx->lock */
+    bool           consumed; /* The Fiber took the result, PHP thread only */
+    int            refcount; /* Held by the Fiber and by the completion queue */
+
+    struct valkey_glide_fiber_job* next;
+};
+
+void valkey_glide_fiber_job_release(valkey_glide_fiber_job* job) {
+    if (__atomic_sub_fetch(&job->refcount, 1, __ATOMIC_ACQ_REL) > 0) {
+        return;
+    }
+    if (job->result) {
+        free_command_result(job->result);
+    }
+    free(job);
+}
+
+static void* fiber_worker(void* arg) {
+    valkey_glide_fiber_context* ctx = (valkey_glide_fiber_context*) arg;
+
+    for (;;) {
+        pthread_mutex_lock(&ctx->lock);
+        while (!ctx->head && !ctx->stopping) {
+            pthread_cond_wait(&ctx->job_cond, &ctx->lock);
+        }
+        valkey_glide_fiber_job* job = ctx->head;
+        if (!job) {
+            /* Stopping and drained */
+            pthread_mutex_unlock(&ctx->lock);
+            break;
+        }
+        ctx->head = job->next;
+        if (!ctx->head) {
+            ctx->tail = NULL;
+        }
+        pthread_mutex_unlock(&ctx->lock);
+
+        CommandResult* result;
+        if (job->batch_info) {
+            result = batch(ctx->glide_client,
+                           0,
+                           job->batch_info,
+                           job->raise_on_error,
+                           job->options,
+                           job->span_ptr);
+        } else {
+            result = command(ctx->glide_client,
+                             0,
+                             job->command_type,
+                             job->arg_count,
+                             job->args,
+                             job->args_len,
+                             job->route_bytes,
+                             job->route_bytes_len,
+                             job->span_ptr);
+        }
+
+        /* Written before done is set, the waiting Fiber closes the descriptor once it sees it */
+        bool for_poll = job->notify_fd < 0;
+        if (!for_poll) {
+            char    byte = 1;
+            ssize_t ret  = write(job->notify_fd, &byte, 1);
+            (void) ret;
+        }
+
+        pthread_mutex_lock(&ctx->lock);
+        job->result = result;
+        job->done   = true;
+        pthread_cond_broadcast(&ctx->done_cond);
+        pthread_mutex_unlock(&ctx->lock);
+
+        if (for_poll) {
+            valkey_glide_async_push_fiber_job(ctx->async_ctx, job);
+        }
+    }
+
+    return NULL;
+}
+
+int valkey_glide_fiber_attach(valkey_glide_object* valkey_glide, int threads, zval* suspend) {
+    if (threads <= 0 || threads > VALKEY_GLIDE_FIBER_MAX_THREADS) {
+        zend_throw_exception(get_valkey_glide_exception_ce(),
+                             "fiber_aware must be true or a thread count between 1 and 256",
+                             0);
+        return FAILURE;
+    }
+
+    if (valkey_glide_async_ensure_context(valkey_glide) == FAILURE) {
+        return FAILURE;
+    }
+
+    valkey_glide_fiber_context* ctx = calloc(1, sizeof(valkey_glide_fiber_context));
+    if (!ctx) {
+        zend_throw_exception(get_valkey_glide_exception_ce(), "Failed to allocate fiber pool", 0);
+        return FAILURE;
+    }
+    ctx->glide_client = valkey_glide->glide_client;
+    ctx->async_ctx    = valkey_glide->async_ctx;
+    ctx->threads      = calloc(threads, sizeof(pthread_t));
+    ZVAL_UNDEF(&ctx->suspend);
+    pthread_mutex_init(&ctx->lock, NULL);
+    pthread_cond_init(&ctx->job_cond, NULL);
+    pthread_cond_init(&ctx->done_cond, NULL);
+
+    for (int i = 0; ctx->threads && i < threads; i++) {
+        if (pthread_create(&ctx->threads[i], NULL, fiber_worker, ctx) != 0) {
+            break;
+        }
+        ctx->thread_count++;
+    }
+
+    if (ctx->thread_count == 0) {
+        pthread_cond_destroy(&ctx->done_cond);
+        pthread_cond_destroy(&ctx->job_cond);
+        pthread_mutex_destroy(&ctx->lock);
+        free(ctx->threads);
+        free(ctx);
+        zend_throw_exception(
+            get_valkey_glide_exception_ce(), "Failed to start fiber worker threads", 0);
+        return FAILURE;
+    }
+
+    if (suspend) {
+        ZVAL_COPY(&ctx->suspend, suspend);
+    }
+    zend_hash_index_update_ptr(
+        &VALKEY_GLIDE_G(fiber_clients), (zend_ulong) (uintptr_t) ctx->glide_client, ctx);
+
+    VALKEY_LOG_DEBUG_FMT("fiber_aware", "Started %d fiber worker threads", ctx->thread_count);
+    return SUCCESS;
+}
+
+void valkey_glide_fiber_detach(valkey_glide_object* valkey_glide) {
+    if (!valkey_glide->glide_client ||
+        zend_hash_num_elements(&VALKEY_GLIDE_G(fiber_clients)) == 0) {
+        return;
+    }
+
+    zend_ulong                  key = (zend_ulong) (uintptr_t) valkey_glide->glide_client;
+    valkey_glide_fiber_context* ctx =
+        zend_hash_index_find_ptr(&VALKEY_GLIDE_G(fiber_clients), key);
+    if (!ctx) {
+        return;
+    }
+    zend_hash_index_del(&VALKEY_GLIDE_G(fiber_clients), key);
+
+    /* Workers finish queued jobs before exiting, so no job outlives the glide client */
+    pthread_mutex_lock(&ctx->lock);
+    ctx->stopping = true;
+    pthread_cond_broadcast(&ctx->job_cond);
+    pthread_mutex_unlock(&ctx->lock);
+
+    for (int i = 0; i < ctx->thread_count; i++) {
+        pthread_join(ctx->threads[i], NULL);
+    }
+
+    pthread_cond_destroy(&ctx->done_cond);
+    pthread_cond_destroy(&ctx->job_cond);
+    pthread_mutex_destroy(&ctx->lock);
+    zval_ptr_dtor(&ctx->suspend);
+    free(ctx->threads);
+    free(ctx);
+}
+
+bool valkey_glide_fiber_should_offload(const void* glide_client) {
+    if (zend_hash_num_elements(&VALKEY_GLIDE_G(fiber_clients)) == 0 || !EG(active_fiber)) {
+        return false;
+    }
+    return zend_hash_index_exists(&VALKEY_GLIDE_G(fiber_clients),
+                                  (zend_ulong) (uintptr_t) glide_client);
+}
+
+/* Block the thread until a worker has completed job */
+static void fiber_wait_done(valkey_glide_fiber_context* ctx, valkey_glide_fiber_job* job) {
+    pthread_mutex_lock(&ctx->lock);
+    while (!job->done) {
+        pthread_cond_wait(&ctx->done_cond, &ctx->lock);
+    }
+    pthread_mutex_unlock(&ctx->lock);
+}
+
+/* Have the fiber_suspend callable suspend the Fiber until the job pipe becomes readable */
+static void fiber_suspend_with_callable(valkey_glide_fiber_context* ctx,
+                                        valkey_glide_fiber_job*     job,
+                                        int                         read_fd) {
+    php_stream* stream = php_stream_fopen_from_fd(read_fd, "r", NULL);
+    zval        z_stream;
+
+    if (!stream) {
+        close(read_fd);
+        fiber_wait_done(ctx, job);
+        return;
+    }
+    php_stream_set_option(stream, PHP_STREAM_OPTION_BLOCKING, 0, NULL);
+    php_stream_to_zval(stream, &z_stream);
+
+    for (;;) {
+        pthread_mutex_lock(&ctx->lock);
+        bool done = job->done;
+        pthread_mutex_unlock(&ctx->lock);
+        if (done) {
+            break;
+        }
+
+        zval retval;
+        ZVAL_UNDEF(&retval);
+        int called = call_user_function(NULL, NULL, &ctx->suspend, &retval, 1, &z_stream);
+        zval_ptr_dtor(&retval);
+
+        if (called == FAILURE || EG(exception)) {
+            /* The worker still reads our arguments */
+            fiber_wait_done(ctx, job);
+            break;
+        }
+    }
+
+    zval_ptr_dtor(&z_stream);
+}
+
+/* Queue job and suspend the current Fiber until a worker has completed it */
+static CommandResult* fiber_run_job(const void* glide_client, valkey_glide_fiber_job* job) {
+    valkey_glide_fiber_context* ctx = zend_hash_index_find_ptr(
+        &VALKEY_GLIDE_G(fiber_clients), (zend_ulong) (uintptr_t) glide_client);
+    int fds[2] = {-1, -1};
+
+    job->ctx       = ctx;
+    job->notify_fd = -1;
+    ZVAL_UNDEF(&job->fiber);
+
+    if (Z_TYPE(ctx->suspend) != IS_UNDEF) {
+        /* The job is the Fiber's alone, its completion is signalled on its own pipe */
+        job->refcount = 1;
+        if (pipe(fds) == 0) {
+            job->notify_fd = fds[1];
+        }
+    } else {
+        job->refcount = 2;
+        ZVAL_OBJ_COPY(&job->fiber, &EG(active_fiber)->std);
+    }
+
+    pthread_mutex_lock(&ctx->lock);
+    if (ctx->tail) {
+        ctx->tail->next = job;
+    } else {
+        ctx->head = job;
+    }
+    ctx->tail = job;
+    pthread_cond_signal(&ctx->job_cond);
+    pthread_mutex_unlock(&ctx->lock);
+
+    if (Z_TYPE(ctx->suspend) != IS_UNDEF) {
+        if (job->notify_fd >= 0) {
+            fiber_suspend_with_callable(ctx, job, fds[0]);
+            close(job->notify_fd);
+        } else {
+            /* Without a pipe to hand to the scheduler the thread waits */
+            fiber_wait_done(ctx, job);
+        }
+    }
+
+    while (Z_TYPE(ctx->suspend) == IS_UNDEF) {
+        pthread_mutex_lock(&ctx->lock);
+        bool done = job->done;
+        pthread_mutex_unlock(&ctx->lock);
+        if (done) {
+            break;
+        }
+
+        zval retval;
+        ZVAL_UNDEF(&retval);
+        zend_call_method_with_0_params(NULL, zend_ce_fiber, NULL, "suspend", &retval);
+        zval_ptr_dtor(&retval);
+
+        if (EG(exception)) {
+            /* The Fiber is being destroyed while the worker still reads our arguments */
+            fiber_wait_done(ctx, job);
+            break;
+        }
+    }
+
+    CommandResult* result = job->result;
+    job->result           = NULL;
+    job->consumed         = true;
+    zval_ptr_dtor(&job->fiber);
+    ZVAL_UNDEF(&job->fiber);
+    valkey_glide_fiber_job_release(job);
+
+    return result;
+}
+
+CommandResult* valkey_glide_fiber_command(const void*          glide_client,
+                                          enum RequestType     command_type,
+                                          unsigned long        arg_count,
+                                          const uintptr_t*     args,
+                                          const unsigned long* args_len,
+                                          const uint8_t*       route_bytes,
+                                          uintptr_t            route_bytes_len,
+                                          uint64_t             span_ptr) {
+    valkey_glide_fiber_job* job = calloc(1, sizeof(valkey_glide_fiber_job));
+    if (!job) {
+        return NULL;
+    }
+
+    job->command_type    = command_type;
+    job->arg_count       = arg_count;
+    job->args            = args;
+    job->args_len        = args_len;
+    job->route_bytes     = route_bytes;
+    job->route_bytes_len = route_bytes_len;
+    job->span_ptr        = span_ptr;
+
+    return fiber_run_job(glide_client, job);
+}
+
+CommandResult* valkey_glide_fiber_batch(const void*                    glide_client,
+                                        const struct BatchInfo*        batch_info,
+                                        bool                           raise_on_error,
+                                        const struct BatchOptionsInfo* options,
+                                        uint64_t                       span_ptr) {
+    valkey_glide_fiber_job* job = calloc(1, sizeof(valkey_glide_fiber_job));
+    if (!job) {
+        return NULL;
+    }
+
+    job->batch_info     = batch_info;
+    job->raise_on_error = raise_on_error;
+    job->options        = options;
+    job->span_ptr       = span_ptr;
+
+    return fiber_run_job(glide_client, job);
+}
+
+void valkey_glide_fiber_resume(valkey_glide_fiber_job* job) {
+    /* A Fiber resumed by someone else may already have taken its result */
+    if (!job->consumed && Z_TYPE(job->fiber) == IS_OBJECT) {
+        zend_fiber* fiber = (zend_fiber*) Z_OBJ(job->fiber);
+
+        if (fiber->context.status == ZEND_FIBER_STATUS_SUSPENDED) {
+            zval fiber_zv, retval;
+            ZVAL_COPY(&fiber_zv, &job->fiber);
+            ZVAL_UNDEF(&retval);
+            zend_call_method_with_0_params(
+                Z_OBJ(fiber_zv), zend_ce_fiber, NULL, "resume", &retval);
+            zval_ptr_dtor(&retval);
+            zval_ptr_dtor(&fiber_zv);
+        }
+    }
+
+    valkey_glide_fiber_job_release(job);
+}
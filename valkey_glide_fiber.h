@@ -0,0 +1,66 @@
+/** Copyright Valkey GLIDE Project Contributors - SPDX Identifier: Apache-2.0 */
+
+#ifndef VALKEY_GLIDE_FIBER_H
+#define VALKEY_GLIDE_FIBER_H
+
+#include "common.h"
+#include "include/glide_bindings.h"
+
+/*
+ * Fiber-aware execution.
+ *
+ * When a client is created with advanced_config['fiber_aware'] enabled, commands issued from
+ * inside a Fiber do not block the thread: the FFI call is handed to a small pool of worker
+ * threads and the Fiber suspends. Commands issued outside of a Fiber keep executing
+ * synchronously.
+ *
+ * With advanced_config['fiber_suspend'], the Fiber suspends by calling it with a stream that
+ * becomes readable once the reply is available, so the scheduler owning the Fiber (Revolt, Amp,
+ * ReactPHP) suspends and resumes it with its own primitives. The callable is called again if it
+ * returns before the reply arrived. Without it the Fiber calls Fiber::suspend() itself and only
+ * poll() resumes it, once the completion was signalled on getCompletionFd(): a Fiber whose
+ * owner never calls poll() stays suspended.
+ *
+ * The commands run through the blocking command()/batch() of the object's own client on the
+ * worker threads, not through a callback-mode client: callbacks deliver a bare CommandResponse,
+ * while every caller consumes the CommandResult that only the blocking calls allocate. The cost
+ * is one thread per in-flight command, so a pool of N threads keeps at most N commands in flight
+ * and further Fibers wait in the queue. The pool belongs to the object: it is started by
+ * connect() and joined by close() or the object's destruction, so under FPM every request that
+ * connects pays for starting it.
+ */
+typedef struct valkey_glide_fiber_job valkey_glide_fiber_job;
+
+/* Advanced configuration key: true for the default pool size, or the number of worker threads */
+#define VALKEY_GLIDE_FIBER_AWARE "fiber_aware"
+#define VALKEY_GLIDE_FIBER_SUSPEND "fiber_suspend"
+#define VALKEY_GLIDE_FIBER_DEFAULT_THREADS 16
+#define VALKEY_GLIDE_FIBER_MAX_THREADS 256
+
+/* Start the worker pool, Fibers suspending with suspend if not NULL */
+int  valkey_glide_fiber_attach(valkey_glide_object* valkey_glide, int threads, zval* suspend);
+void valkey_glide_fiber_detach(valkey_glide_object* valkey_glide);
+
+/* Whether a command for glide_client should be offloaded, i.e. we're in a Fiber of such client */
+bool valkey_glide_fiber_should_offload(const void* glide_client);
+
+/* Offload command()/batch() and suspend the current Fiber until the result is available */
+CommandResult* valkey_glide_fiber_command(const void*          glide_client,
+                                          enum RequestType     command_type,
+                                          unsigned long        arg_count,
+                                          const uintptr_t*     args,
+                                          const unsigned long* args_len,
+                                          const uint8_t*       route_bytes,
+                                          uintptr_t            route_bytes_len,
+                                          uint64_t             span_ptr);
+CommandResult* valkey_glide_fiber_batch(const void*                    glide_client,
+                                        const struct BatchInfo*        batch_info,
+                                        bool                           raise_on_error,
+                                        const struct BatchOptionsInfo* options,
+                                        uint64_t                       span_ptr);
+
+/* Resume the Fiber waiting on job, called by poll(). Releases the caller's job reference. */
+void valkey_glide_fiber_resume(valkey_glide_fiber_job* job);
+void valkey_glide_fiber_job_release(valkey_glide_fiber_job* job);
+
+#endif /* VALKEY_GLIDE_FIBER_H */
@@ -280,15 +280,86 @@ int process_geo_pos_result_async(CommandResponse* response, void* output, zval*
     return 0;
 }
 
+/* Element idx of a GEOSEARCH member's WITH* data, NULL if the reply is short */
+static const CommandResponse* geo_search_info_at(const CommandResponse* info, size_t idx) {
+    return info && idx < (size_t) info->array_value_len ? &info->array_value[idx] : NULL;
+}
+
+/*
+ * OPT_COLUMNAR layout of a GEOSEARCH reply with WITH* options: parallel 'member', 'dist',
+ * 'hash', 'lon' and 'lat' arrays, only holding the columns that were asked for.
+ */
+static int process_geo_search_columnar(const CommandResponse*   response,
+                                       const geo_search_data_t* search_data,
+                                       zval*                    return_value) {
+    uint32_t rows = (uint32_t) response->array_value_len;
+    zval     member, dist, hash, lon, lat;
+
+    array_init_size(&member, rows);
+    ZVAL_UNDEF(&dist);
+    ZVAL_UNDEF(&hash);
+    ZVAL_UNDEF(&lon);
+    ZVAL_UNDEF(&lat);
+    if (search_data->withdist) {
+        array_init_size(&dist, rows);
+    }
+    if (search_data->withhash) {
+        array_init_size(&hash, rows);
+    }
+    if (search_data->withcoord) {
+        array_init_size(&lon, rows);
+        array_init_size(&lat, rows);
+    }
+
+    for (uint32_t i = 0; i < rows; i++) {
+        const CommandResponse* element = &response->array_value[i];
+        const CommandResponse* info    = NULL;
+        size_t                 idx     = 0;
+
+        if (element->response_type != Array || element->array_value_len == 0) {
+            continue;
+        }
+        if (element->array_value_len > 1 && element->array_value[1].response_type == Array) {
+            info = &element->array_value[1];
+        }
+
+        /* Same order as the reply: distance, hash, then coordinates */
+        valkey_glide_column_add(&member, &element->array_value[0]);
+        if (search_data->withdist) {
+            valkey_glide_column_add_double(&dist, geo_search_info_at(info, idx++));
+        }
+        if (search_data->withhash) {
+            valkey_glide_column_add(&hash, geo_search_info_at(info, idx++));
+        }
+        if (search_data->withcoord) {
+            const CommandResponse* coord = geo_search_info_at(info, idx++);
+            bool pair = coord && coord->response_type == Array && coord->array_value_len == 2;
+
+            valkey_glide_column_add_double(&lon, pair ? &coord->array_value[0] : NULL);
+            valkey_glide_column_add_double(&lat, pair ? &coord->array_value[1] : NULL);
+        }
+    }
+
+    array_init(return_value);
+    add_assoc_zval(return_value, "member", &member);
+    if (search_data->withdist) {
+        add_assoc_zval(return_value, "dist", &dist);
+    }
+    if (search_data->withhash) {
+        add_assoc_zval(return_value, "hash", &hash);
+    }
+    if (search_data->withcoord) {
+        add_assoc_zval(return_value, "lon", &lon);
+        add_assoc_zval(return_value, "lat", &lat);
+    }
+    return 1;
+}
+
 /**
  * Batch-compatible async result processor for GEOSEARCH responses
  */
 int process_geo_search_result_async(CommandResponse* response, void* output, zval* return_value) {
-    struct {
-        int withcoord;
-        int withdist;
-        int withhash;
-    }* search_data = (void*) output;
+    geo_search_data_t* search_data = (geo_search_data_t*) output;
 
     if (!response || !return_value || !search_data) {
         efree(search_data);
@@ -308,6 +379,12 @@ int process_geo_search_result_async(CommandResponse* response, void* output, zva
             response, return_value, COMMAND_RESPONSE_NOT_ASSOSIATIVE, false);
     }
 
+    if (search_data->columnar && response->response_type == Array) {
+        int status = process_geo_search_columnar(response, search_data, return_value);
+        efree(search_data);
+        return status;
+    }
+
     /* Process the result and build an associative array */
     if (response->response_type == Array) {
         array_init(return_value);
@@ -492,12 +569,13 @@ int execute_geo_generic_command(valkey_glide_object*   valkey_glide,
     }
 
     /* Execute the command synchronously */
-    CommandResult* result = execute_command(valkey_glide->glide_client,
-                                            cmd_type,   /* command type */
-                                            arg_count,  /* number of arguments */
-                                            arg_values, /* arguments */
-                                            arg_lens    /* argument lengths */
-    );
+    CommandResponse* reply  = NULL;
+    CommandResult*   result = execute_command_for_reply(valkey_glide->glide_client,
+                                                        cmd_type,   /* command type */
+                                                        arg_count,  /* number of arguments */
+                                                        arg_values, /* arguments */
+                                                        arg_lens,   /* argument lengths */
+                                                        &reply);
 
     /* Free allocated strings */
     for (int i = 0; i < allocated_count; i++) {
@@ -525,7 +603,7 @@ int execute_geo_generic_command(valkey_glide_object*   valkey_glide,
     }
 
     /* Process the result */
-    success = process_result(result->response, result_ptr, return_value);
+    success = process_result(reply, result_ptr, return_value);
 
     /* Free the result */
     free_command_result(result);
@@ -943,17 +1021,12 @@ int execute_geosearch_unified(
 
         if (!is_store_variant) {
             /* Create search data for GEOSEARCH result processing */
-            typedef struct {
-                int withcoord;
-                int withdist;
-                int withhash;
-            } search_data_t;
-
-            search_data_t* search_data = emalloc(sizeof(search_data_t));
-            search_data->withcoord     = params.options.with_opts.withcoord;
-            search_data->withdist      = params.options.with_opts.withdist;
-            search_data->withhash      = params.options.with_opts.withhash;
-            result_ptr                 = search_data;
+            geo_search_data_t* search_data = emalloc(sizeof(geo_search_data_t));
+            search_data->withcoord         = params.options.with_opts.withcoord;
+            search_data->withdist          = params.options.with_opts.withdist;
+            search_data->withhash          = params.options.with_opts.withhash;
+            search_data->columnar          = valkey_glide->opt_columnar;
+            result_ptr                     = search_data;
         }
 
         int status = buffer_command_for_batch(valkey_glide,
@@ -1008,16 +1081,11 @@ int execute_geosearch_unified(
         success = process_geo_int_result_async(result->response, NULL, return_value);
     } else {
         /* Create search data for result processing */
-        typedef struct {
-            int withcoord;
-            int withdist;
-            int withhash;
-        } search_data_t;
-
-        search_data_t* search_data = emalloc(sizeof(search_data_t));
-        search_data->withcoord     = params.options.with_opts.withcoord;
-        search_data->withdist      = params.options.with_opts.withdist;
-        search_data->withhash      = params.options.with_opts.withhash;
+        geo_search_data_t* search_data = emalloc(sizeof(geo_search_data_t));
+        search_data->withcoord         = params.options.with_opts.withcoord;
+        search_data->withdist          = params.options.with_opts.withdist;
+        search_data->withhash          = params.options.with_opts.withhash;
+        search_data->columnar          = valkey_glide->opt_columnar;
 
         success = process_geo_search_result_async(result->response, search_data, return_value);
     }
@@ -37,6 +37,16 @@ typedef struct _geo_with_options_t {
     int withhash;  /* Include geohash in the result */
 } geo_with_options_t;
 
+/**
+ * GEOSEARCH reply layout, owned and freed by process_geo_search_result_async
+ */
+typedef struct _geo_search_data_t {
+    int  withcoord;
+    int  withdist;
+    int  withhash;
+    bool columnar; /* OPT_COLUMNAR: one array per field instead of per member */
+} geo_search_data_t;
+
 /**
  * Options for GEORADIUS and GEOSEARCH commands
  */
@@ -17,7 +17,11 @@
 
 #include "common.h"
 #include "ext/standard/php_var.h"
+#include "valkey_glide_bloom.h"
+#include "valkey_glide_breaker.h"
 #include "valkey_glide_core_common.h"
+#include "valkey_glide_hot_keys.h"
+#include "valkey_glide_node_stats.h"
 #include "valkey_glide_z_common.h"
 
 extern zend_class_entry* ce;
@@ -129,6 +133,9 @@ int execute_h_generic_command(valkey_glide_object* valkey_glide,
         }
         goto cleanup;
     }
+    valkey_glide_hot_keys_record(valkey_glide, args->key, args->key_len, args_len, arg_count);
+    valkey_glide_node_stats_record(valkey_glide, args->key, args->key_len);
+    valkey_glide_breaker_record(valkey_glide, args->key, args->key_len);
 
     /* Check for batch mode */
 
@@ -139,13 +146,14 @@ int execute_h_generic_command(valkey_glide_object* valkey_glide,
     }
 
     /* Execute the command */
-    CommandResult* result =
-        execute_command(valkey_glide->glide_client, cmd_type, arg_count, cmd_args, args_len);
+    CommandResponse* reply  = NULL;
+    CommandResult*   result = execute_command_for_reply(
+        valkey_glide->glide_client, cmd_type, arg_count, cmd_args, args_len, &reply);
 
     /* Process result */
     if (result && Z_TYPE_P(return_value) != IS_FALSE) {
-        if (!result->command_error && result->response && process_result) {
-            status = process_result(result->response, result_ptr, return_value);
+        if (!result->command_error && reply && process_result) {
+            status = process_result(reply, result_ptr, return_value);
         } else {
             if (result_ptr) {
                 efree(args->fields);
@@ -254,6 +262,9 @@ int execute_h_simple_command(valkey_glide_object* valkey_glide,
     if (arg_count <= 0) {
         goto cleanup;
     }
+    valkey_glide_hot_keys_record(valkey_glide, args->key, args->key_len, args_len, arg_count);
+    valkey_glide_node_stats_record(valkey_glide, args->key, args->key_len);
+    valkey_glide_breaker_record(valkey_glide, args->key, args->key_len);
 
     /* Check for batch mode */
     z_result_processor_t processor = get_processor_for_response_type(response_type);
@@ -268,14 +279,15 @@ int execute_h_simple_command(valkey_glide_object* valkey_glide,
     }
 
     /* Execute the command */
-    CommandResult* result =
-        execute_command(valkey_glide->glide_client, cmd_type, arg_count, cmd_args, args_len);
+    CommandResponse* reply  = NULL;
+    CommandResult*   result = execute_command_for_reply(
+        valkey_glide->glide_client, cmd_type, arg_count, cmd_args, args_len, &reply);
 
 
     /* Process result using standard handlers */
     if (result && Z_TYPE_P(return_value) != IS_FALSE) {
-        if (!result->command_error && result->response && processor) {
-            status = processor(result->response, result_ptr, return_value);
+        if (!result->command_error && reply && processor) {
+            status = processor(reply, result_ptr, return_value);
         }
         free_command_result(result);
     } else {
@@ -1536,6 +1548,12 @@ int execute_hget_command(zval* object, int argc, zval* return_value, zend_class_
         return 0;
     }
 
+    /* A key the Bloom filter has never seen cannot exist */
+    if (valkey_glide_bloom_rules_out(valkey_glide, key, key_len)) {
+        ZVAL_FALSE(return_value);
+        return 1;
+    }
+
     /* Set up command args */
     h_command_args_t args = {0};
     args.key              = key;
@@ -0,0 +1,541 @@
+/** Copyright Valkey GLIDE Project Contributors - SPDX Identifier: Apache-2.0 */
+
+#include "valkey_glide_hedge.h"
+
+#include <errno.h>
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <zend_exceptions.h>
+
+#include "command_response.h"
+#include "logger.h"
+#include "valkey_glide_commands_common.h"
+#include "valkey_glide_otel.h"
+#include "valkey_glide_slowlog.h"
+
+#define HEDGE_SAMPLES 128      /* Recent primary latencies the p95 is taken from */
+#define HEDGE_REFRESH 32       /* New samples between two computations of the p95 */
+#define HEDGE_BURST 10.0       /* Hedges the rate cap lets through back to back */
+#define HEDGE_MAX_RATE 0.05    /* Default fraction of the reads that may be hedged */
+#define HEDGE_MIN_DELAY_US 500 /* Floor of a learned delay */
+#define HEDGE_NO_DELAY UINT64_MAX
+
+typedef struct hedge_read hedge_read;
+
+/* One command() call of a read, to the primary or to a replica */
+typedef struct hedge_request {
+    hedge_read*           read;
+    int                   index; /* 0 for the primary, 1 for the replica */
+    uint8_t*              route_bytes;
+    size_t                route_bytes_len;
+    uint64_t              span_ptr;
+    struct hedge_request* next;
+} hedge_request;
+
+struct hedge_read {
+    enum RequestType command_type;
+    unsigned long    arg_count;
+    uintptr_t*       args; /* Copies, as a request may outlive the call */
+    unsigned long*   args_len;
+    hedge_request    requests[2];
+    CommandResult*   results[2];
+    int              sent;
+    int              completed;
+    int              winner;   /* The first request to succeed, -1 until one did */
+    int              refcount; /* Held by the caller and by every request sent */
+};
+
+struct valkey_glide_hedge {
+    const void*     glide_client;
+    pthread_mutex_t lock;
+    pthread_cond_t  request_cond;
+    pthread_cond_t  done_cond;
+    pthread_t       threads[VALKEY_GLIDE_HEDGE_THREADS];
+    int             thread_count;
+    int             busy; /* Requests queued or running, losers of finished reads included */
+    bool            stopping;
+    hedge_request*  head;
+    hedge_request*  tail;
+
+    /* Primary latencies in microseconds, written by the workers under lock */
+    uint32_t samples[HEDGE_SAMPLES];
+    uint64_t sample_count;
+    uint64_t refreshed_at; /* sample_count when p95_us was computed */
+    uint64_t p95_us;
+
+    /* Settings and counters, PHP thread only */
+    zend_long delay_ms; /* 0 to use p95_us */
+    double    max_rate;
+    double    tokens;
+    uint64_t  reads;
+    uint64_t  hedged;
+    uint64_t  wins;
+    uint64_t  capped;
+};
+
+static void hedge_read_free(hedge_read* read) {
+    for (int i = 0; i < 2; i++) {
+        free(read->requests[i].route_bytes);
+        if (read->results[i]) {
+            free_command_result(read->results[i]);
+        }
+    }
+    free(read->args);
+    free(read);
+}
+
+/* Release a reference to read, called with the lock held; true for the last one */
+static bool hedge_read_unref(hedge_read* read) {
+    return --read->refcount == 0;
+}
+
+static hedge_read* hedge_read_create(enum RequestType     command_type,
+                                     unsigned long        arg_count,
+                                     const uintptr_t*     args,
+                                     const unsigned long* args_len) {
+    size_t bytes = 0;
+    for (unsigned long i = 0; i < arg_count; i++) {
+        bytes += args_len[i];
+    }
+
+    hedge_read* read = calloc(1, sizeof(hedge_read));
+    if (!read) {
+        return NULL;
+    }
+
+    /* Pointers, lengths and bytes of the arguments in a single block */
+    read->args = malloc(arg_count * (sizeof(uintptr_t) + sizeof(unsigned long)) + bytes);
+    if (!read->args) {
+        free(read);
+        return NULL;
+    }
+    read->args_len = (unsigned long*) (read->args + arg_count);
+
+    char* data = (char*) (read->args_len + arg_count);
+    for (unsigned long i = 0; i < arg_count; i++) {
+        memcpy(data, (const char*) args[i], args_len[i]);
+        read->args[i]     = (uintptr_t) data;
+        read->args_len[i] = args_len[i];
+        data += args_len[i];
+    }
+
+    read->command_type = command_type;
+    read->arg_count    = arg_count;
+    read->winner       = -1;
+    read->refcount     = 1;
+    return read;
+}
+
+static void hedge_add_sample(valkey_glide_hedge* hedge, uint64_t us) {
+    hedge->samples[hedge->sample_count % HEDGE_SAMPLES] = (uint32_t) MIN(us, UINT32_MAX);
+    hedge->sample_count++;
+}
+
+static void* hedge_worker(void* arg) {
+    valkey_glide_hedge* hedge = (valkey_glide_hedge*) arg;
+
+    for (;;) {
+        pthread_mutex_lock(&hedge->lock);
+        while (!hedge->head && !hedge->stopping) {
+            pthread_cond_wait(&hedge->request_cond, &hedge->lock);
+        }
+        hedge_request* request = hedge->head;
+        if (!request) {
+            /* Stopping and drained */
+            pthread_mutex_unlock(&hedge->lock);
+            break;
+        }
+        hedge->head = request->next;
+        if (!hedge->head) {
+            hedge->tail = NULL;
+        }
+        pthread_mutex_unlock(&hedge->lock);
+
+        hedge_read*    read     = request->read;
+        uint64_t       start_ns = valkey_glide_slowlog_now();
+        CommandResult* result   = command(hedge->glide_client,
+                                          0,
+                                          read->command_type,
+                                          read->arg_count,
+                                          read->args,
+                                          read->args_len,
+                                          request->route_bytes,
+                                          request->route_bytes_len,
+                                          request->span_ptr);
+        uint64_t       us       = (valkey_glide_slowlog_now() - start_ns) / 1000;
+
+        valkey_glide_drop_span(request->span_ptr);
+
+        pthread_mutex_lock(&hedge->lock);
+        hedge->busy--;
+        if (request->index == 0) {
+            hedge_add_sample(hedge, us);
+        }
+        read->results[request->index] = result;
+        read->completed++;
+        if (read->winner < 0 && result && !result->command_error) {
+            read->winner = request->index;
+        }
+        pthread_cond_broadcast(&hedge->done_cond);
+        bool last = hedge_read_unref(read);
+        pthread_mutex_unlock(&hedge->lock);
+
+        if (last) {
+            hedge_read_free(read);
+        }
+    }
+
+    return NULL;
+}
+
+static int hedge_compare_samples(const void* a, const void* b) {
+    uint32_t x = *(const uint32_t*) a;
+    uint32_t y = *(const uint32_t*) b;
+    return x < y ? -1 : x > y;
+}
+
+/* Microseconds to wait for the primary, HEDGE_NO_DELAY while the p95 is still unknown */
+static uint64_t hedge_delay_us(valkey_glide_hedge* hedge) {
+    if (hedge->delay_ms > 0) {
+        return (uint64_t) hedge->delay_ms * 1000;
+    }
+
+    pthread_mutex_lock(&hedge->lock);
+    if (hedge->sample_count - hedge->refreshed_at >= HEDGE_REFRESH) {
+        uint32_t sorted[HEDGE_SAMPLES];
+        size_t   count = MIN(hedge->sample_count, HEDGE_SAMPLES);
+
+        memcpy(sorted, hedge->samples, count * sizeof(uint32_t));
+        qsort(sorted, count, sizeof(uint32_t), hedge_compare_samples);
+        hedge->p95_us       = MAX(sorted[count * 95 / 100], HEDGE_MIN_DELAY_US);
+        hedge->refreshed_at = hedge->sample_count;
+    }
+    uint64_t delay_us = hedge->p95_us ? hedge->p95_us : HEDGE_NO_DELAY;
+    pthread_mutex_unlock(&hedge->lock);
+
+    return delay_us;
+}
+
+/* Queue the request index of read, called with the lock held */
+static void hedge_send(valkey_glide_hedge* hedge, hedge_read* read, int index) {
+    hedge_request* request = &read->requests[index];
+
+    request->read  = read;
+    request->index = index;
+    request->next  = NULL;
+    if (hedge->tail) {
+        hedge->tail->next = request;
+    } else {
+        hedge->head = request;
+    }
+    hedge->tail = request;
+
+    read->sent++;
+    read->refcount++;
+    hedge->busy++;
+    pthread_cond_signal(&hedge->request_cond);
+}
+
+/* Route bytes to slot on the heap of the workers */
+static bool hedge_route(hedge_request* request, uint16_t slot, bool replica) {
+    size_t   len   = 0;
+    uint8_t* route = valkey_glide_slot_route_bytes(slot, replica, &len);
+    if (!route) {
+        return false;
+    }
+
+    request->route_bytes = malloc(len);
+    if (request->route_bytes) {
+        memcpy(request->route_bytes, route, len);
+        request->route_bytes_len = len;
+    }
+    efree(route);
+    return request->route_bytes != NULL;
+}
+
+/*
+ * A read that can't be hedged, sent on the calling thread under the default routing. Counted as
+ * capped when it took longer than the hedge delay.
+ */
+static CommandResult* hedge_command_inline(valkey_glide_hedge*  hedge,
+                                           enum RequestType     command_type,
+                                           unsigned long        arg_count,
+                                           const uintptr_t*     args,
+                                           const unsigned long* args_len,
+                                           uint64_t             delay_us,
+                                           uint64_t             span_ptr) {
+    uint64_t       start_ns = valkey_glide_slowlog_now();
+    CommandResult* result   = command(hedge->glide_client,
+                                    0, /* callback_index (not used for sync) */
+                                    command_type,
+                                    arg_count,
+                                    args,
+                                    args_len,
+                                    NULL,
+                                    0,
+                                    span_ptr);
+    uint64_t       us       = (valkey_glide_slowlog_now() - start_ns) / 1000;
+
+    valkey_glide_drop_span(span_ptr);
+
+    pthread_mutex_lock(&hedge->lock);
+    hedge_add_sample(hedge, us);
+    pthread_mutex_unlock(&hedge->lock);
+
+    if (delay_us != HEDGE_NO_DELAY && us > delay_us) {
+        hedge->capped++;
+    }
+    return result;
+}
+
+CommandResult* valkey_glide_hedge_command(valkey_glide_hedge*  hedge,
+                                          enum RequestType     command_type,
+                                          unsigned long        arg_count,
+                                          const uintptr_t*     args,
+                                          const unsigned long* args_len,
+                                          uint16_t             slot,
+                                          uint64_t             span_ptr,
+                                          bool*                replica) {
+    *replica = false;
+
+    hedge->reads++;
+    hedge->tokens = MIN(hedge->tokens + hedge->max_rate, HEDGE_BURST);
+
+    uint64_t delay_us = hedge_delay_us(hedge);
+
+    /*
+     * The primary goes to a worker only when a hedge could follow: the delay is known, the cap
+     * has a token and a second worker is idle. Losing requests keep their worker until their
+     * reply comes, so they count against hedging until then.
+     */
+    pthread_mutex_lock(&hedge->lock);
+    bool hedgeable = delay_us != HEDGE_NO_DELAY && hedge->tokens >= 1.0 &&
+                     hedge->thread_count - hedge->busy >= 2;
+    pthread_mutex_unlock(&hedge->lock);
+
+    if (!hedgeable) {
+        return hedge_command_inline(
+            hedge, command_type, arg_count, args, args_len, delay_us, span_ptr);
+    }
+
+    hedge_read* read = hedge_read_create(command_type, arg_count, args, args_len);
+    if (!read || !hedge_route(&read->requests[0], slot, false)) {
+        VALKEY_LOG_ERROR("hedged_reads", "Failed to allocate a hedged read");
+        if (read) {
+            hedge_read_free(read);
+        }
+        return hedge_command_inline(
+            hedge, command_type, arg_count, args, args_len, delay_us, span_ptr);
+    }
+    read->requests[0].span_ptr = span_ptr;
+
+    pthread_mutex_lock(&hedge->lock);
+    hedge_send(hedge, read, 0);
+
+    struct timespec until;
+    clock_gettime(CLOCK_REALTIME, &until);
+    until.tv_sec += delay_us / 1000000;
+    until.tv_nsec += (long) (delay_us % 1000000) * 1000;
+    if (until.tv_nsec >= 1000000000L) {
+        until.tv_sec++;
+        until.tv_nsec -= 1000000000L;
+    }
+
+    int rc = 0;
+    while (read->winner < 0 && read->completed < read->sent && rc != ETIMEDOUT) {
+        rc = pthread_cond_timedwait(&hedge->done_cond, &hedge->lock, &until);
+    }
+
+    /* The primary is late: hedge while a worker is idle and the cap allows it */
+    if (read->winner < 0 && read->completed < read->sent) {
+        if (hedge->tokens < 1.0 || hedge->busy >= hedge->thread_count) {
+            hedge->capped++;
+        } else if (hedge_route(&read->requests[1], slot, true)) {
+            hedge->tokens -= 1.0;
+            hedge->hedged++;
+            hedge_send(hedge, read, 1);
+        }
+    }
+
+    /* The first success wins; when every request failed, the primary's error is returned */
+    while (read->winner < 0 && read->completed < read->sent) {
+        pthread_cond_wait(&hedge->done_cond, &hedge->lock);
+    }
+    int            taken  = read->winner >= 0 ? read->winner : 0;
+    CommandResult* result = read->results[taken];
+    read->results[taken]  = NULL;
+    if (taken == 1) {
+        hedge->wins++;
+    }
+    *replica  = taken == 1;
+    bool last = hedge_read_unref(read);
+    pthread_mutex_unlock(&hedge->lock);
+
+    if (last) {
+        hedge_read_free(read);
+    }
+    return result;
+}
+
+static valkey_glide_hedge* hedge_start(const void* glide_client) {
+    valkey_glide_hedge* hedge = calloc(1, sizeof(valkey_glide_hedge));
+    if (!hedge) {
+        return NULL;
+    }
+
+    hedge->glide_client = glide_client;
+    hedge->max_rate     = HEDGE_MAX_RATE;
+    hedge->tokens       = 1.0;
+    pthread_mutex_init(&hedge->lock, NULL);
+    pthread_cond_init(&hedge->request_cond, NULL);
+    pthread_cond_init(&hedge->done_cond, NULL);
+
+    for (int i = 0; i < VALKEY_GLIDE_HEDGE_THREADS; i++) {
+        if (pthread_create(&hedge->threads[i], NULL, hedge_worker, hedge) != 0) {
+            break;
+        }
+        hedge->thread_count++;
+    }
+
+    /* Both requests of a read must be able to run at once */
+    if (hedge->thread_count < 2) {
+        pthread_mutex_lock(&hedge->lock);
+        hedge->stopping = true;
+        pthread_cond_broadcast(&hedge->request_cond);
+        pthread_mutex_unlock(&hedge->lock);
+        for (int i = 0; i < hedge->thread_count; i++) {
+            pthread_join(hedge->threads[i], NULL);
+        }
+        pthread_cond_destroy(&hedge->done_cond);
+        pthread_cond_destroy(&hedge->request_cond);
+        pthread_mutex_destroy(&hedge->lock);
+        free(hedge);
+        return NULL;
+    }
+
+    return hedge;
+}
+
+bool valkey_glide_set_hedged_reads(valkey_glide_object* valkey_glide, zval* value, bool cluster) {
+    zend_long delay_ms = 0;
+    double    max_rate = HEDGE_MAX_RATE;
+
+    if (!zval_is_true(value)) {
+        valkey_glide_hedge_release(valkey_glide);
+        return true;
+    }
+
+    /* Replicas are addressed by slot, which only cluster clients route by */
+    if (!cluster || !valkey_glide->glide_client) {
+        return false;
+    }
+
+    /* Workers are registered by the client handle */
+    if (valkey_glide_refuse_shared(valkey_glide, "OPT_HEDGED_READS")) {
+        return false;
+    }
+
+    /* The client was told to keep reads on the primaries */
+    if (valkey_glide->read_from == VALKEY_GLIDE_READ_FROM_PRIMARY) {
+        return false;
+    }
+
+    if (Z_TYPE_P(value) == IS_LONG) {
+        delay_ms = Z_LVAL_P(value);
+    } else if (Z_TYPE_P(value) == IS_ARRAY) {
+        zval* delay = zend_hash_str_find(Z_ARRVAL_P(value), "delay", sizeof("delay") - 1);
+        zval* rate  = zend_hash_str_find(Z_ARRVAL_P(value), "max_rate", sizeof("max_rate") - 1);
+        if (delay) {
+            delay_ms = zval_get_long(delay);
+        }
+        if (rate) {
+            max_rate = zval_get_double(rate);
+        }
+    } else if (Z_TYPE_P(value) != IS_TRUE) {
+        return false;
+    }
+
+    if (delay_ms < 0 || max_rate <= 0.0 || max_rate > 1.0) {
+        return false;
+    }
+
+    valkey_glide_hedge* hedge = valkey_glide->hedge;
+    if (!hedge) {
+        hedge = hedge_start(valkey_glide->glide_client);
+        if (!hedge) {
+            VALKEY_LOG_ERROR("hedged_reads", "Failed to start hedged read workers");
+            return false;
+        }
+        valkey_glide->hedge = hedge;
+        zend_hash_index_update_ptr(&VALKEY_GLIDE_G(hedges),
+                                   (zend_ulong) (uintptr_t) valkey_glide->glide_client,
+                                   hedge);
+    }
+
+    hedge->delay_ms = delay_ms;
+    hedge->max_rate = max_rate;
+    return true;
+}
+
+void valkey_glide_hedged_reads_option(valkey_glide_object* valkey_glide, zval* return_value) {
+    if (!valkey_glide->hedge) {
+        RETURN_FALSE;
+    }
+
+    array_init_size(return_value, 2);
+    add_assoc_long(return_value, "delay", valkey_glide->hedge->delay_ms);
+    add_assoc_double(return_value, "max_rate", valkey_glide->hedge->max_rate);
+}
+
+bool valkey_glide_hedge_stats(valkey_glide_object* valkey_glide, zval* return_value) {
+    valkey_glide_hedge* hedge = valkey_glide->hedge;
+    if (!hedge) {
+        return false;
+    }
+
+    uint64_t delay_us = hedge_delay_us(hedge);
+
+    array_init_size(return_value, 5);
+    add_assoc_long(return_value, "reads", (zend_long) hedge->reads);
+    add_assoc_long(return_value, "hedged", (zend_long) hedge->hedged);
+    add_assoc_long(return_value, "wins", (zend_long) hedge->wins);
+    add_assoc_long(return_value, "capped", (zend_long) hedge->capped);
+    if (delay_us == HEDGE_NO_DELAY) {
+        add_assoc_null(return_value, "delay_ms");
+    } else {
+        add_assoc_double(return_value, "delay_ms", delay_us / 1000.0);
+    }
+    return true;
+}
+
+void valkey_glide_hedge_release(valkey_glide_object* valkey_glide) {
+    valkey_glide_hedge* hedge = valkey_glide->hedge;
+    if (!hedge) {
+        return;
+    }
+    valkey_glide->hedge = NULL;
+
+    /* Objects sharing a client hedge with the workers registered last */
+    zend_ulong index      = (zend_ulong) (uintptr_t) hedge->glide_client;
+    void*      registered = zend_hash_index_find_ptr(&VALKEY_GLIDE_G(hedges), index);
+    if (registered == hedge) {
+        zend_hash_index_del(&VALKEY_GLIDE_G(hedges), index);
+    }
+
+    /* Workers finish the requests in flight before exiting, so none outlives the glide client */
+    pthread_mutex_lock(&hedge->lock);
+    hedge->stopping = true;
+    pthread_cond_broadcast(&hedge->request_cond);
+    pthread_mutex_unlock(&hedge->lock);
+
+    for (int i = 0; i < hedge->thread_count; i++) {
+        pthread_join(hedge->threads[i], NULL);
+    }
+
+    pthread_cond_destroy(&hedge->done_cond);
+    pthread_cond_destroy(&hedge->request_cond);
+    pthread_mutex_destroy(&hedge->lock);
+    free(hedge);
+}
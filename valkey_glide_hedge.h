@@ -0,0 +1,71 @@
+/** Copyright Valkey GLIDE Project Contributors - SPDX Identifier: Apache-2.0 */
+
+#ifndef VALKEY_GLIDE_HEDGE_H
+#define VALKEY_GLIDE_HEDGE_H
+
+#include "common.h"
+#include "include/glide_bindings.h"
+
+/*
+ * Hedged reads, OPT_HEDGED_READS on cluster clients.
+ *
+ * A repeatable read of a single slot is sent to the slot's primary by a worker thread while the
+ * caller waits. When no reply came within the hedge delay, a fixed one or the p95 of the recent
+ * primary latencies, the same read is sent with a slot route to the slot's replicas, which
+ * glide-core picks among round robin without regard to the client's read_from or availability
+ * zone; the first successful reply is returned. The other one is released by the worker
+ * receiving it, which stays busy until then. A token bucket caps hedges to a fraction of the
+ * reads, so a slow cluster doesn't see its read load doubled. Clients configured with
+ * READ_FROM_PRIMARY keep replicas out of their reads and can't turn hedging on.
+ *
+ * A read goes through the workers only when it could be hedged: the delay is known, the bucket
+ * has a token and two workers are idle. Otherwise it is sent from the calling thread, so busy
+ * workers never queue reads behind each other.
+ *
+ * The workers, samples and counters belong to the client object: its workers are started when
+ * hedging is turned on and joined when it is turned off or the object is freed, and a learned
+ * delay starts over with every object, known after its first 32 reads. Under FPM that is once per
+ * request, so short requests are better served by a fixed delay.
+ */
+#define VALKEY_GLIDE_HEDGE_THREADS 4 /* Requests of hedged reads in flight at once */
+
+typedef struct valkey_glide_hedge valkey_glide_hedge;
+
+/* Hedging state of glide_client, NULL if its reads aren't hedged */
+static inline valkey_glide_hedge* valkey_glide_hedge_find(const void* glide_client) {
+    if (EXPECTED(zend_hash_num_elements(&VALKEY_GLIDE_G(hedges)) == 0)) {
+        return NULL;
+    }
+    return zend_hash_index_find_ptr(&VALKEY_GLIDE_G(hedges), (zend_ulong) (uintptr_t) glide_client);
+}
+
+/*
+ * Send a read of slot to its primary, then to a replica once the hedge delay has passed.
+ * replica is set when the reply returned is the replica's.
+ */
+CommandResult* valkey_glide_hedge_command(valkey_glide_hedge*  hedge,
+                                          enum RequestType     command_type,
+                                          unsigned long        arg_count,
+                                          const uintptr_t*     args,
+                                          const unsigned long* args_len,
+                                          uint16_t             slot,
+                                          uint64_t             span_ptr,
+                                          bool*                replica);
+
+/*
+ * setOption(OPT_HEDGED_READS, $value): true for a delay learned from the primary latencies, a
+ * delay in milliseconds, or ['delay' => ms or 0 to learn it, 'max_rate' => fraction of reads].
+ * False stops hedging. Cluster clients only.
+ */
+bool valkey_glide_set_hedged_reads(valkey_glide_object* valkey_glide, zval* value, bool cluster);
+
+/* getOption(OPT_HEDGED_READS): the settings as an array, false while hedging is off */
+void valkey_glide_hedged_reads_option(valkey_glide_object* valkey_glide, zval* return_value);
+
+/* getHedgeStats() counters, false while hedging is off */
+bool valkey_glide_hedge_stats(valkey_glide_object* valkey_glide, zval* return_value);
+
+/* Stop hedging, waiting for the requests in flight, when the object is freed */
+void valkey_glide_hedge_release(valkey_glide_object* valkey_glide);
+
+#endif /* VALKEY_GLIDE_HEDGE_H */
@@ -0,0 +1,331 @@
+/** Copyright Valkey GLIDE Project Contributors - SPDX Identifier: Apache-2.0 */
+
+#include "valkey_glide_hot_keys.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <zend_exceptions.h>
+
+#include "valkey_glide_slot.h"
+
+/* A tracked key, estimates are in samples until reported */
+typedef struct {
+    zend_string* key;
+    uint64_t     count;
+    uint64_t     bytes;
+} hot_key_entry;
+
+struct valkey_glide_hot_keys {
+    double   sample_rate;
+    uint64_t threshold; /* Sample when the next random value is below, UINT64_MAX for all */
+    uint64_t rng_state;
+    uint64_t samples;
+
+    uint32_t counts[VALKEY_GLIDE_HOT_KEYS_DEPTH][VALKEY_GLIDE_HOT_KEYS_WIDTH];
+    uint64_t bytes[VALKEY_GLIDE_HOT_KEYS_DEPTH][VALKEY_GLIDE_HOT_KEYS_WIDTH];
+
+    /* Min-heap on count, the root is the first key to give way to a hotter one */
+    hot_key_entry heap[VALKEY_GLIDE_HOT_KEYS_CAPACITY];
+    int           heap_size;
+
+    /* Cluster clients only: samples and request bytes per hash slot */
+    uint32_t* slot_counts;
+    uint64_t* slot_bytes;
+};
+
+static uint64_t hot_keys_next_random(valkey_glide_hot_keys* hot_keys) {
+    /* xorshift64* */
+    uint64_t x = hot_keys->rng_state;
+    x ^= x >> 12;
+    x ^= x << 25;
+    x ^= x >> 27;
+    hot_keys->rng_state = x;
+    return x * 0x2545F4914F6CDD1DULL;
+}
+
+static uint64_t hot_keys_mix(uint64_t h) {
+    /* splitmix64 finalizer */
+    h ^= h >> 30;
+    h *= 0xBF58476D1CE4E5B9ULL;
+    h ^= h >> 27;
+    h *= 0x94D049BB133111EBULL;
+    h ^= h >> 31;
+    return h;
+}
+
+valkey_glide_hot_keys* valkey_glide_hot_keys_create(double sample_rate, bool per_slot) {
+    valkey_glide_hot_keys* hot_keys = ecalloc(1, sizeof(valkey_glide_hot_keys));
+
+    hot_keys->sample_rate = sample_rate;
+    hot_keys->threshold =
+        sample_rate >= 1.0 ? UINT64_MAX : (uint64_t) (sample_rate * 18446744073709551616.0);
+    hot_keys->rng_state = hot_keys_mix((uint64_t) (uintptr_t) hot_keys ^ (uint64_t) time(NULL));
+    if (hot_keys->rng_state == 0) {
+        hot_keys->rng_state = 0x9E3779B97F4A7C15ULL;
+    }
+
+    if (per_slot) {
+        hot_keys->slot_counts = ecalloc(VALKEY_GLIDE_CLUSTER_SLOTS, sizeof(uint32_t));
+        hot_keys->slot_bytes  = ecalloc(VALKEY_GLIDE_CLUSTER_SLOTS, sizeof(uint64_t));
+    }
+
+    return hot_keys;
+}
+
+void valkey_glide_hot_keys_destroy(valkey_glide_hot_keys* hot_keys) {
+    if (!hot_keys) {
+        return;
+    }
+
+    for (int i = 0; i < hot_keys->heap_size; i++) {
+        zend_string_release(hot_keys->heap[i].key);
+    }
+    if (hot_keys->slot_counts) {
+        efree(hot_keys->slot_counts);
+        efree(hot_keys->slot_bytes);
+    }
+    efree(hot_keys);
+}
+
+double valkey_glide_hot_keys_sample_rate(const valkey_glide_hot_keys* hot_keys) {
+    return hot_keys ? hot_keys->sample_rate : 0.0;
+}
+
+static void hot_keys_sift_down(valkey_glide_hot_keys* hot_keys, int pos) {
+    hot_key_entry* heap = hot_keys->heap;
+
+    for (;;) {
+        int smallest = pos;
+        int left     = 2 * pos + 1;
+        int right    = left + 1;
+
+        if (left < hot_keys->heap_size && heap[left].count < heap[smallest].count) {
+            smallest = left;
+        }
+        if (right < hot_keys->heap_size && heap[right].count < heap[smallest].count) {
+            smallest = right;
+        }
+        if (smallest == pos) {
+            return;
+        }
+
+        hot_key_entry tmp = heap[pos];
+        heap[pos]         = heap[smallest];
+        heap[smallest]    = tmp;
+        pos               = smallest;
+    }
+}
+
+static void hot_keys_sift_up(valkey_glide_hot_keys* hot_keys, int pos) {
+    hot_key_entry* heap = hot_keys->heap;
+
+    while (pos > 0) {
+        int parent = (pos - 1) / 2;
+        if (heap[parent].count <= heap[pos].count) {
+            return;
+        }
+
+        hot_key_entry tmp = heap[pos];
+        heap[pos]         = heap[parent];
+        heap[parent]      = tmp;
+        pos               = parent;
+    }
+}
+
+void valkey_glide_hot_keys_sample(valkey_glide_hot_keys* hot_keys,
+                                  const char*            key,
+                                  size_t                 key_len,
+                                  const unsigned long*   args_len,
+                                  int                    arg_count) {
+    if (hot_keys->threshold != UINT64_MAX &&
+        hot_keys_next_random(hot_keys) >= hot_keys->threshold) {
+        return;
+    }
+
+    uint64_t request_bytes = 0;
+    for (int i = 0; args_len && i < arg_count; i++) {
+        request_bytes += args_len[i];
+    }
+    hot_keys->samples++;
+
+    /* Count-min update, rows indexed by double hashing */
+    zend_ulong hash  = zend_inline_hash_func(key, key_len);
+    uint64_t   h1    = hot_keys_mix((uint64_t) hash);
+    uint64_t   h2    = hot_keys_mix(h1) | 1;
+    uint64_t   count = UINT64_MAX;
+    uint64_t   bytes = UINT64_MAX;
+
+    for (int row = 0; row < VALKEY_GLIDE_HOT_KEYS_DEPTH; row++) {
+        size_t col = (size_t) ((h1 + (uint64_t) row * h2) & (VALKEY_GLIDE_HOT_KEYS_WIDTH - 1));
+
+        if (hot_keys->counts[row][col] < UINT32_MAX) {
+            hot_keys->counts[row][col]++;
+        }
+        hot_keys->bytes[row][col] += request_bytes;
+
+        count = MIN(count, hot_keys->counts[row][col]);
+        bytes = MIN(bytes, hot_keys->bytes[row][col]);
+    }
+
+    if (hot_keys->slot_counts) {
+        uint16_t slot = valkey_glide_key_slot(key, key_len);
+        hot_keys->slot_counts[slot]++;
+        hot_keys->slot_bytes[slot] += request_bytes;
+    }
+
+    /* Refresh the key if it is already tracked */
+    for (int i = 0; i < hot_keys->heap_size; i++) {
+        zend_string* tracked = hot_keys->heap[i].key;
+        if (ZSTR_H(tracked) == hash && ZSTR_LEN(tracked) == key_len &&
+            memcmp(ZSTR_VAL(tracked), key, key_len) == 0) {
+            hot_keys->heap[i].count = count;
+            hot_keys->heap[i].bytes = bytes;
+            hot_keys_sift_down(hot_keys, i);
+            return;
+        }
+    }
+
+    /* Track it while there is room, or in place of the coolest tracked key */
+    bool evict = hot_keys->heap_size == VALKEY_GLIDE_HOT_KEYS_CAPACITY;
+    if (evict && count <= hot_keys->heap[0].count) {
+        return;
+    }
+
+    hot_key_entry* entry = evict ? &hot_keys->heap[0] : &hot_keys->heap[hot_keys->heap_size++];
+    if (evict) {
+        zend_string_release(entry->key);
+    }
+    entry->key         = zend_string_init(key, key_len, 0);
+    ZSTR_H(entry->key) = hash;
+    entry->count       = count;
+    entry->bytes       = bytes;
+
+    if (evict) {
+        hot_keys_sift_down(hot_keys, 0);
+    } else {
+        hot_keys_sift_up(hot_keys, hot_keys->heap_size - 1);
+    }
+}
+
+bool valkey_glide_set_hot_key_sampling(valkey_glide_object* valkey_glide,
+                                       zval*                value,
+                                       bool                 per_slot) {
+    double rate = zval_get_double(value);
+
+    if (!(rate >= 0.0 && rate <= 1.0)) {
+        return false;
+    }
+
+    /* Changing the rate starts over, mixing differently scaled samples would skew estimates */
+    valkey_glide_hot_keys_destroy(valkey_glide->hot_keys);
+    valkey_glide->hot_keys = NULL;
+
+    if (rate > 0.0) {
+        valkey_glide->hot_keys = valkey_glide_hot_keys_create(rate, per_slot);
+    }
+    return true;
+}
+
+static int hot_key_compare(const void* a, const void* b) {
+    const hot_key_entry* left  = (const hot_key_entry*) a;
+    const hot_key_entry* right = (const hot_key_entry*) b;
+
+    if (left->count != right->count) {
+        return left->count < right->count ? 1 : -1;
+    }
+    return left->bytes < right->bytes ? 1 : (left->bytes > right->bytes ? -1 : 0);
+}
+
+/* Scale a sampled figure back to an estimate of all commands */
+static zend_long hot_keys_scale(const valkey_glide_hot_keys* hot_keys, uint64_t sampled) {
+    return (zend_long) ((double) sampled / hot_keys->sample_rate + 0.5);
+}
+
+static void add_hot_slots(const valkey_glide_hot_keys* hot_keys, zend_long n, zval* output) {
+    /* Slots with the most samples, selected with a bounded insertion sort */
+    uint16_t top[VALKEY_GLIDE_HOT_KEYS_CAPACITY];
+    int      top_count = 0;
+
+    for (uint32_t slot = 0; slot < VALKEY_GLIDE_CLUSTER_SLOTS; slot++) {
+        uint32_t count = hot_keys->slot_counts[slot];
+        if (count == 0 ||
+            (top_count == n && count <= hot_keys->slot_counts[top[top_count - 1]])) {
+            continue;
+        }
+
+        int pos = top_count < n ? top_count++ : top_count - 1;
+        while (pos > 0 && hot_keys->slot_counts[top[pos - 1]] < count) {
+            top[pos] = top[pos - 1];
+            pos--;
+        }
+        top[pos] = (uint16_t) slot;
+    }
+
+    zval slots;
+    array_init_size(&slots, top_count);
+    for (int i = 0; i < top_count; i++) {
+        zval entry;
+        array_init(&entry);
+        add_assoc_long(&entry, "count", hot_keys_scale(hot_keys, hot_keys->slot_counts[top[i]]));
+        add_assoc_long(&entry, "bytes", hot_keys_scale(hot_keys, hot_keys->slot_bytes[top[i]]));
+        add_index_zval(&slots, top[i], &entry);
+    }
+    add_assoc_zval(output, "slots", &slots);
+}
+
+int execute_get_hot_keys_command(zval*             object,
+                                 int               argc,
+                                 zval*             return_value,
+                                 zend_class_entry* ce) {
+    zend_long n = 10;
+
+    if (zend_parse_method_parameters(argc, object, "O|l", &object, ce, &n) == FAILURE) {
+        return 0;
+    }
+
+    if (n <= 0) {
+        zend_throw_exception(
+            get_valkey_glide_exception_ce(), "Number of hot keys must be greater than 0", 0);
+        return 0;
+    }
+    n = MIN(n, VALKEY_GLIDE_HOT_KEYS_CAPACITY);
+
+    valkey_glide_object* valkey_glide =
+        VALKEY_GLIDE_PHP_ZVAL_GET_OBJECT(valkey_glide_object, object);
+    if (!valkey_glide || !valkey_glide->hot_keys) {
+        /* Sampling is off */
+        return 0;
+    }
+
+    const valkey_glide_hot_keys* hot_keys = valkey_glide->hot_keys;
+    hot_key_entry                sorted[VALKEY_GLIDE_HOT_KEYS_CAPACITY];
+    int                          count = hot_keys->heap_size;
+
+    memcpy(sorted, hot_keys->heap, count * sizeof(hot_key_entry));
+    qsort(sorted, count, sizeof(hot_key_entry), hot_key_compare);
+    count = MIN(count, (int) n);
+
+    array_init(return_value);
+    add_assoc_double(return_value, "sample_rate", hot_keys->sample_rate);
+    add_assoc_long(return_value, "samples", (zend_long) hot_keys->samples);
+
+    /* A list rather than a map, numeric keys would otherwise turn into integers */
+    zval keys;
+    array_init_size(&keys, count);
+    for (int i = 0; i < count; i++) {
+        zval entry;
+        array_init(&entry);
+        add_assoc_str(&entry, "key", zend_string_copy(sorted[i].key));
+        add_assoc_long(&entry, "count", hot_keys_scale(hot_keys, sorted[i].count));
+        add_assoc_long(&entry, "bytes", hot_keys_scale(hot_keys, sorted[i].bytes));
+        add_next_index_zval(&keys, &entry);
+    }
+    add_assoc_zval(return_value, "keys", &keys);
+
+    if (hot_keys->slot_counts) {
+        add_hot_slots(hot_keys, n, return_value);
+    }
+
+    return 1;
+}
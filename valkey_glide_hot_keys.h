@@ -0,0 +1,68 @@
+/** Copyright Valkey GLIDE Project Contributors - SPDX Identifier: Apache-2.0 */
+
+#ifndef VALKEY_GLIDE_HOT_KEYS_H
+#define VALKEY_GLIDE_HOT_KEYS_H
+
+#include "common.h"
+
+/*
+ * Sampled hot-key detector.
+ *
+ * With OPT_HOT_KEY_SAMPLING set to a rate in (0, 1], that fraction of the commands issued
+ * through a client feed their key and request size into a count-min sketch. The keys with the
+ * highest estimates are kept in a small min-heap and reported by getHotKeys(), scaled back by
+ * the sampling rate. Cluster clients also total the samples per hash slot.
+ */
+#define VALKEY_GLIDE_HOT_KEYS_CAPACITY 64 /* Keys tracked, the most getHotKeys() returns */
+#define VALKEY_GLIDE_HOT_KEYS_DEPTH 4
+#define VALKEY_GLIDE_HOT_KEYS_WIDTH 1024 /* Power of two */
+
+typedef struct valkey_glide_hot_keys valkey_glide_hot_keys;
+
+valkey_glide_hot_keys* valkey_glide_hot_keys_create(double sample_rate, bool per_slot);
+void                   valkey_glide_hot_keys_destroy(valkey_glide_hot_keys* hot_keys);
+double                 valkey_glide_hot_keys_sample_rate(const valkey_glide_hot_keys* hot_keys);
+
+/* Draw a sample and, if selected, count the key. args_len holds the command's argument sizes */
+void valkey_glide_hot_keys_sample(valkey_glide_hot_keys* hot_keys,
+                                  const char*            key,
+                                  size_t                 key_len,
+                                  const unsigned long*   args_len,
+                                  int                    arg_count);
+
+/* Called by the command executors, costs a pointer test while sampling is off */
+static inline void valkey_glide_hot_keys_record(valkey_glide_object* valkey_glide,
+                                                const char*          key,
+                                                size_t               key_len,
+                                                const unsigned long* args_len,
+                                                int                  arg_count) {
+    if (UNEXPECTED(valkey_glide->hot_keys != NULL) && key && key_len > 0) {
+        valkey_glide_hot_keys_sample(valkey_glide->hot_keys, key, key_len, args_len, arg_count);
+    }
+}
+
+/* setOption(OPT_HOT_KEY_SAMPLING, $rate): 0 stops sampling, any other rate restarts it */
+bool valkey_glide_set_hot_key_sampling(valkey_glide_object* valkey_glide,
+                                       zval*                value,
+                                       bool                 per_slot);
+
+int execute_get_hot_keys_command(zval*             object,
+                                 int               argc,
+                                 zval*             return_value,
+                                 zend_class_entry* ce);
+
+#define GET_HOT_KEYS_METHOD_IMPL(class_name)                                            \
+    PHP_METHOD(class_name, getHotKeys) {                                                \
+        if (execute_get_hot_keys_command(getThis(),                                     \
+                                         ZEND_NUM_ARGS(),                               \
+                                         return_value,                                  \
+                                         strcmp(#class_name, "ValkeyGlideCluster") == 0 \
+                                             ? get_valkey_glide_cluster_ce()            \
+                                             : get_valkey_glide_ce())) {                \
+            return;                                                                     \
+        }                                                                               \
+        zval_dtor(return_value);                                                        \
+        RETURN_FALSE;                                                                   \
+    }
+
+#endif /* VALKEY_GLIDE_HOT_KEYS_H */
@@ -0,0 +1,540 @@
+/*
+  +----------------------------------------------------------------------+
+  | Copyright (c) 2023-2025 The PHP Group                                |
+  +----------------------------------------------------------------------+
+  | This source file is subject to version 3.01 of the PHP license,      |
+  | that is bundled with this package in the file LICENSE, and is        |
+  | available through the world-wide-web at the following url:           |
+  | http://www.php.net/license/3_01.txt                                  |
+  | If you did not receive a copy of the PHP license and are unable to   |
+  | obtain it through the world-wide-web, please send a note to          |
+  | license@php.net so we can mail you a copy immediately.               |
+  +----------------------------------------------------------------------+
+*/
+
+#include <errno.h>
+#include <fcntl.h>
+#include <fopen_wrappers.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+#include <zend.h>
+#include <zend_API.h>
+#include <zend_exceptions.h>
+
+#include "command_response.h"
+#include "include/glide_bindings.h"
+#include "logger.h"
+#include "valkey_glide_bloom.h"
+#include "valkey_glide_commands_common.h"
+
+/* ====================================================================
+ * BULK INGEST
+ *
+ * ingestFile() maps the input file read-only and parses it in place: every
+ * argument handed to batch() points straight into the mapping, so nothing
+ * is copied and no PHP values are created per command. Commands are sent as
+ * non-atomic batches of at most `window` commands. The reported offset is
+ * always the byte position just past the last acknowledged batch, so a
+ * failed or interrupted run can be resumed by passing it back in.
+ * ==================================================================== */
+
+#define INGEST_FORMAT_RESP 0
+#define INGEST_FORMAT_CSV 1
+#define INGEST_FORMAT_TSV 2
+
+#define INGEST_DEFAULT_WINDOW 1000
+#define INGEST_MAX_WINDOW 100000
+
+/* Parser results */
+#define INGEST_PARSE_OK 1
+#define INGEST_PARSE_EOF 0
+#define INGEST_PARSE_ERROR -1
+
+/* Arguments of the window currently being assembled */
+typedef struct {
+    const uint8_t**  args;       /* Flat argument pointer pool for the window */
+    uintptr_t*       args_len;   /* Flat argument length pool for the window */
+    size_t           arg_count;  /* Arguments used in the pool */
+    size_t           arg_cap;    /* Pool capacity */
+    size_t*          cmd_start;  /* Index of the first argument of each command */
+    struct CmdInfo*  cmds;       /* Command descriptors */
+    struct CmdInfo** cmd_ptrs;   /* Pointers handed to BatchInfo */
+    size_t           cmd_count;  /* Commands in the window */
+    size_t           window;     /* Maximum commands per window */
+} ingest_window_t;
+
+static void ingest_window_init(ingest_window_t* w, size_t window) {
+    w->window    = window;
+    w->arg_cap   = window * 4;
+    w->arg_count = 0;
+    w->cmd_count = 0;
+    w->args      = (const uint8_t**) emalloc(w->arg_cap * sizeof(uint8_t*));
+    w->args_len  = (uintptr_t*) emalloc(w->arg_cap * sizeof(uintptr_t));
+    w->cmd_start = (size_t*) emalloc(window * sizeof(size_t));
+    w->cmds      = (struct CmdInfo*) emalloc(window * sizeof(struct CmdInfo));
+    w->cmd_ptrs  = (struct CmdInfo**) emalloc(window * sizeof(struct CmdInfo*));
+}
+
+static void ingest_window_free(ingest_window_t* w) {
+    efree(w->args);
+    efree(w->args_len);
+    efree(w->cmd_start);
+    efree(w->cmds);
+    efree(w->cmd_ptrs);
+}
+
+static void ingest_window_reset(ingest_window_t* w) {
+    w->arg_count = 0;
+    w->cmd_count = 0;
+}
+
+static void ingest_window_push_arg(ingest_window_t* w, const uint8_t* arg, size_t len) {
+    if (w->arg_count == w->arg_cap) {
+        w->arg_cap *= 2;
+        w->args     = (const uint8_t**) erealloc(w->args, w->arg_cap * sizeof(uint8_t*));
+        w->args_len = (uintptr_t*) erealloc(w->args_len, w->arg_cap * sizeof(uintptr_t));
+    }
+    w->args[w->arg_count]     = arg;
+    w->args_len[w->arg_count] = len;
+    w->arg_count++;
+}
+
+/* Parse an unsigned decimal terminated by CRLF. Advances *pos past the CRLF. */
+static int ingest_parse_resp_number(const char* data, size_t size, size_t* pos, size_t* out) {
+    size_t p     = *pos;
+    size_t value = 0;
+
+    if (p >= size || data[p] < '0' || data[p] > '9') {
+        return INGEST_PARSE_ERROR;
+    }
+    while (p < size && data[p] >= '0' && data[p] <= '9') {
+        value = value * 10 + (size_t) (data[p] - '0');
+        p++;
+    }
+    if (p + 1 >= size) {
+        return INGEST_PARSE_EOF;
+    }
+    if (data[p] != '\r' || data[p + 1] != '\n') {
+        return INGEST_PARSE_ERROR;
+    }
+
+    *pos = p + 2;
+    *out = value;
+    return INGEST_PARSE_OK;
+}
+
+/*
+ * Parse one RESP command (an array of bulk strings) starting at *pos and add it to the window.
+ * A truncated trailing command is reported as EOF so it is left for a resumed run.
+ */
+static int ingest_parse_resp(const char* data, size_t size, size_t* pos, ingest_window_t* w) {
+    size_t p = *pos;
+    size_t argc, i;
+    int    status;
+
+    /* Tolerate blank lines between commands */
+    while (p < size && (data[p] == '\r' || data[p] == '\n')) {
+        p++;
+    }
+    if (p >= size) {
+        *pos = p;
+        return INGEST_PARSE_EOF;
+    }
+    if (data[p] != '*') {
+        return INGEST_PARSE_ERROR;
+    }
+    p++;
+
+    status = ingest_parse_resp_number(data, size, &p, &argc);
+    if (status != INGEST_PARSE_OK) {
+        return status;
+    }
+    if (argc == 0) {
+        return INGEST_PARSE_ERROR;
+    }
+
+    size_t first_arg = w->arg_count;
+    for (i = 0; i < argc; i++) {
+        size_t len;
+
+        if (p >= size) {
+            w->arg_count = first_arg;
+            return INGEST_PARSE_EOF;
+        }
+        if (data[p] != '$') {
+            w->arg_count = first_arg;
+            return INGEST_PARSE_ERROR;
+        }
+        p++;
+
+        status = ingest_parse_resp_number(data, size, &p, &len);
+        if (status != INGEST_PARSE_OK) {
+            w->arg_count = first_arg;
+            return status;
+        }
+        if (len > size - p || size - p - len < 2) {
+            w->arg_count = first_arg;
+            return INGEST_PARSE_EOF;
+        }
+        if (data[p + len] != '\r' || data[p + len + 1] != '\n') {
+            w->arg_count = first_arg;
+            return INGEST_PARSE_ERROR;
+        }
+
+        ingest_window_push_arg(w, (const uint8_t*) (data + p), len);
+        p += len + 2;
+    }
+
+    w->cmd_start[w->cmd_count]         = first_arg;
+    w->cmds[w->cmd_count].request_type = CustomCommand;
+    w->cmds[w->cmd_count].arg_count    = argc;
+    w->cmd_count++;
+
+    *pos = p;
+    return INGEST_PARSE_OK;
+}
+
+/*
+ * Parse one `key<sep>value[<sep>ttl]` line starting at *pos and add a SET to the window.
+ * Fields are taken verbatim (no quoting). Empty lines and lines starting with '#' are skipped.
+ * A final record without a trailing newline may have been cut short by the writer, so it is
+ * reported as EOF like a truncated RESP command and left for a resumed run.
+ */
+static int ingest_parse_delimited(
+    const char* data, size_t size, size_t* pos, char sep, ingest_window_t* w) {
+    static const uint8_t ex_arg[] = "EX";
+    size_t               p        = *pos;
+
+    for (;;) {
+        if (p >= size) {
+            *pos = p;
+            return INGEST_PARSE_EOF;
+        }
+
+        const char* line = data + p;
+        const char* nl   = memchr(line, '\n', size - p);
+        size_t      len  = nl ? (size_t) (nl - line) : size - p;
+        size_t      next = p + len + (nl ? 1 : 0);
+
+        if (len > 0 && line[len - 1] == '\r') {
+            len--;
+        }
+        if (len == 0 || line[0] == '#') {
+            p = next;
+            continue;
+        }
+        if (!nl) {
+            *pos = p;
+            return INGEST_PARSE_EOF;
+        }
+
+        const char* field[3];
+        size_t      field_len[3];
+        int         fields = 0;
+        const char* start  = line;
+        const char* end    = line + len;
+
+        while (fields < 3) {
+            const char* cut = (fields < 2) ? memchr(start, sep, end - start) : NULL;
+            field[fields]   = start;
+            if (!cut) {
+                field_len[fields++] = end - start;
+                break;
+            }
+            field_len[fields++] = cut - start;
+            start               = cut + 1;
+        }
+
+        if (fields < 2 || field_len[0] == 0) {
+            return INGEST_PARSE_ERROR;
+        }
+
+        size_t first_arg = w->arg_count;
+        ingest_window_push_arg(w, (const uint8_t*) field[0], field_len[0]);
+        ingest_window_push_arg(w, (const uint8_t*) field[1], field_len[1]);
+        if (fields == 3 && field_len[2] > 0) {
+            ingest_window_push_arg(w, ex_arg, sizeof(ex_arg) - 1);
+            ingest_window_push_arg(w, (const uint8_t*) field[2], field_len[2]);
+        }
+
+        w->cmd_start[w->cmd_count]         = first_arg;
+        w->cmds[w->cmd_count].request_type = Set;
+        w->cmds[w->cmd_count].arg_count    = w->arg_count - first_arg;
+        w->cmd_count++;
+
+        *pos = next;
+        return INGEST_PARSE_OK;
+    }
+}
+
+/*
+ * Send the assembled window as one non-atomic batch.
+ * Returns the number of per-command errors, or -1 if the batch itself failed.
+ */
+static long ingest_flush_window(valkey_glide_object* valkey_glide,
+                                ingest_window_t*     w,
+                                char*                error_buf,
+                                size_t               error_buf_len) {
+    size_t i;
+    long   errors = 0;
+
+    /* The pools may have been reallocated while parsing, so bind them only now */
+    for (i = 0; i < w->cmd_count; i++) {
+        w->cmds[i].args     = (const uint8_t* const*) &w->args[w->cmd_start[i]];
+        w->cmds[i].args_len = (const uintptr_t*) &w->args_len[w->cmd_start[i]];
+        w->cmd_ptrs[i]      = &w->cmds[i];
+
+        valkey_glide_bloom_record(valkey_glide->glide_client,
+                                  w->cmds[i].request_type,
+                                  (const uintptr_t*) &w->args[w->cmd_start[i]],
+                                  (const unsigned long*) &w->args_len[w->cmd_start[i]],
+                                  w->cmds[i].arg_count);
+    }
+
+    struct BatchInfo batch_info = {.cmd_count = w->cmd_count,
+                                   .cmds      = (const struct CmdInfo* const*) w->cmd_ptrs,
+                                   .is_atomic = false};
+
+    struct CommandResult* result = batch(valkey_glide->glide_client,
+                                         0, /* callback_index (not used for sync) */
+                                         &batch_info,
+                                         false, /* raise_on_error */
+                                         NULL,  /* options */
+                                         0      /* span_ptr */
+    );
+
+    if (!result) {
+        snprintf(error_buf, error_buf_len, "Batch execution returned no result");
+        return -1;
+    }
+    if (result->command_error) {
+        snprintf(error_buf,
+                 error_buf_len,
+                 "%s",
+                 result->command_error->command_error_message
+                     ? result->command_error->command_error_message
+                     : "Batch execution failed");
+        free_command_result(result);
+        return -1;
+    }
+    if (!result->response || result->response->response_type != Array ||
+        (size_t) result->response->array_value_len != w->cmd_count) {
+        snprintf(error_buf, error_buf_len, "Unexpected batch response");
+        free_command_result(result);
+        return -1;
+    }
+
+    for (i = 0; i < w->cmd_count; i++) {
+        if (result->response->array_value[i].response_type == Error) {
+            errors++;
+        }
+    }
+
+    free_command_result(result);
+    return errors;
+}
+
+static double ingest_now(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double) ts.tv_sec + (double) ts.tv_nsec / 1e9;
+}
+
+/* Execute ingestFile() - bulk load a RESP, CSV or TSV file */
+int execute_ingest_file_command(zval* object, int argc, zval* return_value, zend_class_entry* ce) {
+    valkey_glide_object* valkey_glide;
+    char*                path       = NULL;
+    size_t               path_len   = 0;
+    char*                format     = "resp";
+    size_t               format_len = 4;
+    zend_long            window     = INGEST_DEFAULT_WINDOW;
+    zend_long            offset     = 0;
+    int                  fmt;
+
+    if (zend_parse_method_parameters(argc,
+                                     object,
+                                     "Op|sll",
+                                     &object,
+                                     ce,
+                                     &path,
+                                     &path_len,
+                                     &format,
+                                     &format_len,
+                                     &window,
+                                     &offset) == FAILURE) {
+        return 0;
+    }
+
+    valkey_glide = VALKEY_GLIDE_PHP_ZVAL_GET_OBJECT(valkey_glide_object, object);
+    if (!valkey_glide || !valkey_glide->glide_client) {
+        return 0;
+    }
+
+    if (valkey_glide->is_in_batch_mode) {
+        VALKEY_LOG_ERROR("ingest_file", "ingestFile() cannot be used in batch mode");
+        return 0;
+    }
+
+    if (strcasecmp(format, "resp") == 0) {
+        fmt = INGEST_FORMAT_RESP;
+    } else if (strcasecmp(format, "csv") == 0) {
+        fmt = INGEST_FORMAT_CSV;
+    } else if (strcasecmp(format, "tsv") == 0) {
+        fmt = INGEST_FORMAT_TSV;
+    } else {
+        zend_throw_exception(get_valkey_glide_exception_ce(),
+                             "Invalid ingest format, expected 'resp', 'csv' or 'tsv'",
+                             0);
+        return 0;
+    }
+
+    if (window <= 0 || window > INGEST_MAX_WINDOW) {
+        zend_throw_exception(
+            get_valkey_glide_exception_ce(), "Ingest window must be between 1 and 100000", 0);
+        return 0;
+    }
+
+    /* The file is mapped directly, so the open_basedir check of the stream layer is done here */
+    if (php_check_open_basedir_ex(path, 0) != 0) {
+        zend_throw_exception_ex(get_valkey_glide_exception_ce(),
+                                0,
+                                "Unable to open ingest file '%s': %s",
+                                path,
+                                "open_basedir restriction in effect");
+        return 0;
+    }
+
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        zend_throw_exception_ex(get_valkey_glide_exception_ce(),
+                                0,
+                                "Unable to open ingest file '%s': %s",
+                                path,
+                                strerror(errno));
+        return 0;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        close(fd);
+        zend_throw_exception_ex(
+            get_valkey_glide_exception_ce(), 0, "Unable to stat ingest file: %s", strerror(errno));
+        return 0;
+    }
+
+    size_t size = (size_t) st.st_size;
+    if (offset < 0 || (size_t) offset > size) {
+        close(fd);
+        zend_throw_exception(
+            get_valkey_glide_exception_ce(), "Ingest offset is outside of the file", 0);
+        return 0;
+    }
+
+    const char* data = NULL;
+    if (size > 0) {
+        void* map = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (map == MAP_FAILED) {
+            close(fd);
+            zend_throw_exception_ex(get_valkey_glide_exception_ce(),
+                                    0,
+                                    "Unable to map ingest file: %s",
+                                    strerror(errno));
+            return 0;
+        }
+#ifdef MADV_SEQUENTIAL
+        madvise(map, size, MADV_SEQUENTIAL);
+#endif
+        data = (const char*) map;
+    }
+    close(fd);
+
+    ingest_window_t w;
+    ingest_window_init(&w, (size_t) window);
+
+    char   error_buf[256] = {0};
+    size_t pos            = (size_t) offset;
+    size_t committed      = pos;
+    long   commands       = 0;
+    long   errors         = 0;
+    long   batches        = 0;
+    bool   complete       = false;
+    bool   failed         = false;
+    double started        = ingest_now();
+
+    while (!failed) {
+        int status = INGEST_PARSE_OK;
+
+        while (w.cmd_count < w.window) {
+            status = (fmt == INGEST_FORMAT_RESP)
+                         ? ingest_parse_resp(data, size, &pos, &w)
+                         : ingest_parse_delimited(
+                               data, size, &pos, fmt == INGEST_FORMAT_CSV ? ',' : '\t', &w);
+            if (status != INGEST_PARSE_OK) {
+                break;
+            }
+        }
+
+        if (w.cmd_count > 0) {
+            long batch_errors = ingest_flush_window(valkey_glide, &w, error_buf, sizeof(error_buf));
+            if (batch_errors < 0) {
+                failed = true;
+                break;
+            }
+            commands += (long) w.cmd_count;
+            errors += batch_errors;
+            batches++;
+            committed = pos;
+            ingest_window_reset(&w);
+        }
+
+        if (status == INGEST_PARSE_ERROR) {
+            snprintf(error_buf, sizeof(error_buf), "Malformed input at offset %zu", committed);
+            failed = true;
+        } else if (status == INGEST_PARSE_EOF) {
+            /* A truncated trailing command or record leaves pos short of the end of the file */
+            complete = (pos >= size);
+            if (!complete) {
+                snprintf(
+                    error_buf, sizeof(error_buf), "Truncated input at offset %zu", committed);
+            }
+            break;
+        }
+    }
+
+    double elapsed = ingest_now() - started;
+
+    ingest_window_free(&w);
+    if (data) {
+        munmap((void*) data, size);
+    }
+
+    if (failed) {
+        VALKEY_LOG_WARN_FMT("ingest_file", "ingestFile() stopped: %s", error_buf);
+    }
+
+    array_init(return_value);
+    add_assoc_long(return_value, "commands", commands);
+    add_assoc_long(return_value, "errors", errors);
+    add_assoc_long(return_value, "batches", batches);
+    add_assoc_long(return_value, "bytes", (zend_long) (committed - (size_t) offset));
+    add_assoc_long(return_value, "offset", (zend_long) committed);
+    add_assoc_long(return_value, "size", (zend_long) size);
+    add_assoc_bool(return_value, "complete", complete);
+    add_assoc_double(return_value, "elapsed", elapsed);
+    add_assoc_double(return_value, "commands_per_sec", elapsed > 0 ? commands / elapsed : 0.0);
+    add_assoc_double(return_value,
+                     "bytes_per_sec",
+                     elapsed > 0 ? (double) (committed - (size_t) offset) / elapsed : 0.0);
+    if (error_buf[0]) {
+        add_assoc_string(return_value, "error", error_buf);
+    } else {
+        add_assoc_null(return_value, "error");
+    }
+
+    return 1;
+}
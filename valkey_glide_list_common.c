@@ -16,6 +16,9 @@
 #include "valkey_glide_list_common.h"
 
 #include "common.h"
+#include "valkey_glide_breaker.h"
+#include "valkey_glide_hot_keys.h"
+#include "valkey_glide_node_stats.h"
 #include "valkey_glide_z_common.h"
 extern zend_class_entry* ce;
 extern zend_class_entry* get_valkey_glide_exception_ce();
@@ -83,7 +86,7 @@ int process_list_string_result_async(CommandResponse* response, void* output, zv
         return 0;
 
     if (response->response_type == String) {
-        ZVAL_STRINGL(return_value, response->string_value, response->string_value_len);
+        ZVAL_STR(return_value, valkey_glide_string_from_response(response));
         return 1;
     } else if (response->response_type == Null) {
         ZVAL_FALSE(return_value);
@@ -111,7 +114,7 @@ int process_list_pop_result_async(CommandResponse* response, void* output, zval*
 
     if (response->response_type == String) {
         /* Single value returned */
-        ZVAL_STRINGL(return_value, response->string_value, response->string_value_len);
+        ZVAL_STR(return_value, valkey_glide_string_from_response(response));
         return 1;
     } else if (response->response_type == Array) {
         /* Multiple values returned (when count > 1) */
@@ -259,6 +262,9 @@ int execute_list_generic_command(valkey_glide_object* valkey_glide,
     if (arg_count <= 0) {
         goto cleanup;
     }
+    valkey_glide_hot_keys_record(valkey_glide, args->key, args->key_len, args_len, arg_count);
+    valkey_glide_node_stats_record(valkey_glide, args->key, args->key_len);
+    valkey_glide_breaker_record(valkey_glide, args->key, args->key_len);
 
     /* Check for batch mode */
     if (valkey_glide->is_in_batch_mode) {
@@ -272,13 +278,14 @@ int execute_list_generic_command(valkey_glide_object* valkey_glide,
     }
 
     /* Execute the command */
-    CommandResult* result =
-        execute_command(valkey_glide->glide_client, cmd_type, arg_count, cmd_args, args_len);
+    CommandResponse* reply  = NULL;
+    CommandResult*   result = execute_command_for_reply(
+        valkey_glide->glide_client, cmd_type, arg_count, cmd_args, args_len, &reply);
 
     /* Process result */
     if (result) {
-        if (!result->command_error && result->response && process_result) {
-            status = process_result(result->response, result_ptr, return_value);
+        if (!result->command_error && reply && process_result) {
+            status = process_result(reply, result_ptr, return_value);
         }
         free_command_result(result);
     }
@@ -0,0 +1,80 @@
+/** Copyright Valkey GLIDE Project Contributors - SPDX Identifier: Apache-2.0 */
+
+#include "valkey_glide_memory.h"
+
+#include <string.h>
+#include <zend_alloc.h>
+
+valkey_glide_mem_counter valkey_glide_mem_counters[VALKEY_GLIDE_MEM_TAGS];
+int64_t                  valkey_glide_mem_scan_cursors;
+
+static const char* const mem_tag_names[VALKEY_GLIDE_MEM_TAGS] = {
+    "batch",
+    "pubsub",
+    "scan",
+    "response",
+};
+
+static bool mem_is_scan_cursor(const char* cursor_id) {
+    return cursor_id && cursor_id[0] && strcmp(cursor_id, "0") != 0 &&
+           strcmp(cursor_id, "finished") != 0;
+}
+
+void valkey_glide_mem_scan_cursor_opened(const char* cursor_id) {
+    if (mem_is_scan_cursor(cursor_id)) {
+        __atomic_add_fetch(&valkey_glide_mem_scan_cursors, 1, __ATOMIC_RELAXED);
+    }
+}
+
+void valkey_glide_mem_scan_cursor_released(const char* cursor_id) {
+    if (mem_is_scan_cursor(cursor_id)) {
+        __atomic_sub_fetch(&valkey_glide_mem_scan_cursors, 1, __ATOMIC_RELAXED);
+    }
+}
+
+/* Execute getMemoryStats() - the accounting counters, plus the engine's own usage */
+int execute_get_memory_stats_command(zval*             object,
+                                     int               argc,
+                                     zval*             return_value,
+                                     zend_class_entry* ce) {
+    zend_long live_bytes = 0;
+    int       tag;
+
+    if (zend_parse_method_parameters(argc, object, "O", &object, ce) == FAILURE) {
+        return 0;
+    }
+
+    array_init(return_value);
+    for (tag = 0; tag < VALKEY_GLIDE_MEM_TAGS; tag++) {
+        const valkey_glide_mem_counter* counter = &valkey_glide_mem_counters[tag];
+
+        int64_t  live        = __atomic_load_n(&counter->live_bytes, __ATOMIC_RELAXED);
+        uint64_t allocations = __atomic_load_n(&counter->allocations, __ATOMIC_RELAXED);
+        uint64_t frees       = __atomic_load_n(&counter->frees, __ATOMIC_RELAXED);
+        zval     entry;
+
+        array_init(&entry);
+        add_assoc_long(&entry, "live_bytes", live);
+        add_assoc_long(
+            &entry, "peak_bytes", __atomic_load_n(&counter->peak_bytes, __ATOMIC_RELAXED));
+        add_assoc_long(&entry, "allocations", (zend_long) allocations);
+        add_assoc_long(&entry, "live_allocations", (zend_long) (allocations - frees));
+
+        if (tag == VALKEY_GLIDE_MEM_PUBSUB) {
+            /* Every queued message is one allocation until its callback has run */
+            add_assoc_long(&entry, "queue_depth", (zend_long) (allocations - frees));
+        } else if (tag == VALKEY_GLIDE_MEM_SCAN) {
+            add_assoc_long(&entry,
+                           "rust_cursors",
+                           __atomic_load_n(&valkey_glide_mem_scan_cursors, __ATOMIC_RELAXED));
+        }
+
+        add_assoc_zval(return_value, mem_tag_names[tag], &entry);
+        live_bytes += live;
+    }
+
+    add_assoc_long(return_value, "live_bytes", live_bytes);
+    add_assoc_long(return_value, "php_usage", (zend_long) zend_memory_usage(false));
+    add_assoc_long(return_value, "php_real_usage", (zend_long) zend_memory_usage(true));
+    return 1;
+}
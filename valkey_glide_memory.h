@@ -0,0 +1,95 @@
+/** Copyright Valkey GLIDE Project Contributors - SPDX Identifier: Apache-2.0 */
+
+#ifndef VALKEY_GLIDE_MEMORY_H
+#define VALKEY_GLIDE_MEMORY_H
+
+#include <stdint.h>
+
+#include "common.h"
+
+/*
+ * Memory accounting per subsystem, reported by getMemoryStats().
+ *
+ * The subsystems that hold memory between calls tag what they allocate and free here: batch
+ * buffers, queued pub/sub messages, scan cursors and the scratch space of response conversion.
+ * The counters are process-wide and updated atomically, pub/sub messages being queued from
+ * glide-core threads. Memory the engine reclaims at the end of a request without the extension
+ * freeing it stays counted, which is exactly what a leak looks like.
+ */
+typedef enum {
+    VALKEY_GLIDE_MEM_BATCH,    /* multi()/pipeline() command buffers and argument copies */
+    VALKEY_GLIDE_MEM_PUBSUB,   /* Messages queued for a subscribe() callback */
+    VALKEY_GLIDE_MEM_SCAN,     /* ClusterScanCursor objects and their cursor ids */
+    VALKEY_GLIDE_MEM_RESPONSE, /* Scratch space of replies being converted to PHP values */
+    VALKEY_GLIDE_MEM_TAGS
+} valkey_glide_mem_tag;
+
+typedef struct {
+    int64_t  live_bytes;
+    int64_t  peak_bytes;
+    uint64_t allocations; /* Ever made */
+    uint64_t frees;
+} valkey_glide_mem_counter;
+
+extern valkey_glide_mem_counter valkey_glide_mem_counters[VALKEY_GLIDE_MEM_TAGS];
+
+/* Cursors glide-core handed out for cluster scans and not yet released */
+extern int64_t valkey_glide_mem_scan_cursors;
+
+static inline void valkey_glide_mem_alloc(valkey_glide_mem_tag tag, size_t bytes) {
+    valkey_glide_mem_counter* counter = &valkey_glide_mem_counters[tag];
+
+    int64_t live = __atomic_add_fetch(&counter->live_bytes, (int64_t) bytes, __ATOMIC_RELAXED);
+    int64_t peak = __atomic_load_n(&counter->peak_bytes, __ATOMIC_RELAXED);
+
+    __atomic_add_fetch(&counter->allocations, 1, __ATOMIC_RELAXED);
+    while (live > peak && !__atomic_compare_exchange_n(&counter->peak_bytes,
+                                                       &peak,
+                                                       live,
+                                                       true,
+                                                       __ATOMIC_RELAXED,
+                                                       __ATOMIC_RELAXED)) {
+    }
+}
+
+static inline void valkey_glide_mem_free(valkey_glide_mem_tag tag, size_t bytes) {
+    valkey_glide_mem_counter* counter = &valkey_glide_mem_counters[tag];
+
+    __atomic_sub_fetch(&counter->live_bytes, (int64_t) bytes, __ATOMIC_RELAXED);
+    __atomic_add_fetch(&counter->frees, 1, __ATOMIC_RELAXED);
+}
+
+/* A block that grew or shrank in place counts as a free and a new allocation */
+static inline void valkey_glide_mem_realloc(valkey_glide_mem_tag tag,
+                                            size_t               old_bytes,
+                                            size_t               new_bytes) {
+    if (old_bytes > 0) {
+        valkey_glide_mem_free(tag, old_bytes);
+    }
+    valkey_glide_mem_alloc(tag, new_bytes);
+}
+
+/* Track cluster scan cursor ids, the initial "0" and the final "finished" are not cursors */
+void valkey_glide_mem_scan_cursor_opened(const char* cursor_id);
+void valkey_glide_mem_scan_cursor_released(const char* cursor_id);
+
+int execute_get_memory_stats_command(zval*             object,
+                                     int               argc,
+                                     zval*             return_value,
+                                     zend_class_entry* ce);
+
+#define GET_MEMORY_STATS_METHOD_IMPL(class_name)                                            \
+    PHP_METHOD(class_name, getMemoryStats) {                                                \
+        if (execute_get_memory_stats_command(getThis(),                                     \
+                                             ZEND_NUM_ARGS(),                               \
+                                             return_value,                                  \
+                                             strcmp(#class_name, "ValkeyGlideCluster") == 0 \
+                                                 ? get_valkey_glide_cluster_ce()            \
+                                                 : get_valkey_glide_ce())) {                \
+            return;                                                                         \
+        }                                                                                   \
+        zval_dtor(return_value);                                                            \
+        RETURN_FALSE;                                                                       \
+    }
+
+#endif /* VALKEY_GLIDE_MEMORY_H */
@@ -0,0 +1,546 @@
+/** Copyright Valkey GLIDE Project Contributors - SPDX Identifier: Apache-2.0 */
+
+#include "valkey_glide_metrics.h"
+
+#include <string.h>
+#include <zend_exceptions.h>
+
+#include "command_response.h"
+#include "logger.h"
+#include "valkey_glide_slowlog.h"
+
+/* The INFO fields rates are computed from, the counters first */
+enum {
+    METRICS_TOTAL_COMMANDS,
+    METRICS_KEYSPACE_HITS,
+    METRICS_KEYSPACE_MISSES,
+    METRICS_NET_INPUT,
+    METRICS_NET_OUTPUT,
+    METRICS_COUNTERS, /* The fields above are kept between snapshots */
+    METRICS_INSTANTANEOUS_OPS = METRICS_COUNTERS,
+    METRICS_INSTANTANEOUS_INPUT_KBPS,
+    METRICS_INSTANTANEOUS_OUTPUT_KBPS,
+    METRICS_SOURCES
+};
+
+static const char* const metrics_source_names[METRICS_SOURCES] = {
+    "total_commands_processed",
+    "keyspace_hits",
+    "keyspace_misses",
+    "total_net_input_bytes",
+    "total_net_output_bytes",
+    "instantaneous_ops_per_sec",
+    "instantaneous_input_kbps",
+    "instantaneous_output_kbps",
+};
+
+/* Fields returned when none are asked for */
+static const char* const metrics_default_fields[] = {
+    "used_memory",
+    "connected_clients",
+    "total_commands_processed",
+    "keyspace_hits",
+    "keyspace_misses",
+    "evicted_keys",
+    "expired_keys",
+};
+
+/*
+ * The section of the fields a snapshot usually asks for. When every requested field is listed
+ * here, INFO is sent those sections only; any other field falls back to the default sections.
+ */
+typedef struct {
+    const char* field;
+    const char* section;
+} metrics_field_section;
+
+static const metrics_field_section metrics_field_sections[] = {
+    {"redis_version", "server"},
+    {"valkey_version", "server"},
+    {"run_id", "server"},
+    {"tcp_port", "server"},
+    {"uptime_in_seconds", "server"},
+    {"connected_clients", "clients"},
+    {"blocked_clients", "clients"},
+    {"tracking_clients", "clients"},
+    {"maxclients", "clients"},
+    {"used_memory", "memory"},
+    {"used_memory_rss", "memory"},
+    {"used_memory_peak", "memory"},
+    {"used_memory_dataset", "memory"},
+    {"maxmemory", "memory"},
+    {"mem_fragmentation_ratio", "memory"},
+    {"total_connections_received", "stats"},
+    {"total_commands_processed", "stats"},
+    {"instantaneous_ops_per_sec", "stats"},
+    {"total_net_input_bytes", "stats"},
+    {"total_net_output_bytes", "stats"},
+    {"instantaneous_input_kbps", "stats"},
+    {"instantaneous_output_kbps", "stats"},
+    {"rejected_connections", "stats"},
+    {"expired_keys", "stats"},
+    {"evicted_keys", "stats"},
+    {"keyspace_hits", "stats"},
+    {"keyspace_misses", "stats"},
+    {"pubsub_channels", "stats"},
+    {"total_error_replies", "stats"},
+    {"role", "replication"},
+    {"connected_slaves", "replication"},
+    {"master_repl_offset", "replication"},
+    {"used_cpu_sys", "cpu"},
+    {"used_cpu_user", "cpu"},
+};
+
+#define METRICS_MAX_SECTIONS 8
+
+typedef struct {
+    uint64_t at_ns;
+    double   counters[METRICS_COUNTERS];
+} metrics_sample;
+
+/* What a snapshot looks for in each reply */
+typedef struct {
+    HashTable     lookup; /* Name => (field index + 1) | (source index + 1) << 16 */
+    zend_string** fields;
+    uint32_t      field_count;
+} metrics_request;
+
+static void metrics_sample_dtor(zval* zv) {
+    efree(Z_PTR_P(zv));
+}
+
+void valkey_glide_metrics_release(valkey_glide_object* valkey_glide) {
+    if (valkey_glide->metrics_samples) {
+        zend_hash_destroy(valkey_glide->metrics_samples);
+        FREE_HASHTABLE(valkey_glide->metrics_samples);
+        valkey_glide->metrics_samples = NULL;
+    }
+}
+
+static const char* metrics_field_section_of(const zend_string* field) {
+    for (size_t i = 0; i < sizeof(metrics_field_sections) / sizeof(metrics_field_sections[0]);
+         i++) {
+        const char* name = metrics_field_sections[i].field;
+        if (ZSTR_LEN(field) == strlen(name) &&
+            memcmp(ZSTR_VAL(field), name, ZSTR_LEN(field)) == 0) {
+            return metrics_field_sections[i].section;
+        }
+    }
+    return NULL;
+}
+
+static void metrics_lookup_add(HashTable* lookup, const char* name, size_t len, zend_long bits) {
+    zval* existing = zend_hash_str_find(lookup, name, len);
+    if (existing) {
+        /* A field asked for twice keeps its first position */
+        if ((bits & 0xffff) == 0 || (Z_LVAL_P(existing) & 0xffff) == 0) {
+            Z_LVAL_P(existing) |= bits;
+        }
+    } else {
+        zval entry;
+        ZVAL_LONG(&entry, bits);
+        zend_hash_str_add_new(lookup, name, len, &entry);
+    }
+}
+
+/* Collect the requested fields, or the defaults, and the sections to ask INFO for */
+static bool metrics_request_init(metrics_request* request,
+                                 HashTable*       requested,
+                                 const char**     sections,
+                                 int*             section_count) {
+    zval* field;
+    bool  known = true;
+
+    request->field_count = requested ? zend_hash_num_elements(requested) : 0;
+    if (request->field_count == 0) {
+        request->field_count = sizeof(metrics_default_fields) / sizeof(metrics_default_fields[0]);
+        request->fields      = safe_emalloc(request->field_count, sizeof(zend_string*), 0);
+        for (uint32_t i = 0; i < request->field_count; i++) {
+            request->fields[i] = zend_string_init(
+                metrics_default_fields[i], strlen(metrics_default_fields[i]), 0);
+        }
+    } else {
+        uint32_t i      = 0;
+        request->fields = safe_emalloc(request->field_count, sizeof(zend_string*), 0);
+        ZEND_HASH_FOREACH_VAL(requested, field) {
+            if (Z_TYPE_P(field) != IS_STRING || Z_STRLEN_P(field) == 0) {
+                while (i > 0) {
+                    zend_string_release(request->fields[--i]);
+                }
+                efree(request->fields);
+                zend_argument_value_error(1, "must contain only non-empty strings");
+                return false;
+            }
+            request->fields[i++] = zend_string_copy(Z_STR_P(field));
+        }
+        ZEND_HASH_FOREACH_END();
+    }
+
+    zend_hash_init(&request->lookup, request->field_count + METRICS_SOURCES, NULL, NULL, 0);
+    for (uint32_t i = 0; i < METRICS_SOURCES; i++) {
+        metrics_lookup_add(&request->lookup,
+                           metrics_source_names[i],
+                           strlen(metrics_source_names[i]),
+                           (zend_long) (i + 1) << 16);
+    }
+
+    /* Rates need the stats section whatever the fields */
+    sections[0]    = "stats";
+    *section_count = 1;
+    for (uint32_t i = 0; i < request->field_count; i++) {
+        const char* section = metrics_field_section_of(request->fields[i]);
+        int         j;
+
+        metrics_lookup_add(&request->lookup,
+                           ZSTR_VAL(request->fields[i]),
+                           ZSTR_LEN(request->fields[i]),
+                           (zend_long) (i + 1));
+        if (!section) {
+            known = false;
+            continue;
+        }
+        for (j = 0; j < *section_count && strcmp(sections[j], section) != 0; j++) {
+        }
+        if (j == *section_count && *section_count < METRICS_MAX_SECTIONS) {
+            sections[(*section_count)++] = section;
+        }
+    }
+    if (!known) {
+        *section_count = 0;
+    }
+    return true;
+}
+
+static void metrics_request_destroy(metrics_request* request) {
+    for (uint32_t i = 0; i < request->field_count; i++) {
+        zend_string_release(request->fields[i]);
+    }
+    efree(request->fields);
+    zend_hash_destroy(&request->lookup);
+}
+
+static void metrics_add_rate(zval* rates, const char* name, bool known, double value) {
+    if (known) {
+        add_assoc_double(rates, name, value);
+    } else {
+        add_assoc_null(rates, name);
+    }
+}
+
+/* The rates over the interval since the node's previous sample, instantaneous ones without */
+static void metrics_add_rates(valkey_glide_object* valkey_glide,
+                              const char*          node,
+                              size_t               node_len,
+                              const double*        sources,
+                              const bool*          seen,
+                              uint64_t             now_ns,
+                              zval*                output) {
+    metrics_sample* previous = NULL;
+    bool            counters = true;
+    zval            rates;
+
+    for (int i = 0; i < METRICS_COUNTERS; i++) {
+        counters = counters && seen[i];
+    }
+
+    if (!valkey_glide->metrics_samples) {
+        ALLOC_HASHTABLE(valkey_glide->metrics_samples);
+        zend_hash_init(valkey_glide->metrics_samples, 8, NULL, metrics_sample_dtor, 0);
+    }
+    previous = zend_hash_str_find_ptr(valkey_glide->metrics_samples, node, node_len);
+
+    /* A counter going backwards means a restart or another node behind the same name */
+    bool delta = counters && previous && now_ns > previous->at_ns;
+    for (int i = 0; delta && i < METRICS_COUNTERS; i++) {
+        delta = sources[i] >= previous->counters[i];
+    }
+
+    array_init_size(&rates, 5);
+    if (delta) {
+        double seconds = (double) (now_ns - previous->at_ns) / 1e9;
+        double hits    = sources[METRICS_KEYSPACE_HITS] - previous->counters[METRICS_KEYSPACE_HITS];
+        double misses =
+            sources[METRICS_KEYSPACE_MISSES] - previous->counters[METRICS_KEYSPACE_MISSES];
+
+        add_assoc_double(
+            &rates,
+            "ops_per_sec",
+            (sources[METRICS_TOTAL_COMMANDS] - previous->counters[METRICS_TOTAL_COMMANDS]) /
+                seconds);
+        metrics_add_rate(&rates, "hit_ratio", hits + misses > 0, hits / (hits + misses));
+        add_assoc_double(
+            &rates,
+            "net_input_bytes_per_sec",
+            (sources[METRICS_NET_INPUT] - previous->counters[METRICS_NET_INPUT]) / seconds);
+        add_assoc_double(
+            &rates,
+            "net_output_bytes_per_sec",
+            (sources[METRICS_NET_OUTPUT] - previous->counters[METRICS_NET_OUTPUT]) / seconds);
+        add_assoc_double(&rates, "interval", seconds);
+    } else {
+        double hits   = sources[METRICS_KEYSPACE_HITS];
+        double misses = sources[METRICS_KEYSPACE_MISSES];
+
+        metrics_add_rate(&rates,
+                         "ops_per_sec",
+                         seen[METRICS_INSTANTANEOUS_OPS],
+                         sources[METRICS_INSTANTANEOUS_OPS]);
+        metrics_add_rate(&rates,
+                         "hit_ratio",
+                         seen[METRICS_KEYSPACE_HITS] && seen[METRICS_KEYSPACE_MISSES] &&
+                             hits + misses > 0,
+                         hits / (hits + misses));
+        metrics_add_rate(&rates,
+                         "net_input_bytes_per_sec",
+                         seen[METRICS_INSTANTANEOUS_INPUT_KBPS],
+                         sources[METRICS_INSTANTANEOUS_INPUT_KBPS] * 1024);
+        metrics_add_rate(&rates,
+                         "net_output_bytes_per_sec",
+                         seen[METRICS_INSTANTANEOUS_OUTPUT_KBPS],
+                         sources[METRICS_INSTANTANEOUS_OUTPUT_KBPS] * 1024);
+        add_assoc_double(&rates, "interval", 0.0);
+    }
+    add_assoc_zval(output, "rates", &rates);
+
+    if (counters) {
+        metrics_sample* sample = emalloc(sizeof(metrics_sample));
+        sample->at_ns          = now_ns;
+        memcpy(sample->counters, sources, sizeof(sample->counters));
+        zend_hash_str_update_ptr(valkey_glide->metrics_samples, node, node_len, sample);
+    }
+}
+
+/*
+ * Pick the requested fields out of one node's INFO text. Lines are split in place, nothing is
+ * copied but the values kept, and the walk stops once every field has been found.
+ */
+static void metrics_parse_node(valkey_glide_object*   valkey_glide,
+                               const metrics_request* request,
+                               const char*            info,
+                               size_t                 info_len,
+                               const char*            node,
+                               size_t                 node_len,
+                               uint64_t               now_ns,
+                               zval*                  output) {
+    const char* end = info + info_len;
+    const char* line;
+    double      sources[METRICS_SOURCES] = {0};
+    bool        seen[METRICS_SOURCES]    = {false};
+    uint32_t    wanted                   = zend_hash_num_elements(&request->lookup);
+
+    /* Fields missing from the reply stay null, in the order they were asked for */
+    array_init_size(output, request->field_count + 1);
+    for (uint32_t i = 0; i < request->field_count; i++) {
+        add_assoc_null_ex(output, ZSTR_VAL(request->fields[i]), ZSTR_LEN(request->fields[i]));
+    }
+
+    for (line = info; line < end && wanted > 0;) {
+        const char* eol   = memchr(line, '\n', end - line);
+        const char* next  = eol ? eol + 1 : end;
+        const char* colon = NULL;
+        size_t      len;
+
+        if (!eol) {
+            eol = end;
+        }
+        len = eol - line;
+        if (len > 0 && line[len - 1] == '\r') {
+            len--;
+        }
+        if (len == 0 || *line == '#' || !(colon = memchr(line, ':', len)) || colon == line) {
+            line = next;
+            continue;
+        }
+
+        zval* entry = zend_hash_str_find(&request->lookup, line, colon - line);
+        if (entry) {
+            const char* value     = colon + 1;
+            size_t      value_len = len - (value - line);
+            zend_long   bits      = Z_LVAL_P(entry);
+            zend_long   field     = (bits & 0xffff) - 1;
+            zend_long   source    = (bits >> 16) - 1;
+            zend_long   lval      = 0;
+            double      dval      = 0;
+            zend_uchar  type =
+                value_len > 0 ? is_numeric_string(value, value_len, &lval, &dval, 0) : 0;
+
+            if (field >= 0) {
+                zend_string* name = request->fields[field];
+                switch (type) {
+                    case IS_LONG:
+                        add_assoc_long_ex(output, ZSTR_VAL(name), ZSTR_LEN(name), lval);
+                        break;
+                    case IS_DOUBLE:
+                        add_assoc_double_ex(output, ZSTR_VAL(name), ZSTR_LEN(name), dval);
+                        break;
+                    default:
+                        add_assoc_stringl_ex(
+                            output, ZSTR_VAL(name), ZSTR_LEN(name), (char*) value, value_len);
+                        break;
+                }
+            }
+            if (source >= 0 && type) {
+                sources[source] = type == IS_LONG ? (double) lval : dval;
+                seen[source]    = true;
+            }
+            wanted--;
+        }
+        line = next;
+    }
+
+    metrics_add_rates(valkey_glide, node, node_len, sources, seen, now_ns, output);
+}
+
+/*
+ * The node a cluster route names, for keying its counters. Multi-node routes answer with a map
+ * keyed by address and leave *node NULL. Routes that pick a node we can't name (randomNode, a
+ * key or slot) are refused, as their counters would mix nodes.
+ */
+static bool metrics_route_node(zval* route, zend_string** node) {
+    zval *type, *host, *port;
+
+    *node = NULL;
+    if (Z_TYPE_P(route) == IS_STRING) {
+        if (zend_string_equals_literal_ci(Z_STR_P(route), "allPrimaries") ||
+            zend_string_equals_literal_ci(Z_STR_P(route), "allNodes")) {
+            return true;
+        }
+    } else if (Z_TYPE_P(route) == IS_ARRAY) {
+        type = zend_hash_str_find(Z_ARRVAL_P(route), "type", sizeof("type") - 1);
+        host = zend_hash_str_find(Z_ARRVAL_P(route), "host", sizeof("host") - 1);
+        port = zend_hash_str_find(Z_ARRVAL_P(route), "port", sizeof("port") - 1);
+        if (type && Z_TYPE_P(type) == IS_STRING &&
+            zend_string_equals_literal_ci(Z_STR_P(type), "routeByAddress") && host &&
+            Z_TYPE_P(host) == IS_STRING && port) {
+            *node = zend_strpprintf(0, "%s:" ZEND_LONG_FMT, Z_STRVAL_P(host), zval_get_long(port));
+            return true;
+        }
+    }
+
+    zend_argument_value_error(
+        2, "must be \"allPrimaries\", \"allNodes\" or a routeByAddress array");
+    return false;
+}
+
+int execute_metrics_snapshot_command(zval*             object,
+                                     int               argc,
+                                     zval*             return_value,
+                                     zend_class_entry* ce) {
+    valkey_glide_object* valkey_glide;
+    HashTable*           requested = NULL;
+    zval*                route     = NULL;
+    zend_string*         node      = NULL;
+    zval                 default_route;
+    metrics_request      request;
+    const char*          sections[METRICS_MAX_SECTIONS];
+    int                  section_count = 0;
+    uintptr_t            args[METRICS_MAX_SECTIONS];
+    unsigned long        args_len[METRICS_MAX_SECTIONS];
+    CommandResult*       result;
+    int                  status = 0;
+
+    zend_bool is_cluster = (ce == get_valkey_glide_cluster_ce());
+
+    if (is_cluster) {
+        if (zend_parse_method_parameters(
+                argc, object, "O|hz", &object, ce, &requested, &route) == FAILURE) {
+            return 0;
+        }
+    } else if (zend_parse_method_parameters(argc, object, "O|h", &object, ce, &requested) ==
+               FAILURE) {
+        return 0;
+    }
+
+    valkey_glide = VALKEY_GLIDE_PHP_ZVAL_GET_OBJECT(valkey_glide_object, object);
+    if (!valkey_glide || !valkey_glide->glide_client) {
+        return 0;
+    }
+    if (valkey_glide->is_in_batch_mode) {
+        /* The rates depend on when the reply arrives */
+        VALKEY_LOG_ERROR("metrics_snapshot", "metricsSnapshot() cannot be used in a batch");
+        return 0;
+    }
+
+    if (is_cluster && route && !metrics_route_node(route, &node)) {
+        return 0;
+    }
+    if (!metrics_request_init(&request, requested, sections, &section_count)) {
+        if (node) {
+            zend_string_release(node);
+        }
+        return 0;
+    }
+    for (int i = 0; i < section_count; i++) {
+        args[i]     = (uintptr_t) sections[i];
+        args_len[i] = strlen(sections[i]);
+    }
+
+    if (is_cluster) {
+        if (!route) {
+            ZVAL_STRINGL(&default_route, "allPrimaries", sizeof("allPrimaries") - 1);
+            route = &default_route;
+        }
+        result = execute_command_with_route(
+            valkey_glide->glide_client, Info, section_count, args, args_len, route);
+        if (route == &default_route) {
+            zval_ptr_dtor(&default_route);
+        }
+    } else {
+        result = execute_command(valkey_glide->glide_client, Info, section_count, args, args_len);
+    }
+
+    uint64_t now_ns = valkey_glide_slowlog_now();
+
+    if (!result) {
+        VALKEY_LOG_WARN("metrics_snapshot", "INFO returned no result");
+    } else if (result->command_error) {
+        VALKEY_LOG_WARN_FMT("metrics_snapshot",
+                            "INFO failed: %s",
+                            result->command_error->command_error_message);
+    } else if (result->response && result->response->response_type == String) {
+        /* One node, named by its address for a cluster client */
+        metrics_parse_node(valkey_glide,
+                           &request,
+                           result->response->string_value,
+                           result->response->string_value_len,
+                           node ? ZSTR_VAL(node) : "",
+                           node ? ZSTR_LEN(node) : 0,
+                           now_ns,
+                           return_value);
+        status = 1;
+    } else if (result->response && result->response->response_type == Map) {
+        /* One entry per node, keyed by its address */
+        array_init_size(return_value, (uint32_t) result->response->array_value_len);
+        for (long i = 0; i < result->response->array_value_len; i++) {
+            const CommandResponse* key   = result->response->array_value[i].map_key;
+            const CommandResponse* value = result->response->array_value[i].map_value;
+            zval                   node;
+
+            if (!key || !value || key->response_type != String ||
+                value->response_type != String) {
+                continue;
+            }
+            metrics_parse_node(valkey_glide,
+                               &request,
+                               value->string_value,
+                               value->string_value_len,
+                               key->string_value,
+                               key->string_value_len,
+                               now_ns,
+                               &node);
+            add_assoc_zval_ex(return_value, key->string_value, key->string_value_len, &node);
+        }
+        status = 1;
+    } else {
+        VALKEY_LOG_WARN("metrics_snapshot", "Unexpected INFO reply");
+    }
+
+    if (result) {
+        free_command_result(result);
+    }
+    if (node) {
+        zend_string_release(node);
+    }
+    metrics_request_destroy(&request);
+    return status;
+}
@@ -0,0 +1,39 @@
+/** Copyright Valkey GLIDE Project Contributors - SPDX Identifier: Apache-2.0 */
+
+#ifndef VALKEY_GLIDE_METRICS_H
+#define VALKEY_GLIDE_METRICS_H
+
+#include "common.h"
+
+/*
+ * metricsSnapshot(), INFO reduced to the fields a monitoring agent asks for.
+ *
+ * The reply is scanned in place, line by line, and only the requested fields are converted,
+ * numbers to ints and floats. When every field is one the extension knows the section of, only
+ * those sections are requested. The counters rates are computed from are kept per node between
+ * calls, so each snapshot reports the rates over the interval since the previous one.
+ */
+
+/* Forget the previous snapshots, when the object is freed */
+void valkey_glide_metrics_release(valkey_glide_object* valkey_glide);
+
+int execute_metrics_snapshot_command(zval*             object,
+                                     int               argc,
+                                     zval*             return_value,
+                                     zend_class_entry* ce);
+
+#define METRICS_SNAPSHOT_METHOD_IMPL(class_name)                                            \
+    PHP_METHOD(class_name, metricsSnapshot) {                                               \
+        if (execute_metrics_snapshot_command(getThis(),                                     \
+                                             ZEND_NUM_ARGS(),                               \
+                                             return_value,                                  \
+                                             strcmp(#class_name, "ValkeyGlideCluster") == 0 \
+                                                 ? get_valkey_glide_cluster_ce()            \
+                                                 : get_valkey_glide_ce())) {                \
+            return;                                                                         \
+        }                                                                                   \
+        zval_dtor(return_value);                                                            \
+        RETURN_FALSE;                                                                       \
+    }
+
+#endif /* VALKEY_GLIDE_METRICS_H */
@@ -0,0 +1,317 @@
+/** Copyright Valkey GLIDE Project Contributors - SPDX Identifier: Apache-2.0 */
+
+#include "valkey_glide_node_stats.h"
+
+#include <string.h>
+#include <zend_exceptions.h>
+
+#include "valkey_glide_slowlog.h"
+
+#define NODE_STATS_EWMA_ALPHA 0.1
+
+typedef struct {
+    uint32_t requests;
+    uint32_t errors;
+    uint32_t timeouts;
+    uint32_t disconnects;
+    double   ewma_us;
+    uint32_t latency[VALKEY_GLIDE_NODE_STATS_BUCKETS]; /* [2^i, 2^(i+1)) us, the last unbounded */
+} node_stats_entry;
+
+/*
+ * Cluster clients keep two entries per node, for the calls its primary served and for the reads
+ * sent to its replicas, and the node serving each slot as of the last CLUSTER SLOTS lookup.
+ * Nodes keep their entries when the topology changes, new ones are appended.
+ */
+struct valkey_glide_node_stats {
+    int               next_slot; /* Slot of the key noted for the next call */
+    uint16_t*         owners;    /* Node serving each slot, NULL for standalone clients */
+    HashTable         nodes;     /* "host:port" => node index, in the order they were seen */
+    node_stats_entry* entries;   /* Primary and replica entries of each node */
+    uint32_t          capacity;  /* Nodes entries has room for */
+    node_stats_entry  unkeyed;   /* Calls without a slot, or to a slot nobody serves */
+};
+
+static int node_stats_bucket(uint64_t us) {
+    int bucket = 0;
+
+    while (us > 1 && bucket < VALKEY_GLIDE_NODE_STATS_BUCKETS - 1) {
+        us >>= 1;
+        bucket++;
+    }
+    return bucket;
+}
+
+void valkey_glide_node_stats_note_key(valkey_glide_object* valkey_glide,
+                                      const char*          key,
+                                      size_t               key_len) {
+    valkey_glide_node_stats* stats = valkey_glide->node_stats;
+
+    /* Batched commands are sent later, all at once */
+    if (valkey_glide->is_in_batch_mode || !stats->owners) {
+        return;
+    }
+    stats->next_slot = valkey_glide_key_slot(key, key_len);
+}
+
+void valkey_glide_node_stats_add(valkey_glide_node_stats* stats,
+                                 int                      slot,
+                                 bool                     replica,
+                                 uint64_t                 start_ns,
+                                 const CommandResult*     result) {
+    node_stats_entry* entry;
+    uint64_t          us = (valkey_glide_slowlog_now() - start_ns) / 1000;
+
+    if (slot == VALKEY_GLIDE_NODE_STATS_UNKEYED) {
+        slot = stats->next_slot;
+    }
+    stats->next_slot = VALKEY_GLIDE_NODE_STATS_UNKEYED;
+
+    if (!stats->owners) {
+        entry = &stats->entries[0];
+    } else if (slot == VALKEY_GLIDE_NODE_STATS_UNKEYED ||
+               stats->owners[slot] == VALKEY_GLIDE_CLUSTER_SLOTS) {
+        entry = &stats->unkeyed;
+    } else {
+        entry = &stats->entries[2 * stats->owners[slot] + (replica ? 1 : 0)];
+    }
+
+    entry->ewma_us = entry->requests == 0
+                         ? (double) us
+                         : entry->ewma_us + NODE_STATS_EWMA_ALPHA * ((double) us - entry->ewma_us);
+    entry->requests++;
+    entry->latency[node_stats_bucket(us)]++;
+
+    if (!result || result->command_error) {
+        entry->errors++;
+        if (result && result->command_error->command_error_type == Timeout) {
+            entry->timeouts++;
+        } else if (result && result->command_error->command_error_type == Disconnect) {
+            entry->disconnects++;
+        }
+    }
+}
+
+/*
+ * Look the owners of the slots up again, giving nodes not seen before their entries. Throws and
+ * returns false if CLUSTER SLOTS fails.
+ */
+static bool node_stats_refresh(valkey_glide_node_stats* stats, const void* glide_client) {
+    uint16_t* owners = safe_emalloc(VALKEY_GLIDE_CLUSTER_SLOTS, sizeof(uint16_t), 0);
+    zval      nodes;
+
+    if (!valkey_glide_slot_owners(glide_client, owners, &nodes)) {
+        efree(owners);
+        return false;
+    }
+
+    /* Index of each node of the lookup among the nodes already counted */
+    uint32_t     found = zend_hash_num_elements(Z_ARRVAL(nodes));
+    uint16_t*    known = safe_emalloc(found, sizeof(uint16_t), 0);
+    zend_string* node;
+    zval*        index;
+
+    ZEND_HASH_FOREACH_STR_KEY_VAL(Z_ARRVAL(nodes), node, index) {
+        zval* seen = zend_hash_find(&stats->nodes, node);
+        if (seen) {
+            known[Z_LVAL_P(index)] = (uint16_t) Z_LVAL_P(seen);
+            continue;
+        }
+
+        uint32_t count = zend_hash_num_elements(&stats->nodes);
+        if (count >= VALKEY_GLIDE_CLUSTER_SLOTS) {
+            known[Z_LVAL_P(index)] = VALKEY_GLIDE_CLUSTER_SLOTS;
+            continue;
+        }
+        if (count == stats->capacity) {
+            stats->capacity = MAX(8, 2 * stats->capacity);
+            stats->entries  = safe_erealloc(
+                stats->entries, 2 * stats->capacity, sizeof(node_stats_entry), 0);
+            memset(&stats->entries[2 * count],
+                   0,
+                   2 * (stats->capacity - count) * sizeof(node_stats_entry));
+        }
+
+        zval entry;
+        ZVAL_LONG(&entry, count);
+        zend_hash_add_new(&stats->nodes, node, &entry);
+        known[Z_LVAL_P(index)] = (uint16_t) count;
+    }
+    ZEND_HASH_FOREACH_END();
+
+    for (int slot = 0; slot < VALKEY_GLIDE_CLUSTER_SLOTS; slot++) {
+        stats->owners[slot] = owners[slot] < found ? known[owners[slot]]
+                                                   : VALKEY_GLIDE_CLUSTER_SLOTS;
+    }
+
+    zval_ptr_dtor(&nodes);
+    efree(known);
+    efree(owners);
+    return true;
+}
+
+bool valkey_glide_set_node_stats(valkey_glide_object* valkey_glide, zval* value, bool cluster) {
+    if (!zval_is_true(value)) {
+        valkey_glide_node_stats_release(valkey_glide);
+        return true;
+    }
+
+    /* Recording is keyed by the client handle, which only exists once connected */
+    if (!valkey_glide->glide_client ||
+        valkey_glide_refuse_shared(valkey_glide, "OPT_NODE_STATS")) {
+        return false;
+    }
+
+    if (!valkey_glide->node_stats) {
+        valkey_glide_node_stats* stats = ecalloc(1, sizeof(valkey_glide_node_stats));
+
+        stats->next_slot = VALKEY_GLIDE_NODE_STATS_UNKEYED;
+        zend_hash_init(&stats->nodes, 8, NULL, NULL, 0);
+        if (cluster) {
+            stats->owners = safe_emalloc(VALKEY_GLIDE_CLUSTER_SLOTS, sizeof(uint16_t), 0);
+            if (!node_stats_refresh(stats, valkey_glide->glide_client)) {
+                zend_hash_destroy(&stats->nodes);
+                efree(stats->entries);
+                efree(stats->owners);
+                efree(stats);
+                return false;
+            }
+        } else {
+            stats->capacity = 1;
+            stats->entries  = ecalloc(2, sizeof(node_stats_entry));
+        }
+
+        valkey_glide->node_stats = stats;
+        zend_hash_index_update_ptr(&VALKEY_GLIDE_G(node_stats),
+                                   (zend_ulong) (uintptr_t) valkey_glide->glide_client,
+                                   stats);
+    }
+    return true;
+}
+
+void valkey_glide_node_stats_release(valkey_glide_object* valkey_glide) {
+    if (!valkey_glide->node_stats) {
+        return;
+    }
+
+    /* Objects sharing a client record into the statistics registered last */
+    zend_ulong index      = (zend_ulong) (uintptr_t) valkey_glide->glide_client;
+    void*      registered = zend_hash_index_find_ptr(&VALKEY_GLIDE_G(node_stats), index);
+    if (registered == valkey_glide->node_stats) {
+        zend_hash_index_del(&VALKEY_GLIDE_G(node_stats), index);
+    }
+
+    zend_hash_destroy(&valkey_glide->node_stats->nodes);
+    if (valkey_glide->node_stats->entries) {
+        efree(valkey_glide->node_stats->entries);
+    }
+    if (valkey_glide->node_stats->owners) {
+        efree(valkey_glide->node_stats->owners);
+    }
+    efree(valkey_glide->node_stats);
+    valkey_glide->node_stats = NULL;
+}
+
+/* The upper bound of the bucket holding the 99th percentile, the lower one for the last */
+static zend_long node_stats_p99_us(const node_stats_entry* entry) {
+    uint64_t rank = ((uint64_t) entry->requests * 99 + 99) / 100;
+    uint64_t seen = 0;
+
+    for (int i = 0; i < VALKEY_GLIDE_NODE_STATS_BUCKETS; i++) {
+        seen += entry->latency[i];
+        if (seen >= rank) {
+            return i == VALKEY_GLIDE_NODE_STATS_BUCKETS - 1 ? (zend_long) 1 << i
+                                                            : (zend_long) 1 << (i + 1);
+        }
+    }
+    return 0;
+}
+
+/* Counters of entry, the ones every report has */
+static void node_stats_counters_to_zval(const node_stats_entry* entry, zval* output) {
+    add_assoc_long(output, "requests", entry->requests);
+    add_assoc_long(output, "errors", entry->errors);
+    add_assoc_long(output, "timeouts", entry->timeouts);
+    add_assoc_long(output, "disconnects", entry->disconnects);
+    add_assoc_double(output, "rtt_avg_us", entry->ewma_us);
+    add_assoc_long(output, "rtt_p99_us", node_stats_p99_us(entry));
+}
+
+static void node_stats_entry_to_zval(const node_stats_entry* entry,
+                                     const char*             role,
+                                     zend_long               slots,
+                                     zval*                   output) {
+    array_init_size(output, 9);
+    if (role) {
+        add_assoc_string(output, "role", (char*) role);
+    } else {
+        add_assoc_null(output, "role");
+    }
+    add_assoc_long(output, "slots", slots);
+    node_stats_counters_to_zval(entry, output);
+}
+
+int execute_get_node_stats_command(zval*             object,
+                                   int               argc,
+                                   zval*             return_value,
+                                   zend_class_entry* ce) {
+    if (zend_parse_method_parameters(argc, object, "O", &object, ce) == FAILURE) {
+        return 0;
+    }
+
+    valkey_glide_object* valkey_glide =
+        VALKEY_GLIDE_PHP_ZVAL_GET_OBJECT(valkey_glide_object, object);
+    if (!valkey_glide || !valkey_glide->node_stats) {
+        /* Recording is off */
+        return 0;
+    }
+
+    valkey_glide_node_stats* stats = valkey_glide->node_stats;
+    zval                     entry;
+
+    if (!stats->owners) {
+        array_init_size(return_value, 1);
+        node_stats_entry_to_zval(&stats->entries[0], NULL, 0, &entry);
+        add_assoc_zval(return_value, "default", &entry);
+        return 1;
+    }
+
+    if (!node_stats_refresh(stats, valkey_glide->glide_client)) {
+        return 0;
+    }
+
+    uint32_t   node_count = zend_hash_num_elements(&stats->nodes);
+    zend_long* served     = ecalloc(node_count + 1, sizeof(zend_long));
+
+    for (int slot = 0; slot < VALKEY_GLIDE_CLUSTER_SLOTS; slot++) {
+        served[MIN(stats->owners[slot], node_count)]++;
+    }
+
+    zend_string* node;
+    zval*        owner;
+
+    /* Nodes that no longer serve slots keep what they counted, without a role */
+    array_init_size(return_value, node_count + 1);
+    ZEND_HASH_FOREACH_STR_KEY_VAL(&stats->nodes, node, owner) {
+        zend_long served_slots = served[Z_LVAL_P(owner)];
+        zval      replicas;
+
+        node_stats_entry_to_zval(&stats->entries[2 * Z_LVAL_P(owner)],
+                                 served_slots > 0 ? "primary" : NULL,
+                                 served_slots,
+                                 &entry);
+        array_init_size(&replicas, 6);
+        node_stats_counters_to_zval(&stats->entries[2 * Z_LVAL_P(owner) + 1], &replicas);
+        add_assoc_zval(&entry, "replicas", &replicas);
+        zend_hash_update(Z_ARRVAL_P(return_value), node, &entry);
+    }
+    ZEND_HASH_FOREACH_END();
+
+    if (stats->unkeyed.requests > 0) {
+        node_stats_entry_to_zval(&stats->unkeyed, NULL, served[node_count], &entry);
+        add_assoc_zval_ex(return_value, "", 0, &entry);
+    }
+
+    efree(served);
+    return 1;
+}
@@ -0,0 +1,86 @@
+/** Copyright Valkey GLIDE Project Contributors - SPDX Identifier: Apache-2.0 */
+
+#ifndef VALKEY_GLIDE_NODE_STATS_H
+#define VALKEY_GLIDE_NODE_STATS_H
+
+#include "common.h"
+#include "include/glide_bindings.h"
+#include "valkey_glide_slot.h"
+
+/*
+ * Per-node request statistics, measured client-side.
+ *
+ * With OPT_NODE_STATS on, every command()-level call is timed and counted against the node
+ * serving the hash slot of its key, or of its route, and a single entry for standalone clients.
+ * Cluster clients look the owners of the slots up with CLUSTER SLOTS when recording starts and
+ * again on every getNodeStats(), so a call is counted against the node serving its slot as of
+ * the last lookup. Reads routed to replicas, by withReadFrom() or won by a hedge, are counted
+ * apart from the primary's. Commands without a single key (fan-outs, scripts, administration)
+ * are counted apart too.
+ */
+#define VALKEY_GLIDE_NODE_STATS_BUCKETS 20 /* Latency buckets, powers of two of microseconds */
+#define VALKEY_GLIDE_NODE_STATS_UNKEYED VALKEY_GLIDE_CLUSTER_SLOTS
+
+typedef struct valkey_glide_node_stats valkey_glide_node_stats;
+
+/* Statistics recorded for glide_client, NULL if there are none */
+static inline valkey_glide_node_stats* valkey_glide_node_stats_find(const void* glide_client) {
+    if (EXPECTED(zend_hash_num_elements(&VALKEY_GLIDE_G(node_stats)) == 0)) {
+        return NULL;
+    }
+    return zend_hash_index_find_ptr(&VALKEY_GLIDE_G(node_stats),
+                                    (zend_ulong) (uintptr_t) glide_client);
+}
+
+/* Called by the command executors before a command is sent, with the key it is routed by */
+void valkey_glide_node_stats_note_key(valkey_glide_object* valkey_glide,
+                                      const char*          key,
+                                      size_t               key_len);
+
+static inline void valkey_glide_node_stats_record(valkey_glide_object* valkey_glide,
+                                                  const char*          key,
+                                                  size_t               key_len) {
+    if (UNEXPECTED(valkey_glide->node_stats != NULL) && key && key_len > 0) {
+        valkey_glide_node_stats_note_key(valkey_glide, key, key_len);
+    }
+}
+
+/*
+ * Count a call that started at start_ns against slot, or against the key noted last when slot
+ * is VALKEY_GLIDE_NODE_STATS_UNKEYED, replica when a replica of the slot served it.
+ */
+void valkey_glide_node_stats_add(valkey_glide_node_stats* stats,
+                                 int                      slot,
+                                 bool                     replica,
+                                 uint64_t                 start_ns,
+                                 const CommandResult*     result);
+
+/*
+ * setOption(OPT_NODE_STATS, $on): turning it off discards the statistics. Cluster clients look
+ * the slots up first, which throws and returns false when CLUSTER SLOTS fails.
+ */
+bool valkey_glide_set_node_stats(valkey_glide_object* valkey_glide, zval* value, bool cluster);
+
+/* Stop recording, when the object is freed */
+void valkey_glide_node_stats_release(valkey_glide_object* valkey_glide);
+
+int execute_get_node_stats_command(zval*             object,
+                                   int               argc,
+                                   zval*             return_value,
+                                   zend_class_entry* ce);
+
+#define GET_NODE_STATS_METHOD_IMPL(class_name)                                            \
+    PHP_METHOD(class_name, getNodeStats) {                                                \
+        if (execute_get_node_stats_command(getThis(),                                     \
+                                           ZEND_NUM_ARGS(),                               \
+                                           return_value,                                  \
+                                           strcmp(#class_name, "ValkeyGlideCluster") == 0 \
+                                               ? get_valkey_glide_cluster_ce()            \
+                                               : get_valkey_glide_ce())) {                \
+            return;                                                                       \
+        }                                                                                 \
+        zval_dtor(return_value);                                                          \
+        RETURN_FALSE;                                                                     \
+    }
+
+#endif /* VALKEY_GLIDE_NODE_STATS_H */
@@ -21,16 +21,34 @@
 
 #include "common.h"
 #include "logger.h"
+#include "valkey_glide_pubsub_common.h"
 
 /* Forward declarations for static functions */
-static void                               cleanup_otel_config(void);
+static void                               free_otel_config(struct OpenTelemetryConfig* config);
 static bool                               valkey_glide_otel_should_sample(void);
 static struct OpenTelemetryConfig*        parse_otel_config(zval* config_obj);
 static struct OpenTelemetryTracesConfig*  parse_traces_config_object(zval* traces_obj);
 static struct OpenTelemetryMetricsConfig* parse_metrics_config_object(zval* metrics_obj);
 
-/* Global OTEL configuration */
+/* Global OTEL configuration. Process-wide and persistent, as it outlives the request and thread
+ * that set it up; written with otel_lock held. */
 struct OpenTelemetryConfig* g_otel_config = NULL;
+static mutex_t              otel_lock;
+
+/* Sampling threshold over 32-bit random values: 0 never samples, above UINT32_MAX always does.
+ * Derived from the sample percentage whenever it changes, so sampling never reads the config. */
+static volatile uint64_t otel_sample_threshold = 0;
+
+static void otel_update_sample_threshold(uint32_t percentage) {
+    otel_sample_threshold = ((uint64_t) percentage << 32) / 100;
+}
+
+/**
+ * Set up the OTEL lock, called once per process from MINIT
+ */
+void valkey_glide_otel_startup(void) {
+    mutex_init(&otel_lock);
+}
 
 /**
  * Initialize OpenTelemetry with the given configuration
@@ -44,20 +62,36 @@ int valkey_glide_otel_init(zval* config_obj) {
     }
 
     /* Parse configuration - caller has validated it's a non-null object */
-    g_otel_config = parse_otel_config(config_obj);
-    if (!g_otel_config) {
+    struct OpenTelemetryConfig* config = parse_otel_config(config_obj);
+    if (!config) {
         VALKEY_LOG_ERROR("otel_init", "Failed to parse OTEL configuration");
         return 0;
     }
 
+    /* Another thread may have won the race since the check above */
+    mutex_lock(&otel_lock);
+    if (g_otel_config) {
+        mutex_unlock(&otel_lock);
+        free_otel_config(config);
+        VALKEY_LOG_WARN("otel_init",
+                        "OpenTelemetry already initialized, ignoring subsequent calls");
+        return 1;
+    }
+
     /* Initialize OTEL with Rust FFI */
-    const char* error = init_open_telemetry(g_otel_config);
+    const char* error = init_open_telemetry(config);
     if (error) {
+        mutex_unlock(&otel_lock);
         VALKEY_LOG_ERROR_FMT("otel_init", "Failed to initialize OTEL: %s", error);
         free_c_string((char*) error);
-        cleanup_otel_config();
+        free_otel_config(config);
         return 0;
     }
+    g_otel_config = config;
+    if (config->traces) {
+        otel_update_sample_threshold(config->traces->sample_percentage);
+    }
+    mutex_unlock(&otel_lock);
 
     VALKEY_LOG_INFO("otel_init", "OpenTelemetry initialized successfully");
     return 1;
@@ -86,9 +120,12 @@ void valkey_glide_otel_set_sample_percentage(uint32_t percentage) {
     }
 
     /* Cast away const to modify the sample_percentage field */
+    mutex_lock(&otel_lock);
     struct OpenTelemetryTracesConfig* mutable_traces =
         (struct OpenTelemetryTracesConfig*) g_otel_config->traces;
     mutable_traces->sample_percentage = percentage;
+    otel_update_sample_threshold(percentage);
+    mutex_unlock(&otel_lock);
 
     VALKEY_LOG_DEBUG_FMT("otel_set_sample", "Sample percentage updated to %u", percentage);
 }
@@ -110,23 +147,129 @@ int valkey_glide_otel_get_sample_percentage(uint32_t* percentage) {
  * For testing purposes only - allows resetting OTEL state between tests.
  */
 static void valkey_glide_otel_shutdown(void) {
-    if (g_otel_config) {
-        cleanup_otel_config();
+    mutex_lock(&otel_lock);
+    struct OpenTelemetryConfig* config = g_otel_config;
+    g_otel_config                      = NULL;
+    otel_sample_threshold              = 0;
+    mutex_unlock(&otel_lock);
+
+    if (config) {
+        free_otel_config(config);
         VALKEY_LOG_INFO("otel_shutdown", "OpenTelemetry shutdown complete");
     }
 }
 
+/* The span set with setOtelParentSpan() on this thread, 0 if none */
+static uint64_t otel_current_parent_span(void) {
+    if (VALKEY_GLIDE_G(otel_parent_span) == 0) {
+        return 0;
+    }
+
+    void* span = zend_hash_index_find_ptr(&VALKEY_GLIDE_G(otel_spans),
+                                          (zend_ulong) VALKEY_GLIDE_G(otel_parent_span));
+    return span ? (uint64_t) (uintptr_t) span : 0;
+}
+
 /**
  * Create a span for command tracing
  */
 uint64_t valkey_glide_create_span(enum RequestType request_type) {
-    if (!g_otel_config) {
+    if (!valkey_glide_otel_should_sample()) {
         return 0;
     }
+
+    uint64_t parent_span = otel_current_parent_span();
+    return parent_span ? create_otel_span_with_parent(request_type, parent_span)
+                       : create_otel_span(request_type);
+}
+
+/**
+ * Create the parent span of a MULTI/PIPELINE batch, sampled once for the whole batch
+ */
+uint64_t valkey_glide_create_batch_span(size_t command_count, size_t payload_bytes) {
     if (!valkey_glide_otel_should_sample()) {
         return 0;
     }
-    return create_otel_span(request_type);
+
+    uint64_t parent_span = otel_current_parent_span();
+    uint64_t span_ptr    = parent_span ? create_batch_otel_span_with_parent(parent_span)
+                                       : create_batch_otel_span();
+
+    /* The FFI has no span attribute setter, so the batch shape is reported through the log */
+    VALKEY_LOG_DEBUG_FMT("otel_batch",
+                         "Batch span %llu: %zu commands, %zu payload bytes",
+                         (unsigned long long) span_ptr,
+                         command_count,
+                         payload_bytes);
+    return span_ptr;
+}
+
+/**
+ * Open a named span and return its handle, 0 on failure. The span only becomes the parent of
+ * command and batch spans once passed to valkey_glide_otel_set_parent_span().
+ */
+zend_long valkey_glide_otel_start_span(const char* name) {
+    if (!g_otel_config || !g_otel_config->traces) {
+        zend_throw_exception(get_valkey_glide_exception_ce(),
+                             "OpenTelemetry not initialized or traces not configured",
+                             0);
+        return 0;
+    }
+
+    uint64_t span_ptr = create_named_otel_span(name);
+    if (!span_ptr) {
+        VALKEY_LOG_ERROR_FMT("otel_span", "Failed to create span '%s'", name);
+        return 0;
+    }
+
+    zend_long handle = ++VALKEY_GLIDE_G(otel_next_span);
+    zend_hash_index_update_ptr(
+        &VALKEY_GLIDE_G(otel_spans), (zend_ulong) handle, (void*) (uintptr_t) span_ptr);
+    return handle;
+}
+
+/**
+ * End a span opened with valkey_glide_otel_start_span(), false if handle is not open
+ */
+bool valkey_glide_otel_end_span(zend_long handle) {
+    void* span = zend_hash_index_find_ptr(&VALKEY_GLIDE_G(otel_spans), (zend_ulong) handle);
+    if (!span) {
+        return false;
+    }
+
+    if (VALKEY_GLIDE_G(otel_parent_span) == handle) {
+        VALKEY_GLIDE_G(otel_parent_span) = 0;
+    }
+    zend_hash_index_del(&VALKEY_GLIDE_G(otel_spans), (zend_ulong) handle);
+    drop_otel_span((uint64_t) (uintptr_t) span);
+    return true;
+}
+
+/**
+ * Make the open span handle the parent of the spans created on this thread, 0 for none
+ */
+bool valkey_glide_otel_set_parent_span(zend_long handle) {
+    if (handle != 0 &&
+        !zend_hash_index_exists(&VALKEY_GLIDE_G(otel_spans), (zend_ulong) handle)) {
+        return false;
+    }
+
+    VALKEY_GLIDE_G(otel_parent_span) = handle;
+    return true;
+}
+
+/**
+ * End spans left open by the request
+ */
+void valkey_glide_otel_request_shutdown(void) {
+    void* span;
+
+    ZEND_HASH_FOREACH_PTR(&VALKEY_GLIDE_G(otel_spans), span) {
+        drop_otel_span((uint64_t) (uintptr_t) span);
+    }
+    ZEND_HASH_FOREACH_END();
+    zend_hash_clean(&VALKEY_GLIDE_G(otel_spans));
+    VALKEY_GLIDE_G(otel_parent_span) = 0;
 }
 
 /**
@@ -190,9 +333,9 @@ static struct OpenTelemetryConfig* parse_otel_config(zval* config_obj) {
             if (!metrics_config) {
                 if (traces_config) {
                     if (traces_config->endpoint) {
-                        efree((void*) traces_config->endpoint);
+                        pefree((void*) traces_config->endpoint, 1);
                     }
-                    efree(traces_config);
+                    pefree(traces_config, 1);
                 }
                 zval_dtor(&retval);
                 return NULL;
@@ -220,7 +363,7 @@ static struct OpenTelemetryConfig* parse_otel_config(zval* config_obj) {
     }
 
     // Create main FFI config struct
-    struct OpenTelemetryConfig* main_config = emalloc(sizeof(struct OpenTelemetryConfig));
+    struct OpenTelemetryConfig* main_config = pemalloc(sizeof(struct OpenTelemetryConfig), 1);
     main_config->traces                     = traces_config;
     main_config->metrics                    = metrics_config;
     main_config->has_flush_interval_ms      = has_flush_interval;
@@ -241,7 +384,7 @@ static struct OpenTelemetryTracesConfig* parse_traces_config_object(zval* traces
     // Get endpoint
     if (call_method(traces_obj, "getEndpoint", &retval)) {
         if (Z_TYPE(retval) == IS_STRING) {
-            endpoint = estrdup(Z_STRVAL(retval));
+            endpoint = pestrdup(Z_STRVAL(retval), 1);
         }
         zval_dtor(&retval);
     }
@@ -262,7 +405,7 @@ static struct OpenTelemetryTracesConfig* parse_traces_config_object(zval* traces
 
     // Allocate and populate FFI traces config struct
     struct OpenTelemetryTracesConfig* traces_config =
-        emalloc(sizeof(struct OpenTelemetryTracesConfig));
+        pemalloc(sizeof(struct OpenTelemetryTracesConfig), 1);
     traces_config->endpoint              = endpoint;  // Transfer ownership
     traces_config->has_sample_percentage = has_sample_percentage;
     traces_config->sample_percentage     = (uint32_t) sample_percentage;
@@ -280,7 +423,7 @@ static struct OpenTelemetryMetricsConfig* parse_metrics_config_object(zval* metr
     // Get endpoint
     if (call_method(metrics_obj, "getEndpoint", &retval)) {
         if (Z_TYPE(retval) == IS_STRING) {
-            endpoint = estrdup(Z_STRVAL(retval));
+            endpoint = pestrdup(Z_STRVAL(retval), 1);
         }
         zval_dtor(&retval);
     }
@@ -292,42 +435,47 @@ static struct OpenTelemetryMetricsConfig* parse_metrics_config_object(zval* metr
 
     // Allocate and populate FFI metrics config struct
     struct OpenTelemetryMetricsConfig* metrics_config =
-        emalloc(sizeof(struct OpenTelemetryMetricsConfig));
+        pemalloc(sizeof(struct OpenTelemetryMetricsConfig), 1);
     metrics_config->endpoint = endpoint;  // Transfer ownership
 
     return metrics_config;
 }
 
 /**
- * Cleanup OTEL configuration
+ * Free an OTEL configuration
  */
-static void cleanup_otel_config(void) {
-    if (!g_otel_config) {
-        return;
-    }
-
-    if (g_otel_config->traces) {
-        if (g_otel_config->traces->endpoint) {
-            efree((void*) g_otel_config->traces->endpoint);
+static void free_otel_config(struct OpenTelemetryConfig* config) {
+    if (config->traces) {
+        if (config->traces->endpoint) {
+            pefree((void*) config->traces->endpoint, 1);
         }
-        efree((void*) g_otel_config->traces);
+        pefree((void*) config->traces, 1);
     }
 
-    if (g_otel_config->metrics) {
-        if (g_otel_config->metrics->endpoint) {
-            efree((void*) g_otel_config->metrics->endpoint);
+    if (config->metrics) {
+        if (config->metrics->endpoint) {
+            pefree((void*) config->metrics->endpoint, 1);
         }
-        efree((void*) g_otel_config->metrics);
+        pefree((void*) config->metrics, 1);
     }
 
-    efree(g_otel_config);
-    g_otel_config = NULL;
+    pefree(config, 1);
+}
+
+/* xorshift64* over per-thread state, seeded in GINIT */
+static uint32_t otel_next_random(void) {
+    uint64_t x = VALKEY_GLIDE_G(otel_rng_state);
+    x ^= x >> 12;
+    x ^= x << 25;
+    x ^= x >> 27;
+    VALKEY_GLIDE_G(otel_rng_state) = x;
+    return (uint32_t) ((x * 0x2545F4914F6CDD1DULL) >> 32);
 }
 
 static bool valkey_glide_otel_should_sample(void) {
-    if (!g_otel_config || !g_otel_config->traces) {
+    uint64_t threshold = otel_sample_threshold;
+    if (threshold == 0) {
         return false;
     }
-    uint32_t percentage = g_otel_config->traces->sample_percentage;
-    return percentage > 0 && (percentage == 100 || (rand() % 100) < percentage);
+    return threshold > UINT32_MAX || otel_next_random() < threshold;
 }
@@ -22,10 +22,18 @@
 extern struct OpenTelemetryConfig* g_otel_config;
 
 /* Function declarations */
+void     valkey_glide_otel_startup(void);
 int      valkey_glide_otel_init(zval* config_obj);
 void     valkey_glide_otel_set_sample_percentage(uint32_t percentage);
 int      valkey_glide_otel_get_sample_percentage(uint32_t* percentage);
 uint64_t valkey_glide_create_span(enum RequestType request_type);
+uint64_t valkey_glide_create_batch_span(size_t command_count, size_t payload_bytes);
 void     valkey_glide_drop_span(uint64_t span_ptr);
 
+/* Application spans by handle, the one set as parent owning the spans created on the thread */
+zend_long valkey_glide_otel_start_span(const char* name);
+bool      valkey_glide_otel_end_span(zend_long handle);
+bool      valkey_glide_otel_set_parent_span(zend_long handle);
+void      valkey_glide_otel_request_shutdown(void);
+
 #endif /* VALKEY_GLIDE_OTEL_H */
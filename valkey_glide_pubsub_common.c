@@ -6,6 +6,7 @@
 #include <zend_exceptions.h>
 
 #include "logger.h"
+#include "valkey_glide_memory.h"
 
 // PubSub message type constants (from PushKind enum)
 #define PUBSUB_KIND_MESSAGE 3
@@ -78,31 +79,80 @@ void cond_destroy(cond_t* c) {
 #endif
 }
 
-// Global pubsub callback storage
+// Global pubsub callback storage. It is shared by every PHP thread and by the glide-core threads
+// delivering messages, so it is persistent and only accessed with pubsub_callbacks_lock held.
+// Entries themselves belong to the PHP thread that registered them.
 static HashTable pubsub_callbacks;
 static bool      pubsub_callbacks_initialized = false;
+static mutex_t   pubsub_callbacks_lock;
+
+// Create the callback registry, called once per process from MINIT
+void valkey_glide_pubsub_startup(void) {
+    mutex_init(&pubsub_callbacks_lock);
+    init_pubsub_callbacks();
+}
 
 // Initialize pubsub callbacks
 void init_pubsub_callbacks(void) {
+    mutex_lock(&pubsub_callbacks_lock);
     if (!pubsub_callbacks_initialized) {
-        zend_hash_init(&pubsub_callbacks, 16, NULL, cleanup_callback_info, 0);
+        zend_hash_init(&pubsub_callbacks, 16, NULL, cleanup_callback_info, 1);
         pubsub_callbacks_initialized = true;
     }
+    mutex_unlock(&pubsub_callbacks_lock);
 }
 
 // Find pubsub callback by client key
 zval* find_pubsub_callback(const char* client_key) {
-    if (!pubsub_callbacks_initialized) {
-        return NULL;
+    zval* callback_zv = NULL;
+
+    mutex_lock(&pubsub_callbacks_lock);
+    if (pubsub_callbacks_initialized) {
+        callback_zv = zend_hash_str_find(&pubsub_callbacks, client_key, strlen(client_key));
     }
-    return zend_hash_str_find(&pubsub_callbacks, client_key, strlen(client_key));
+    mutex_unlock(&pubsub_callbacks_lock);
+    return callback_zv;
+}
+
+// Find the callback info registered for a client, NULL if there is none
+static pubsub_callback_info* lookup_pubsub_callback_info(uintptr_t client_ptr) {
+    char client_key[32];
+    int  key_len = snprintf(client_key, sizeof(client_key), "%lu", (unsigned long) client_ptr);
+    pubsub_callback_info* info = NULL;
+
+    mutex_lock(&pubsub_callbacks_lock);
+    if (pubsub_callbacks_initialized) {
+        zval* callback_zv = zend_hash_str_find(&pubsub_callbacks, client_key, key_len);
+        if (callback_zv) {
+            info = (pubsub_callback_info*) Z_PTR_P(callback_zv);
+        }
+    }
+    mutex_unlock(&pubsub_callbacks_lock);
+    return info;
 }
 
 // Remove pubsub callback by client key
 void remove_pubsub_callback(const char* client_key) {
+    mutex_lock(&pubsub_callbacks_lock);
     if (pubsub_callbacks_initialized) {
         zend_hash_str_del(&pubsub_callbacks, client_key, strlen(client_key));
     }
+    mutex_unlock(&pubsub_callbacks_lock);
+}
+
+// Bytes a message holds, for memory accounting
+static size_t pubsub_message_bytes(const pubsub_message* msg) {
+    return sizeof(pubsub_message) + (size_t) msg->channel_len + (size_t) msg->message_len +
+           (size_t) msg->pattern_len;
+}
+
+// Free a queued message, allocated on a glide-core thread
+static void free_pubsub_message(pubsub_message* msg) {
+    valkey_glide_mem_free(VALKEY_GLIDE_MEM_PUBSUB, pubsub_message_bytes(msg));
+    free(msg->channel);
+    free(msg->message);
+    free(msg->pattern);
+    free(msg);
 }
 
 // Cleanup callback info
@@ -113,13 +163,7 @@ void cleanup_callback_info(zval* zv) {
         pubsub_message* msg = info->queue_head;
         while (msg) {
             pubsub_message* next = msg->next;
-            if (msg->channel)
-                efree(msg->channel);
-            if (msg->message)
-                efree(msg->message);
-            if (msg->pattern)
-                efree(msg->pattern);
-            efree(msg);
+            free_pubsub_message(msg);
             msg = next;
         }
 
@@ -147,7 +191,7 @@ void cleanup_callback_info_ptr(void* ptr) {
     }
 }
 
-// C callback handler for FFI
+// C callback handler for FFI, called on a glide-core thread
 void pubsub_callback_handler(uintptr_t      client_ptr,
                              int            kind,
                              const uint8_t* message,
@@ -160,69 +204,49 @@ void pubsub_callback_handler(uintptr_t      client_ptr,
         return;
     }
 
-    char client_key[32];
-    int  key_len = snprintf(client_key, sizeof(client_key), "%lu", (unsigned long) client_ptr);
-
-    zval* callback_zv = zend_hash_str_find(&pubsub_callbacks, client_key, key_len);
-    if (!callback_zv) {
-        return;
-    }
-
-    pubsub_callback_info* info = (pubsub_callback_info*) Z_PTR_P(callback_zv);
-    if (!info || !info->is_active) {
-        return;
-    }
-
     // Only handle message types
     if (kind != PUBSUB_KIND_MESSAGE && kind != PUBSUB_KIND_PMESSAGE &&
         kind != PUBSUB_KIND_SMESSAGE) {
         return;
     }
 
-    // Allocate and populate message node
-    pubsub_message* msg = (pubsub_message*) emalloc(sizeof(pubsub_message));
+    // Allocate and populate message node. This is not a PHP thread, so the request allocator
+    // must not be used here.
+    pubsub_message* msg = (pubsub_message*) calloc(1, sizeof(pubsub_message));
     if (!msg)
         return;
 
-    msg->kind = kind;
-    msg->next = NULL;
-
-    // Copy channel
-    msg->channel = (uint8_t*) emalloc(channel_len);
-    if (msg->channel) {
-        memcpy(msg->channel, channel, channel_len);
-        msg->channel_len = channel_len;
-    } else {
-        efree(msg);
-        return;
+    msg->kind        = kind;
+    msg->channel     = (uint8_t*) malloc(channel_len > 0 ? channel_len : 1);
+    msg->message     = (uint8_t*) malloc(message_len > 0 ? message_len : 1);
+    msg->channel_len = channel_len;
+    msg->message_len = message_len;
+    if (pattern && pattern_len > 0) {
+        msg->pattern     = (uint8_t*) malloc(pattern_len);
+        msg->pattern_len = pattern_len;
     }
-
-    // Copy message
-    msg->message = (uint8_t*) emalloc(message_len);
-    if (msg->message) {
-        memcpy(msg->message, message, message_len);
-        msg->message_len = message_len;
-    } else {
-        efree(msg->channel);
-        efree(msg);
+    valkey_glide_mem_alloc(VALKEY_GLIDE_MEM_PUBSUB, pubsub_message_bytes(msg));
+    if (!msg->channel || !msg->message || (pattern && pattern_len > 0 && !msg->pattern)) {
+        free_pubsub_message(msg);
         return;
     }
+    memcpy(msg->channel, channel, channel_len);
+    memcpy(msg->message, message, message_len);
+    if (msg->pattern) {
+        memcpy(msg->pattern, pattern, pattern_len);
+    }
 
-    // Copy pattern if present
-    if (pattern && pattern_len > 0) {
-        msg->pattern = (uint8_t*) emalloc(pattern_len);
-        if (msg->pattern) {
-            memcpy(msg->pattern, pattern, pattern_len);
-            msg->pattern_len = pattern_len;
-        } else {
-            efree(msg->message);
-            efree(msg->channel);
-            efree(msg);
-            return;
-        }
-    } else {
-        msg->pattern     = NULL;
-        msg->pattern_len = 0;
+    char client_key[32];
+    int  key_len = snprintf(client_key, sizeof(client_key), "%lu", (unsigned long) client_ptr);
+
+    // The registry lock keeps the owning thread from freeing the entry while we queue to it
+    mutex_lock(&pubsub_callbacks_lock);
+    zval*                 callback_zv = zend_hash_str_find(&pubsub_callbacks, client_key, key_len);
+    pubsub_callback_info* info = callback_zv ? (pubsub_callback_info*) Z_PTR_P(callback_zv) : NULL;
+    if (!info || !info->is_active) {
+        mutex_unlock(&pubsub_callbacks_lock);
+        free_pubsub_message(msg);
+        return;
     }
 
     // Add to queue (thread-safe)
@@ -235,6 +259,7 @@ void pubsub_callback_handler(uintptr_t      client_ptr,
     info->queue_tail = msg;
     cond_signal(&info->queue_cond);
     mutex_unlock(&info->queue_mutex);
+    mutex_unlock(&pubsub_callbacks_lock);
 }
 
 // Register callback
@@ -267,7 +292,9 @@ void php_register_pubsub_callback(uintptr_t client_ptr, zval* callback, zval* cl
     // Store the pointer in a zval using ZVAL_PTR
     zval callback_zv;
     ZVAL_PTR(&callback_zv, info);
+    mutex_lock(&pubsub_callbacks_lock);
     zend_hash_str_update(&pubsub_callbacks, client_key, key_len, &callback_zv);
+    mutex_unlock(&pubsub_callbacks_lock);
 }
 
 // Unregister callback
@@ -278,6 +305,7 @@ void php_unregister_pubsub_callback(uintptr_t client_ptr) {
     char client_key[32];
     int  key_len = snprintf(client_key, sizeof(client_key), "%lu", (unsigned long) client_ptr);
 
+    mutex_lock(&pubsub_callbacks_lock);
     zval* callback_zv = zend_hash_str_find(&pubsub_callbacks, client_key, key_len);
     if (callback_zv) {
         pubsub_callback_info* info = (pubsub_callback_info*) Z_PTR_P(callback_zv);
@@ -288,6 +316,7 @@ void php_unregister_pubsub_callback(uintptr_t client_ptr) {
         // Delete from hashtable - this will call cleanup_callback_info
         zend_hash_str_del(&pubsub_callbacks, client_key, key_len);
     }
+    mutex_unlock(&pubsub_callbacks_lock);
 }
 
 // Check if client is in subscribe mode
@@ -295,27 +324,17 @@ bool is_client_in_subscribe_mode(uintptr_t client_ptr) {
     if (!pubsub_callbacks_initialized)
         return false;
 
-    char client_key[32];
-    snprintf(client_key, sizeof(client_key), "%lu", (unsigned long) client_ptr);
-
-    zval* callback_zv = find_pubsub_callback(client_key);
-    if (!callback_zv)
-        return false;
-
-    pubsub_callback_info* info = (pubsub_callback_info*) Z_PTR_P(callback_zv);
+    pubsub_callback_info* info = lookup_pubsub_callback_info(client_ptr);
     return info ? info->in_subscribe_mode : false;
 }
 
 // Common subscribe blocking loop
 static void subscribe_blocking_loop(uintptr_t connection, enum RequestType unsub_type) {
-    char client_key[32];
-    snprintf(client_key, sizeof(client_key), "%lu", (unsigned long) connection);
-    zval* callback_zv = find_pubsub_callback(client_key);
-    if (!callback_zv)
+    pubsub_callback_info* info = lookup_pubsub_callback_info(connection);
+    if (!info)
         return;
 
-    pubsub_callback_info* info = (pubsub_callback_info*) Z_PTR_P(callback_zv);
-    info->in_subscribe_mode    = true;
+    info->in_subscribe_mode = true;
 
     while (info->is_active && zend_hash_num_elements(info->subscribed_channels) > 0) {
         pubsub_message* msg = NULL;
@@ -366,13 +385,7 @@ static void subscribe_blocking_loop(uintptr_t connection, enum RequestType unsub
                 zval_ptr_dtor(&php_pattern);
             }
 
-            if (msg->channel)
-                efree(msg->channel);
-            if (msg->message)
-                efree(msg->message);
-            if (msg->pattern)
-                efree(msg->pattern);
-            efree(msg);
+            free_pubsub_message(msg);
         }
     }
 
@@ -577,6 +590,13 @@ void valkey_glide_subscribe_impl(INTERNAL_FUNCTION_PARAMETERS, const void* conne
         RETURN_FALSE;
     }
 
+    if (VALKEY_GLIDE_PHP_ZVAL_GET_OBJECT(valkey_glide_object, ZEND_THIS)->shared_client) {
+        zend_throw_exception(get_valkey_glide_exception_ce(),
+                             "Subscriptions are not supported on shared clients",
+                             0);
+        RETURN_FALSE;
+    }
+
     php_register_pubsub_callback((uintptr_t) connection, callback, ZEND_THIS);
 
     execute_subscribe_command(connection,
@@ -614,6 +634,13 @@ void valkey_glide_psubscribe_impl(INTERNAL_FUNCTION_PARAMETERS, const void* conn
         RETURN_FALSE;
     }
 
+    if (VALKEY_GLIDE_PHP_ZVAL_GET_OBJECT(valkey_glide_object, ZEND_THIS)->shared_client) {
+        zend_throw_exception(get_valkey_glide_exception_ce(),
+                             "Subscriptions are not supported on shared clients",
+                             0);
+        RETURN_FALSE;
+    }
+
     php_register_pubsub_callback((uintptr_t) connection, callback, ZEND_THIS);
 
     execute_subscribe_command(connection,
@@ -709,25 +736,15 @@ void valkey_glide_pubsub_callback(uintptr_t      client_adapter_ptr,
                                   int64_t        channel_len,
                                   const uint8_t* pattern,
                                   int64_t        pattern_len) {
-    char client_key[32];
-    snprintf(client_key, sizeof(client_key), "%lu", (unsigned long) client_adapter_ptr);
-
-    zval* callback_zv = find_pubsub_callback(client_key);
-    if (callback_zv) {
-        pubsub_callback_info* info = (pubsub_callback_info*) Z_PTR_P(callback_zv);
-        if (info && info->is_active) {
-            pubsub_callback_handler(client_adapter_ptr,
-                                    (int) kind,
-                                    message,
-                                    message_len,
-                                    channel,
-                                    channel_len,
-                                    pattern,
-                                    pattern_len);
-        } else {
-            remove_pubsub_callback(client_key);
-        }
-    }
+    // Inactive entries are left to the PHP thread owning them, the handler just drops the message
+    pubsub_callback_handler(client_adapter_ptr,
+                            (int) kind,
+                            message,
+                            message_len,
+                            channel,
+                            channel_len,
+                            pattern,
+                            pattern_len);
 }
 
 
@@ -737,4 +754,5 @@ void valkey_glide_pubsub_shutdown(void) {
         zend_hash_destroy(&pubsub_callbacks);
         pubsub_callbacks_initialized = false;
     }
+    mutex_destroy(&pubsub_callbacks_lock);
 }
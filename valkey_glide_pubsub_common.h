@@ -103,6 +103,7 @@ void  valkey_glide_pubsub_callback(uintptr_t      client_adapter_ptr,
                                    int64_t        channel_len,
                                    const uint8_t* pattern,
                                    int64_t        pattern_len);
+void  valkey_glide_pubsub_startup(void);
 void  valkey_glide_pubsub_shutdown(void);
 
 // Common pubsub method implementations
@@ -0,0 +1,490 @@
+/** Copyright Valkey GLIDE Project Contributors - SPDX Identifier: Apache-2.0 */
+
+#include "valkey_glide_rate_limiter.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <zend_exceptions.h>
+
+#include "include/glide_bindings.h"
+#include "logger.h"
+#include "valkey_glide_bloom.h"
+#include "valkey_glide_commands_common.h"
+#include "valkey_glide_rate_limiter_arginfo.h"
+#include "valkey_glide_slot.h"
+
+static zend_class_entry*    valkey_glide_rate_limiter_ce;
+static zend_class_entry*    valkey_glide_rate_limit_result_ce;
+static zend_object_handlers valkey_glide_rate_limiter_object_handlers;
+
+#define RATE_LIMIT_NUMBER_MAX 24 /* Room for a formatted zend_long */
+#define RATE_LIMIT_REPLY_LEN 5
+
+/* ====================================================================
+ * SCRIPTS
+ *
+ * Every script sees one key per limit and, per limit, ARGV limit, period in microseconds and
+ * cost. probe() works out the limit's state without writing it back: the allowance before and
+ * after this request, the wait before it would fit, the time until the allowance is full again
+ * before and after, and what commit() needs to store. Nothing is committed unless every limit
+ * has room, and the reply is {allowed, remaining, retry_after_us, reset_after_us, limit_index}.
+ * ==================================================================== */
+
+#define RATE_LIMIT_SCRIPT_PROLOGUE   \
+    "local t = redis.call('TIME')\n" \
+    "local now = tonumber(t[1]) * 1000000 + tonumber(t[2])\n"
+
+#define RATE_LIMIT_SCRIPT_EPILOGUE                                                               \
+    "local probes, allowed = {}, 1\n"                                                            \
+    "for i = 1, #KEYS do\n"                                                                      \
+    "  local limit, period, cost = tonumber(ARGV[3 * i - 2]), tonumber(ARGV[3 * i - 1]),\n"      \
+    "                              tonumber(ARGV[3 * i])\n"                                      \
+    "  probes[i] = {probe(KEYS[i], limit, period, cost)}\n"                                      \
+    "  if probes[i][2] < 0 then allowed = 0 end\n"                                               \
+    "end\n"                                                                                      \
+    "local remaining, which, retry, reset = nil, 1, 0, 0\n"                                      \
+    "for i = 1, #KEYS do\n"                                                                      \
+    "  local p = probes[i]\n"                                                                    \
+    "  local left, full = p[1], p[4]\n"                                                          \
+    "  if allowed == 1 then\n"                                                                   \
+    "    left, full = p[2], p[5]\n"                                                              \
+    "    commit(KEYS[i], tonumber(ARGV[3 * i - 1]), tonumber(ARGV[3 * i]), p[6])\n"              \
+    "  elseif p[2] < 0 and p[3] > retry then\n"                                                  \
+    "    retry, which = p[3], i\n"                                                               \
+    "  end\n"                                                                                    \
+    "  if remaining == nil or left < remaining then\n"                                           \
+    "    remaining = left\n"                                                                     \
+    "    if allowed == 1 then which = i end\n"                                                   \
+    "  end\n"                                                                                    \
+    "  if full > reset then reset = full end\n"                                                  \
+    "end\n"                                                                                      \
+    "return {allowed, math.floor(math.max(remaining, 0)), math.ceil(retry), math.ceil(reset),\n" \
+    "        which - 1}\n"
+
+/* Tokens refill continuously at limit per period, up to limit */
+static const char rate_limit_token_bucket_script[] =
+    RATE_LIMIT_SCRIPT_PROLOGUE
+    "local function probe(key, limit, period, cost)\n"
+    "  local rate = limit / period\n"
+    "  local state = redis.call('HMGET', key, 'tokens', 'ts')\n"
+    "  local tokens = tonumber(state[1])\n"
+    "  if tokens == nil then\n"
+    "    tokens = limit\n"
+    "  else\n"
+    "    tokens = math.min(limit, tokens + math.max(0, now - tonumber(state[2])) * rate)\n"
+    "  end\n"
+    "  local after = tokens - cost\n"
+    "  local wait = 0\n"
+    "  if after < 0 then wait = math.ceil(-after / rate) end\n"
+    "  return tokens, after, wait, (limit - tokens) / rate, (limit - after) / rate, after\n"
+    "end\n"
+    "local function commit(key, period, cost, tokens)\n"
+    "  redis.call('HSET', key, 'tokens', tokens, 'ts', now)\n"
+    "  redis.call('PEXPIRE', key, math.max(1, math.ceil(period / 1000)))\n"
+    "end\n"
+    RATE_LIMIT_SCRIPT_EPILOGUE;
+
+/* The key holds the theoretical arrival time of the next request, in microseconds */
+static const char rate_limit_gcra_script[] =
+    RATE_LIMIT_SCRIPT_PROLOGUE
+    "local function probe(key, limit, period, cost)\n"
+    "  local interval = period / limit\n"
+    "  local tat = math.max(tonumber(redis.call('GET', key)) or now, now)\n"
+    "  local new_tat = tat + interval * cost\n"
+    "  local before = math.floor((now - tat + period) / interval + 1e-9)\n"
+    "  local wait = 0\n"
+    "  if before < cost then wait = math.max(1, new_tat - period - now) end\n"
+    "  return before, before - cost, wait, tat - now, new_tat - now, new_tat\n"
+    "end\n"
+    "local function commit(key, period, cost, tat)\n"
+    "  if cost > 0 then\n"
+    "    redis.call('SET', key, string.format('%.0f', tat), 'PX',\n"
+    "               math.max(1, math.ceil((tat - now) / 1000)))\n"
+    "  end\n"
+    "end\n"
+    RATE_LIMIT_SCRIPT_EPILOGUE;
+
+/* One sorted set entry per counted request, scored by its time */
+static const char rate_limit_sliding_window_script[] =
+    RATE_LIMIT_SCRIPT_PROLOGUE
+    "local function probe(key, limit, period, cost)\n"
+    "  redis.call('ZREMRANGEBYSCORE', key, '-inf', now - period)\n"
+    "  local count = redis.call('ZCARD', key)\n"
+    "  local before = limit - count\n"
+    "  local after = before - cost\n"
+    "  local wait, full = 0, 0\n"
+    "  if count > 0 then\n"
+    "    local newest = redis.call('ZRANGE', key, -1, -1, 'WITHSCORES')\n"
+    "    full = tonumber(newest[2]) + period - now\n"
+    "  end\n"
+    "  if after < 0 then\n"
+    "    local oldest = redis.call('ZRANGE', key, -after - 1, -after - 1, 'WITHSCORES')\n"
+    "    wait = math.max(1, tonumber(oldest[2]) + period - now)\n"
+    "  end\n"
+    "  return before, after, wait, full, cost > 0 and period or full, count\n"
+    "end\n"
+    "local function commit(key, period, cost, count)\n"
+    "  if cost > 0 then\n"
+    "    for j = 1, cost do\n"
+    "      redis.call('ZADD', key, now, string.format('%.0f-%d', now, count + j))\n"
+    "    end\n"
+    "    redis.call('PEXPIRE', key, math.max(1, math.ceil(period / 1000)))\n"
+    "  end\n"
+    "end\n"
+    RATE_LIMIT_SCRIPT_EPILOGUE;
+
+static const char* const rate_limit_scripts[VALKEY_GLIDE_RATE_LIMIT_ALGORITHMS] = {
+    rate_limit_token_bucket_script,
+    rate_limit_gcra_script,
+    rate_limit_sliding_window_script,
+};
+
+/* Hashes glide-core returned for the scripts, registered once at startup */
+static char   rate_limit_hashes[VALKEY_GLIDE_RATE_LIMIT_ALGORITHMS][65];
+static size_t rate_limit_hash_lens[VALKEY_GLIDE_RATE_LIMIT_ALGORITHMS];
+
+static void rate_limit_store_scripts(void) {
+    int i;
+
+    for (i = 0; i < VALKEY_GLIDE_RATE_LIMIT_ALGORITHMS; i++) {
+        struct ScriptHashBuffer* hash_buffer =
+            store_script((const uint8_t*) rate_limit_scripts[i], strlen(rate_limit_scripts[i]));
+
+        if (hash_buffer && hash_buffer->ptr && hash_buffer->len < sizeof(rate_limit_hashes[i])) {
+            memcpy(rate_limit_hashes[i], hash_buffer->ptr, hash_buffer->len);
+            rate_limit_hash_lens[i] = hash_buffer->len;
+        }
+        if (hash_buffer) {
+            free_script_hash_buffer(hash_buffer);
+        }
+    }
+}
+
+/* ====================================================================
+ * OBJECT HANDLERS
+ * ==================================================================== */
+
+static zend_object* create_valkey_glide_rate_limiter_object(zend_class_entry* ce) {
+    valkey_glide_rate_limiter_object* limiter =
+        ecalloc(1, sizeof(valkey_glide_rate_limiter_object) + zend_object_properties_size(ce));
+
+    zend_object_std_init(&limiter->std, ce);
+    object_properties_init(&limiter->std, ce);
+
+    ZVAL_UNDEF(&limiter->client);
+    limiter->algorithm    = VALKEY_GLIDE_RATE_LIMIT_GCRA;
+    limiter->std.handlers = &valkey_glide_rate_limiter_object_handlers;
+
+    return &limiter->std;
+}
+
+static void free_valkey_glide_rate_limiter_object(zend_object* object) {
+    valkey_glide_rate_limiter_object* limiter = VALKEY_GLIDE_RATE_LIMITER_GET_OBJECT(object);
+
+    zval_ptr_dtor(&limiter->client);
+    zend_object_std_dtor(&limiter->std);
+}
+
+/* The client is the only reference the limiter holds */
+static HashTable* get_gc_valkey_glide_rate_limiter_object(zend_object* object,
+                                                          zval**       table,
+                                                          int*         n) {
+    valkey_glide_rate_limiter_object* limiter = VALKEY_GLIDE_RATE_LIMITER_GET_OBJECT(object);
+
+    *table = &limiter->client;
+    *n     = 1;
+    return zend_std_get_properties(object);
+}
+
+/* ====================================================================
+ * CHECKING LIMITS
+ * ==================================================================== */
+
+/* A limit from check(), in either its associative or its positional form */
+static zval* rate_limit_field(HashTable* limit, const char* name, size_t name_len, zend_ulong pos) {
+    zval* value = zend_hash_str_find(limit, name, name_len);
+
+    if (!value) {
+        value = zend_hash_index_find(limit, pos);
+    }
+    if (value) {
+        ZVAL_DEREF(value);
+    }
+    return value;
+}
+
+static void rate_limit_result(zval* return_value, const CommandResponse* reply) {
+    zend_object* result;
+
+    object_init_ex(return_value, valkey_glide_rate_limit_result_ce);
+    result = Z_OBJ_P(return_value);
+
+    /* Properties in declaration order */
+    ZVAL_BOOL(OBJ_PROP_NUM(result, 0), reply[0].int_value != 0);
+    ZVAL_LONG(OBJ_PROP_NUM(result, 1), (zend_long) reply[1].int_value);
+    ZVAL_DOUBLE(OBJ_PROP_NUM(result, 2), (double) reply[2].int_value / 1e6);
+    ZVAL_DOUBLE(OBJ_PROP_NUM(result, 3), (double) reply[3].int_value / 1e6);
+    ZVAL_LONG(OBJ_PROP_NUM(result, 4), (zend_long) reply[4].int_value);
+}
+
+static void rate_limit_check(valkey_glide_rate_limiter_object* limiter,
+                             HashTable*                        limits,
+                             zval*                             return_value) {
+    valkey_glide_object* valkey_glide =
+        VALKEY_GLIDE_PHP_ZVAL_GET_OBJECT(valkey_glide_object, &limiter->client);
+    uint32_t count = zend_hash_num_elements(limits);
+    bool is_cluster = instanceof_function(Z_OBJCE(limiter->client), get_valkey_glide_cluster_ce());
+
+    int      slot = -1;
+    uint32_t i    = 0;
+    zval*    entry;
+
+    if (!valkey_glide || !valkey_glide->glide_client) {
+        zend_throw_exception(get_valkey_glide_exception_ce(), "The client is not connected", 0);
+        return;
+    }
+    if (count == 0) {
+        zend_throw_exception(
+            get_valkey_glide_exception_ce(), "At least one rate limit is required", 0);
+        return;
+    }
+    if (rate_limit_hash_lens[limiter->algorithm] == 0) {
+        zend_throw_exception(
+            get_valkey_glide_exception_ce(), "The rate limit script could not be registered", 0);
+        return;
+    }
+
+    uintptr_t*  keys     = safe_emalloc(count, sizeof(uintptr_t), 0);
+    uintptr_t*  keys_len = safe_emalloc(count, sizeof(uintptr_t), 0);
+    uintptr_t*  args     = safe_emalloc(count, 3 * sizeof(uintptr_t), 0);
+    uintptr_t*  args_len = safe_emalloc(count, 3 * sizeof(uintptr_t), 0);
+    char*       numbers  = safe_emalloc(count, 3 * RATE_LIMIT_NUMBER_MAX, 0);
+    const char* error    = NULL;
+
+    ZEND_HASH_FOREACH_VAL(limits, entry) {
+        ZVAL_DEREF(entry);
+        if (Z_TYPE_P(entry) != IS_ARRAY) {
+            error = "Every rate limit must be an array";
+            break;
+        }
+
+        zval* key    = rate_limit_field(Z_ARRVAL_P(entry), ZEND_STRL("key"), 0);
+        zval* limit  = rate_limit_field(Z_ARRVAL_P(entry), ZEND_STRL("limit"), 1);
+        zval* period = rate_limit_field(Z_ARRVAL_P(entry), ZEND_STRL("period"), 2);
+        zval* cost   = rate_limit_field(Z_ARRVAL_P(entry), ZEND_STRL("cost"), 3);
+
+        if (!key || Z_TYPE_P(key) != IS_STRING || !limit || !period) {
+            error = "Every rate limit needs a string key, a limit and a period";
+            break;
+        }
+
+        zend_long limit_value  = zval_get_long(limit);
+        double    period_value = zval_get_double(period) * 1e6;
+        zend_long cost_value   = cost ? zval_get_long(cost) : 1;
+
+        if (limit_value <= 0 || period_value < 1 || period_value > (double) ZEND_LONG_MAX) {
+            error = "A rate limit needs a positive limit and period";
+            break;
+        }
+        if (cost_value < 0 || cost_value > limit_value) {
+            error = "A rate limit cost must be between 0 and the limit";
+            break;
+        }
+
+        if (is_cluster) {
+            int key_slot = valkey_glide_key_slot(Z_STRVAL_P(key), Z_STRLEN_P(key));
+            if (slot >= 0 && key_slot != slot) {
+                error = "All rate limit keys of a call must map to the same slot";
+                break;
+            }
+            slot = key_slot;
+        }
+
+        keys[i]     = (uintptr_t) Z_STRVAL_P(key);
+        keys_len[i] = Z_STRLEN_P(key);
+
+        zend_long values[3] = {limit_value, (zend_long) period_value, cost_value};
+        for (int j = 0; j < 3; j++) {
+            char* buf           = numbers + (3 * i + j) * RATE_LIMIT_NUMBER_MAX;
+            args[3 * i + j]     = (uintptr_t) buf;
+            args_len[3 * i + j] = snprintf(buf, RATE_LIMIT_NUMBER_MAX, ZEND_LONG_FMT, values[j]);
+        }
+        i++;
+    }
+    ZEND_HASH_FOREACH_END();
+
+    if (!error) {
+        const char* hash = rate_limit_hashes[limiter->algorithm];
+        valkey_glide_drop_next_call_options(valkey_glide->glide_client);
+        for (uint32_t k = 0; k < count; k++) {
+            valkey_glide_bloom_record_key(
+                valkey_glide->glide_client, (const char*) keys[k], keys_len[k]);
+        }
+        CommandResult* result = invoke_script(valkey_glide->glide_client,
+                                              0, /* callback_index (not used for sync) */
+                                              (const uint8_t*) hash,
+                                              rate_limit_hash_lens[limiter->algorithm],
+                                              count,
+                                              keys,
+                                              keys_len,
+                                              3 * (size_t) count,
+                                              args,
+                                              args_len,
+                                              NULL, /* route_bytes */
+                                              0);
+
+        if (!result || result->command_error || !result->response ||
+            result->response->response_type != Array ||
+            result->response->array_value_len != RATE_LIMIT_REPLY_LEN) {
+            VALKEY_LOG_WARN_FMT("rate_limiter",
+                                "Rate limit script failed: %s",
+                                result && result->command_error &&
+                                        result->command_error->command_error_message
+                                    ? result->command_error->command_error_message
+                                    : "unexpected reply");
+            ZVAL_FALSE(return_value);
+        } else {
+            rate_limit_result(return_value, result->response->array_value);
+        }
+        if (result) {
+            free_command_result(result);
+        }
+    }
+
+    efree(keys);
+    efree(keys_len);
+    efree(args);
+    efree(args_len);
+    efree(numbers);
+
+    if (error) {
+        zend_throw_exception(get_valkey_glide_exception_ce(), error, 0);
+    }
+}
+
+/* ====================================================================
+ * METHODS
+ * ==================================================================== */
+
+/**
+ * Constructor: new ValkeyGlideRateLimiter($client, $algorithm = GCRA)
+ */
+PHP_METHOD(ValkeyGlideRateLimiter, __construct) {
+    zval*                             client;
+    zend_long                         algorithm = VALKEY_GLIDE_RATE_LIMIT_GCRA;
+    valkey_glide_rate_limiter_object* limiter;
+
+    ZEND_PARSE_PARAMETERS_START(1, 2)
+    Z_PARAM_OBJECT(client)
+    Z_PARAM_OPTIONAL
+    Z_PARAM_LONG(algorithm)
+    ZEND_PARSE_PARAMETERS_END_EX(RETURN_THROWS());
+
+    if (!instanceof_function(Z_OBJCE_P(client), get_valkey_glide_ce()) &&
+        !instanceof_function(Z_OBJCE_P(client), get_valkey_glide_cluster_ce())) {
+        zend_argument_type_error(1,
+                                 "must be of type ValkeyGlide|ValkeyGlideCluster, %s given",
+                                 zend_zval_type_name(client));
+        RETURN_THROWS();
+    }
+    if (algorithm < 0 || algorithm >= VALKEY_GLIDE_RATE_LIMIT_ALGORITHMS) {
+        zend_argument_value_error(2, "must be one of the ValkeyGlideRateLimiter algorithms");
+        RETURN_THROWS();
+    }
+
+    limiter = VALKEY_GLIDE_RATE_LIMITER_ZVAL_GET_OBJECT(ZEND_THIS);
+    zval_ptr_dtor(&limiter->client);
+    ZVAL_COPY(&limiter->client, client);
+    limiter->algorithm = algorithm;
+}
+
+/**
+ * check(array $limits): Check the limits, counting the request if they all allow it
+ */
+PHP_METHOD(ValkeyGlideRateLimiter, check) {
+    HashTable*                        limits;
+    valkey_glide_rate_limiter_object* limiter =
+        VALKEY_GLIDE_RATE_LIMITER_ZVAL_GET_OBJECT(ZEND_THIS);
+
+    ZEND_PARSE_PARAMETERS_START(1, 1)
+    Z_PARAM_ARRAY_HT(limits)
+    ZEND_PARSE_PARAMETERS_END_EX(RETURN_THROWS());
+
+    if (Z_ISUNDEF(limiter->client)) {
+        zend_throw_error(NULL, "ValkeyGlideRateLimiter has not been constructed");
+        RETURN_THROWS();
+    }
+    rate_limit_check(limiter, limits, return_value);
+}
+
+/**
+ * allow(string $key, int $limit, float $period, int $cost = 1): Check a single limit
+ */
+PHP_METHOD(ValkeyGlideRateLimiter, allow) {
+    zend_string*                      key;
+    zend_long                         limit;
+    double                            period;
+    zend_long                         cost = 1;
+    valkey_glide_rate_limiter_object* limiter =
+        VALKEY_GLIDE_RATE_LIMITER_ZVAL_GET_OBJECT(ZEND_THIS);
+    zval                              limits, entry;
+
+    ZEND_PARSE_PARAMETERS_START(3, 4)
+    Z_PARAM_STR(key)
+    Z_PARAM_LONG(limit)
+    Z_PARAM_DOUBLE(period)
+    Z_PARAM_OPTIONAL
+    Z_PARAM_LONG(cost)
+    ZEND_PARSE_PARAMETERS_END_EX(RETURN_THROWS());
+
+    if (Z_ISUNDEF(limiter->client)) {
+        zend_throw_error(NULL, "ValkeyGlideRateLimiter has not been constructed");
+        RETURN_THROWS();
+    }
+
+    array_init_size(&entry, 4);
+    add_next_index_str(&entry, zend_string_copy(key));
+    add_next_index_long(&entry, limit);
+    add_next_index_double(&entry, period);
+    add_next_index_long(&entry, cost);
+    array_init_size(&limits, 1);
+    add_next_index_zval(&limits, &entry);
+
+    rate_limit_check(limiter, Z_ARRVAL(limits), return_value);
+    zval_ptr_dtor(&limits);
+}
+
+/**
+ * getAlgorithm(): The algorithm constant the limiter was created with
+ */
+PHP_METHOD(ValkeyGlideRateLimiter, getAlgorithm) {
+    ZEND_PARSE_PARAMETERS_NONE();
+
+    RETURN_LONG(VALKEY_GLIDE_RATE_LIMITER_ZVAL_GET_OBJECT(ZEND_THIS)->algorithm);
+}
+
+/* Results are only made by the limiter */
+PHP_METHOD(ValkeyGlideRateLimitResult, __construct) {
+}
+
+/* Class registration function using generated arginfo */
+void register_valkey_glide_rate_limiter_class(void) {
+    valkey_glide_rate_limiter_ce = register_class_ValkeyGlideRateLimiter();
+    valkey_glide_rate_limiter_ce->create_object = create_valkey_glide_rate_limiter_object;
+    valkey_glide_rate_limit_result_ce           = register_class_ValkeyGlideRateLimitResult();
+
+    memcpy(&valkey_glide_rate_limiter_object_handlers,
+           zend_get_std_object_handlers(),
+           sizeof(valkey_glide_rate_limiter_object_handlers));
+    valkey_glide_rate_limiter_object_handlers.offset =
+        XtOffsetOf(valkey_glide_rate_limiter_object, std);
+    valkey_glide_rate_limiter_object_handlers.free_obj  = free_valkey_glide_rate_limiter_object;
+    valkey_glide_rate_limiter_object_handlers.get_gc    = get_gc_valkey_glide_rate_limiter_object;
+    valkey_glide_rate_limiter_object_handlers.clone_obj = NULL;
+
+    rate_limit_store_scripts();
+}
+
+zend_class_entry* get_valkey_glide_rate_limiter_ce(void) {
+    return valkey_glide_rate_limiter_ce;
+}
@@ -0,0 +1,36 @@
+/** Copyright Valkey GLIDE Project Contributors - SPDX Identifier: Apache-2.0 */
+
+#ifndef VALKEY_GLIDE_RATE_LIMITER_H
+#define VALKEY_GLIDE_RATE_LIMITER_H
+
+#include "common.h"
+#include "php.h"
+
+/*
+ * ValkeyGlideRateLimiter, rate limits checked by a server-side script.
+ *
+ * Each algorithm is a Lua script registered with glide-core once per process and invoked by
+ * hash, glide-core loading it on the server on a NOSCRIPT. A call checks any number of limits,
+ * all keys in one slot, and only counts the request if every limit allows it. The script
+ * replies with plain integers that become a ValkeyGlideRateLimitResult.
+ */
+#define VALKEY_GLIDE_RATE_LIMIT_TOKEN_BUCKET 0
+#define VALKEY_GLIDE_RATE_LIMIT_GCRA 1
+#define VALKEY_GLIDE_RATE_LIMIT_SLIDING_WINDOW 2
+#define VALKEY_GLIDE_RATE_LIMIT_ALGORITHMS 3
+
+typedef struct {
+    zval        client; /* The ValkeyGlide or ValkeyGlideCluster the limits are checked through */
+    zend_long   algorithm;
+    zend_object std;
+} valkey_glide_rate_limiter_object;
+
+#define VALKEY_GLIDE_RATE_LIMITER_GET_OBJECT(obj) \
+    VALKEY_GLIDE_PHP_GET_OBJECT(valkey_glide_rate_limiter_object, obj)
+#define VALKEY_GLIDE_RATE_LIMITER_ZVAL_GET_OBJECT(zv) \
+    VALKEY_GLIDE_PHP_ZVAL_GET_OBJECT(valkey_glide_rate_limiter_object, zv)
+
+void              register_valkey_glide_rate_limiter_class(void);
+zend_class_entry* get_valkey_glide_rate_limiter_ce(void);
+
+#endif /* VALKEY_GLIDE_RATE_LIMITER_H */
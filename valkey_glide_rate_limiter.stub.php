@@ -0,0 +1,122 @@
+<?php
+
+/**
+ * @generate-function-entries
+ * @generate-legacy-arginfo
+ * @generate-class-entries
+ */
+
+/**
+ * ValkeyGlideRateLimiter checks rate limits with a server-side script.
+ *
+ * The script for each algorithm is registered with the client core once per process and then
+ * invoked by hash, so its body is only sent if the server does not have it cached. Several
+ * limits can be checked in one round trip, for example a per-user and a per-IP limit. They are
+ * all-or-nothing: a request is only counted against any of them if all of them allow it. With a
+ * cluster client, every key of a call must map to the same slot, use a {hash tag}.
+ *
+ * @example
+ * $limiter = new ValkeyGlideRateLimiter($client);
+ * $result = $limiter->check([
+ *     ['key' => '{user:42}:minute', 'limit' => 100, 'period' => 60],
+ *     ['key' => '{user:42}:burst', 'limit' => 5, 'period' => 1],
+ * ]);
+ * if (!$result->allowed) {
+ *     header('Retry-After: ' . ceil($result->retryAfter));
+ * }
+ */
+final class ValkeyGlideRateLimiter
+{
+    /**
+     * Token bucket: a bucket of `limit` tokens refilled at `limit` per `period`.
+     *
+     * @var int
+     */
+    public const TOKEN_BUCKET = 0;
+
+    /**
+     * Generic cell rate algorithm: requests spaced `period / limit` apart on average, with
+     * bursts of up to `limit`. Stores a single timestamp per key.
+     *
+     * @var int
+     */
+    public const GCRA = 1;
+
+    /**
+     * Sliding window log: at most `limit` requests in any `period`. Exact, but keeps one
+     * sorted set entry per request.
+     *
+     * @var int
+     */
+    public const SLIDING_WINDOW = 2;
+
+    /**
+     * Create a rate limiter.
+     *
+     * @param ValkeyGlide|ValkeyGlideCluster $client    The client to check limits through.
+     * @param int                            $algorithm One of the algorithm constants.
+     */
+    public function __construct(ValkeyGlide|ValkeyGlideCluster $client, int $algorithm = ValkeyGlideRateLimiter::GCRA)
+    {
+    }
+
+    /**
+     * Check one or more limits and count the request against them if they all allow it.
+     *
+     * @param array $limits The limits, each an array with:
+     *                      - 'key': the key holding the limit's state
+     *                      - 'limit': requests allowed per period
+     *                      - 'period': the period in seconds, fractions allowed
+     *                      - 'cost': how many requests this one counts for, 1 by default.
+     *                        A cost of 0 checks the limits without counting anything.
+     *                      Positional arrays [key, limit, period, cost] work too.
+     *
+     * @return ValkeyGlideRateLimitResult|false The outcome, or false if the script failed.
+     */
+    public function check(array $limits): ValkeyGlideRateLimitResult|false
+    {
+    }
+
+    /**
+     * Check a single limit, the shorthand for check([[$key, $limit, $period, $cost]]).
+     *
+     * @see ValkeyGlideRateLimiter::check
+     */
+    public function allow(string $key, int $limit, float $period, int $cost = 1): ValkeyGlideRateLimitResult|false
+    {
+    }
+
+    /**
+     * Get the algorithm the limiter uses.
+     *
+     * @return int One of the algorithm constants.
+     */
+    public function getAlgorithm(): int
+    {
+    }
+}
+
+/**
+ * The outcome of a ValkeyGlideRateLimiter check.
+ */
+final class ValkeyGlideRateLimitResult
+{
+    /** Whether the request was allowed, and counted. */
+    public readonly bool $allowed;
+
+    /** Requests still allowed right now by the tightest limit. */
+    public readonly int $remaining;
+
+    /** Seconds until the request would be allowed, 0 when it was. */
+    public readonly float $retryAfter;
+
+    /** Seconds until every limit is back to its full allowance. */
+    public readonly float $resetAfter;
+
+    /** Index in $limits of the limit that decided: the one that refused, or the tightest. */
+    public readonly int $limit;
+
+    private function __construct()
+    {
+    }
+}
@@ -19,6 +19,10 @@
 #include "command_response.h"
 #include "common.h"
 #include "logger.h"
+#include "valkey_glide_breaker.h"
+#include "valkey_glide_hot_keys.h"
+#include "valkey_glide_memory.h"
+#include "valkey_glide_node_stats.h"
 #include "valkey_glide_z_common.h"
 
 /* Import the string conversion functions from command_response.c */
@@ -730,11 +734,12 @@ int execute_s_generic_command(valkey_glide_object* valkey_glide,
                               s_response_type_t    response_type,
                               s_command_args_t*    args,
                               zval*                return_value) {
-    uintptr_t*     cmd_args  = NULL;
-    unsigned long* args_len  = NULL;
-    int            arg_count = 0;
-    int            status    = 0;
-    CommandResult* result    = NULL;
+    uintptr_t*       cmd_args  = NULL;
+    unsigned long*   args_len  = NULL;
+    int              arg_count = 0;
+    int              status    = 0;
+    CommandResult*   result    = NULL;
+    CommandResponse* reply     = NULL;
 
     /* Validate basic parameters */
     if (!valkey_glide->glide_client || !args) {
@@ -791,6 +796,10 @@ int execute_s_generic_command(valkey_glide_object* valkey_glide,
     if (arg_count <= 0 || !cmd_args || !args_len) {
         goto cleanup;
     }
+    valkey_glide_hot_keys_record(valkey_glide, args->key, args->key_len, args_len, arg_count);
+    valkey_glide_node_stats_record(valkey_glide, args->key, args->key_len);
+    valkey_glide_breaker_record(valkey_glide, args->key, args->key_len);
+
     scan_data_t*         scan_data      = NULL;
     z_result_processor_t process_result = NULL;
     switch (response_type) {
@@ -832,9 +841,10 @@ int execute_s_generic_command(valkey_glide_object* valkey_glide,
     }
 
     /* Execute the command synchronously */
-    result = execute_command(valkey_glide->glide_client, cmd_type, arg_count, cmd_args, args_len);
+    result = execute_command_for_reply(
+        valkey_glide->glide_client, cmd_type, arg_count, cmd_args, args_len, &reply);
     if (result) {
-        status = process_result(result->response, scan_data, return_value);
+        status = process_result(reply, scan_data, return_value);
     }
     free_command_result(result);
 
@@ -1845,6 +1855,7 @@ int execute_cluster_scan_command(const void* glide_client,
     }
 
     /* Call request_cluster_scan FFI function directly */
+    valkey_glide_drop_next_call_options(glide_client);
     CommandResult* result =
         request_cluster_scan(glide_client, 0, *cursor, arg_count, args, args_len);
 
@@ -1861,6 +1872,9 @@ int execute_cluster_scan_command(const void* glide_client,
         success = process_s_scan_result_async(result->response, &scan_args, return_value);
         /* Convert legacy "finished" cursor to "0" for backward compatibility */
         *cursor = scan_args.cursor;
+        if (success) {
+            valkey_glide_mem_scan_cursor_opened(*cursor);
+        }
         if (*cursor && strcmp(*cursor, "finished") == 0) {
             remove_cluster_scan_cursor(*cursor);
             efree(*cursor);
@@ -1977,8 +1991,14 @@ int execute_scan_command(zval* object, int argc, zval* return_value, zend_class_
             /* Update ClusterScanCursor object with new cursor value directly */
             cluster_scan_cursor_object* cursor_obj = CLUSTER_SCAN_CURSOR_ZVAL_GET_OBJECT(z_iter);
 
-
+            /* Scanning again with the same cursor object replaces the previous next cursor */
+            if (cursor_obj->next_cursor_id) {
+                valkey_glide_mem_free(VALKEY_GLIDE_MEM_SCAN,
+                                      strlen(cursor_obj->next_cursor_id) + 1);
+                efree(cursor_obj->next_cursor_id);
+            }
             cursor_obj->next_cursor_id = estrdup(cursor_ptr);
+            valkey_glide_mem_alloc(VALKEY_GLIDE_MEM_SCAN, strlen(cursor_ptr) + 1);
 
             efree(cursor_ptr);
             return 1;
@@ -0,0 +1,26 @@
+/** Copyright Valkey GLIDE Project Contributors - SPDX Identifier: Apache-2.0 */
+
+#ifndef VALKEY_GLIDE_SLOT_H
+#define VALKEY_GLIDE_SLOT_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "common.h"
+
+#define VALKEY_GLIDE_CLUSTER_SLOTS 16384
+
+/* Hash slot of key, honouring {hash tags} */
+uint16_t valkey_glide_key_slot(const char* key, size_t key_len);
+
+/*
+ * Ask glide_client for CLUSTER SLOTS and fill owners, one entry per slot, with the index of the
+ * primary serving it in nodes, an array of "host:port" => index. Slots no node serves are set to
+ * VALKEY_GLIDE_CLUSTER_SLOTS. Throws and returns false if the command fails.
+ *
+ * The command is sent with command() rather than execute_command(): it isn't counted by the
+ * statistics, gated by the breakers or run in a Fiber, and leaves the next-call options alone.
+ */
+bool valkey_glide_slot_owners(const void* glide_client, uint16_t* owners, zval* nodes);
+
+#endif /* VALKEY_GLIDE_SLOT_H */
@@ -0,0 +1,533 @@
+/** Copyright Valkey GLIDE Project Contributors - SPDX Identifier: Apache-2.0 */
+
+#include "valkey_glide_slowlog.h"
+
+#include <ctype.h>
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/time.h>
+#include <time.h>
+#include <zend_exceptions.h>
+
+#include "command_response.h"
+#include "include/glide/command_request.pb-c.h"
+
+typedef struct {
+    uint64_t         id;
+    double           timestamp;   /* Unix time the call returned */
+    uint64_t         recorded_ns; /* The same, on the valkey_glide_slowlog_now() clock */
+    uint64_t         duration_us;
+    uint64_t         fingerprint;
+    uint64_t         arg_bytes;
+    uint64_t         reply_bytes;
+    uint32_t         arg_count; /* Commands in the batch for batches */
+    enum RequestType command_type;
+    bool             is_batch;
+    bool             is_atomic;
+    bool             failed;
+    size_t           command_len; /* Of the name sent as first argument of CustomCommand */
+
+    /* The first argument, the key of keyed commands, and the next few, all truncated */
+    size_t key_len;
+    char   key[VALKEY_GLIDE_SLOWLOG_KEY_MAX];
+    int    args_kept;
+    size_t args_len[VALKEY_GLIDE_SLOWLOG_ARGS];
+    char   args[VALKEY_GLIDE_SLOWLOG_ARGS][VALKEY_GLIDE_SLOWLOG_ARG_MAX];
+    char   route[VALKEY_GLIDE_SLOWLOG_ROUTE_MAX];
+    char   command[VALKEY_GLIDE_SLOWLOG_ARG_MAX];
+} slowlog_entry;
+
+struct valkey_glide_slowlog {
+    zend_long     threshold_us;
+    uint64_t      next_id;
+    uint64_t      next_expiry_ns; /* Aged entries are looked for at most once per second */
+    uint32_t      count;
+    slowlog_entry entries[VALKEY_GLIDE_SLOWLOG_ENTRIES]; /* Min-heap, entries[0] is the fastest */
+};
+
+uint64_t valkey_glide_slowlog_now(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t) ts.tv_sec * 1000000000ULL + (uint64_t) ts.tv_nsec;
+}
+
+bool valkey_glide_slowlog_is_slow(const valkey_glide_slowlog* slowlog,
+                                  uint64_t                    start_ns,
+                                  uint64_t*                   duration_us) {
+    uint64_t elapsed_us = (valkey_glide_slowlog_now() - start_ns) / 1000;
+
+    if (elapsed_us < (uint64_t) slowlog->threshold_us) {
+        return false;
+    }
+    *duration_us = elapsed_us;
+    return true;
+}
+
+/* Move the entry at i down the heap until no child is faster */
+static void slowlog_sift_down(valkey_glide_slowlog* slowlog, uint32_t i) {
+    slowlog_entry* entries = slowlog->entries;
+    slowlog_entry  moved   = entries[i];
+
+    for (;;) {
+        uint32_t child = 2 * i + 1;
+        if (child >= slowlog->count) {
+            break;
+        }
+        if (child + 1 < slowlog->count &&
+            entries[child + 1].duration_us < entries[child].duration_us) {
+            child++;
+        }
+        if (entries[child].duration_us >= moved.duration_us) {
+            break;
+        }
+        entries[i] = entries[child];
+        i          = child;
+    }
+    entries[i] = moved;
+}
+
+/* Drop the entries recorded more than VALKEY_GLIDE_SLOWLOG_MAX_AGE_S ago */
+static void slowlog_expire(valkey_glide_slowlog* slowlog, uint64_t now_ns) {
+    uint64_t max_age_ns = (uint64_t) VALKEY_GLIDE_SLOWLOG_MAX_AGE_S * 1000000000ULL;
+    uint32_t kept       = 0;
+
+    if (now_ns < slowlog->next_expiry_ns) {
+        return;
+    }
+    slowlog->next_expiry_ns = now_ns + 1000000000ULL;
+
+    for (uint32_t i = 0; i < slowlog->count; i++) {
+        if (now_ns - slowlog->entries[i].recorded_ns <= max_age_ns) {
+            if (kept != i) {
+                slowlog->entries[kept] = slowlog->entries[i];
+            }
+            kept++;
+        }
+    }
+    if (kept == slowlog->count) {
+        return;
+    }
+
+    slowlog->count = kept;
+    for (uint32_t i = kept / 2; i-- > 0;) {
+        slowlog_sift_down(slowlog, i);
+    }
+}
+
+/*
+ * Slot for a call that took duration_us, NULL when all of the slowest calls kept took longer.
+ * Entries are moved along the heap by duration only, the returned one is then filled in.
+ */
+static slowlog_entry* slowlog_next_entry(valkey_glide_slowlog* slowlog, uint64_t duration_us) {
+    slowlog_entry* entries = slowlog->entries;
+    uint64_t       now_ns  = valkey_glide_slowlog_now();
+    uint32_t       i;
+    struct timeval now;
+
+    /* A full heap only takes slower calls, aged entries must make room for the others */
+    if (slowlog->count == VALKEY_GLIDE_SLOWLOG_ENTRIES) {
+        slowlog_expire(slowlog, now_ns);
+    }
+
+    if (slowlog->count < VALKEY_GLIDE_SLOWLOG_ENTRIES) {
+        /* Sift up from the end */
+        for (i = slowlog->count++; i > 0; i = (i - 1) / 2) {
+            if (entries[(i - 1) / 2].duration_us <= duration_us) {
+                break;
+            }
+            entries[i] = entries[(i - 1) / 2];
+        }
+    } else if (duration_us <= entries[0].duration_us) {
+        return NULL;
+    } else {
+        /* Replace the fastest one, sifting down from the root */
+        for (i = 0;;) {
+            uint32_t child = 2 * i + 1;
+            if (child >= VALKEY_GLIDE_SLOWLOG_ENTRIES) {
+                break;
+            }
+            if (child + 1 < VALKEY_GLIDE_SLOWLOG_ENTRIES &&
+                entries[child + 1].duration_us < entries[child].duration_us) {
+                child++;
+            }
+            if (entries[child].duration_us >= duration_us) {
+                break;
+            }
+            entries[i] = entries[child];
+            i          = child;
+        }
+    }
+
+    slowlog_entry* entry = &entries[i];
+    gettimeofday(&now, NULL);
+    memset(entry, 0, offsetof(slowlog_entry, key));
+    entry->id          = slowlog->next_id++;
+    entry->timestamp   = (double) now.tv_sec + (double) now.tv_usec / 1e6;
+    entry->recorded_ns = now_ns;
+    entry->duration_us = duration_us;
+    entry->key_len     = 0;
+    entry->args_kept   = 0;
+    return entry;
+}
+
+/* FNV-1a */
+static uint64_t slowlog_hash(uint64_t hash, const void* data, size_t len) {
+    const unsigned char* bytes = data;
+    for (size_t i = 0; i < len; i++) {
+        hash ^= bytes[i];
+        hash *= 0x100000001B3ULL;
+    }
+    return hash;
+}
+
+/* Reply size: string payloads, plus 8 bytes per number */
+static uint64_t slowlog_reply_bytes(const CommandResponse* response) {
+    uint64_t bytes = 0;
+    int64_t  i;
+
+    switch (response->response_type) {
+        case Int:
+            return sizeof(int64_t);
+        case Float:
+            return sizeof(double);
+        case Bool:
+            return 1;
+        case String:
+            return (uint64_t) response->string_value_len;
+        case Array:
+            for (i = 0; i < response->array_value_len; i++) {
+                bytes += slowlog_reply_bytes(&response->array_value[i]);
+            }
+            return bytes;
+        case Map:
+            for (i = 0; i < response->array_value_len; i++) {
+                const CommandResponse* element = &response->array_value[i];
+                if (element->map_key) {
+                    bytes += slowlog_reply_bytes(element->map_key);
+                }
+                if (element->map_value) {
+                    bytes += slowlog_reply_bytes(element->map_value);
+                }
+            }
+            return bytes;
+        case Sets:
+            for (i = 0; i < response->sets_value_len; i++) {
+                bytes += slowlog_reply_bytes(&response->sets_value[i]);
+            }
+            return bytes;
+        default:
+            return 0;
+    }
+}
+
+static void slowlog_set_result(slowlog_entry* entry, const CommandResult* result) {
+    entry->failed = !result || result->command_error;
+    if (result && result->response) {
+        entry->reply_bytes += slowlog_reply_bytes(result->response);
+    }
+}
+
+void valkey_glide_slowlog_add_command(valkey_glide_slowlog* slowlog,
+                                      uint64_t              duration_us,
+                                      enum RequestType      command_type,
+                                      unsigned long         arg_count,
+                                      const uintptr_t*      args,
+                                      const unsigned long*  args_len,
+                                      const char*           route,
+                                      const CommandResult*  result) {
+    slowlog_entry* entry = slowlog_next_entry(slowlog, duration_us);
+    if (!entry) {
+        return;
+    }
+
+    uint64_t hash = slowlog_hash(0xCBF29CE484222325ULL, &command_type, sizeof(command_type));
+
+    /* Raw commands are named by their first argument */
+    unsigned long first = 0;
+    if (command_type == CustomCommand && arg_count > 0) {
+        entry->command_len = MIN(args_len[0], VALKEY_GLIDE_SLOWLOG_ARG_MAX);
+        memcpy(entry->command, (const char*) args[0], entry->command_len);
+        first = 1;
+    }
+
+    entry->command_type = command_type;
+    entry->arg_count    = (uint32_t) (arg_count - first);
+
+    for (unsigned long i = 0; i < arg_count; i++) {
+        const char* arg = (const char*) args[i];
+        size_t      len = args_len[i];
+
+        entry->arg_bytes += len;
+        hash = slowlog_hash(hash, &len, sizeof(len));
+        hash = slowlog_hash(hash, arg, len);
+
+        if (i < first) {
+            continue;
+        } else if (i == first) {
+            entry->key_len = len;
+            memcpy(entry->key, arg, MIN(len, VALKEY_GLIDE_SLOWLOG_KEY_MAX));
+        } else if (entry->args_kept < VALKEY_GLIDE_SLOWLOG_ARGS) {
+            entry->args_len[entry->args_kept] = len;
+            memcpy(entry->args[entry->args_kept], arg, MIN(len, VALKEY_GLIDE_SLOWLOG_ARG_MAX));
+            entry->args_kept++;
+        }
+    }
+    entry->fingerprint = hash;
+
+    snprintf(entry->route, sizeof(entry->route), "%s", route ? route : "default");
+    slowlog_set_result(entry, result);
+}
+
+void valkey_glide_slowlog_add_batch(valkey_glide_slowlog* slowlog,
+                                    uint64_t              duration_us,
+                                    bool                  is_atomic,
+                                    size_t                command_count,
+                                    size_t                payload_bytes,
+                                    const CommandResult*  result) {
+    slowlog_entry* entry = slowlog_next_entry(slowlog, duration_us);
+    if (!entry) {
+        return;
+    }
+
+    entry->is_batch    = true;
+    entry->is_atomic   = is_atomic;
+    entry->arg_count   = (uint32_t) command_count;
+    entry->arg_bytes   = payload_bytes;
+    entry->fingerprint = slowlog_hash(0xCBF29CE484222325ULL, &command_count, sizeof(size_t));
+
+    snprintf(entry->route, sizeof(entry->route), "default");
+    slowlog_set_result(entry, result);
+}
+
+bool valkey_glide_set_slowlog_threshold(valkey_glide_object* valkey_glide, zval* value) {
+    zend_long threshold = zval_get_long(value);
+
+    if (threshold < 0) {
+        valkey_glide_slowlog_release(valkey_glide);
+        return true;
+    }
+
+    /* Recording is keyed by the client handle, which only exists once connected */
+    if (!valkey_glide->glide_client ||
+        valkey_glide_refuse_shared(valkey_glide, "OPT_SLOWLOG_THRESHOLD")) {
+        return false;
+    }
+
+    if (!valkey_glide->slowlog) {
+        valkey_glide->slowlog = ecalloc(1, sizeof(valkey_glide_slowlog));
+        zend_hash_index_update_ptr(&VALKEY_GLIDE_G(slow_logs),
+                                   (zend_ulong) (uintptr_t) valkey_glide->glide_client,
+                                   valkey_glide->slowlog);
+    }
+    valkey_glide->slowlog->threshold_us = threshold;
+    return true;
+}
+
+zend_long valkey_glide_slowlog_threshold(const valkey_glide_object* valkey_glide) {
+    return valkey_glide->slowlog ? valkey_glide->slowlog->threshold_us : -1;
+}
+
+void valkey_glide_slowlog_release(valkey_glide_object* valkey_glide) {
+    if (!valkey_glide->slowlog) {
+        return;
+    }
+
+    /* Objects sharing a client record into the log registered last */
+    zend_ulong index = (zend_ulong) (uintptr_t) valkey_glide->glide_client;
+    if (zend_hash_index_find_ptr(&VALKEY_GLIDE_G(slow_logs), index) == valkey_glide->slowlog) {
+        zend_hash_index_del(&VALKEY_GLIDE_G(slow_logs), index);
+    }
+
+    efree(valkey_glide->slowlog);
+    valkey_glide->slowlog = NULL;
+}
+
+/* Truncated values end like the server's SLOWLOG: "... (N more bytes)" */
+static void add_truncated(
+    zval* output, const char* key, const char* value, size_t len, size_t kept) {
+    if (len <= kept) {
+        add_assoc_stringl_ex(output, key, strlen(key), value, len);
+        return;
+    }
+
+    zend_string* str = strpprintf(0, "%.*s... (%zu more bytes)", (int) kept, value, len - kept);
+    add_assoc_str_ex(output, key, strlen(key), str);
+}
+
+static void add_truncated_arg(zval* output, const char* value, size_t len, size_t kept) {
+    if (len <= kept) {
+        add_next_index_stringl(output, value, len);
+        return;
+    }
+
+    add_next_index_str(output,
+                       strpprintf(0, "%.*s... (%zu more bytes)", (int) kept, value, len - kept));
+}
+
+/* Commands of request types named after a container command and its subcommand */
+static const char* const slowlog_containers[] = {"Acl",
+                                                 "Client",
+                                                 "Cluster",
+                                                 "Command",
+                                                 "Config",
+                                                 "Function",
+                                                 "Latency",
+                                                 "Memory",
+                                                 "Module",
+                                                 "Object",
+                                                 "PubSub",
+                                                 "Script",
+                                                 "XGroup",
+                                                 "XInfo"};
+
+/* Upper-case copy of name, with a space after its first split_at bytes if not 0 */
+static zend_string* slowlog_upper(const char* name, size_t name_len, size_t split_at) {
+    zend_string* upper = zend_string_alloc(name_len + (split_at ? 1 : 0), 0);
+    char*        out   = ZSTR_VAL(upper);
+
+    for (size_t i = 0; i < name_len; i++) {
+        if (split_at && i == split_at) {
+            *out++ = ' ';
+        }
+        *out++ = (char) toupper((unsigned char) name[i]);
+    }
+    *out = '\0';
+    return upper;
+}
+
+/* Command name of an entry, "CLIENT GETNAME" for ClientGetName */
+static zend_string* slowlog_command_name(const slowlog_entry* entry) {
+    if (entry->command_len > 0) {
+        return slowlog_upper(entry->command, entry->command_len, 0);
+    }
+
+    const ProtobufCEnumValue* value = protobuf_c_enum_descriptor_get_value(
+        &command_request__request_type__descriptor, (int) entry->command_type);
+    if (!value) {
+        return strpprintf(0, "%d", (int) entry->command_type);
+    }
+
+    size_t name_len = strlen(value->name);
+    size_t split_at = 0;
+    for (size_t i = 0; i < sizeof(slowlog_containers) / sizeof(slowlog_containers[0]); i++) {
+        size_t len = strlen(slowlog_containers[i]);
+        if (name_len > len && strncmp(value->name, slowlog_containers[i], len) == 0) {
+            split_at = len;
+            break;
+        }
+    }
+    return slowlog_upper(value->name, name_len, split_at);
+}
+
+static void slowlog_entry_to_zval(const slowlog_entry* entry, zval* output) {
+    array_init(output);
+    add_assoc_long(output, "id", (zend_long) entry->id);
+    add_assoc_double(output, "timestamp", entry->timestamp);
+    add_assoc_long(output, "duration_us", (zend_long) entry->duration_us);
+
+    if (entry->is_batch) {
+        add_assoc_string(output, "command", entry->is_atomic ? "MULTI" : "PIPELINE");
+        add_assoc_null(output, "key");
+        add_assoc_long(output, "commands", entry->arg_count);
+    } else {
+        add_assoc_str(output, "command", slowlog_command_name(entry));
+        if (entry->arg_count > 0) {
+            add_truncated(
+                output, "key", entry->key, entry->key_len, VALKEY_GLIDE_SLOWLOG_KEY_MAX);
+        } else {
+            add_assoc_null(output, "key");
+        }
+
+        zval args;
+        array_init(&args);
+        for (int i = 0; i < entry->args_kept; i++) {
+            add_truncated_arg(
+                &args, entry->args[i], entry->args_len[i], VALKEY_GLIDE_SLOWLOG_ARG_MAX);
+        }
+        if (entry->arg_count > (uint32_t) entry->args_kept + 1) {
+            add_next_index_str(&args,
+                               strpprintf(0,
+                                          "... (%u more arguments)",
+                                          entry->arg_count - entry->args_kept - 1));
+        }
+        add_assoc_zval(output, "args", &args);
+        add_assoc_long(output, "arg_count", entry->arg_count);
+    }
+
+    add_assoc_long(output, "arg_bytes", (zend_long) entry->arg_bytes);
+    add_assoc_long(output, "reply_bytes", (zend_long) entry->reply_bytes);
+    add_assoc_bool(output, "failed", entry->failed);
+    add_assoc_string(output, "route", (char*) entry->route);
+    add_assoc_str(output, "fingerprint", strpprintf(0, "%016" PRIx64, entry->fingerprint));
+}
+
+/* Longest duration first, then the most recent */
+static int slowlog_compare_slowest(const void* a, const void* b) {
+    const slowlog_entry* left  = *(const slowlog_entry* const*) a;
+    const slowlog_entry* right = *(const slowlog_entry* const*) b;
+
+    if (left->duration_us != right->duration_us) {
+        return left->duration_us > right->duration_us ? -1 : 1;
+    }
+    return left->id > right->id ? -1 : (left->id < right->id ? 1 : 0);
+}
+
+int execute_get_slow_log_command(zval*             object,
+                                 int               argc,
+                                 zval*             return_value,
+                                 zend_class_entry* ce) {
+    if (zend_parse_method_parameters(argc, object, "O", &object, ce) == FAILURE) {
+        return 0;
+    }
+
+    valkey_glide_object* valkey_glide =
+        VALKEY_GLIDE_PHP_ZVAL_GET_OBJECT(valkey_glide_object, object);
+    if (!valkey_glide || !valkey_glide->slowlog) {
+        /* Recording is off */
+        return 0;
+    }
+
+    /* Slowest first, among the entries that haven't aged out */
+    valkey_glide_slowlog* slowlog = valkey_glide->slowlog;
+    const slowlog_entry*  sorted[VALKEY_GLIDE_SLOWLOG_ENTRIES];
+
+    slowlog->next_expiry_ns = 0;
+    slowlog_expire(slowlog, valkey_glide_slowlog_now());
+
+    for (uint32_t i = 0; i < slowlog->count; i++) {
+        sorted[i] = &slowlog->entries[i];
+    }
+    qsort(sorted, slowlog->count, sizeof(sorted[0]), slowlog_compare_slowest);
+
+    array_init_size(return_value, slowlog->count);
+    for (uint32_t i = 0; i < slowlog->count; i++) {
+        zval entry;
+        slowlog_entry_to_zval(sorted[i], &entry);
+        add_next_index_zval(return_value, &entry);
+    }
+
+    return 1;
+}
+
+int execute_reset_slow_log_command(zval*             object,
+                                   int               argc,
+                                   zval*             return_value,
+                                   zend_class_entry* ce) {
+    if (zend_parse_method_parameters(argc, object, "O", &object, ce) == FAILURE) {
+        return 0;
+    }
+
+    valkey_glide_object* valkey_glide =
+        VALKEY_GLIDE_PHP_ZVAL_GET_OBJECT(valkey_glide_object, object);
+    if (!valkey_glide || !valkey_glide->slowlog) {
+        return 0;
+    }
+
+    /* Entry ids keep increasing across resets */
+    valkey_glide->slowlog->count = 0;
+
+    ZVAL_TRUE(return_value);
+    return 1;
+}
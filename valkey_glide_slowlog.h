@@ -0,0 +1,103 @@
+/** Copyright Valkey GLIDE Project Contributors - SPDX Identifier: Apache-2.0 */
+
+#ifndef VALKEY_GLIDE_SLOWLOG_H
+#define VALKEY_GLIDE_SLOWLOG_H
+
+#include "common.h"
+#include "include/glide_bindings.h"
+
+/*
+ * Client-side slow log.
+ *
+ * With OPT_SLOWLOG_THRESHOLD set to a number of microseconds, commands and batches whose
+ * command()/batch() call takes at least that long are recorded in a fixed min-heap keeping the
+ * slowest ones, read with getSlowLog(). Entries older than VALKEY_GLIDE_SLOWLOG_MAX_AGE_S age
+ * out, so one slow spike doesn't hide later calls forever. Unlike the server SLOWLOG, the time
+ * includes the network and the client's own queueing. Entries are fixed-size, keys and arguments
+ * are truncated, so recording allocates nothing.
+ */
+#define VALKEY_GLIDE_SLOWLOG_ENTRIES 128
+#define VALKEY_GLIDE_SLOWLOG_MAX_AGE_S 600
+#define VALKEY_GLIDE_SLOWLOG_KEY_MAX 64
+#define VALKEY_GLIDE_SLOWLOG_ARGS 4     /* Arguments kept after the key */
+#define VALKEY_GLIDE_SLOWLOG_ARG_MAX 32 /* Bytes kept of each of them */
+#define VALKEY_GLIDE_SLOWLOG_ROUTE_MAX 64
+
+typedef struct valkey_glide_slowlog valkey_glide_slowlog;
+
+/* Slow log recorded for glide_client, NULL if there is none */
+static inline valkey_glide_slowlog* valkey_glide_slowlog_find(const void* glide_client) {
+    if (EXPECTED(zend_hash_num_elements(&VALKEY_GLIDE_G(slow_logs)) == 0)) {
+        return NULL;
+    }
+    return zend_hash_index_find_ptr(&VALKEY_GLIDE_G(slow_logs),
+                                    (zend_ulong) (uintptr_t) glide_client);
+}
+
+uint64_t valkey_glide_slowlog_now(void);
+
+/* Whether a call started at start_ns reached the threshold, setting its duration if so */
+bool valkey_glide_slowlog_is_slow(const valkey_glide_slowlog* slowlog,
+                                  uint64_t                    start_ns,
+                                  uint64_t*                   duration_us);
+
+void valkey_glide_slowlog_add_command(valkey_glide_slowlog* slowlog,
+                                      uint64_t              duration_us,
+                                      enum RequestType      command_type,
+                                      unsigned long         arg_count,
+                                      const uintptr_t*      args,
+                                      const unsigned long*  args_len,
+                                      const char*           route,
+                                      const CommandResult*  result);
+void valkey_glide_slowlog_add_batch(valkey_glide_slowlog* slowlog,
+                                    uint64_t              duration_us,
+                                    bool                  is_atomic,
+                                    size_t                command_count,
+                                    size_t                payload_bytes,
+                                    const CommandResult*  result);
+
+/* setOption(OPT_SLOWLOG_THRESHOLD, $us): a negative threshold stops recording */
+bool      valkey_glide_set_slowlog_threshold(valkey_glide_object* valkey_glide, zval* value);
+zend_long valkey_glide_slowlog_threshold(const valkey_glide_object* valkey_glide);
+
+/* Stop recording, when the object is freed */
+void valkey_glide_slowlog_release(valkey_glide_object* valkey_glide);
+
+int execute_get_slow_log_command(zval*             object,
+                                 int               argc,
+                                 zval*             return_value,
+                                 zend_class_entry* ce);
+int execute_reset_slow_log_command(zval*             object,
+                                   int               argc,
+                                   zval*             return_value,
+                                   zend_class_entry* ce);
+
+#define GET_SLOW_LOG_METHOD_IMPL(class_name)                                            \
+    PHP_METHOD(class_name, getSlowLog) {                                                \
+        if (execute_get_slow_log_command(getThis(),                                     \
+                                         ZEND_NUM_ARGS(),                               \
+                                         return_value,                                  \
+                                         strcmp(#class_name, "ValkeyGlideCluster") == 0 \
+                                             ? get_valkey_glide_cluster_ce()            \
+                                             : get_valkey_glide_ce())) {                \
+            return;                                                                     \
+        }                                                                               \
+        zval_dtor(return_value);                                                        \
+        RETURN_FALSE;                                                                   \
+    }
+
+#define RESET_SLOW_LOG_METHOD_IMPL(class_name)                                            \
+    PHP_METHOD(class_name, resetSlowLog) {                                                \
+        if (execute_reset_slow_log_command(getThis(),                                     \
+                                           ZEND_NUM_ARGS(),                               \
+                                           return_value,                                  \
+                                           strcmp(#class_name, "ValkeyGlideCluster") == 0 \
+                                               ? get_valkey_glide_cluster_ce()            \
+                                               : get_valkey_glide_ce())) {                \
+            return;                                                                       \
+        }                                                                                 \
+        zval_dtor(return_value);                                                          \
+        RETURN_FALSE;                                                                     \
+    }
+
+#endif /* VALKEY_GLIDE_SLOWLOG_H */
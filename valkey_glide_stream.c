@@ -0,0 +1,822 @@
+/** Copyright Valkey GLIDE Project Contributors - SPDX Identifier: Apache-2.0 */
+
+#include "valkey_glide_stream.h"
+
+#include <ext/standard/url.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <zend_exceptions.h>
+#include <zend_smart_str.h>
+
+#include "command_response.h"
+#include "include/glide_bindings.h"
+#include "logger.h"
+#include "valkey_glide_bloom.h"
+
+#define STREAM_MODE_READ 0
+#define STREAM_MODE_WRITE 1  /* "w": SET, then APPEND */
+#define STREAM_MODE_APPEND 2 /* "a": APPEND */
+#define STREAM_MODE_UPDATE 3 /* "c": SETRANGE at the current position */
+
+/* A fetched window, pointing into the GETRANGE reply it came with */
+typedef struct stream_chunk {
+    CommandResult*       result;
+    const char*          data;
+    size_t               len;
+    size_t               pos; /* Bytes already handed to PHP */
+    struct stream_chunk* next;
+} stream_chunk;
+
+typedef struct {
+    zval         client; /* Keeps the client alive while the stream is open */
+    const void*  glide_client;
+    zend_string* key;
+    int          mode;
+    size_t       chunk_size;
+    int          read_ahead;
+    size_t       position; /* Offset of the next byte read or written by PHP */
+    size_t       size;     /* Length of the value when it was opened, for reads */
+
+    /* Read windows, filled by the worker or synchronously when read_ahead is 0 */
+    pthread_mutex_t lock;
+    pthread_cond_t  cond;
+    pthread_t       worker;
+    bool            worker_running;
+    bool            stopping;
+    bool            exhausted; /* No more windows will be fetched */
+    bool            failed;
+    char            error[256];
+    stream_chunk*   head;
+    stream_chunk*   tail;
+    int             queued;
+    size_t          fetch_offset; /* Next offset to fetch */
+
+    /* Writes */
+    smart_str pending;
+    bool      created; /* "w" streams replaced the value already */
+} valkey_glide_stream_data;
+
+/* ====================================================================
+ * COMMANDS
+ * ==================================================================== */
+
+static CommandResult* stream_command(const void*        glide_client,
+                                     enum RequestType   type,
+                                     unsigned long      argc,
+                                     const char* const* argv,
+                                     const size_t*      argv_len) {
+    uintptr_t     args[3];
+    unsigned long args_len[3];
+
+    for (unsigned long i = 0; i < argc; i++) {
+        args[i]     = (uintptr_t) argv[i];
+        args_len[i] = (unsigned long) argv_len[i];
+    }
+
+    return command(glide_client, 0, type, argc, args, args_len, NULL, 0, 0);
+}
+
+/* Error message of a failed reply, NULL on success. Frees result on failure. */
+static const char* stream_result_error(CommandResult* result, char* buf, size_t buf_len) {
+    if (!result) {
+        snprintf(buf, buf_len, "Command execution returned no result");
+        return buf;
+    }
+    if (result->command_error) {
+        snprintf(buf,
+                 buf_len,
+                 "%s",
+                 result->command_error->command_error_message
+                     ? result->command_error->command_error_message
+                     : "Command failed");
+        free_command_result(result);
+        return buf;
+    }
+    if (!result->response) {
+        snprintf(buf, buf_len, "Command returned no response");
+        free_command_result(result);
+        return buf;
+    }
+    return NULL;
+}
+
+static CommandResult* stream_get_range(const void*  glide_client,
+                                       zend_string* key,
+                                       size_t       offset,
+                                       size_t       len) {
+    char start[24], end[24];
+    snprintf(start, sizeof(start), "%zu", offset);
+    snprintf(end, sizeof(end), "%zu", offset + len - 1);
+
+    const char* argv[]     = {ZSTR_VAL(key), start, end};
+    size_t      argv_len[] = {ZSTR_LEN(key), strlen(start), strlen(end)};
+    return stream_command(glide_client, GetRange, 3, argv, argv_len);
+}
+
+/* Length of the value, or -1 if the key doesn't exist or can't be read */
+static zend_long stream_value_length(const void*  glide_client,
+                                     zend_string* key,
+                                     char*        error,
+                                     size_t       error_len) {
+    const char*    argv[]     = {ZSTR_VAL(key)};
+    size_t         argv_len[] = {ZSTR_LEN(key)};
+    CommandResult* result     = stream_command(glide_client, Strlen, 1, argv, argv_len);
+
+    if (stream_result_error(result, error, error_len)) {
+        return -1;
+    }
+    zend_long len = result->response->response_type == Int ? result->response->int_value : -1;
+    free_command_result(result);
+    if (len != 0) {
+        return len;
+    }
+
+    /* STRLEN doesn't tell an empty value from a missing key */
+    result = stream_command(glide_client, Exists, 1, argv, argv_len);
+    if (stream_result_error(result, error, error_len)) {
+        return -1;
+    }
+    bool exists = result->response->response_type == Int && result->response->int_value > 0;
+    free_command_result(result);
+    if (!exists) {
+        snprintf(error, error_len, "No such key");
+        return -1;
+    }
+    return 0;
+}
+
+/* ====================================================================
+ * READING
+ * ==================================================================== */
+
+/* Chunks are allocated by the worker thread, so they live outside of the PHP heap */
+static void stream_free_chunk(stream_chunk* chunk) {
+    free_command_result(chunk->result);
+    free(chunk);
+}
+
+/* Fetch the window at fetch_offset and queue it. Called with data->lock held. */
+static void stream_fetch_locked(valkey_glide_stream_data* data) {
+    if (data->fetch_offset >= data->size) {
+        data->exhausted = true;
+        return;
+    }
+
+    size_t offset = data->fetch_offset;
+    size_t len    = MIN(data->chunk_size, data->size - offset);
+    data->fetch_offset += len;
+
+    pthread_mutex_unlock(&data->lock);
+    CommandResult* result = stream_get_range(data->glide_client, data->key, offset, len);
+    char           error[sizeof(data->error)];
+    const char*    failure = stream_result_error(result, error, sizeof(error));
+    pthread_mutex_lock(&data->lock);
+
+    if (failure) {
+        snprintf(data->error, sizeof(data->error), "%s", failure);
+        data->failed = true;
+        return;
+    }
+
+    stream_chunk* chunk = malloc(sizeof(stream_chunk));
+    if (!chunk) {
+        free_command_result(result);
+        snprintf(data->error, sizeof(data->error), "Failed to allocate read buffer");
+        data->failed = true;
+        return;
+    }
+    chunk->result = result;
+    chunk->data   = result->response->response_type == String ? result->response->string_value
+                                                              : NULL;
+    chunk->len    = chunk->data ? (size_t) result->response->string_value_len : 0;
+    chunk->pos    = 0;
+    chunk->next   = NULL;
+
+    if (data->tail) {
+        data->tail->next = chunk;
+    } else {
+        data->head = chunk;
+    }
+    data->tail = chunk;
+    data->queued++;
+
+    /* The value shrank since it was opened */
+    if (chunk->len < len) {
+        data->exhausted = true;
+    }
+}
+
+static void* stream_worker(void* arg) {
+    valkey_glide_stream_data* data = arg;
+
+    pthread_mutex_lock(&data->lock);
+    while (!data->stopping && !data->exhausted && !data->failed) {
+        if (data->queued >= data->read_ahead) {
+            pthread_cond_wait(&data->cond, &data->lock);
+            continue;
+        }
+        stream_fetch_locked(data);
+        pthread_cond_broadcast(&data->cond);
+    }
+    pthread_mutex_unlock(&data->lock);
+
+    return NULL;
+}
+
+static void stream_stop_worker(valkey_glide_stream_data* data) {
+    if (!data->worker_running) {
+        return;
+    }
+
+    pthread_mutex_lock(&data->lock);
+    data->stopping = true;
+    pthread_cond_broadcast(&data->cond);
+    pthread_mutex_unlock(&data->lock);
+
+    pthread_join(data->worker, NULL);
+    data->worker_running = false;
+    data->stopping       = false;
+}
+
+static void stream_drop_chunks(valkey_glide_stream_data* data) {
+    while (data->head) {
+        stream_chunk* chunk = data->head;
+        data->head          = chunk->next;
+        stream_free_chunk(chunk);
+    }
+    data->tail   = NULL;
+    data->queued = 0;
+}
+
+static ssize_t stream_read(php_stream* stream, char* buf, size_t count) {
+    valkey_glide_stream_data* data = stream->abstract;
+
+    if (data->mode != STREAM_MODE_READ) {
+        return -1;
+    }
+    if (data->position >= data->size) {
+        stream->eof = 1;
+        return 0;
+    }
+
+    if (data->read_ahead > 0 && !data->worker_running && !data->exhausted) {
+        data->worker_running = pthread_create(&data->worker, NULL, stream_worker, data) == 0;
+        if (!data->worker_running) {
+            /* Fall back to synchronous fetches */
+            data->read_ahead = 0;
+        }
+    }
+
+    pthread_mutex_lock(&data->lock);
+    while (!data->head && !data->failed && !data->exhausted) {
+        if (data->worker_running) {
+            pthread_cond_wait(&data->cond, &data->lock);
+        } else {
+            stream_fetch_locked(data);
+        }
+    }
+
+    stream_chunk* chunk = data->head;
+    if (!chunk) {
+        bool failed = data->failed;
+        pthread_mutex_unlock(&data->lock);
+
+        if (failed) {
+            php_error_docref(NULL,
+                             E_WARNING,
+                             "Failed to read '%s': %s",
+                             ZSTR_VAL(data->key),
+                             data->error);
+            return -1;
+        }
+        data->size  = data->position;
+        stream->eof = 1;
+        return 0;
+    }
+
+    size_t n = MIN(count, chunk->len - chunk->pos);
+    if (n > 0) {
+        memcpy(buf, chunk->data + chunk->pos, n);
+    }
+    chunk->pos += n;
+
+    bool consumed = chunk->pos >= chunk->len;
+    if (consumed) {
+        data->head = chunk->next;
+        if (!data->head) {
+            data->tail = NULL;
+        }
+        data->queued--;
+        pthread_cond_broadcast(&data->cond);
+    }
+    pthread_mutex_unlock(&data->lock);
+
+    if (consumed) {
+        stream_free_chunk(chunk);
+    }
+
+    data->position += n;
+    if (n == 0 || data->position >= data->size) {
+        if (n == 0) {
+            data->size = data->position;
+        }
+        stream->eof = 1;
+    }
+    return (ssize_t) n;
+}
+
+/* ====================================================================
+ * WRITING
+ * ==================================================================== */
+
+static int stream_send(valkey_glide_stream_data* data, const char* buf, size_t len) {
+    CommandResult* result;
+    char           offset[24];
+
+    valkey_glide_bloom_record_key(data->glide_client, ZSTR_VAL(data->key), ZSTR_LEN(data->key));
+
+    if (data->mode == STREAM_MODE_UPDATE) {
+        snprintf(offset, sizeof(offset), "%zu", data->position);
+        const char* argv[]     = {ZSTR_VAL(data->key), offset, buf};
+        size_t      argv_len[] = {ZSTR_LEN(data->key), strlen(offset), len};
+        result                 = stream_command(data->glide_client, SetRange, 3, argv, argv_len);
+    } else {
+        const char*      argv[]     = {ZSTR_VAL(data->key), buf};
+        size_t           argv_len[] = {ZSTR_LEN(data->key), len};
+        enum RequestType type = data->mode == STREAM_MODE_WRITE && !data->created ? Set : Append;
+        result                = stream_command(data->glide_client, type, 2, argv, argv_len);
+    }
+
+    char error[256];
+    if (stream_result_error(result, error, sizeof(error))) {
+        php_error_docref(
+            NULL, E_WARNING, "Failed to write '%s': %s", ZSTR_VAL(data->key), error);
+        return FAILURE;
+    }
+    free_command_result(result);
+
+    data->created = true;
+    data->position += len;
+    return SUCCESS;
+}
+
+static int stream_flush_pending(valkey_glide_stream_data* data) {
+    if (!data->pending.s || ZSTR_LEN(data->pending.s) == 0) {
+        return SUCCESS;
+    }
+
+    int ret = stream_send(data, ZSTR_VAL(data->pending.s), ZSTR_LEN(data->pending.s));
+    ZSTR_LEN(data->pending.s) = 0;
+    return ret;
+}
+
+static ssize_t stream_write(php_stream* stream, const char* buf, size_t count) {
+    valkey_glide_stream_data* data    = stream->abstract;
+    size_t                    written = 0;
+
+    if (data->mode == STREAM_MODE_READ) {
+        return -1;
+    }
+
+    while (written < count) {
+        size_t remaining = count - written;
+        size_t buffered  = data->pending.s ? ZSTR_LEN(data->pending.s) : 0;
+
+        /* Whole chunks are sent straight from the caller's buffer */
+        if (buffered == 0 && remaining >= data->chunk_size) {
+            if (stream_send(data, buf + written, data->chunk_size) == FAILURE) {
+                return written > 0 ? (ssize_t) written : -1;
+            }
+            written += data->chunk_size;
+            continue;
+        }
+
+        size_t n = MIN(remaining, data->chunk_size - buffered);
+        smart_str_appendl(&data->pending, buf + written, n);
+        written += n;
+
+        if (ZSTR_LEN(data->pending.s) >= data->chunk_size &&
+            stream_flush_pending(data) == FAILURE) {
+            return -1;
+        }
+    }
+
+    return (ssize_t) written;
+}
+
+/* ====================================================================
+ * STREAM OPERATIONS
+ * ==================================================================== */
+
+static int stream_flush(php_stream* stream) {
+    valkey_glide_stream_data* data = stream->abstract;
+
+    if (data->mode == STREAM_MODE_READ) {
+        return 0;
+    }
+    return stream_flush_pending(data) == SUCCESS ? 0 : -1;
+}
+
+static int stream_close(php_stream* stream, int close_handle) {
+    valkey_glide_stream_data* data = stream->abstract;
+    int                       ret  = 0;
+
+    if (data->mode == STREAM_MODE_READ) {
+        stream_stop_worker(data);
+        stream_drop_chunks(data);
+    } else {
+        if (stream_flush_pending(data) == FAILURE) {
+            ret = EOF;
+        }
+        /* "w" truncates even when nothing was written */
+        if (ret == 0 && data->mode == STREAM_MODE_WRITE && !data->created &&
+            stream_send(data, "", 0) == FAILURE) {
+            ret = EOF;
+        }
+        smart_str_free(&data->pending);
+    }
+
+    pthread_cond_destroy(&data->cond);
+    pthread_mutex_destroy(&data->lock);
+    zend_string_release(data->key);
+    zval_ptr_dtor(&data->client);
+    efree(data);
+
+    return ret;
+}
+
+static int stream_seek(php_stream* stream, zend_off_t offset, int whence, zend_off_t* newoffset) {
+    valkey_glide_stream_data* data = stream->abstract;
+    zend_off_t                target;
+
+    if (data->mode == STREAM_MODE_WRITE || data->mode == STREAM_MODE_APPEND) {
+        return -1;
+    }
+    if (data->mode == STREAM_MODE_UPDATE && stream_flush_pending(data) == FAILURE) {
+        return -1;
+    }
+
+    switch (whence) {
+        case SEEK_SET:
+            target = offset;
+            break;
+        case SEEK_CUR:
+            target = (zend_off_t) data->position + offset;
+            break;
+        case SEEK_END:
+            if (data->mode != STREAM_MODE_READ) {
+                return -1;
+            }
+            target = (zend_off_t) data->size + offset;
+            break;
+        default:
+            return -1;
+    }
+    if (target < 0 || (data->mode == STREAM_MODE_READ && (size_t) target > data->size)) {
+        return -1;
+    }
+
+    if (data->mode == STREAM_MODE_READ) {
+        stream_stop_worker(data);
+        stream_drop_chunks(data);
+        data->fetch_offset = (size_t) target;
+        data->exhausted    = false;
+        data->failed       = false;
+        stream->eof        = 0;
+    }
+    data->position = (size_t) target;
+    *newoffset     = target;
+    return 0;
+}
+
+static int stream_stat(php_stream* stream, php_stream_statbuf* ssb) {
+    valkey_glide_stream_data* data = stream->abstract;
+
+    memset(ssb, 0, sizeof(*ssb));
+    ssb->sb.st_mode = S_IFREG | 0666;
+    ssb->sb.st_size = data->mode == STREAM_MODE_READ ? (zend_off_t) data->size
+                                                     : (zend_off_t) data->position;
+    return 0;
+}
+
+static const php_stream_ops valkey_glide_stream_ops = {
+    stream_write,
+    stream_read,
+    stream_close,
+    stream_flush,
+    VALKEY_GLIDE_STREAM_SCHEME,
+    stream_seek,
+    NULL, /* cast */
+    stream_stat,
+    NULL, /* set_option */
+};
+
+/* ====================================================================
+ * WRAPPER
+ * ==================================================================== */
+
+static zend_long stream_context_long(php_stream_context* context,
+                                     const char*         name,
+                                     zend_long           def) {
+    zval* option = context ? php_stream_context_get_option(
+                                 context, VALKEY_GLIDE_STREAM_SCHEME, name)
+                           : NULL;
+    return option ? zval_get_long(option) : def;
+}
+
+/* Resolve "valkey://alias/key" to a connected client and a decoded key */
+static int stream_resolve(const char*         url,
+                          php_stream_context* context,
+                          zval*               client,
+                          zend_string**       key,
+                          char*               error,
+                          size_t              error_len) {
+    size_t scheme_len = sizeof(VALKEY_GLIDE_STREAM_SCHEME "://") - 1;
+
+    if (strncasecmp(url, VALKEY_GLIDE_STREAM_SCHEME "://", scheme_len) != 0) {
+        snprintf(error, error_len, "Invalid URL, expected valkey://<alias>/<key>");
+        return FAILURE;
+    }
+
+    const char* alias = url + scheme_len;
+    const char* slash = strchr(alias, '/');
+    if (!slash || slash[1] == '\0') {
+        snprintf(error, error_len, "Invalid URL, expected valkey://<alias>/<key>");
+        return FAILURE;
+    }
+
+    zval* option =
+        context ? php_stream_context_get_option(context, VALKEY_GLIDE_STREAM_SCHEME, "client")
+                : NULL;
+    zval* found = NULL;
+    if (option && Z_TYPE_P(option) == IS_OBJECT) {
+        found = option;
+    } else if (VALKEY_GLIDE_G(stream_aliases)) {
+        found = zend_hash_str_find(VALKEY_GLIDE_G(stream_aliases), alias, slash - alias);
+    }
+    if (!found || (!instanceof_function(Z_OBJCE_P(found), get_valkey_glide_ce()) &&
+                   !instanceof_function(Z_OBJCE_P(found), get_valkey_glide_cluster_ce()))) {
+        snprintf(error,
+                 error_len,
+                 "No client registered for alias '%.*s'",
+                 (int) (slash - alias),
+                 alias);
+        return FAILURE;
+    }
+
+    valkey_glide_object* valkey_glide =
+        VALKEY_GLIDE_PHP_ZVAL_GET_OBJECT(valkey_glide_object, found);
+    if (!valkey_glide || !valkey_glide->glide_client) {
+        snprintf(error, error_len, "Client is not connected");
+        return FAILURE;
+    }
+    /* Stream commands are sent as they are, not as the next call of the client */
+    valkey_glide_drop_next_call_options(valkey_glide->glide_client);
+
+    *key           = zend_string_init(slash + 1, strlen(slash + 1), 0);
+    ZSTR_LEN(*key) = php_raw_url_decode(ZSTR_VAL(*key), ZSTR_LEN(*key));
+    ZVAL_COPY(client, found);
+    return SUCCESS;
+}
+
+static php_stream* stream_opener(php_stream_wrapper* wrapper,
+                                 const char*         filename,
+                                 const char*         mode,
+                                 int                 options,
+                                 zend_string**       opened_path,
+                                 php_stream_context* context STREAMS_DC) {
+    char         error[256];
+    zval         client;
+    zend_string* key;
+    int          stream_mode;
+
+    if (strchr(mode, '+')) {
+        php_stream_wrapper_log_error(wrapper, options, "Read/write mode is not supported");
+        return NULL;
+    }
+    switch (mode[0]) {
+        case 'r':
+            stream_mode = STREAM_MODE_READ;
+            break;
+        case 'w':
+            stream_mode = STREAM_MODE_WRITE;
+            break;
+        case 'a':
+            stream_mode = STREAM_MODE_APPEND;
+            break;
+        case 'c':
+            stream_mode = STREAM_MODE_UPDATE;
+            break;
+        default:
+            php_stream_wrapper_log_error(wrapper, options, "Unsupported mode '%s'", mode);
+            return NULL;
+    }
+
+    zend_long chunk_size =
+        stream_context_long(context, "chunk_size", VALKEY_GLIDE_STREAM_DEFAULT_CHUNK_SIZE);
+    zend_long read_ahead =
+        stream_context_long(context, "read_ahead", VALKEY_GLIDE_STREAM_DEFAULT_READ_AHEAD);
+    if (chunk_size < VALKEY_GLIDE_STREAM_MIN_CHUNK_SIZE ||
+        chunk_size > VALKEY_GLIDE_STREAM_MAX_CHUNK_SIZE) {
+        php_stream_wrapper_log_error(wrapper,
+                                     options,
+                                     "chunk_size must be between %d and %d bytes",
+                                     VALKEY_GLIDE_STREAM_MIN_CHUNK_SIZE,
+                                     VALKEY_GLIDE_STREAM_MAX_CHUNK_SIZE);
+        return NULL;
+    }
+    if (read_ahead < 0 || read_ahead > VALKEY_GLIDE_STREAM_MAX_READ_AHEAD) {
+        php_stream_wrapper_log_error(wrapper,
+                                     options,
+                                     "read_ahead must be between 0 and %d",
+                                     VALKEY_GLIDE_STREAM_MAX_READ_AHEAD);
+        return NULL;
+    }
+
+    if (stream_resolve(filename, context, &client, &key, error, sizeof(error)) == FAILURE) {
+        php_stream_wrapper_log_error(wrapper, options, "%s", error);
+        return NULL;
+    }
+
+    valkey_glide_object* valkey_glide =
+        VALKEY_GLIDE_PHP_ZVAL_GET_OBJECT(valkey_glide_object, &client);
+    zend_long size = 0;
+    if (stream_mode == STREAM_MODE_READ) {
+        size = stream_value_length(valkey_glide->glide_client, key, error, sizeof(error));
+        if (size < 0) {
+            php_stream_wrapper_log_error(
+                wrapper, options, "Failed to open '%s': %s", ZSTR_VAL(key), error);
+            zend_string_release(key);
+            zval_ptr_dtor(&client);
+            return NULL;
+        }
+    }
+
+    valkey_glide_stream_data* data = ecalloc(1, sizeof(valkey_glide_stream_data));
+    ZVAL_COPY_VALUE(&data->client, &client);
+    data->glide_client = valkey_glide->glide_client;
+    data->key          = key;
+    data->mode         = stream_mode;
+    data->chunk_size   = (size_t) chunk_size;
+    data->read_ahead   = (int) read_ahead;
+    data->size         = (size_t) size;
+    pthread_mutex_init(&data->lock, NULL);
+    pthread_cond_init(&data->cond, NULL);
+
+    php_stream* stream = php_stream_alloc(&valkey_glide_stream_ops, data, NULL, mode);
+    if (stream_mode == STREAM_MODE_WRITE || stream_mode == STREAM_MODE_APPEND) {
+        stream->flags |= PHP_STREAM_FLAG_NO_SEEK;
+    }
+    return stream;
+}
+
+static int stream_url_stat(php_stream_wrapper* wrapper,
+                           const char*         url,
+                           int                 flags,
+                           php_stream_statbuf* ssb,
+                           php_stream_context* context) {
+    char         error[256];
+    zval         client;
+    zend_string* key;
+
+    if (stream_resolve(url, context, &client, &key, error, sizeof(error)) == FAILURE) {
+        if (!(flags & PHP_STREAM_URL_STAT_QUIET)) {
+            php_error_docref(NULL, E_WARNING, "%s", error);
+        }
+        return -1;
+    }
+
+    valkey_glide_object* valkey_glide =
+        VALKEY_GLIDE_PHP_ZVAL_GET_OBJECT(valkey_glide_object, &client);
+    zend_long size = stream_value_length(valkey_glide->glide_client, key, error, sizeof(error));
+    zend_string_release(key);
+    zval_ptr_dtor(&client);
+    if (size < 0) {
+        return -1;
+    }
+
+    memset(ssb, 0, sizeof(*ssb));
+    ssb->sb.st_mode = S_IFREG | 0666;
+    ssb->sb.st_size = (zend_off_t) size;
+    return 0;
+}
+
+static int stream_unlink(php_stream_wrapper* wrapper,
+                         const char*         url,
+                         int                 options,
+                         php_stream_context* context) {
+    char         error[256];
+    zval         client;
+    zend_string* key;
+
+    if (stream_resolve(url, context, &client, &key, error, sizeof(error)) == FAILURE) {
+        php_stream_wrapper_log_error(wrapper, options, "%s", error);
+        return 0;
+    }
+
+    valkey_glide_object* valkey_glide =
+        VALKEY_GLIDE_PHP_ZVAL_GET_OBJECT(valkey_glide_object, &client);
+    const char*    argv[]     = {ZSTR_VAL(key)};
+    size_t         argv_len[] = {ZSTR_LEN(key)};
+    CommandResult* result = stream_command(valkey_glide->glide_client, Del, 1, argv, argv_len);
+    const char*    failure = stream_result_error(result, error, sizeof(error));
+    bool           deleted = false;
+
+    if (!failure) {
+        deleted = result->response->response_type == Int && result->response->int_value > 0;
+        free_command_result(result);
+        if (!deleted) {
+            snprintf(error, sizeof(error), "No such key");
+        }
+    }
+    if (!deleted) {
+        php_stream_wrapper_log_error(
+            wrapper, options, "Failed to unlink '%s': %s", ZSTR_VAL(key), error);
+    }
+
+    zend_string_release(key);
+    zval_ptr_dtor(&client);
+    return deleted ? 1 : 0;
+}
+
+static const php_stream_wrapper_ops valkey_glide_stream_wrapper_ops = {
+    stream_opener,
+    NULL, /* stream_closer */
+    NULL, /* stream_stat */
+    stream_url_stat,
+    NULL, /* dir_opener */
+    VALKEY_GLIDE_STREAM_SCHEME,
+    stream_unlink,
+    NULL, /* rename */
+    NULL, /* stream_mkdir */
+    NULL, /* stream_rmdir */
+    NULL, /* stream_metadata */
+};
+
+static const php_stream_wrapper valkey_glide_stream_wrapper = {
+    &valkey_glide_stream_wrapper_ops,
+    NULL,
+    0, /* is_url */
+};
+
+int valkey_glide_stream_startup(void) {
+    return php_register_url_stream_wrapper(VALKEY_GLIDE_STREAM_SCHEME,
+                                           &valkey_glide_stream_wrapper);
+}
+
+void valkey_glide_stream_shutdown(void) {
+    php_unregister_url_stream_wrapper(VALKEY_GLIDE_STREAM_SCHEME);
+}
+
+void valkey_glide_stream_request_shutdown(void) {
+    HashTable* aliases = VALKEY_GLIDE_G(stream_aliases);
+
+    if (aliases) {
+        VALKEY_GLIDE_G(stream_aliases) = NULL;
+        zend_hash_destroy(aliases);
+        FREE_HASHTABLE(aliases);
+    }
+}
+
+/* Execute registerStreamAlias() - make the client reachable as valkey://<alias>/ */
+int execute_register_stream_alias_command(zval*             object,
+                                          int               argc,
+                                          zval*             return_value,
+                                          zend_class_entry* ce) {
+    char*  alias;
+    size_t alias_len;
+
+    if (zend_parse_method_parameters(argc, object, "Os", &object, ce, &alias, &alias_len) ==
+        FAILURE) {
+        return 0;
+    }
+
+    if (alias_len == 0 || memchr(alias, '/', alias_len)) {
+        zend_throw_exception(get_valkey_glide_exception_ce(),
+                             "Stream alias must be non-empty and must not contain '/'",
+                             0);
+        return 0;
+    }
+
+    valkey_glide_object* valkey_glide =
+        VALKEY_GLIDE_PHP_ZVAL_GET_OBJECT(valkey_glide_object, object);
+    if (!valkey_glide || !valkey_glide->glide_client) {
+        zend_throw_exception(get_valkey_glide_exception_ce(), "Client is not connected", 0);
+        return 0;
+    }
+
+    if (!VALKEY_GLIDE_G(stream_aliases)) {
+        ALLOC_HASHTABLE(VALKEY_GLIDE_G(stream_aliases));
+        zend_hash_init(VALKEY_GLIDE_G(stream_aliases), 4, NULL, ZVAL_PTR_DTOR, 0);
+    }
+
+    /* The alias holds a reference until the end of the request */
+    zval client;
+    ZVAL_COPY(&client, object);
+    zend_hash_str_update(VALKEY_GLIDE_G(stream_aliases), alias, alias_len, &client);
+
+    ZVAL_TRUE(return_value);
+    return 1;
+}
@@ -0,0 +1,55 @@
+/** Copyright Valkey GLIDE Project Contributors - SPDX Identifier: Apache-2.0 */
+
+#ifndef VALKEY_GLIDE_STREAM_H
+#define VALKEY_GLIDE_STREAM_H
+
+#include "common.h"
+
+/*
+ * valkey:// stream wrapper.
+ *
+ * fopen("valkey://<alias>/<key>", $mode) opens a string value as a PHP stream, where <alias> was
+ * registered with registerStreamAlias() (or a client is passed as the 'client' context option)
+ * and <key> is rawurlencoded. Values are read with windowed GETRANGE and written with SET,
+ * APPEND or SETRANGE, one chunk at a time, so copying a value from or to a file or socket runs
+ * in memory bounded by the chunk size. Reads prefetch the next windows on a helper thread.
+ *
+ * Context options, under 'valkey':
+ *   - client:     ValkeyGlide or ValkeyGlideCluster instance, instead of the URL alias
+ *   - chunk_size: bytes per GETRANGE / write command (default 1 MiB)
+ *   - read_ahead: windows fetched ahead of the reader, 0 to fetch synchronously (default 2)
+ */
+#define VALKEY_GLIDE_STREAM_SCHEME "valkey"
+#define VALKEY_GLIDE_STREAM_DEFAULT_CHUNK_SIZE (1024 * 1024)
+#define VALKEY_GLIDE_STREAM_MIN_CHUNK_SIZE 1024
+#define VALKEY_GLIDE_STREAM_MAX_CHUNK_SIZE (512 * 1024 * 1024)
+#define VALKEY_GLIDE_STREAM_DEFAULT_READ_AHEAD 2
+#define VALKEY_GLIDE_STREAM_MAX_READ_AHEAD 64
+
+int  valkey_glide_stream_startup(void);
+void valkey_glide_stream_shutdown(void);
+
+/* Release the aliases registered during the request */
+void valkey_glide_stream_request_shutdown(void);
+
+int execute_register_stream_alias_command(zval*             object,
+                                          int               argc,
+                                          zval*             return_value,
+                                          zend_class_entry* ce);
+
+#define REGISTER_STREAM_ALIAS_METHOD_IMPL(class_name)                                       \
+    PHP_METHOD(class_name, registerStreamAlias) {                                           \
+        if (execute_register_stream_alias_command(getThis(),                                \
+                                                  ZEND_NUM_ARGS(),                          \
+                                                  return_value,                             \
+                                                  strcmp(#class_name, "ValkeyGlideCluster") \
+                                                          == 0                              \
+                                                      ? get_valkey_glide_cluster_ce()       \
+                                                      : get_valkey_glide_ce())) {           \
+            return;                                                                         \
+        }                                                                                   \
+        zval_dtor(return_value);                                                            \
+        RETURN_FALSE;                                                                       \
+    }
+
+#endif /* VALKEY_GLIDE_STREAM_H */
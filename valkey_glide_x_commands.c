@@ -415,8 +415,11 @@ int execute_xrange_command(zval* object, int argc, zval* return_value, zend_clas
         parse_x_count_options(z_options, &args.range_opts);
 
         /* Use the generic command execution framework */
+        x_result_processor_t processor =
+            valkey_glide->opt_columnar ? process_x_stream_columnar_result : process_x_stream_result;
+
         int result = execute_x_generic_command(
-            valkey_glide, XRange, &args, NULL, process_x_stream_result, return_value);
+            valkey_glide, XRange, &args, NULL, processor, return_value);
 
         /* Clean up if we created options array */
         if (options_created) {
@@ -491,8 +494,11 @@ int execute_xrevrange_command(zval* object, int argc, zval* return_value, zend_c
         parse_x_count_options(z_options, &args.range_opts);
 
         /* Use the generic command execution framework */
+        x_result_processor_t processor =
+            valkey_glide->opt_columnar ? process_x_stream_columnar_result : process_x_stream_result;
+
         int result = execute_x_generic_command(
-            valkey_glide, XRevRange, &args, NULL, process_x_stream_result, return_value);
+            valkey_glide, XRevRange, &args, NULL, processor, return_value);
 
         /* Clean up if we created options array */
         if (options_created) {
@@ -613,8 +619,12 @@ int execute_xpending_command(zval* object, int argc, zval* return_value, zend_cl
         parse_x_pending_options(z_options, &args.pending_opts);
 
         /* Execute the command */
+        x_result_processor_t processor = valkey_glide->opt_columnar
+                                             ? process_x_pending_columnar_result
+                                             : process_x_pending_result;
+
         int result = execute_x_generic_command(
-            valkey_glide, XPending, &args, NULL, process_x_pending_result, return_value);
+            valkey_glide, XPending, &args, NULL, processor, return_value);
 
         /* Clean up if we created options array */
         if (options_created && z_options) {
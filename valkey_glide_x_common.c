@@ -17,6 +17,9 @@
 #include "valkey_glide_x_common.h"
 
 #include "logger.h"
+#include "valkey_glide_breaker.h"
+#include "valkey_glide_hot_keys.h"
+#include "valkey_glide_node_stats.h"
 #include "valkey_glide_z_common.h"
 
 /* ====================================================================
@@ -441,6 +444,9 @@ int execute_x_generic_command(valkey_glide_object* valkey_glide,
             efree(allocated_strings);
         return 0;
     }
+    valkey_glide_hot_keys_record(valkey_glide, args->key, args->key_len, args_len, arg_count);
+    valkey_glide_node_stats_record(valkey_glide, args->key, args->key_len);
+    valkey_glide_breaker_record(valkey_glide, args->key, args->key_len);
 
     if (valkey_glide->is_in_batch_mode) {
         int result = buffer_command_for_batch(
@@ -463,8 +469,9 @@ int execute_x_generic_command(valkey_glide_object* valkey_glide,
     }
 
     /* Execute the command */
-    CommandResult* result =
-        execute_command(valkey_glide->glide_client, cmd_type, arg_count, cmd_args, args_len);
+    CommandResponse* reply  = NULL;
+    CommandResult*   result = execute_command_for_reply(
+        valkey_glide->glide_client, cmd_type, arg_count, cmd_args, args_len, &reply);
 
     /* Free allocated strings */
     int i;
@@ -492,7 +499,7 @@ int execute_x_generic_command(valkey_glide_object* valkey_glide,
     }
 
     /* Process the result */
-    int success = process_result(result->response, result_ptr, return_value);
+    int success = process_result(reply, result_ptr, return_value);
 
     /* Free the result */
     free_command_result(result);
@@ -526,6 +533,100 @@ int process_x_stream_result(CommandResponse* response, void* output, zval* retur
     return command_response_to_stream_zval(response, return_value);
 }
 
+/* Append a field value to row of its column in fields, creating the column on first sight */
+static void x_stream_column_set(zval*                  fields,
+                                uint32_t               row,
+                                uint32_t               rows,
+                                const CommandResponse* name,
+                                const CommandResponse* value) {
+    zval* column;
+
+    if (!name || name->response_type != String) {
+        return;
+    }
+
+    /* Numeric field names become integer keys, as in the row-shaped replies */
+    column =
+        zend_symtable_str_find(Z_ARRVAL_P(fields), name->string_value, name->string_value_len);
+    if (!column) {
+        zval new_column;
+        array_init_size(&new_column, rows);
+        for (uint32_t i = 0; i < row; i++) {
+            add_next_index_null(&new_column);
+        }
+        column = zend_symtable_str_update(
+            Z_ARRVAL_P(fields), name->string_value, name->string_value_len, &new_column);
+    }
+
+    /* A field repeated within an entry keeps its first value */
+    if (zend_hash_num_elements(Z_ARRVAL_P(column)) == row) {
+        valkey_glide_column_add(column, value);
+    }
+}
+
+/**
+ * Process a stream result under OPT_COLUMNAR: ['id' => [...], 'fields' => [name => [...]]],
+ * with null where an entry lacks a field the others have
+ */
+int process_x_stream_columnar_result(CommandResponse* response, void* output, zval* return_value) {
+    zval     ids, fields, *column;
+    uint32_t rows, row = 0;
+
+    if (!response || response->response_type != Map) {
+        return command_response_to_stream_zval(response, return_value);
+    }
+
+    rows = (uint32_t) response->array_value_len;
+    array_init_size(&ids, rows);
+    array_init(&fields);
+
+    for (uint32_t i = 0; i < rows; i++) {
+        const CommandResponse* entry = &response->array_value[i];
+        const CommandResponse* pairs = entry->map_value;
+
+        if (!entry->map_key || !pairs || entry->map_key->response_type != String) {
+            continue;
+        }
+        valkey_glide_column_add(&ids, entry->map_key);
+
+        if (pairs->response_type == Map) {
+            for (size_t j = 0; j < pairs->array_value_len; j++) {
+                x_stream_column_set(&fields,
+                                    row,
+                                    rows,
+                                    pairs->array_value[j].map_key,
+                                    pairs->array_value[j].map_value);
+            }
+        } else if (pairs->response_type == Array) {
+            for (size_t j = 0; j < pairs->array_value_len; j++) {
+                const CommandResponse* pair = &pairs->array_value[j];
+
+                if (pair->response_type == Array && pair->array_value_len == 2) {
+                    x_stream_column_set(
+                        &fields, row, rows, &pair->array_value[0], &pair->array_value[1]);
+                } else if (j + 1 < pairs->array_value_len) {
+                    /* Flat field, value, field, value... */
+                    x_stream_column_set(&fields, row, rows, pair, &pairs->array_value[++j]);
+                }
+            }
+        }
+
+        /* Fields this entry lacks */
+        row++;
+        ZEND_HASH_FOREACH_VAL(Z_ARRVAL(fields), column) {
+            if (zend_hash_num_elements(Z_ARRVAL_P(column)) < row) {
+                add_next_index_null(column);
+            }
+        }
+        ZEND_HASH_FOREACH_END();
+    }
+
+    array_init(return_value);
+    add_assoc_zval(return_value, "id", &ids);
+    add_assoc_zval(return_value, "fields", &fields);
+    return 1;
+}
+
 /**
  * Process an XADD result from a command
  */
@@ -577,6 +678,43 @@ int process_x_pending_result(CommandResponse* response, void* output, zval* retu
     return status;
 }
 
+/**
+ * Process an XPENDING result under OPT_COLUMNAR: the extended form becomes parallel 'id',
+ * 'consumer', 'idle' and 'deliveries' arrays, the summary form is left as it is
+ */
+int process_x_pending_columnar_result(CommandResponse* response, void* output, zval* return_value) {
+    zval     id, consumer, idle, deliveries;
+    uint32_t rows;
+
+    if (!response || response->response_type != Array ||
+        (response->array_value_len > 0 && response->array_value[0].response_type != Array)) {
+        return process_x_pending_result(response, output, return_value);
+    }
+
+    rows = (uint32_t) response->array_value_len;
+    array_init_size(&id, rows);
+    array_init_size(&consumer, rows);
+    array_init_size(&idle, rows);
+    array_init_size(&deliveries, rows);
+
+    for (uint32_t i = 0; i < rows; i++) {
+        const CommandResponse* entry  = &response->array_value[i];
+        size_t                 fields = entry->response_type == Array ? entry->array_value_len : 0;
+
+        valkey_glide_column_add(&id, fields > 0 ? &entry->array_value[0] : NULL);
+        valkey_glide_column_add(&consumer, fields > 1 ? &entry->array_value[1] : NULL);
+        valkey_glide_column_add(&idle, fields > 2 ? &entry->array_value[2] : NULL);
+        valkey_glide_column_add(&deliveries, fields > 3 ? &entry->array_value[3] : NULL);
+    }
+
+    array_init(return_value);
+    add_assoc_zval(return_value, "id", &id);
+    add_assoc_zval(return_value, "consumer", &consumer);
+    add_assoc_zval(return_value, "idle", &idle);
+    add_assoc_zval(return_value, "deliveries", &deliveries);
+    return 1;
+}
+
 /**
  * Process an XREADGROUP result from a command
  */
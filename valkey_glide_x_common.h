@@ -268,6 +268,8 @@ int process_x_stream_result(CommandResponse* response, void* output, zval* retur
 int process_x_add_result(CommandResponse* response, void* output, zval* return_value);
 int process_x_group_result(CommandResponse* response, void* output, zval* return_value);
 int process_x_pending_result(CommandResponse* response, void* output, zval* return_value);
+int process_x_stream_columnar_result(CommandResponse* response, void* output, zval* return_value);
+int process_x_pending_columnar_result(CommandResponse* response, void* output, zval* return_value);
 int process_x_readgroup_result(CommandResponse* response, void* output, zval* return_value);
 int process_x_claim_result(CommandResponse* response, void* output, zval* return_value);
 int process_x_autoclaim_result(CommandResponse* response, void* output, zval* return_value);
@@ -649,8 +649,12 @@ int execute_zrange_command(zval* object, int argc, zval* return_value, zend_clas
     parse_range_options(options, &range_opts);
 
 
-    int result = execute_z_generic_command(
-        valkey_glide, ZRange, &args, NULL, process_z_array_result, return_value);
+    /* WITHSCORES replies come back as columns under OPT_COLUMNAR */
+    z_result_processor_t processor =
+        valkey_glide->opt_columnar ? process_z_columnar_result : process_z_array_result;
+
+    int result =
+        execute_z_generic_command(valkey_glide, ZRange, &args, NULL, processor, return_value);
 
     /* If the command failed, clean up the return array */
     if (valkey_glide->is_in_batch_mode) {
@@ -975,8 +979,12 @@ int execute_zrangebyscore_command(zval*             object,
     parse_range_options(z_opts, &range_opts);
 
 
+    /* WITHSCORES replies come back as columns under OPT_COLUMNAR */
+    z_result_processor_t processor =
+        valkey_glide->opt_columnar ? process_z_columnar_result : process_z_array_result;
+
     int result = execute_z_generic_command(
-        valkey_glide, ZRangeByScore, &args, NULL, process_z_array_result, return_value);
+        valkey_glide, ZRangeByScore, &args, NULL, processor, return_value);
 
     if (valkey_glide->is_in_batch_mode) {
         /* In batch mode, return $this for method chaining */
@@ -1028,8 +1036,12 @@ int execute_zrevrangebyscore_command(zval*             object,
     parse_range_options(options, &range_opts);
 
 
+    /* WITHSCORES replies come back as columns under OPT_COLUMNAR */
+    z_result_processor_t processor =
+        valkey_glide->opt_columnar ? process_z_columnar_result : process_z_array_result;
+
     int result = execute_z_generic_command(
-        valkey_glide, ZRevRangeByScore, &args, NULL, process_z_array_result, return_value);
+        valkey_glide, ZRevRangeByScore, &args, NULL, processor, return_value);
 
     if (valkey_glide->is_in_batch_mode) {
         /* In batch mode, return $this for method chaining */
@@ -1687,6 +1699,7 @@ int execute_zmpop_command_internal(valkey_glide_object* valkey_glide,
             valkey_glide, cmd_type, args, args_len, arg_count, NULL, process_zmpop_result);
     } else {
         /* Execute the command */
+        valkey_glide_drop_next_call_options(valkey_glide->glide_client);
         cmd_result = command(valkey_glide->glide_client,
                              0,         /* channel */
                              cmd_type,  /* command type */
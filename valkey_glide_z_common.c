@@ -21,8 +21,11 @@
 #include <string.h>
 
 #include "command_response.h"
+#include "valkey_glide_breaker.h"
 #include "valkey_glide_commands_common.h"
 #include "valkey_glide_core_common.h"
+#include "valkey_glide_hot_keys.h"
+#include "valkey_glide_node_stats.h"
 
 /* Import the string conversion functions from command_response.c */
 extern char* long_to_string(long value, size_t* len);
@@ -560,6 +563,9 @@ int execute_z_generic_command(valkey_glide_object* valkey_glide,
             efree(allocated_strings);
         return 0;
     }
+    valkey_glide_hot_keys_record(valkey_glide, args->key, args->key_len, arg_lens, arg_count);
+    valkey_glide_node_stats_record(valkey_glide, args->key, args->key_len);
+    valkey_glide_breaker_record(valkey_glide, args->key, args->key_len);
 
     if (valkey_glide->is_in_batch_mode) {
         int result = buffer_command_for_batch(valkey_glide,
@@ -587,8 +593,9 @@ int execute_z_generic_command(valkey_glide_object* valkey_glide,
         return result;
     }
     /* Execute the command */
-    CommandResult* result =
-        execute_command(valkey_glide->glide_client, cmd_type, arg_count, arg_values, arg_lens);
+    CommandResponse* reply  = NULL;
+    CommandResult*   result = execute_command_for_reply(
+        valkey_glide->glide_client, cmd_type, arg_count, arg_values, arg_lens, &reply);
 
     /* Free allocated strings */
     int i;
@@ -616,7 +623,7 @@ int execute_z_generic_command(valkey_glide_object* valkey_glide,
     }
 
     /* Process the result */
-    int success = process_result(result->response, result_ptr, return_value);
+    int success = process_result(reply, result_ptr, return_value);
 
     /* Free the result */
     free_command_result(result);
@@ -1841,6 +1848,34 @@ int process_z_array_result(CommandResponse* response, void* output, zval* return
     return success;
 }
 
+/**
+ * Process a range result under OPT_COLUMNAR: WITHSCORES replies become parallel 'member' and
+ * 'score' arrays, anything else is processed like process_z_array_result
+ */
+int process_z_columnar_result(CommandResponse* response, void* output, zval* return_value) {
+    zval member, score;
+
+    if (!response || !return_value) {
+        return 0;
+    }
+    if (response->response_type != Map) {
+        return process_z_array_result(response, output, return_value);
+    }
+
+    array_init_size(&member, (uint32_t) response->array_value_len);
+    array_init_size(&score, (uint32_t) response->array_value_len);
+
+    for (size_t i = 0; i < response->array_value_len; i++) {
+        valkey_glide_column_add(&member, response->array_value[i].map_key);
+        valkey_glide_column_add_double(&score, response->array_value[i].map_value);
+    }
+
+    array_init(return_value);
+    add_assoc_zval(return_value, "member", &member);
+    add_assoc_zval(return_value, "score", &score);
+    return 1;
+}
+
 /**
  * Process integer result and set as ZVAL_LONG (for commands like ZINTERCARD)
  */
@@ -143,6 +143,11 @@ int process_z_double_result(CommandResponse* response, void* output, zval* retur
  */
 int process_z_array_result(CommandResponse* response, void* output, zval* return_value);
 
+/**
+ * Process a ZRANGE-style result as 'member' and 'score' columns (OPT_COLUMNAR)
+ */
+int process_z_columnar_result(CommandResponse* response, void* output, zval* return_value);
+
 int process_z_array_zrand_result(CommandResponse* response, void* output, zval* return_value);
 
 int process_z_long_to_zval_result(CommandResponse* response, void* output, zval* return_value);
@@ -13,10 +13,13 @@
 #include <ext/standard/info.h>
 
 #include "command_response.h" /* Include command_response.h for string conversion functions */
+#include "valkey_glide_bitmap.h"
 #include "valkey_glide_commands_common.h"
 #include "valkey_glide_geo_common.h"
 #include "valkey_glide_hash_common.h" /* Include hash command framework */
+#include "valkey_glide_hedge.h"
 #include "valkey_glide_list_common.h"
+#include "valkey_glide_node_stats.h"
 #include "valkey_glide_s_common.h"
 #include "valkey_glide_x_common.h"
 #include "valkey_glide_z_common.h"
@@ -562,6 +565,10 @@ BITOP_METHOD_IMPL(ValkeyGlide)
 GETBIT_METHOD_IMPL(ValkeyGlide)
 /* }}} */
 
+/* {{{ proto ValkeyGlideBitmap ValkeyGlide::getBitmap(string key) */
+GET_BITMAP_METHOD_IMPL(ValkeyGlide)
+/* }}} */
+
 /* {{{ proto long ValkeyGlide::setBit(string key, long offset, int value) */
 SETBIT_METHOD_IMPL(ValkeyGlide)
 /* }}} */
@@ -687,6 +694,22 @@ DISCARD_METHOD_IMPL(ValkeyGlide)
 EXEC_METHOD_IMPL(ValkeyGlide)
 /* }}} */
 
+/* {{{ proto array ValkeyGlide::ingestFile(string path [, string format, int window, int offset]) */
+INGEST_FILE_METHOD_IMPL(ValkeyGlide)
+/* }}} */
+
+/* {{{ proto ValkeyGlideBitmap ValkeyGlide::msetex(array kv, int|array ttl) */
+MSETEX_METHOD_IMPL(ValkeyGlide)
+/* }}} */
+
+/* {{{ proto ValkeyGlideBitmap ValkeyGlide::hmsetMulti(array hashes) */
+HMSET_MULTI_METHOD_IMPL(ValkeyGlide)
+/* }}} */
+
+/* {{{ proto ValkeyGlideBitmap ValkeyGlide::zaddMulti(array sets) */
+ZADD_MULTI_METHOD_IMPL(ValkeyGlide)
+/* }}} */
+
 /* {{{ proto string ValkeyGlide::dump(string key) */
 DUMP_METHOD_IMPL(ValkeyGlide)
 /* }}} */